@@ -0,0 +1,259 @@
+// BVH benchmark, no flecs / SDL needed:
+//   bvh_bench [count ...]     default 10000 100000 1000000
+// Per entity count: build, move 10% of the boxes, then aabb / sphere / ray /
+// frustum queries against a linear scan over the same boxes.
+
+#include "flecs_bvh_tree.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCH_QUERIES 1000
+#define BENCH_WORLD   1000.0f   // boxes spread over [-W, W] on x / z, [-W/10, W/10] on y
+
+static double bench_now(void) {
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1e6;
+}
+
+static uint32_t bench_rng = 12345u;
+static float bench_randf(float lo, float hi) {
+  bench_rng = bench_rng * 1664525u + 1013904223u;
+  return lo + (hi - lo) * (float)(bench_rng >> 8) / 16777216.0f;
+}
+
+static BvhAabb bench_box(float x, float y, float z, float half) {
+  return (BvhAabb){ { x - half, y - half, z - half }, { x + half, y + half, z + half } };
+}
+
+static BvhAabb bench_random_box(void) {
+  return bench_box(bench_randf(-BENCH_WORLD, BENCH_WORLD),
+                   bench_randf(-BENCH_WORLD * 0.1f, BENCH_WORLD * 0.1f),
+                   bench_randf(-BENCH_WORLD, BENCH_WORLD),
+                   bench_randf(0.25f, 2.0f));
+}
+
+static bool bench_count(void *ctx, int32_t proxy, uint64_t userData) {
+  (void)proxy; (void)userData;
+  (*(int64_t *)ctx)++;
+  return true;
+}
+
+static float bench_ray_hit(void *ctx, int32_t proxy, uint64_t userData, float t) {
+  (void)proxy; (void)userData;
+  float *best = ctx;
+  if (t < *best) *best = t;
+  return *best; // closest hit so far, clips the rest of the traversal
+}
+
+static bool bench_overlap(const BvhAabb *a, const BvhAabb *b) {
+  for (int i = 0; i < 3; i++) {
+    if (a->max[i] < b->min[i] || b->max[i] < a->min[i]) return false;
+  }
+  return true;
+}
+
+static bool bench_sphere(const BvhAabb *a, const float c[3], float r) {
+  float d2 = 0.0f;
+  for (int i = 0; i < 3; i++) {
+    float v = fmaxf(a->min[i] - c[i], fmaxf(0.0f, c[i] - a->max[i]));
+    d2 += v * v;
+  }
+  return d2 <= r * r;
+}
+
+static float bench_slab(const BvhAabb *a, const float o[3], const float inv[3], float maxT) {
+  float tmin = 0.0f, tmax = maxT;
+  for (int i = 0; i < 3; i++) {
+    float t1 = (a->min[i] - o[i]) * inv[i];
+    float t2 = (a->max[i] - o[i]) * inv[i];
+    tmin = fmaxf(tmin, fminf(t1, t2));
+    tmax = fminf(tmax, fmaxf(t1, t2));
+  }
+  return tmin <= tmax ? tmin : -1.0f;
+}
+
+static bool bench_frustum(const BvhAabb *a, const float planes[6][4]) {
+  for (int p = 0; p < 6; p++) {
+    float d = planes[p][3];
+    for (int i = 0; i < 3; i++) d += planes[p][i] * (planes[p][i] > 0.0f ? a->max[i] : a->min[i]);
+    if (d < 0.0f) return false;
+  }
+  return true;
+}
+
+// column major perspective (Vulkan depth 0..1) * look-at, no cglm so the bench stays standalone
+static void bench_view_proj(const float eye[3], const float fwd[3], float out[4][4]) {
+  float up[3] = { 0.0f, 1.0f, 0.0f };
+  float s[3] = { fwd[1] * up[2] - fwd[2] * up[1], fwd[2] * up[0] - fwd[0] * up[2], fwd[0] * up[1] - fwd[1] * up[0] };
+  float sl = sqrtf(s[0] * s[0] + s[1] * s[1] + s[2] * s[2]);
+  for (int i = 0; i < 3; i++) s[i] /= sl;
+  float u[3] = { s[1] * fwd[2] - s[2] * fwd[1], s[2] * fwd[0] - s[0] * fwd[2], s[0] * fwd[1] - s[1] * fwd[0] };
+  float view[4][4] = {
+    { s[0], u[0], -fwd[0], 0.0f },
+    { s[1], u[1], -fwd[1], 0.0f },
+    { s[2], u[2], -fwd[2], 0.0f },
+    { -(s[0] * eye[0] + s[1] * eye[1] + s[2] * eye[2]),
+      -(u[0] * eye[0] + u[1] * eye[1] + u[2] * eye[2]),
+      fwd[0] * eye[0] + fwd[1] * eye[1] + fwd[2] * eye[2], 1.0f }
+  };
+  float nearZ = 0.1f, farZ = 300.0f, f = 1.0f / tanf(0.5f * 1.0472f), aspect = 16.0f / 9.0f;
+  float proj[4][4] = {
+    { f / aspect, 0.0f, 0.0f, 0.0f },
+    { 0.0f, -f, 0.0f, 0.0f },
+    { 0.0f, 0.0f, farZ / (nearZ - farZ), -1.0f },
+    { 0.0f, 0.0f, nearZ * farZ / (nearZ - farZ), 0.0f }
+  };
+  for (int c = 0; c < 4; c++) {
+    for (int r = 0; r < 4; r++) {
+      out[c][r] = 0.0f;
+      for (int k = 0; k < 4; k++) out[c][r] += proj[k][r] * view[c][k];
+    }
+  }
+}
+
+static void bench_run(int32_t count) {
+  BvhAabb *boxes = malloc(sizeof(BvhAabb) * (size_t)count);
+  int32_t *proxies = malloc(sizeof(int32_t) * (size_t)count);
+  if (!boxes || !proxies) {
+    fprintf(stderr, "out of memory for %d boxes\n", count);
+    free(boxes);
+    free(proxies);
+    return;
+  }
+  for (int32_t i = 0; i < count; i++) boxes[i] = bench_random_box();
+
+  BvhTree tree;
+  flecs_bvh_tree_init(&tree, BVH_MARGIN);
+
+  printf("== %d entities ==\n", count);
+  double t0 = bench_now();
+  for (int32_t i = 0; i < count; i++) proxies[i] = flecs_bvh_tree_insert(&tree, &boxes[i], (uint64_t)i);
+  double t1 = bench_now();
+  printf("  insert            %9.2f ms  height %d  area ratio %.1f\n", t1 - t0,
+         flecs_bvh_tree_height(&tree), flecs_bvh_tree_area_ratio(&tree));
+
+  // 10% moving: half jitter inside the margin, half jump far
+  int32_t moved = count / 10, reinserted = 0;
+  t0 = bench_now();
+  for (int32_t i = 0; i < moved; i++) {
+    int32_t k = (int32_t)(bench_randf(0.0f, 1.0f) * (float)(count - 1));
+    float step = (i & 1) ? bench_randf(-BVH_MARGIN, BVH_MARGIN) * 0.5f : bench_randf(-20.0f, 20.0f);
+    for (int a = 0; a < 3; a++) {
+      boxes[k].min[a] += step;
+      boxes[k].max[a] += step;
+    }
+    reinserted += flecs_bvh_tree_move(&tree, proxies[k], &boxes[k]) ? 1 : 0;
+  }
+  t1 = bench_now();
+  printf("  move 10%%          %9.2f ms  %d reinserted  height %d\n", t1 - t0, reinserted,
+         flecs_bvh_tree_height(&tree));
+
+  // aabb, 20 units wide
+  BvhAabb queries[BENCH_QUERIES];
+  for (int q = 0; q < BENCH_QUERIES; q++) queries[q] = bench_box(bench_randf(-BENCH_WORLD, BENCH_WORLD), 0.0f, bench_randf(-BENCH_WORLD, BENCH_WORLD), 10.0f);
+
+  int64_t hitsTree = 0, hitsScan = 0;
+  t0 = bench_now();
+  for (int q = 0; q < BENCH_QUERIES; q++) flecs_bvh_tree_query_aabb(&tree, &queries[q], bench_count, &hitsTree);
+  t1 = bench_now();
+  int scanQueries = count >= 1000000 ? BENCH_QUERIES / 10 : BENCH_QUERIES;
+  double s0 = bench_now();
+  for (int q = 0; q < scanQueries; q++) {
+    for (int32_t i = 0; i < count; i++) hitsScan += bench_overlap(&boxes[i], &queries[q]);
+  }
+  double s1 = bench_now();
+  double scale = (double)BENCH_QUERIES / scanQueries;
+  printf("  aabb    x%d      %9.2f ms  scan %9.2f ms  hits %lld / %lld\n", BENCH_QUERIES, t1 - t0,
+         (s1 - s0) * scale, (long long)hitsTree, (long long)(hitsScan * (int64_t)scale));
+
+  // sphere, radius 15
+  hitsTree = hitsScan = 0;
+  t0 = bench_now();
+  for (int q = 0; q < BENCH_QUERIES; q++) {
+    float c[3] = { queries[q].min[0] + 10.0f, 0.0f, queries[q].min[2] + 10.0f };
+    flecs_bvh_tree_query_sphere(&tree, c, 15.0f, bench_count, &hitsTree);
+  }
+  t1 = bench_now();
+  s0 = bench_now();
+  for (int q = 0; q < scanQueries; q++) {
+    float c[3] = { queries[q].min[0] + 10.0f, 0.0f, queries[q].min[2] + 10.0f };
+    for (int32_t i = 0; i < count; i++) hitsScan += bench_sphere(&boxes[i], c, 15.0f);
+  }
+  s1 = bench_now();
+  printf("  sphere  x%d      %9.2f ms  scan %9.2f ms  hits %lld / %lld\n", BENCH_QUERIES, t1 - t0,
+         (s1 - s0) * scale, (long long)hitsTree, (long long)(hitsScan * (int64_t)scale));
+
+  // ray, closest hit along x from random origins, same distance as the scan
+  static float bestTree[BENCH_QUERIES];
+  int64_t rayMatches = 0, rayHits = 0;
+  float dir[3] = { 1.0f, 0.0f, 0.05f };
+  float inv[3] = { 1.0f / dir[0], INFINITY, 1.0f / dir[2] };
+  t0 = bench_now();
+  for (int q = 0; q < BENCH_QUERIES; q++) {
+    float o[3] = { -BENCH_WORLD, queries[q].min[1], queries[q].min[2] };
+    bestTree[q] = 4.0f * BENCH_WORLD;
+    flecs_bvh_tree_raycast(&tree, o, dir, 4.0f * BENCH_WORLD, bench_ray_hit, &bestTree[q]);
+  }
+  t1 = bench_now();
+  s0 = bench_now();
+  for (int q = 0; q < scanQueries; q++) {
+    float o[3] = { -BENCH_WORLD, queries[q].min[1], queries[q].min[2] };
+    float best = 4.0f * BENCH_WORLD;
+    for (int32_t i = 0; i < count; i++) {
+      if (o[1] < boxes[i].min[1] || o[1] > boxes[i].max[1]) continue; // dir.y == 0
+      float t = bench_slab(&boxes[i], o, inv, best);
+      if (t >= 0.0f) best = t;
+    }
+    if (best < 4.0f * BENCH_WORLD) rayHits++;
+    if (best == bestTree[q]) rayMatches++;
+  }
+  s1 = bench_now();
+  printf("  ray     x%d      %9.2f ms  scan %9.2f ms  closest t %lld / %d (%lld hit)\n", BENCH_QUERIES, t1 - t0,
+         (s1 - s0) * scale, (long long)rayMatches, scanQueries, (long long)rayHits);
+
+  // frustum, 100 cameras looking along random directions
+  int frustums = 100;
+  hitsTree = hitsScan = 0;
+  float planes[100][6][4];
+  for (int q = 0; q < frustums; q++) {
+    float eye[3] = { queries[q].min[0], 20.0f, queries[q].min[2] };
+    float a = bench_randf(0.0f, 6.2831853f);
+    float fwd[3] = { cosf(a) * 0.97f, -0.243f, sinf(a) * 0.97f };
+    float vp[4][4];
+    bench_view_proj(eye, fwd, vp);
+    flecs_bvh_frustum_planes((const float (*)[4])vp, planes[q]);
+  }
+  t0 = bench_now();
+  for (int q = 0; q < frustums; q++) flecs_bvh_tree_query_frustum(&tree, (const float (*)[4])planes[q], bench_count, &hitsTree);
+  t1 = bench_now();
+  s0 = bench_now();
+  for (int q = 0; q < frustums; q++) {
+    for (int32_t i = 0; i < count; i++) hitsScan += bench_frustum(&boxes[i], (const float (*)[4])planes[q]);
+  }
+  s1 = bench_now();
+  printf("  frustum x%d       %9.2f ms  scan %9.2f ms  hits %lld / %lld\n", frustums, t1 - t0,
+         s1 - s0, (long long)hitsTree, (long long)hitsScan);
+
+  t0 = bench_now();
+  for (int32_t i = 0; i < count; i++) flecs_bvh_tree_remove(&tree, proxies[i]);
+  t1 = bench_now();
+  printf("  remove            %9.2f ms  %d left\n", t1 - t0, tree.proxyCount);
+
+  flecs_bvh_tree_fini(&tree);
+  free(boxes);
+  free(proxies);
+}
+
+int main(int argc, char **argv) {
+  if (argc > 1) {
+    for (int i = 1; i < argc; i++) bench_run((int32_t)atoi(argv[i]));
+  } else {
+    bench_run(10000);
+    bench_run(100000);
+    bench_run(1000000);
+  }
+  return 0;
+}
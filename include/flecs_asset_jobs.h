@@ -0,0 +1,117 @@
+#ifndef FLECS_ASSET_JOBS_H
+#define FLECS_ASSET_JOBS_H
+
+#include "flecs_types.h"
+#include "flecs_texture_cooker.h"
+
+#define ASSET_PATH_MAX 128
+
+// asset_cooker mesh, "<model path>.mesh": AssetMeshHeader, Vertex3d[], uint32_t[]
+#define ASSET_MESH_COOKED_EXT ".mesh"
+#define ASSET_MESH_MAGIC      0x48534D46u  // "FMSH"
+#define ASSET_MESH_VERSION    1
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t vertexCount;
+  uint32_t indexCount;
+  uint32_t vertexSize;   // sizeof(Vertex3d) when cooked
+  uint32_t reserved;
+} AssetMeshHeader;
+
+typedef enum {
+  ASSET_TYPE_TEXTURE,   // stbi_load RGBA8, or BC cooked when the device supports it
+  ASSET_TYPE_MESH,      // aiImportFile first mesh to Vertex3d
+  ASSET_TYPE_FONT,      // font file bytes (FT_New_Memory_Face)
+  ASSET_TYPE_FILE       // raw file bytes
+} AssetType;
+
+typedef enum {
+  ASSET_STATE_LOADING,  // queued or decoding on a worker
+  ASSET_STATE_READY,    // uploaded on main thread
+  ASSET_STATE_FAILED
+} AssetState;
+
+// CPU side data filled on a worker thread, handed to the upload callback on
+// the main thread. All buffers are malloc'd, upload can take ownership by
+// setting the pointer to NULL.
+typedef struct {
+  // texture
+  unsigned char *pixels;
+  int width;
+  int height;
+  int channels;
+  CookedTexture cooked; // BC blocks + mips instead of pixels (cooked.file != NULL)
+  // mesh
+  Vertex3d *vertices;
+  uint32_t vertexCount;
+  uint32_t *indices;
+  uint32_t indexCount;
+  // raw file / font bytes
+  void *data;
+  size_t size;
+  // module payload (ex. glyph metrics)
+  void *userData;
+  uint64_t contentHash; // FNV-1a of the source file, 0 when the decoder never saw the bytes
+  const char *error;
+} AssetResult;
+
+// worker thread, must not touch the world
+typedef bool (*AssetDecodeFn)(const char *path, AssetResult *result);
+// main thread, LogicUpdatePhase
+typedef bool (*AssetUploadFn)(ecs_world_t *world, ecs_entity_t entity, AssetResult *result);
+
+typedef struct {
+  const char *path;
+  AssetType type;
+  AssetDecodeFn decode;   // optional, default decoder for type
+  AssetUploadFn upload;   // optional, GPU upload on main thread
+  bool raw;               // texture: keep RGBA8 pixels, skip the BC cooker
+} AssetLoadDesc;
+
+typedef struct {
+  AssetType type;
+  AssetState state;
+  char path[ASSET_PATH_MAX];
+  // load desc, kept for flecs_asset_reload
+  AssetDecodeFn decode;
+  AssetUploadFn upload;
+  bool raw;
+  bool reloading;       // re-decode in flight, state and GPU data stay the old ones
+  uint32_t version;     // successful uploads, > 1 after a reload
+  uint64_t contentHash; // of the uploaded version, 0 if the decoder didn't hash it
+} AssetHandle;
+ECS_COMPONENT_DECLARE(AssetHandle);
+
+typedef struct AssetJobQueue AssetJobQueue;
+
+typedef struct {
+  AssetJobQueue *queue;     // heap, worker threads keep this pointer
+  int workerCount;
+  int pendingCount;         // submitted but not uploaded yet
+  int maxUploadsPerFrame;   // GPU uploads per LogicUpdatePhase
+} AssetJobContext;
+ECS_COMPONENT_DECLARE(AssetJobContext);
+
+void flecs_asset_jobs_module_init(ecs_world_t *world);
+void flecs_asset_jobs_cleanup(ecs_world_t *world);
+
+ecs_entity_t flecs_asset_load(ecs_world_t *world, const AssetLoadDesc *desc);
+// decode the file again on a worker, the upload callback runs with the new
+// result at a frame boundary (queue idle) and swaps the GPU resources
+bool flecs_asset_reload(ecs_world_t *world, ecs_entity_t asset);
+void flecs_asset_result_free(AssetResult *result);
+
+// aiImportFileEx with aiFileIO reading through the vfs (pack or loose files)
+struct aiScene;
+const struct aiScene *flecs_asset_import_scene(const char *path, unsigned int flags);
+
+// every file the importer opened (model, .mtl ...), asset_cooker dependencies
+typedef void (*AssetImportOpenFn)(void *user, const char *path);
+// first mesh of the model to Vertex3d, onOpen optional
+bool flecs_asset_import_mesh(const char *path, AssetResult *result, AssetImportOpenFn onOpen, void *user);
+// AssetMeshHeader blob of a decoded mesh, malloc'd
+void *flecs_asset_mesh_serialize(const AssetResult *result, size_t *size);
+
+#endif
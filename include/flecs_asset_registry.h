@@ -0,0 +1,78 @@
+#ifndef FLECS_ASSET_REGISTRY_H
+#define FLECS_ASSET_REGISTRY_H
+
+#include "flecs_types.h"
+#include "flecs_asset_jobs.h"
+
+// Asset registry
+// One entity per distinct asset, found by its normalised path and, once the
+// bytes were read, by their hash. Modules acquire assets for an owner entity
+// (their context singleton or a scene entity), the owner holds an
+// (AssetUses, asset) pair. Removing the last pair, by flecs_asset_release or
+// by deleting the owner, deletes the asset and its OnRemove hooks free the
+// GPU objects.
+
+typedef enum {
+  ASSET_KIND_HANDLE,            // AssetHandle job, path key includes type/decode/upload
+  ASSET_KIND_STREAMED_TEXTURE,  // StreamedTexture, identical pixels share one image
+  ASSET_KIND_SHADER,            // ShaderAsset, keyed by the SPIR-V only
+  ASSET_KIND_COUNT
+} AssetKind;
+
+typedef struct {
+  AssetKind kind;
+  char path[ASSET_PATH_MAX];   // normalised, empty for content only assets
+  uint64_t key;                // path index, 0 = not indexed by path
+  uint64_t contentHash;        // content index, 0 until decoded
+  int32_t refCount;            // owners holding (AssetUses, this)
+} AssetRegistryEntry;
+ECS_COMPONENT_DECLARE(AssetRegistryEntry);
+
+typedef struct {
+  VkShaderModule module;
+  size_t codeSize;
+} ShaderAsset;
+ECS_COMPONENT_DECLARE(ShaderAsset);
+
+typedef struct {
+  ecs_map_t paths;       // key -> asset entity
+  ecs_map_t contents;    // kind + content hash -> asset entity
+  ecs_map_t shaders;     // shader entity -> VkShaderModule, readable before deferred sets land
+  bool ready;            // maps are gone after cleanup, hooks skip the index
+  uint32_t loads;        // stats
+  uint32_t hits;
+} AssetRegistryContext;
+ECS_COMPONENT_DECLARE(AssetRegistryContext);
+
+// relationship, (AssetUses, asset) on every owner
+ECS_TAG_DECLARE(AssetUses);
+
+void flecs_asset_registry_module_init(ecs_world_t *world);
+void flecs_asset_registry_cleanup(ecs_world_t *world);
+
+// "./assets\textures//old/../a.png" -> "assets/textures/a.png"
+bool flecs_asset_normalize_path(const char *path, char *out, size_t size);
+
+// flecs_asset_load through the registry, the same file with the same
+// type/decode/upload is decoded and uploaded once. Meant for upload callbacks
+// that fill a module context; per entity products (texture sets) keep
+// flecs_asset_load.
+ecs_entity_t flecs_asset_acquire(ecs_world_t *world, ecs_entity_t owner, const AssetLoadDesc *desc);
+
+// one VkShaderModule per distinct SPIR-V, release it once the pipeline is built
+ecs_entity_t flecs_asset_shader_acquire(ecs_world_t *world, ecs_entity_t owner, const uint32_t *code, size_t codeSize);
+VkShaderModule flecs_asset_shader_module(ecs_world_t *world, ecs_entity_t shader);
+
+// ownership, the asset is deleted when its last owner lets go
+void flecs_asset_use(ecs_world_t *world, ecs_entity_t owner, ecs_entity_t asset);
+void flecs_asset_release(ecs_world_t *world, ecs_entity_t owner, ecs_entity_t asset);
+
+// for modules that create their own asset entities (texture_stream), salt
+// separates keys of the same path (ex. decode/upload functions)
+ecs_entity_t flecs_asset_registry_find(ecs_world_t *world, AssetKind kind, const char *path, uint64_t salt);
+ecs_entity_t flecs_asset_registry_find_content(ecs_world_t *world, AssetKind kind, uint64_t contentHash);
+void flecs_asset_registry_add(ecs_world_t *world, ecs_entity_t asset, AssetKind kind, const char *path, uint64_t salt);
+// first asset with a hash keeps the content index, later ones can alias it
+void flecs_asset_registry_set_content(ecs_world_t *world, ecs_entity_t asset, uint64_t contentHash);
+
+#endif
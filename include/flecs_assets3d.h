@@ -34,6 +34,8 @@ typedef struct {
   VkDescriptorSetLayout assets3d_descriptorSetLayout;
   VkPipelineLayout assets3d_pipelineLayout;
   VkPipeline assets3d_graphicsPipeline;
+  ecs_entity_t assets3d_meshAsset;   // AssetHandle entity
+  ecs_entity_t assets3d_model;       // SimTransform spun on the fixed tick, WorldTransform is the model matrix
 } Assets3DModelContext;
 
 ECS_COMPONENT_DECLARE(Assets3DModelContext);
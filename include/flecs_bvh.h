@@ -0,0 +1,48 @@
+#ifndef FLECS_BVH_H
+#define FLECS_BVH_H
+
+#include "flecs.h"
+#include "flecs_types.h"
+#include "flecs_transform.h"
+#include "flecs_bvh_tree.h"
+
+// Spatial index
+// Every entity with Bounds + WorldTransform has a leaf in a dynamic AABB tree
+// (flecs_bvh_tree.h). BvhUpdateSystem runs in TransformPhase right after
+// TransformPropagateSystem and only visits tables whose Bounds or
+// WorldTransform changed: new entities are inserted, moved ones refit (no
+// tree work while the box stays inside its fat margin). An OnRemove observer
+// drops the leaf when the entity is deleted or loses either component.
+// Queries are valid from BeginRenderPhase on and report the entity as the
+// callback's userData.
+// flecs_bvh_query_* / flecs_bvh_raycast are main thread only (they share one
+// ecs_ref_t). A system on worker stages takes BvhContext as a term, in, and
+// calls flecs_bvh_tree_query_* on its tree, those may run on any thread.
+
+typedef struct {
+  float min[3];        // local space, WorldTransform turns it into a world AABB
+  float max[3];
+} Bounds;
+ECS_COMPONENT_DECLARE(Bounds);
+
+typedef struct {
+  BvhTree tree;
+  ecs_map_t proxies;        // entity -> tree proxy
+  bool proxiesReady;
+  ecs_query_t *query;       // Bounds, WorldTransform, change detection
+  uint32_t insertedCount;   // last frame
+  uint32_t movedCount;      // leaves reinserted last frame
+} BvhContext;
+ECS_COMPONENT_DECLARE(BvhContext);
+
+// after flecs_transform_module_init, BvhUpdateSystem must follow TransformPropagateSystem
+void flecs_bvh_module_init(ecs_world_t *world);
+void flecs_bvh_cleanup(ecs_world_t *world);
+
+int32_t flecs_bvh_query_aabb(ecs_world_t *world, const BvhAabb *aabb, BvhQueryFn fn, void *ctx);
+int32_t flecs_bvh_query_sphere(ecs_world_t *world, const vec3 center, float radius, BvhQueryFn fn, void *ctx);
+// viewProj = proj * view of the camera (cglm, Vulkan depth)
+int32_t flecs_bvh_query_frustum(ecs_world_t *world, const mat4 viewProj, BvhQueryFn fn, void *ctx);
+int32_t flecs_bvh_raycast(ecs_world_t *world, const vec3 origin, const vec3 dir, float maxT, BvhRayFn fn, void *ctx);
+
+#endif
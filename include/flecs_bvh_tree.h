@@ -0,0 +1,78 @@
+#ifndef FLECS_BVH_TREE_H
+#define FLECS_BVH_TREE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Dynamic AABB tree
+// Leaves hold a fat box (tight box + margin) so small moves do not touch the
+// tree; queries descend on fat boxes and report on the tight one. A leaf
+// that leaves its fat box is removed and inserted again: the sibling is
+// picked by surface area cost and every ancestor on the way back up gets an
+// AVL style rotation, the tree stays balanced incrementally.
+// No flecs / cglm here, flecs_bvh.c wraps it for entities and
+// examples/bvh_bench.c times it standalone.
+// Queries only read the tree and use a stack on the C stack, several threads
+// may query at once as long as nobody inserts / moves / removes.
+
+#define BVH_NULL        -1
+#define BVH_MARGIN      0.1f   // fat box margin, world units
+#define BVH_STACK_SIZE  256    // traversal depth, an AVL tree of 2^32 leaves stays well below
+
+typedef struct {
+  float min[3];
+  float max[3];
+} BvhAabb;
+
+typedef struct {
+  BvhAabb aabb;        // fat box for leaves, union of the children otherwise
+  BvhAabb tight;       // leaves: the box passed to insert / move
+  uint64_t userData;   // entity for flecs_bvh
+  int32_t parent;      // next free node while in the free list
+  int32_t child1;      // BVH_NULL for leaves
+  int32_t child2;
+  int32_t height;      // leaf 0, free -1
+} BvhNode;
+
+typedef struct {
+  BvhNode *nodes;
+  int32_t root;
+  int32_t nodeCount;
+  int32_t nodeCapacity;
+  int32_t freeList;
+  int32_t proxyCount;
+  float margin;
+} BvhTree;
+
+// return false to stop the query
+typedef bool (*BvhQueryFn)(void *ctx, int32_t proxy, uint64_t userData);
+// t = entry distance along the ray into the leaf's tight box. Return the new max
+// distance (clip), the current one to go on, or 0 to stop
+typedef float (*BvhRayFn)(void *ctx, int32_t proxy, uint64_t userData, float t);
+
+void flecs_bvh_tree_init(BvhTree *tree, float margin);
+void flecs_bvh_tree_fini(BvhTree *tree);
+
+// proxy id stays valid until removed, BVH_NULL when out of memory
+int32_t flecs_bvh_tree_insert(BvhTree *tree, const BvhAabb *aabb, uint64_t userData);
+void flecs_bvh_tree_remove(BvhTree *tree, int32_t proxy);
+// true when the leaf was reinserted, false when its fat box still fits
+bool flecs_bvh_tree_move(BvhTree *tree, int32_t proxy, const BvhAabb *aabb);
+
+// leaves reported
+int32_t flecs_bvh_tree_query_aabb(const BvhTree *tree, const BvhAabb *aabb, BvhQueryFn fn, void *ctx);
+int32_t flecs_bvh_tree_query_sphere(const BvhTree *tree, const float center[3], float radius, BvhQueryFn fn, void *ctx);
+// planes (a, b, c, d) with normals pointing inside, a point is inside when
+// a x + b y + c z + d >= 0 for all six. Subtrees fully inside skip the tests
+int32_t flecs_bvh_tree_query_frustum(const BvhTree *tree, const float planes[6][4], BvhQueryFn fn, void *ctx);
+// dir does not need to be normalized, distances are in units of dir
+int32_t flecs_bvh_tree_raycast(const BvhTree *tree, const float origin[3], const float dir[3], float maxT, BvhRayFn fn, void *ctx);
+
+// frustum planes of a column major view * projection, Vulkan depth 0..1
+void flecs_bvh_frustum_planes(const float viewProj[4][4], float planes[6][4]);
+
+int32_t flecs_bvh_tree_height(const BvhTree *tree);
+// sum of internal node areas / root area, lower is a better tree
+float flecs_bvh_tree_area_ratio(const BvhTree *tree);
+
+#endif
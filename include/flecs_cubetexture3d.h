@@ -16,10 +16,8 @@ typedef struct {
   VkDescriptorSetLayout cubetexture3dDescriptorSetLayout;
   VkPipelineLayout cubetexture3dPipelineLayout;
   VkPipeline cubetexture3dPipeline;
-  VkImage cubetexture3dImage;
-  VkDeviceMemory cubetexture3dImageMemory;
-  VkImageView cubetexture3dImageView;
-  VkSampler cubetexture3dSampler;
+  ecs_entity_t texture;         // StreamedTexture entity
+  uint32_t textureGeneration;   // last view written to the descriptor set
 } CubeText3DContext;
 
 ECS_COMPONENT_DECLARE(CubeText3DContext);
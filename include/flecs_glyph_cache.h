@@ -0,0 +1,89 @@
+#ifndef FLECS_GLYPH_CACHE_H
+#define FLECS_GLYPH_CACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <vulkan/vulkan.h>
+#include "flecs_vulkan.h"
+
+// Glyph cache
+// Glyphs are rasterised with FreeType the first time a (font, pixel size,
+// codepoint) is drawn and packed into R8 atlas pages by a shelf packer. Only
+// the new glyph rectangles are copied to the page (one staging buffer, one
+// submit per frame). When every page is full the least recently used page is
+// cleared and its glyphs come back on their next use.
+// SDF fonts store one signed distance field per glyph at GLYPH_SDF_PIXEL_SIZE
+// (0.5 = outline, GLYPH_SDF_SPREAD pixels each way), every drawn size reuses
+// it. Pages hold glyphs of one mode so the shader knows how to read them.
+// Main thread only.
+
+#define GLYPH_PAGE_SIZE     1024
+#define GLYPH_MAX_PAGES     4             // one descriptor set and draw per page
+#define GLYPH_MAX_FONTS     8
+#define GLYPH_MAX_SHELVES   128           // per page
+#define GLYPH_MAX_COPIES    1024          // new glyphs per frame, the rest waits a frame
+#define GLYPH_MAX_PIXEL_SIZE 256          // coverage glyphs, SDF glyphs draw at any size
+#define GLYPH_PADDING       1             // empty texels right and below, no bleeding with linear filtering
+#define GLYPH_STAGING_SIZE  (1024 * 1024) // new glyph pixels per frame
+#define GLYPH_SDF_PIXEL_SIZE 32           // SDF glyphs are rasterised once at this size
+#define GLYPH_SDF_SPREAD    8             // distance range in pixels at GLYPH_SDF_PIXEL_SIZE
+
+typedef enum {
+  GLYPH_MODE_COVERAGE,    // antialiased coverage, one entry per pixel size
+  GLYPH_MODE_SDF          // signed distance field, scaled to any size
+} GlyphCacheMode;
+
+typedef struct {
+  uint16_t page;
+  uint16_t x, y;          // texels in the page, padding excluded
+  uint16_t width, height; // 0 for blank glyphs (space)
+  int16_t bearingX;       // pen to left edge
+  int16_t bearingY;       // baseline to top edge
+  float advanceX;         // pixels
+  float u0, v0, u1, v1;
+  float scale;            // requested / rasterised size, multiply the metrics by it
+} GlyphCacheGlyph;
+
+typedef struct GlyphCache GlyphCache;
+
+// pages allocate their descriptor set (binding 0 sampler) from pool / layout
+GlyphCache *flecs_glyph_cache_create(VulkanContext *v_ctx, VkDescriptorPool pool, VkDescriptorSetLayout layout);
+// caller waits for the device first
+void flecs_glyph_cache_destroy(GlyphCache *cache, VulkanContext *v_ctx);
+
+// takes the malloc'd font file (FT_New_Memory_Face keeps pointing into it),
+// returns the font id or -1. font >= 0 replaces that font (hot reload) and
+// drops its cached glyphs. FreeType and the face only start on the first
+// glyph that was not inserted, glyphs from a baked atlas never need them
+int flecs_glyph_cache_set_font(GlyphCache *cache, int font, GlyphCacheMode mode, void *data, size_t size);
+GlyphCacheMode flecs_glyph_cache_font_mode(const GlyphCache *cache, int font);
+
+// add an already rasterised glyph (baked or cooked atlas), no FreeType.
+// bitmap rows are pitch bytes apart, metrics page/x/y/uv are filled in.
+// SDF fonts only take GLYPH_SDF_PIXEL_SIZE fields
+bool flecs_glyph_cache_insert(GlyphCache *cache, int font, uint32_t pixelSize, uint32_t codepoint,
+                              const uint8_t *bitmap, int pitch, const GlyphCacheGlyph *metrics);
+
+// cached glyph, rasterised on first use. false when it can't be placed this
+// frame (staging or pages full with glyphs already used this frame)
+bool flecs_glyph_cache_get(GlyphCache *cache, int font, uint32_t pixelSize, uint32_t codepoint, GlyphCacheGlyph *glyph);
+
+// pages drawn from after this are not evicted until the next frame
+void flecs_glyph_cache_begin_frame(GlyphCache *cache);
+// submit the pending glyph copies (glyphs added since the last flush), before
+// the frame's command buffer so queue order puts them ahead of the draws
+void flecs_glyph_cache_flush(GlyphCache *cache, VulkanContext *v_ctx);
+
+uint32_t flecs_glyph_cache_page_count(const GlyphCache *cache);
+VkDescriptorSet flecs_glyph_cache_page_set(const GlyphCache *cache, uint32_t page);
+GlyphCacheMode flecs_glyph_cache_page_mode(const GlyphCache *cache, uint32_t page);
+// bumped when the page is cleared, uvs on it from an older generation are stale
+uint32_t flecs_glyph_cache_page_generation(const GlyphCache *cache, uint32_t page);
+// keep the page for this frame, for glyphs drawn from a retained layout
+void flecs_glyph_cache_touch_page(GlyphCache *cache, uint32_t page);
+
+// next code point of a UTF-8 string and advance *text, U+FFFD for bad bytes
+uint32_t flecs_utf8_next(const char **text);
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef FLECS_HOT_RELOAD_H
+#define FLECS_HOT_RELOAD_H
+
+#include "flecs_types.h"
+#include "flecs_asset_jobs.h"
+
+// Asset hot reload
+// Every AssetHandle whose file is a loose file on disk (not in assets.pak) is
+// watched, inotify on linux and a polling thread elsewhere. A changed file
+// re-runs only its own asset job (flecs_asset_reload): decode on a worker,
+// upload callback at a frame boundary, old GPU objects released through
+// flecs_vulkan_defer_destroy once the frames using them are done.
+
+#define HOT_RELOAD_PATH_MAX     512
+#define HOT_RELOAD_POLL_MS      250   // polling fallback interval
+#define HOT_RELOAD_DEBOUNCE_MS  150   // editors save in several writes
+
+typedef struct HotReloadWatcher HotReloadWatcher;
+
+typedef struct {
+  HotReloadWatcher *watcher;   // heap, the watcher thread keeps this pointer
+  bool inotify;                // false = polling
+  uint32_t debounceMs;
+  uint32_t watchedCount;
+  uint32_t reloadCount;
+} HotReloadContext;
+ECS_COMPONENT_DECLARE(HotReloadContext);
+
+void flecs_hot_reload_module_init(ecs_world_t *world);
+void flecs_hot_reload_cleanup(ecs_world_t *world);
+
+// watch a vfs path, done automatically for every AssetHandle
+void flecs_hot_reload_watch(ecs_world_t *world, const char *path);
+
+#endif
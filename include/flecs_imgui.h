@@ -13,6 +13,35 @@ typedef struct {
 } IMGUIContext;
 ECS_COMPONENT_DECLARE(IMGUIContext);
 
+// built ImGui font atlas, "imgui_<key>_<size>_v<version>.atlas":
+// ImGuiAtlasHeader, TexUvLines, ImGuiAtlasGlyph[glyphCount], alpha8 pixels
+#define IMGUI_FONT_PIXEL_SIZE 13.0f
+#define IMGUI_ATLAS_CACHE_DIR "cache/fonts"
+#define IMGUI_ATLAS_MAGIC     0x4C544149u  // "IATL"
+#define IMGUI_ATLAS_VERSION   1
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t width;
+  uint32_t height;
+  uint32_t glyphCount;
+  uint32_t lineBytes;     // sizeof(ImFontAtlas.TexUvLines)
+  float fontSize;
+  float ascent;
+  float descent;
+  float whitePixel[2];    // TexUvWhitePixel
+  uint32_t reserved;
+  uint64_t key;           // ImGui version + atlas settings
+} ImGuiAtlasHeader;
+
+typedef struct {
+  uint32_t codepoint;
+  float advanceX;
+  float x0, y0, x1, y1;
+  float u0, v0, u1, v1;
+} ImGuiAtlasGlyph;
+
 // Create entity
 ecs_entity_t widget;
 // Create a custom event
@@ -0,0 +1,72 @@
+#ifndef FLECS_MEMORY_H
+#define FLECS_MEMORY_H
+
+#include "flecs.h"
+#include "flecs_types.h"
+#include <stddef.h>
+
+// Memory
+// Everything goes through mimalloc: flecs via its ecs_os_api hooks, engine
+// code via flecs_mem_* with a tag, so live / peak bytes can be read per
+// module. mimalloc keeps per-thread heaps, worker threads do not fight over
+// one allocator lock.
+// Transient data (upload scratch, per-frame lists, layout buffers) comes from
+// a frame arena: one atomic bump, no free. FrameArenaResetSystem rewinds it
+// first thing in BeginRenderPhase, so arena memory lives from there until the
+// next frame's BeginRenderPhase. The reset does not wait for the GPU: the
+// arena is for cpu data only. A frame that runs out spills to the heap and
+// the arena grows to fit at the next reset.
+
+#define MEMORY_FRAME_ARENA_SIZE   (4u * 1024u * 1024u)  // initial bytes, grows on overflow
+#define MEMORY_FRAME_ALIGN        16u
+
+typedef enum {
+  MEMORY_TAG_ENGINE,     // default for engine code
+  MEMORY_TAG_FLECS,      // ecs_os_api malloc / calloc / realloc / free
+  MEMORY_TAG_VULKAN,     // setup lists, swapchain arrays, deferred destroys
+  MEMORY_TAG_TEXT,       // layouts, kerning
+  MEMORY_TAG_TEXTURE,    // cooker scratch, texture set tables (pixels stay on malloc)
+  MEMORY_TAG_FRAME,      // the frame arena block and its overflow
+  MEMORY_TAG_COUNT
+} MemoryTag;
+
+typedef struct {
+  int64_t liveBytes;
+  int64_t peakBytes;
+  int64_t allocs;
+  int64_t frees;
+} MemoryTagStats;
+
+typedef struct {
+  uint64_t frame;
+  size_t arenaCapacity;
+  size_t arenaUsed;       // last frame, overflow included
+  size_t arenaPeak;
+  size_t arenaOverflow;   // last frame, bytes that went to the heap
+  uint32_t arenaGrowths;
+} MemoryContext;
+ECS_COMPONENT_DECLARE(MemoryContext);
+
+// before ecs_init, flecs allocates through mimalloc from the first call
+void flecs_memory_os_api_init(void);
+// after flecs_init_module, before any module with BeginRenderPhase systems so
+// the arena reset runs first in that phase
+void flecs_memory_module_init(ecs_world_t *world);
+// per tag live / peak bytes, call after ecs_fini to see what leaked
+void flecs_memory_print(void);
+
+void *flecs_mem_alloc(MemoryTag tag, size_t size);
+void *flecs_mem_calloc(MemoryTag tag, size_t count, size_t size);
+void *flecs_mem_realloc(MemoryTag tag, void *ptr, size_t size);
+void flecs_mem_free(MemoryTag tag, void *ptr);
+
+void flecs_memory_stats(MemoryTag tag, MemoryTagStats *out);
+const char *flecs_memory_tag_name(MemoryTag tag);
+
+// MEMORY_FRAME_ALIGN aligned, thread safe, never freed by the caller.
+// NULL only when the heap is out of memory
+void *flecs_frame_alloc(size_t size);
+// grows in place when ptr is the newest arena allocation, copies otherwise
+void *flecs_frame_realloc(void *ptr, size_t oldSize, size_t size);
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef FLECS_PROFILE_H
+#define FLECS_PROFILE_H
+
+#include "flecs.h"
+#include "flecs_types.h"
+
+// CPU timing per system and per phase
+// flecs_profile_attach gives every system a run callback that takes
+// SDL_GetPerformanceCounter before / after it and pushes the pair into the
+// ring of the stage (thread) running it, no locks. flecs_profile_frame_end
+// drains the rings on the main thread once per frame and keeps rolling
+// min / avg / p95 / p99 over the last PROFILE_WINDOW frames in ProfileContext.
+
+#define PROFILE_MAX_SLOTS      256    // systems + phases
+#define PROFILE_RING_SIZE      4096   // samples per thread, power of two
+#define PROFILE_WINDOW         120    // frames of history per slot
+#define PROFILE_STATS_INTERVAL 30     // frames between min / avg / percentile updates
+#define PROFILE_NAME_MAX       48
+
+typedef struct ProfileState ProfileState;
+
+typedef struct {
+  char name[PROFILE_NAME_MAX];
+  ecs_entity_t entity;     // system or phase
+  ecs_entity_t phase;      // phase of a system (DependsOn target or FixedUpdatePhase), 0 for phases
+  bool isPhase;            // first system begin to last system end of the phase
+  float lastMs;            // last frame it ran in, summed over fixed ticks / worker stages
+  float minMs, avgMs, p95Ms, p99Ms;
+} ProfileStat;
+
+typedef struct {
+  ProfileStat stats[PROFILE_MAX_SLOTS];  // systems in attach order, phases as first seen
+  int32_t statCount;
+  ProfileStat frame;                     // whole frame, frame_end to frame_end
+  uint64_t frameCount;
+  uint64_t droppedSamples;               // a ring was full
+  ProfileState *state;                   // rings and history, freed at ecs_fini
+} ProfileContext;
+ECS_COMPONENT_DECLARE(ProfileContext);
+
+void flecs_profile_module_init(ecs_world_t *world);
+
+// after every module registered its systems, later systems are not timed
+void flecs_profile_attach(ecs_world_t *world);
+
+// main thread, after the frame's ecs_progress
+void flecs_profile_frame_end(ecs_world_t *world);
+
+// log the current stats, slowest avg first
+void flecs_profile_print(ecs_world_t *world);
+
+#endif
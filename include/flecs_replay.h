@@ -0,0 +1,78 @@
+#ifndef FLECS_REPLAY_H
+#define FLECS_REPLAY_H
+
+#include "flecs.h"
+#include "flecs_types.h"
+#include "flecs_sdl.h"
+#include <stdio.h>
+
+// Input record / replay
+// --record file   writes, per frame, the frame delta and ECS_SDL_INPUT_T as
+//                 SDLInputSystem left it
+// --replay file   feeds both back: main takes the delta from
+//                 flecs_replay_frame_delta, ReplayInputSystem (right after
+//                 SDLInputSystem) overwrites the live input. Quit and resize
+//                 still come from SDL. The tick rate of the recording is
+//                 applied, so the fixed ticks match the recorded session.
+// --replay-pace   recorded (default, real time), fast (recorded deltas, no
+//                 waiting) or fixed (one fixed tick per frame, no waiting)
+// The program shuts down after the last frame and prints the frame timing;
+// with the profiler's output, two builds can be compared on the same session.
+
+#define REPLAY_MAGIC    0x4C505246u   // "FRPL"
+#define REPLAY_VERSION  1
+
+typedef enum {
+  REPLAY_OFF,
+  REPLAY_RECORD,
+  REPLAY_PLAY
+} ReplayMode;
+
+typedef enum {
+  REPLAY_PACE_RECORDED,   // recorded deltas, waits so playback runs in real time
+  REPLAY_PACE_FAST,       // recorded deltas, as fast as possible
+  REPLAY_PACE_FIXED       // fixedDelta every frame, as fast as possible
+} ReplayPace;
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t inputSize;     // sizeof(ECS_SDL_INPUT_T) of the recording build
+  uint32_t frameCount;    // patched when recording stops
+  float tickRate;
+  uint32_t width;
+  uint32_t height;
+  uint32_t reserved;
+} ReplayHeader;
+
+typedef struct {
+  float delta;
+  uint32_t reserved;
+  ECS_SDL_INPUT_T input;  // event only kept for keyboard / mouse types (ImGui reads it)
+} ReplayFrame;
+
+typedef struct {
+  ReplayMode mode;
+  ReplayPace pace;
+  FILE *file;             // record
+  ReplayFrame *frames;    // play, whole file
+  uint32_t frameCount;
+  uint32_t frame;         // next frame to record / play
+  float pendingDelta;     // record: this frame's delta, written with its input
+  bool finished;
+  Uint64 startNS;
+  Uint64 lastNS;
+  double minFrameMs;
+  double maxFrameMs;
+} ReplayContext;
+ECS_COMPONENT_DECLARE(ReplayContext);
+
+// after flecs_sdl_module_init (ReplayInputSystem follows SDLInputSystem) and
+// flecs_timestep_module_init. path NULL = off
+void flecs_replay_module_init(ecs_world_t *world, ReplayMode mode, const char *path, ReplayPace pace);
+void flecs_replay_cleanup(ecs_world_t *world);
+
+// main loop, before flecs_timestep_progress: the delta this frame runs with
+float flecs_replay_frame_delta(ecs_world_t *world, float wallDelta);
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef FLECS_SNAPSHOT_H
+#define FLECS_SNAPSHOT_H
+
+#include "flecs.h"
+#include "flecs_types.h"
+#include <stddef.h>
+
+// World snapshots
+// Only registered components are saved: plain data, no pointers or Vulkan
+// handles (contexts stay out). The binary format is column-wise per table:
+//
+//   SnapshotHeader
+//   schema  x componentCount   name, size, version
+//   table   x tableCount       SnapshotTableHeader, schema index per column,
+//                              entity ids, then one 16 byte aligned column
+//                              per component (count * size bytes)
+//
+// Saving is one memcpy per column, loading one ecs_bulk_init per table.
+// Tables are written parents first (ChildOf depth) so a table's parent
+// always exists when it is inserted.
+// The JSON form has the same content per entity, for debugging and diffs;
+// it needs field descriptors, components without them are written as hex.
+
+#define SNAPSHOT_MAGIC            0x504E5346u   // "FSNP"
+#define SNAPSHOT_FORMAT_VERSION   1
+#define SNAPSHOT_MAX_COMPONENTS   32
+#define SNAPSHOT_MAX_FIELDS       8
+#define SNAPSHOT_NAME_MAX         32
+#define SNAPSHOT_ALIGN            16
+
+typedef enum {
+  SNAPSHOT_FIELD_F32,
+  SNAPSHOT_FIELD_I32,
+  SNAPSHOT_FIELD_U32,
+  SNAPSHOT_FIELD_U64,
+  SNAPSHOT_FIELD_BOOL
+} SnapshotFieldType;
+
+typedef struct {
+  const char *name;
+  SnapshotFieldType type;
+  uint16_t count;        // array length, 1 for scalars
+  uint16_t offset;
+} SnapshotField;
+
+#define SNAPSHOT_FIELD(T, member, type, count) { #member, type, count, (uint16_t)offsetof(T, member) }
+
+// data saved with an older version of the component, convert count
+// elements of srcSize bytes into the current layout
+typedef void (*SnapshotMigrateFn)(uint32_t fromVersion, const void *src, uint32_t srcSize, void *dst, int32_t count);
+
+typedef struct {
+  ecs_entity_t id;
+  char name[SNAPSHOT_NAME_MAX];
+  uint32_t size;
+  uint32_t version;      // bump when the layout changes
+  SnapshotField fields[SNAPSHOT_MAX_FIELDS];
+  int32_t fieldCount;
+  SnapshotMigrateFn migrate;
+} SnapshotComponent;
+
+typedef struct {
+  SnapshotComponent components[SNAPSHOT_MAX_COMPONENTS];
+  int32_t count;
+  double lastSaveMs;
+  double lastLoadMs;
+  uint64_t lastEntityCount;
+} SnapshotContext;
+ECS_COMPONENT_DECLARE(SnapshotContext);
+
+typedef enum {
+  // fresh ids, ChildOf targets inside the snapshot remapped (spawn a saved
+  // level or group next to what is there)
+  SNAPSHOT_LOAD_NEW,
+  // the saved ids: dead ones are revived and bulk inserted, alive ones get
+  // their saved components set (per entity). For quick load and for a
+  // restarted program, where module entities come back with the same ids
+  SNAPSHOT_LOAD_RESTORE
+} SnapshotLoadMode;
+
+// after the modules whose components it registers (transform, timestep, bvh)
+void flecs_snapshot_module_init(ecs_world_t *world);
+void flecs_snapshot_cleanup(ecs_world_t *world);
+
+// name from the component entity, fields only needed for JSON
+bool flecs_snapshot_register(ecs_world_t *world, ecs_entity_t component, uint32_t version,
+                             const SnapshotField *fields, int32_t fieldCount, SnapshotMigrateFn migrate);
+
+// buffer from flecs_mem_alloc(MEMORY_TAG_ENGINE), free with flecs_mem_free
+void *flecs_snapshot_save_mem(ecs_world_t *world, size_t *size);
+// entities created or restored, -1 when the data is not a valid snapshot
+int64_t flecs_snapshot_load_mem(ecs_world_t *world, const void *data, size_t size, SnapshotLoadMode mode);
+
+bool flecs_snapshot_save(ecs_world_t *world, const char *path);
+int64_t flecs_snapshot_load(ecs_world_t *world, const char *path, SnapshotLoadMode mode);
+
+// cJSON_Print'ed text, free with cJSON_free
+char *flecs_snapshot_export_json(ecs_world_t *world);
+int64_t flecs_snapshot_import_json(ecs_world_t *world, const char *json, SnapshotLoadMode mode);
+
+#endif
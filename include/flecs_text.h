@@ -3,35 +3,132 @@
 
 #include "flecs.h"
 #include "flecs_types.h"
+#include "flecs_asset_jobs.h"
+#include "flecs_glyph_cache.h"
 #include <SDL3/SDL.h>
 #include <vulkan/vulkan.h>
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
+#define TEXT_BAKED_PIXEL_SIZE 48     // ASCII 32-126 of the baked / cooked coverage atlas
+#define TEXT_INITIAL_GLYPHS   1024   // glyph instance buffer capacity, doubles when a frame needs more
+#define TEXT_MAX_LENGTH       128    // bytes of Text.value, including the terminator
+#define TEXT_LINE_HEIGHT      1.25f  // times Text.size, for '\n'
+
+#define TEXT_FONT_MODE        GLYPH_MODE_SDF // font atlas mode, runtime and asset_cooker
+
+// fragment push constants, outline and shadow only apply to SDF pages
+typedef struct {
+  float outlineColor[4];
+  float shadowColor[4];
+  float shadowOffset[2];  // pixels at TEXT_BAKED_PIXEL_SIZE, page uv in the push constant
+  float outlineWidth;     // distance units, 0.5 reaches GLYPH_SDF_SPREAD pixels
+  float shadowSoftness;   // distance units added to the shadow edge
+  uint32_t sdf;           // set per draw from the page mode
+} TextStyle;
+
+// vertex push constants, after TextStyle (text.vert declares the offset)
+#define TEXT_VIEW_OFFSET 56
+typedef struct {
+  float pixelToNdc[2];    // 2 / screen size
+} TextView;
+
+typedef enum {
+  TEXT_ALIGN_LEFT,
+  TEXT_ALIGN_CENTER,
+  TEXT_ALIGN_RIGHT
+} TextAlign;
+
+// screen text, every enabled entity with Text is drawn each frame. The layout
+// is retained and only redone when flecs sees the component change, so write
+// it with ecs_set / flecs_text_set_value or call ecs_modified after ecs_ensure.
+typedef struct {
+  char value[TEXT_MAX_LENGTH]; // UTF-8, '\n' starts a new line
+  float x, y;                  // pixels, baseline of the first line
+  float size;                  // pixel size
+  uint32_t color;              // RGBA8, R in the low byte, alpha 0 hides it
+  int font;                    // glyph cache font id, 0 = the module's font
+  TextAlign align;             // x is the left end, centre or right end of each line
+} Text;
+ECS_COMPONENT_DECLARE(Text);
+
+// one instanced draw per glyph cache page
+typedef struct {
+  uint32_t page;
+  uint32_t firstGlyph;    // first instance
+  uint32_t glyphCount;
+} TextDraw;
+
 typedef struct {
   // Text Rendering
-  VkBuffer textVertexBuffer;                   // Text vertex buffer
-  VkDeviceMemory textVertexBufferMemory;       // Text vertex buffer memory
-  VkBuffer textIndexBuffer;                    // Text index buffer
-  VkDeviceMemory textIndexBufferMemory;        // Text index buffer memory
-  VkDescriptorPool textDescriptorPool;         // Text descriptor pool
-  VkDescriptorSet textDescriptorSet;           // Text descriptor set
+  VkBuffer textVertexBuffer;                   // Text glyph instances (one record per glyph)
+  VkDeviceMemory textVertexBufferMemory;       // Text glyph instance memory
+  void *textVertexMapped;                      // persistently mapped, written in TextLayoutSystem
+  uint32_t textVertexCapacity;                 // glyphs the instance buffer holds
+  VkDescriptorPool textDescriptorPool;         // Text descriptor pool, one set per glyph page
   VkDescriptorSetLayout textDescriptorSetLayout; // Text descriptor set layout
   VkPipelineLayout textPipelineLayout;         // Text pipeline layout
   VkPipeline textPipeline;                     // Text pipeline
-  VkImage textFontImage;                       // Font atlas texture
-  VkDeviceMemory textFontImageMemory;          // Font atlas memory
-  VkImageView textFontImageView;               // Font atlas image view
-  VkSampler textFontSampler;                   // Font texture sampler
-  void *textGlyphs;                            // Metrics for ASCII 32-126
-  int textAtlasWidth;                          // Font atlas width
-  int textAtlasHeight;                         // Font atlas height
+  GlyphCache *textGlyphCache;                  // atlas pages, glyphs rasterised on first use
+  int textFont;                                // glyph cache font id, -1 until the font is uploaded
+  ecs_entity_t textFontAsset;                  // AssetHandle entity for the font
+  int16_t *textKerning;                        // ASCII pairs of textFont [left - 32][right - 32], 1/64 px, NULL = none
+  uint32_t textKerningPixelSize;               // size the pairs were measured at
+  TextDraw textDraws[GLYPH_MAX_PAGES];         // this frame's draws
+  uint32_t textDrawCount;
+  TextStyle textStyle;                         // outline / shadow of SDF text
+  ecs_query_t *textQuery;                      // Text entities, change detection drives the layout cache
+  ecs_map_t textLayouts;                       // entity -> retained layout (glyph ranges per page)
+  bool textLayoutsReady;
+  uint32_t textLayoutEpoch;                    // bumped by font uploads and resizes, every layout is stale
+  uint32_t textDrawnEpoch;                     // epoch of the vertex buffer contents
+  bool textIncomplete;                         // a glyph was missing, lay out again next frame
+  float textScreenWidth, textScreenHeight;     // size the layouts were made for
 } Text2DContext;
 ECS_COMPONENT_DECLARE(Text2DContext);
 
 void flecs_text_module_init(ecs_world_t *world);
 void flecs_text_cleanup(ecs_world_t *world);
 
+// copy value into the entity's Text (truncated on a UTF-8 boundary) and mark
+// it modified, adds Text when missing
+void flecs_text_set_value(ecs_world_t *world, ecs_entity_t entity, const char *value);
+
+// baked atlas: TextAtlasHeader, glyphs, R8 pixels, TextKerningPair[].
+// asset_cooker writes "<font path>.atlas" into the pack, a font without one
+// is baked on first run and kept in TEXT_ATLAS_CACHE_DIR, named by the font
+// file hash, mode and size
+#define TEXT_ATLAS_COOKED_EXT ".atlas"
+#define TEXT_ATLAS_CACHE_DIR  "cache/fonts"
+#define TEXT_ATLAS_MAGIC      0x4C544146u  // "FATL"
+#define TEXT_ATLAS_VERSION    3            // 2: mode + pixel size, 3: kerning + source hash
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t width;
+  uint32_t height;
+  uint32_t glyphCount;   // ASCII 32-126
+  uint32_t glyphSize;    // sizeof(GlyphInfo) when cooked
+  uint32_t mode;         // GlyphCacheMode
+  uint32_t pixelSize;    // TEXT_BAKED_PIXEL_SIZE or GLYPH_SDF_PIXEL_SIZE
+  uint32_t kerningCount; // pairs after the pixels
+  uint32_t reserved;
+  uint64_t sourceHash;   // FNV-1a of the font file, a changed font is baked again
+} TextAtlasHeader;
+
+typedef struct {
+  uint8_t left, right;   // ASCII
+  int16_t x;             // 1/64 pixels at pixelSize, non zero pairs only
+} TextKerningPair;
+
+// rasterize ASCII into an R8 atlas + glyph metrics + kerning (worker or
+// asset_cooker), coverage at TEXT_BAKED_PIXEL_SIZE or distance fields at
+// GLYPH_SDF_PIXEL_SIZE. Seeds the glyph cache so startup needs no FreeType
+bool flecs_text_bake_font_atlas(const char *path, GlyphCacheMode mode, AssetResult *result);
+// baked atlas as one blob, malloc'd
+void *flecs_text_atlas_serialize(const AssetResult *result, size_t *size);
+
 // void TextSetupSystem(ecs_iter_t *it);
 // void TextPipelineSetupSystem(ecs_iter_t *it);
 // void TextRenderSystem(ecs_iter_t *it);
@@ -14,10 +14,9 @@ typedef struct {
   VkDescriptorSetLayout texture2dDescriptorSetLayout;
   VkPipelineLayout texture2dPipelineLayout;
   VkPipeline texture2dPipeline;
-  VkImage texture2dImage;
-  VkDeviceMemory texture2dImageMemory;
-  VkImageView texture2dImageView;
-  VkSampler texture2dSampler;
+  ecs_entity_t textureSet;     // TextureSet entity (texture_array_module)
+  uint32_t textureLayer;       // material layer, push constant
+  bool textureBound;           // descriptor points at the set
 } Texture2DContext;
 ECS_COMPONENT_DECLARE(Texture2DContext);
 
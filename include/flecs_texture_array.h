@@ -0,0 +1,40 @@
+#ifndef FLECS_TEXTURE_ARRAY_H
+#define FLECS_TEXTURE_ARRAY_H
+
+#include "flecs_types.h"
+#include "flecs_asset_jobs.h"
+
+#define TEXTURE_SET_MAX_LAYERS 64
+
+// Texture set: every png in a directory as the layers of one
+// VK_IMAGE_VIEW_TYPE_2D_ARRAY image. Layers decode in parallel on the asset
+// workers, the image is built when the last one is done. Layers have to
+// share the size of the first one, others are left black.
+typedef struct {
+  char dir[ASSET_PATH_MAX];
+  char (*layerPaths)[ASSET_PATH_MAX]; // sorted, index = layer
+  ecs_entity_t *layerAssets;          // AssetHandle per layer
+  unsigned char **layerPixels;        // RGBA8 until the image is built
+  int *layerWidth;
+  int *layerHeight;
+  uint32_t layerCount;
+  uint32_t width;
+  uint32_t height;
+  uint32_t mipLevels;
+  VkImage image;
+  VkDeviceMemory memory;
+  VkImageView view;
+  VkSampler sampler;
+  bool ready;
+} TextureSet;
+ECS_COMPONENT_DECLARE(TextureSet);
+
+void flecs_texture_array_module_init(ecs_world_t *world);
+void flecs_texture_array_cleanup(ecs_world_t *world);
+
+// queue every png in dir, returns the TextureSet entity
+ecs_entity_t flecs_texture_set_load(ecs_world_t *world, const char *dir);
+// layer of "texture_08.png" (file name or full path), -1 when missing
+int flecs_texture_set_find(const TextureSet *set, const char *name);
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef FLECS_TEXTURE_COOKER_H
+#define FLECS_TEXTURE_COOKER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <math.h>
+#include <vulkan/vulkan.h>
+
+// Texture cooker
+// RGBA8 -> BC1 / BC3 / BC7 with the full mip chain, stored in a KTX2 style
+// container (KTX2 header + level index, key/value "flecsSourceHash").
+// Cache files live in TEXTURE_CACHE_DIR named by the source hash, so a
+// changed png gets a new entry and a hit skips the png decode entirely.
+// Thread safe, called from asset worker threads.
+
+#define TEXTURE_CACHE_DIR      "cache/textures"
+#define TEXTURE_COOKED_EXT     ".ktx2"           // asset_cooker output, "<png path>.ktx2"
+#define TEXTURE_COOK_MAX_MIPS  16
+#define TEXTURE_COOK_VERSION   2              // 2: mips averaged in linear space
+
+typedef enum {
+  TEXTURE_COOK_AUTO,   // BC1 when opaque, BC3 when the image has alpha
+  TEXTURE_COOK_BC1,    // rgb, 1 bit alpha ignored, 4 bpp
+  TEXTURE_COOK_BC3,    // rgba, 8 bpp
+  TEXTURE_COOK_BC7     // rgba high quality (mode 6), 8 bpp
+} TextureCookFormat;
+
+typedef struct {
+  uint8_t *file;                              // whole container, malloc'd
+  size_t fileSize;
+  VkFormat format;                            // VK_FORMAT_BC*_SRGB_BLOCK
+  uint32_t width;
+  uint32_t height;
+  uint32_t mipLevels;
+  uint64_t levelOffset[TEXTURE_COOK_MAX_MIPS]; // into file, block aligned (usable as staging bufferOffset)
+  uint64_t levelSize[TEXTURE_COOK_MAX_MIPS];
+  uint64_t sourceHash;                        // hash of the png it was cooked from, 0 = unchecked
+} CookedTexture;
+
+// sRGB <-> linear for the box filters. Mips of sRGB textures are averaged in
+// linear space, averaging the encoded bytes darkens every level. Built per
+// chain on the caller's stack, 256 + SRGB_ENCODE_STEPS powf calls
+#define SRGB_ENCODE_STEPS 4096
+
+static inline void flecs_srgb_tables(float toLinear[256], uint8_t toSrgb[SRGB_ENCODE_STEPS]) {
+  for (int i = 0; i < 256; i++) {
+    float c = i / 255.0f;
+    toLinear[i] = c <= 0.04045f ? c / 12.92f : powf((c + 0.055f) / 1.055f, 2.4f);
+  }
+  for (int i = 0; i < SRGB_ENCODE_STEPS; i++) {
+    float l = i / (float)(SRGB_ENCODE_STEPS - 1);
+    float c = l <= 0.0031308f ? l * 12.92f : 1.055f * powf(l, 1.0f / 2.4f) - 0.055f;
+    toSrgb[i] = (uint8_t)(c * 255.0f + 0.5f);
+  }
+}
+
+// average of four sRGB bytes, through linear
+static inline uint8_t flecs_srgb_average(const float toLinear[256], const uint8_t toSrgb[SRGB_ENCODE_STEPS],
+                                         uint8_t a, uint8_t b, uint8_t c, uint8_t d) {
+  float l = (toLinear[a] + toLinear[b] + toLinear[c] + toLinear[d]) * 0.25f;
+  return toSrgb[(int)(l * (SRGB_ENCODE_STEPS - 1) + 0.5f)];
+}
+
+// 64 bit FNV-1a of the source bytes, the cache key
+uint64_t flecs_texture_source_hash(const void *data, size_t size);
+
+// encode rgba (width * height * 4) into cooked, threads <= 0 uses all cores
+bool flecs_texture_cook(const uint8_t *rgba, uint32_t width, uint32_t height, TextureCookFormat format,
+                        uint64_t sourceHash, int threads, CookedTexture *cooked);
+
+// container io, parse validates the header and the source hash (0 = any)
+bool flecs_texture_cooked_parse(uint8_t *file, size_t fileSize, uint64_t sourceHash, CookedTexture *cooked);
+bool flecs_texture_cooked_write(const char *path, const CookedTexture *cooked);
+void flecs_texture_cooked_free(CookedTexture *cooked);
+
+// VK_FORMAT_BC*_SRGB_BLOCK of a fixed format, VK_FORMAT_UNDEFINED for AUTO
+VkFormat flecs_texture_cook_vk_format(TextureCookFormat format);
+
+// "cache/textures/<hash>.ktx2"
+void flecs_texture_cache_path(uint64_t sourceHash, TextureCookFormat format, char *out, size_t outSize);
+
+// "<path>.ktx2" from asset_cooker (assets.pak) if present, else source hash
+// -> cache hit (through the vfs, so packed caches work) or stbi decode + cook
+// + write cache. The source file is still read for the hash, never decoded on
+// a hit. Cooks single threaded, the asset job workers give the parallelism.
+bool flecs_texture_load_cooked(const char *path, TextureCookFormat format, CookedTexture *cooked);
+
+#endif
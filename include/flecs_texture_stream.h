@@ -0,0 +1,83 @@
+#ifndef FLECS_TEXTURE_STREAM_H
+#define FLECS_TEXTURE_STREAM_H
+
+#include "flecs_types.h"
+#include "flecs_asset_jobs.h"
+#include "flecs_asset_registry.h"
+
+// Texture streaming
+// Every level of a texture stays on the CPU (BC blocks from the cooker or an
+// RGBA8 chain), the GPU only holds the levels render systems asked for.
+// Small mips go up first, finer ones follow the screen-space feedback while
+// the resident total fits the VRAM budget. Over budget the least recently
+// used textures drop their finest levels. Files with identical pixels share
+// one image through the registry content hash.
+
+#define TEXTURE_STREAM_MAX_MIPS        TEXTURE_COOK_MAX_MIPS
+#define TEXTURE_STREAM_TAIL_SIZE       64             // levels <= 64px are always resident
+#define TEXTURE_STREAM_DEFAULT_BUDGET  (128ull << 20) // bytes, lower tier target
+#define TEXTURE_STREAM_UNUSED_FRAMES   120            // no feedback for this long -> back to the tail
+#define TEXTURE_STREAM_UPLOAD_SLOTS    3              // upload batches in flight
+
+typedef struct {
+  char path[ASSET_PATH_MAX];
+  ecs_entity_t asset;                          // AssetHandle, child of this entity
+  // cpu copy of every level
+  uint8_t *data;                               // cooked container or RGBA8 chain
+  uint64_t levelOffset[TEXTURE_STREAM_MAX_MIPS];
+  uint64_t levelSize[TEXTURE_STREAM_MAX_MIPS];
+  VkFormat format;
+  uint32_t width;
+  uint32_t height;
+  uint32_t mipLevels;
+  uint32_t tailMip;                            // coarsest level kept no matter what
+  // residency, mip index into the full chain (mipLevels = nothing resident)
+  uint32_t residentMip;                        // finest level on the gpu
+  uint32_t requestedMip;                       // finest level asked for this frame
+  uint32_t plannedMip;                         // residentMip after this frame's changes
+  uint64_t lastUsedFrame;
+  VkDeviceSize residentBytes;                  // image allocation size
+  VkImage image;
+  VkDeviceMemory memory;
+  VkImageView view;                            // covers residentMip..mipLevels-1
+  VkSampler sampler;
+  uint32_t generation;                         // bumped when view changes, rewrite descriptors
+  ecs_entity_t alias;                          // same pixels as this texture, which holds the image
+} StreamedTexture;
+ECS_COMPONENT_DECLARE(StreamedTexture);
+
+typedef struct {
+  VkDeviceSize budgetBytes;       // configured cap, 0 = only the device budget
+  float heapBudgetFraction;       // share of VK_EXT_memory_budget heapBudget textures may use
+  VkDeviceSize effectiveBudget;   // min of the two, refreshed every budgetRefreshFrames
+  VkDeviceSize residentBytes;     // sum of StreamedTexture.residentBytes
+  uint32_t budgetRefreshFrames;
+  uint32_t maxUploadsPerFrame;    // upgrades per LogicUpdatePhase, one rebuild per texture
+  uint32_t unusedFrames;
+  uint64_t frame;
+  uint32_t evictedLevels;         // stats
+  uint32_t streamedLevels;
+  // residency changes of a frame, one fenced submit
+  VkCommandBuffer uploadCmd[TEXTURE_STREAM_UPLOAD_SLOTS];
+  VkFence uploadFence[TEXTURE_STREAM_UPLOAD_SLOTS];
+  uint32_t uploadSlot;
+  bool uploadRecording;
+} TextureStreamContext;
+ECS_COMPONENT_DECLARE(TextureStreamContext);
+
+void flecs_texture_stream_module_init(ecs_world_t *world);
+void flecs_texture_stream_cleanup(ecs_world_t *world);
+
+// queue the decode/cook on the asset workers, returns the StreamedTexture entity
+ecs_entity_t flecs_texture_stream_load(ecs_world_t *world, const char *path);
+// through the asset registry: one StreamedTexture per path, owned by owner
+// until flecs_asset_release or the owner is deleted
+ecs_entity_t flecs_texture_stream_acquire(ecs_world_t *world, ecs_entity_t owner, const char *path);
+// the texture holding the image (follows alias), NULL while loading
+const StreamedTexture *flecs_texture_stream_get(ecs_world_t *world, ecs_entity_t texture);
+
+// render systems, once per frame per use: screenPixels is the on screen size
+// of the whole texture (uv 0..1) along its longer side
+void flecs_texture_stream_feedback(ecs_world_t *world, ecs_entity_t texture, float screenPixels);
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef FLECS_TIMESTEP_H
+#define FLECS_TIMESTEP_H
+
+#include "flecs.h"
+#include "flecs_types.h"
+#include "flecs_transform.h"
+
+// Fixed timestep
+// Simulation systems (.add = ecs_ids(GlobalPhases.FixedUpdatePhase)) run in
+// their own pipeline at tickRate, zero or more times per display frame, with
+// it->delta_time = fixedDelta. The render pipeline (ecs_progress) runs once
+// per frame and blends the last two ticks with TimeStepContext.alpha.
+
+#define TIMESTEP_DEFAULT_RATE     60      // ticks per second, --tick-rate N
+#define TIMESTEP_MAX_TICKS        5       // catch-up limit per frame, the rest is dropped
+#define TIMESTEP_MAX_FRAME_DELTA  0.25f   // seconds, longer frames (breakpoint, window drag) are clamped
+
+typedef struct {
+  float tickRate;             // simulation ticks per second
+  float fixedDelta;           // 1 / tickRate
+  float maxFrameDelta;
+  int32_t maxTicksPerFrame;
+  float accumulator;          // frame time not simulated yet, < fixedDelta after a frame
+  float alpha;                // accumulator / fixedDelta, 0 = previous tick, 1 = current tick
+  int32_t ticksThisFrame;
+  uint64_t tick;              // ticks since start
+  uint64_t droppedTicks;      // backlog thrown away by the catch-up limit
+  ecs_entity_t fixedPipeline; // systems with GlobalPhases.FixedUpdatePhase, in creation order
+} TimeStepContext;
+ECS_COMPONENT_DECLARE(TimeStepContext);
+
+// simulated transform, same layout as LocalTransform. SimTransform,
+// SimTransformPrev and LocalTransform live in the same table, so each is one
+// compact array; the blend goes to LocalTransform and from there through the
+// transform hierarchy.
+typedef LocalTransform SimTransform;      // current tick, written by FixedUpdatePhase systems
+ECS_COMPONENT_DECLARE(SimTransform);
+
+typedef LocalTransform SimTransformPrev;  // previous tick, copied before each tick
+ECS_COMPONENT_DECLARE(SimTransformPrev);
+
+// after flecs_init_module, before modules that register FixedUpdatePhase systems
+void flecs_timestep_module_init(ecs_world_t *world, float tickRate);
+
+// run the fixed ticks owed for frameDelta, then one ecs_progress. Returns
+// ecs_progress' result
+bool flecs_timestep_progress(ecs_world_t *world, float frameDelta);
+
+// place an entity without blending from its old transform (spawn, teleport),
+// adds SimTransform, SimTransformPrev, LocalTransform and WorldTransform
+void flecs_timestep_set_transform(ecs_world_t *world, ecs_entity_t entity, const SimTransform *transform);
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef FLECS_TRANSFORM_H
+#define FLECS_TRANSFORM_H
+
+#include "flecs.h"
+#include "flecs_types.h"
+#include <cglm/cglm.h>
+
+// Transform hierarchy
+// LocalTransform is relative to the ChildOf parent. TransformPropagateSystem
+// (TransformPhase) writes WorldTransform = parent WorldTransform * local, one
+// table at a time in cascade (breadth first) order. Change detection skips
+// every table whose LocalTransform and parent WorldTransform did not change,
+// so a static hierarchy costs one ecs_query_changed per frame.
+
+typedef struct {
+  float position[3];
+  float rotation[4];   // quaternion x, y, z, w
+  float scale[3];
+} LocalTransform;
+ECS_COMPONENT_DECLARE(LocalTransform);
+
+typedef struct {
+  mat4 matrix;         // column major model matrix
+} WorldTransform;
+ECS_COMPONENT_DECLARE(WorldTransform);
+
+typedef struct {
+  ecs_query_t *query;         // LocalTransform, WorldTransform, parent WorldTransform (cascade)
+  uint32_t updatedCount;      // matrices recomputed last frame, 0 for a static scene
+  uint32_t updatedTables;
+} TransformContext;
+ECS_COMPONENT_DECLARE(TransformContext);
+
+#define TRANSFORM_IDENTITY ((LocalTransform){ .rotation = {0.0f, 0.0f, 0.0f, 1.0f}, .scale = {1.0f, 1.0f, 1.0f} })
+
+void flecs_transform_module_init(ecs_world_t *world);
+void flecs_transform_cleanup(ecs_world_t *world);
+
+// LocalTransform (identity when local is NULL) + WorldTransform, parent with
+// ecs_add_pair(world, entity, EcsChildOf, parent)
+void flecs_transform_add(ecs_world_t *world, ecs_entity_t entity, const LocalTransform *local);
+
+#endif
@@ -160,6 +160,7 @@ typedef struct {
 typedef struct {
   // loop order
   ecs_entity_t LogicUpdatePhase;
+  ecs_entity_t TransformPhase;      // WorldTransform propagation, after logic wrote LocalTransform
   ecs_entity_t BeginRenderPhase;
   ecs_entity_t BeginCMDBufferPhase;
   ecs_entity_t CMDBufferPhase;
@@ -167,6 +168,8 @@ typedef struct {
   ecs_entity_t CMDBuffer2Phase;
   ecs_entity_t EndCMDBufferPhase;
   ecs_entity_t EndRenderPhase;
+  // fixed tick, tag for the timestep pipeline (flecs_timestep.h)
+  ecs_entity_t FixedUpdatePhase;
   // setup once
   ecs_entity_t SetupPhase;
   ecs_entity_t InstanceSetupPhase;
@@ -182,18 +185,32 @@ typedef struct {
   ecs_entity_t SetupModulePhase;
 } FlecsPhases;
 
-// TEST
-typedef struct {
-  bool isCleanUpModule;
-  int moduleCount;
-} ModuleContext;
-ECS_COMPONENT_DECLARE(ModuleContext);
+// module lifecycle, shutdown waits for every registered module to be cleaned
+// before CleanUpGraphicEvent releases the device
+typedef enum {
+  MODULE_STATE_LOADING,   // registered, module init still running
+  MODULE_STATE_READY,     // init done
+  MODULE_STATE_DRAINING,  // CleanUpEvent sent, waiting on its cleanup observer
+  MODULE_STATE_CLEANED    // resources released
+} ModuleState;
+
+#define MODULE_MAX         32
+#define MODULE_HANDLE_NONE -1
+typedef int32_t ModuleHandle;  // index into ModuleContext.modules
 
 typedef struct {
   char name[32]; // Fixed-size string for simplicity
-  bool isCleanUp;
+  ModuleState state;
 } PluginModule;
-ECS_COMPONENT_DECLARE(PluginModule);
+
+typedef struct {
+  bool isCleanUpModule;               // CleanUpGraphicEvent sent
+  int moduleCount;
+  int cleanedCount;                   // modules in MODULE_STATE_CLEANED
+  PluginModule modules[MODULE_MAX];   // by ModuleHandle
+  ecs_entity_t drainSystem;           // disabled until shutdown, off again once all are cleaned
+} ModuleContext;
+ECS_COMPONENT_DECLARE(ModuleContext);
 
 ecs_entity_t ShutDownEvent;
 ecs_entity_t ShutDownModule;
@@ -209,14 +226,44 @@ ecs_entity_t CloseModule;
 
 extern FlecsPhases GlobalPhases;
 
+// Singleton system terms: the source is the component entity, so a system
+// declares which contexts it reads / writes and the pipeline can schedule
+// around it. The callback takes them with ecs_field(it, T, index), the
+// system does not run until the singleton exists.
+#define ECS_SINGLETON_IN(T)    { ecs_id(T), .src.id = ecs_id(T), .inout = EcsIn }
+#define ECS_SINGLETON_INOUT(T) { ecs_id(T), .src.id = ecs_id(T), .inout = EcsInOut }
+
+// Singleton access outside system terms (main loop, module functions called
+// every frame or per entity). ecs_singleton_ensure looks the entity up on
+// every call and, while the world is deferred, queues an ensure command; the
+// ref keeps the table record and only looks again when the table changed.
+// Bind it once the singleton is set (module init), then
+//   const T *x = ecs_ref_get(world, &ref, T);   // read only, nothing marked
+#define ECS_SINGLETON_REF(world, T) ecs_ref_init(world, ecs_id(T), T)
+
+// query flags for cached queries that use ecs_query_changed / ecs_iter_changed.
+// Change detection is opt-in on newer flecs, older versions track it on
+// every cached query
+#ifdef EcsQueryDetectChanges
+#define ECS_QUERY_DETECT_CHANGES EcsQueryDetectChanges
+#else
+#define ECS_QUERY_DETECT_CHANGES 0
+#endif
+
+// flecs worker stages (main thread included). Systems registered with
+// .multi_threaded = true split their matched entities across them, the rest
+// (SDL, Vulkan recording and submission) keep running on the main thread
+#define ECS_MAX_THREADS 32
+
 void flecs_phases_init(ecs_world_t *world, FlecsPhases *phases);
 
 void flecs_init_module(ecs_world_t *world);
 
-// ecs_entity_t add_module_name(ecs_world_t *world, const char *name);
-
-void module_break_name(ecs_iter_t *it, const char *module_name);
+// registry slot in MODULE_STATE_LOADING, keep the handle for module_set_state.
+// MODULE_HANDLE_NONE when the registry is full
+ModuleHandle module_register(ecs_world_t *world, const char *name);
 
-ecs_entity_t add_module_name(ecs_world_t *world, const char *name);
+// READY at the end of module init, CLEANED from its CleanUpEvent observer
+void module_set_state(ecs_world_t *world, ModuleHandle handle, ModuleState state);
 
 #endif
\ No newline at end of file
@@ -6,7 +6,10 @@
 #include <vulkan/vulkan.h>
 #include <flecs.h>
 #include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
 #include "flecs_sdl.h"
+#include "flecs_texture_cooker.h"
 
 // Helper function to report SDL errors and abort
 static inline void report_sdl_error(SDLContext *sdl_ctx, const char *error_msg) {
@@ -51,4 +54,167 @@ static VkShaderModule createShaderModuleH(VkDevice device, const uint32_t *code,
 }
 
 
+//===============================================
+// mipmaps
+//===============================================
+
+#define MAX_MIP_LEVELS 16
+
+// full chain down to 1x1
+static inline uint32_t calcMipLevels(uint32_t width, uint32_t height) {
+  uint32_t size = width > height ? width : height;
+  uint32_t levels = 1;
+  while (size > 1 && levels < MAX_MIP_LEVELS) {
+    size >>= 1;
+    levels++;
+  }
+  return levels;
+}
+
+// vkCmdBlitImage with VK_FILTER_LINEAR needs these on optimal tiling
+static inline bool formatSupportsLinearBlit(VkPhysicalDevice physicalDevice, VkFormat format) {
+  VkFormatProperties props;
+  vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &props);
+  VkFormatFeatureFlags need = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT |
+                              VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+  return (props.optimalTilingFeatures & need) == need;
+}
+
+// Blit chain, all levels must be in TRANSFER_DST_OPTIMAL with level 0 filled.
+// Leaves every level in SHADER_READ_ONLY_OPTIMAL.
+static inline void cmdGenerateMipmaps(VkCommandBuffer commandBuffer, VkImage image, int32_t width, int32_t height, uint32_t mipLevels, uint32_t layerCount) {
+  VkImageMemoryBarrier barrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+  barrier.image = image;
+  barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  barrier.subresourceRange.baseArrayLayer = 0;
+  barrier.subresourceRange.layerCount = layerCount;
+  barrier.subresourceRange.levelCount = 1;
+
+  int32_t mipWidth = width;
+  int32_t mipHeight = height;
+  for (uint32_t i = 1; i < mipLevels; i++) {
+    barrier.subresourceRange.baseMipLevel = i - 1;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, NULL, 0, NULL, 1, &barrier);
+
+    int32_t nextWidth = mipWidth > 1 ? mipWidth / 2 : 1;
+    int32_t nextHeight = mipHeight > 1 ? mipHeight / 2 : 1;
+
+    VkImageBlit blit = {0};
+    blit.srcOffsets[1].x = mipWidth;
+    blit.srcOffsets[1].y = mipHeight;
+    blit.srcOffsets[1].z = 1;
+    blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    blit.srcSubresource.mipLevel = i - 1;
+    blit.srcSubresource.layerCount = layerCount;
+    blit.dstOffsets[1].x = nextWidth;
+    blit.dstOffsets[1].y = nextHeight;
+    blit.dstOffsets[1].z = 1;
+    blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    blit.dstSubresource.mipLevel = i;
+    blit.dstSubresource.layerCount = layerCount;
+    vkCmdBlitImage(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
+
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, NULL, 0, NULL, 1, &barrier);
+
+    mipWidth = nextWidth;
+    mipHeight = nextHeight;
+  }
+
+  barrier.subresourceRange.baseMipLevel = mipLevels - 1;
+  barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+  barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+  barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, NULL, 0, NULL, 1, &barrier);
+}
+
+// Fallback for formats without linear blit: 2x2 box filter on the CPU.
+// srgb averages the color channels in linear space (alpha, the 4th channel,
+// stays linear), like the blit does for an _SRGB format.
+// *out is malloc'd with every level packed, regions[mipLevels] get the
+// buffer offsets for vkCmdCopyBufferToImage. Returns total bytes.
+static inline size_t buildMipChainCPU(const unsigned char *src, uint32_t width, uint32_t height, uint32_t channels, bool srgb,
+                                      uint32_t mipLevels, unsigned char **out, VkBufferImageCopy *regions) {
+  size_t total = 0;
+  uint32_t w = width, h = height;
+  for (uint32_t i = 0; i < mipLevels; i++) {
+    total += (size_t)w * h * channels;
+    w = w > 1 ? w / 2 : 1;
+    h = h > 1 ? h / 2 : 1;
+  }
+  unsigned char *data = malloc(total);
+  if (!data) {
+    *out = NULL;
+    return 0;
+  }
+  memcpy(data, src, (size_t)width * height * channels);
+
+  float toLinear[256];
+  uint8_t toSrgb[SRGB_ENCODE_STEPS];
+  if (srgb && mipLevels > 1) flecs_srgb_tables(toLinear, toSrgb);
+  uint32_t colorChannels = srgb ? (channels == 4 ? 3 : channels) : 0;
+
+  size_t offset = 0;
+  w = width;
+  h = height;
+  for (uint32_t i = 0; i < mipLevels; i++) {
+    memset(&regions[i], 0, sizeof(VkBufferImageCopy));
+    regions[i].bufferOffset = offset;
+    regions[i].imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    regions[i].imageSubresource.mipLevel = i;
+    regions[i].imageSubresource.layerCount = 1;
+    regions[i].imageExtent.width = w;
+    regions[i].imageExtent.height = h;
+    regions[i].imageExtent.depth = 1;
+    if (i + 1 == mipLevels) break;
+
+    const unsigned char *prev = data + offset;
+    size_t nextOffset = offset + (size_t)w * h * channels;
+    unsigned char *next = data + nextOffset;
+    uint32_t nw = w > 1 ? w / 2 : 1;
+    uint32_t nh = h > 1 ? h / 2 : 1;
+    for (uint32_t y = 0; y < nh; y++) {
+      uint32_t y0 = y * 2, y1 = (y * 2 + 1 < h) ? y * 2 + 1 : y0;
+      for (uint32_t x = 0; x < nw; x++) {
+        uint32_t x0 = x * 2, x1 = (x * 2 + 1 < w) ? x * 2 + 1 : x0;
+        for (uint32_t c = 0; c < channels; c++) {
+          unsigned char a = prev[((size_t)y0 * w + x0) * channels + c], b = prev[((size_t)y0 * w + x1) * channels + c];
+          unsigned char d = prev[((size_t)y1 * w + x0) * channels + c], e = prev[((size_t)y1 * w + x1) * channels + c];
+          next[((size_t)y * nw + x) * channels + c] = c < colorChannels ? flecs_srgb_average(toLinear, toSrgb, a, b, d, e)
+                                                                         : (unsigned char)((a + b + d + e + 2) / 4);
+        }
+      }
+    }
+    offset = nextOffset;
+    w = nw;
+    h = nh;
+  }
+  *out = data;
+  return total;
+}
+
+// one copy per level, staging buffer holds cooked->file as is
+static inline void cookedCopyRegions(const CookedTexture *cooked, VkBufferImageCopy *regions) {
+  for (uint32_t i = 0; i < cooked->mipLevels; i++) {
+    memset(&regions[i], 0, sizeof(VkBufferImageCopy));
+    regions[i].bufferOffset = cooked->levelOffset[i];
+    regions[i].imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    regions[i].imageSubresource.mipLevel = i;
+    regions[i].imageSubresource.layerCount = 1;
+    regions[i].imageExtent.width = cooked->width >> i ? cooked->width >> i : 1;
+    regions[i].imageExtent.height = cooked->height >> i ? cooked->height >> i : 1;
+    regions[i].imageExtent.depth = 1;
+  }
+}
+
 #endif // FLECS_UTILS_H
\ No newline at end of file
@@ -0,0 +1,77 @@
+#ifndef FLECS_VFS_H
+#define FLECS_VFS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Virtual file system on top of PhysFS.
+// - directories (and zip) mount through PhysFS
+// - one pack file (.pak) mapped in memory, entries stored raw or LZ4
+// - lookup order: pack first, then PhysFS search path
+// Read only after init, safe to call from asset worker threads.
+
+#define VFS_PACK_MAGIC   0x4B415046u  // "FPAK"
+#define VFS_PACK_VERSION 1
+#define VFS_PACK_NAME_MAX 128
+
+typedef enum {
+  VFS_COMPRESSION_NONE = 0,
+  VFS_COMPRESSION_LZ4  = 1   // LZ4 block format
+} VfsCompression;
+
+// on disk: VfsPackHeader, VfsPackEntry[entryCount], data
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t entryCount;
+  uint32_t reserved;
+} VfsPackHeader;
+
+typedef struct {
+  char name[VFS_PACK_NAME_MAX]; // "assets/textures/light/texture_08.png"
+  uint64_t offset;              // from start of pack
+  uint32_t packedSize;
+  uint32_t size;
+  uint32_t compression;         // VfsCompression
+  uint32_t reserved;
+} VfsPackEntry;
+
+typedef struct {
+  const void *data;
+  size_t size;
+  void *owned;    // heap copy (loose file or LZ4), NULL when it points into the pack mapping
+} VfsView;
+
+bool flecs_vfs_init(const char *argv0);
+void flecs_vfs_deinit(void);
+
+bool flecs_vfs_mount(const char *dir, const char *mountPoint);
+bool flecs_vfs_mount_pack(const char *packPath);
+
+bool flecs_vfs_exists(const char *path);
+// zero copy for raw pack entries, else read into heap
+bool flecs_vfs_open_view(const char *path, VfsView *view);
+void flecs_vfs_close_view(VfsView *view);
+// malloc'd copy, caller free()
+void *flecs_vfs_read_all(const char *path, size_t *size);
+
+// files directly under dir (pack and PhysFS, no recursion) ending with ext
+// (NULL = any), sorted "dir/name" paths, free with flecs_vfs_list_free
+char **flecs_vfs_list(const char *dir, const char *ext, int *count);
+void flecs_vfs_list_free(char **list, int count);
+
+// os path of a loose file ("<mount dir>/assets/cube.obj"), false when the
+// path comes from the pack or an archive (hot reload watches these)
+bool flecs_vfs_real_path(const char *path, char *out, size_t outSize);
+
+// os path, not through the vfs. Written to "<path>.<thread id>.tmp" next to
+// the target and renamed over it, so a reader (or a crash) never sees half a
+// file and two threads writing the same path do not collide. The directory
+// must exist
+bool flecs_write_file_atomic(const char *path, const void *data, size_t size);
+
+// returns decompressed size or -1
+int64_t flecs_vfs_lz4_decompress(const uint8_t *src, size_t srcSize, uint8_t *dst, size_t dstSize);
+
+#endif
@@ -7,6 +7,13 @@
 #include "flecs.h"
 #include "flecs_types.h"
 
+// object released once the frames that may still use it are done
+typedef struct {
+  VkObjectType type;   // IMAGE, IMAGE_VIEW, SAMPLER, BUFFER, DEVICE_MEMORY, PIPELINE
+  uint64_t handle;
+  uint64_t frame;      // frameCount when queued
+} VulkanDeferredDestroy;
+
 typedef struct {
   // Vulkan Core
   // SDL_Window *window;                          // SDL Window
@@ -40,6 +47,12 @@ typedef struct {
   const char *errorMessage;                    // Error message
   bool needsSwapchainRecreation;               // Flag to indicate swapchain needs recreation
   bool skipRender; // Add this
+  bool textureCompressionBC;                   // BC1/BC3/BC7 sampling enabled on device
+  bool memoryBudget;                           // VK_EXT_memory_budget enabled on device
+  uint64_t frameCount;                         // frames submitted
+  VulkanDeferredDestroy *deferred;             // hot reload / swapped resources
+  uint32_t deferredCount;
+  uint32_t deferredCapacity;
 } VulkanContext;
 
 ECS_COMPONENT_DECLARE(VulkanContext);
@@ -64,6 +77,10 @@ void flecs_vulkan_module_init(ecs_world_t *world);
 
 void flecs_vulkan_cleanup(ecs_world_t *world);
 
+// destroy after the GPU is done with the current frame (BeginRenderSystem
+// after the fence wait), for resources swapped while frames are in flight
+void flecs_vulkan_defer_destroy(VulkanContext *v_ctx, VkObjectType type, uint64_t handle);
+
 VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(
   VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
   VkDebugUtilsMessageTypeFlagsEXT messageType,
@@ -1,27 +1,85 @@
 	// 1115.1.0
 	 #pragma once
 const uint32_t text_frag_spv[] = {
-	0x07230203,0x00010000,0x0008000b,0x0000001c,0x00000000,0x00020011,0x00000001,0x0006000b,
+	0x07230203,0x00010000,0x0008000b,0x00000068,0x00000000,0x00020011,0x00000001,0x0006000b,
 	0x00000001,0x4c534c47,0x6474732e,0x3035342e,0x00000000,0x0003000e,0x00000000,0x00000001,
-	0x0007000f,0x00000004,0x00000004,0x6e69616d,0x00000000,0x00000010,0x00000018,0x00030010,
-	0x00000004,0x00000007,0x00030003,0x00000002,0x000001c2,0x00040005,0x00000004,0x6e69616d,
-	0x00000000,0x00040005,0x00000008,0x68706c61,0x00000061,0x00050005,0x0000000c,0x53786574,
-	0x6c706d61,0x00007265,0x00040005,0x00000010,0x67617266,0x00005655,0x00050005,0x00000018,
-	0x4374756f,0x726f6c6f,0x00000000,0x00040047,0x0000000c,0x00000021,0x00000000,0x00040047,
-	0x0000000c,0x00000022,0x00000000,0x00040047,0x00000010,0x0000001e,0x00000000,0x00040047,
-	0x00000018,0x0000001e,0x00000000,0x00020013,0x00000002,0x00030021,0x00000003,0x00000002,
-	0x00030016,0x00000006,0x00000020,0x00040020,0x00000007,0x00000007,0x00000006,0x00090019,
-	0x00000009,0x00000006,0x00000001,0x00000000,0x00000000,0x00000000,0x00000001,0x00000000,
-	0x0003001b,0x0000000a,0x00000009,0x00040020,0x0000000b,0x00000000,0x0000000a,0x0004003b,
-	0x0000000b,0x0000000c,0x00000000,0x00040017,0x0000000e,0x00000006,0x00000002,0x00040020,
-	0x0000000f,0x00000001,0x0000000e,0x0004003b,0x0000000f,0x00000010,0x00000001,0x00040017,
-	0x00000012,0x00000006,0x00000004,0x00040015,0x00000014,0x00000020,0x00000000,0x0004002b,
-	0x00000014,0x00000015,0x00000000,0x00040020,0x00000017,0x00000003,0x00000012,0x0004003b,
-	0x00000017,0x00000018,0x00000003,0x0004002b,0x00000006,0x00000019,0x3f800000,0x00050036,
-	0x00000002,0x00000004,0x00000000,0x00000003,0x000200f8,0x00000005,0x0004003b,0x00000007,
-	0x00000008,0x00000007,0x0004003d,0x0000000a,0x0000000d,0x0000000c,0x0004003d,0x0000000e,
-	0x00000011,0x00000010,0x00050057,0x00000012,0x00000013,0x0000000d,0x00000011,0x00050051,
-	0x00000006,0x00000016,0x00000013,0x00000000,0x0003003e,0x00000008,0x00000016,0x0004003d,
-	0x00000006,0x0000001a,0x00000008,0x00070050,0x00000012,0x0000001b,0x00000019,0x00000019,
-	0x00000019,0x0000001a,0x0003003e,0x00000018,0x0000001b,0x000100fd,0x00010038
+	0x0008000f,0x00000004,0x00000002,0x6e69616d,0x00000000,0x00000003,0x00000004,0x00000005,
+	0x00030010,0x00000002,0x00000007,0x00030003,0x00000002,0x000001c2,0x00040005,0x00000002,
+	0x6e69616d,0x00000000,0x00050005,0x00000006,0x53786574,0x6c706d61,0x00007265,0x00040005,
+	0x00000003,0x67617266,0x00005655,0x00050005,0x00000004,0x67617266,0x6f6c6f43,0x00000072,
+	0x00050005,0x00000005,0x4374756f,0x726f6c6f,0x00000000,0x00050005,0x00000007,0x74786554,
+	0x6c797453,0x00000065,0x00070006,0x00000007,0x00000000,0x6c74756f,0x43656e69,0x726f6c6f,
+	0x00000000,0x00060006,0x00000007,0x00000001,0x64616873,0x6f43776f,0x00726f6c,0x00070006,
+	0x00000007,0x00000002,0x64616873,0x664f776f,0x74657366,0x00000000,0x00070006,0x00000007,
+	0x00000003,0x6c74756f,0x57656e69,0x68746469,0x00000000,0x00070006,0x00000007,0x00000004,
+	0x64616873,0x6f53776f,0x656e7466,0x00007373,0x00040006,0x00000007,0x00000005,0x00666473,
+	0x00040005,0x00000008,0x6c797473,0x00000065,0x00040047,0x00000006,0x00000022,0x00000000,
+	0x00040047,0x00000006,0x00000021,0x00000000,0x00040047,0x00000003,0x0000001e,0x00000000,
+	0x00040047,0x00000004,0x0000001e,0x00000001,0x00040047,0x00000005,0x0000001e,0x00000000,
+	0x00050048,0x00000007,0x00000000,0x00000023,0x00000000,0x00050048,0x00000007,0x00000001,
+	0x00000023,0x00000010,0x00050048,0x00000007,0x00000002,0x00000023,0x00000020,0x00050048,
+	0x00000007,0x00000003,0x00000023,0x00000028,0x00050048,0x00000007,0x00000004,0x00000023,
+	0x0000002c,0x00050048,0x00000007,0x00000005,0x00000023,0x00000030,0x00030047,0x00000007,
+	0x00000002,0x00020013,0x00000009,0x00030021,0x0000000a,0x00000009,0x00030016,0x0000000b,
+	0x00000020,0x00040017,0x0000000c,0x0000000b,0x00000002,0x00040017,0x0000000d,0x0000000b,
+	0x00000003,0x00040017,0x0000000e,0x0000000b,0x00000004,0x00040015,0x0000000f,0x00000020,
+	0x00000000,0x00040015,0x00000010,0x00000020,0x00000001,0x00020014,0x00000011,0x00090019,
+	0x00000012,0x0000000b,0x00000001,0x00000000,0x00000000,0x00000000,0x00000001,0x00000000,
+	0x0003001b,0x00000013,0x00000012,0x00040020,0x00000014,0x00000000,0x00000013,0x0004003b,
+	0x00000014,0x00000006,0x00000000,0x00040020,0x00000015,0x00000001,0x0000000c,0x0004003b,
+	0x00000015,0x00000003,0x00000001,0x00040020,0x00000016,0x00000001,0x0000000e,0x0004003b,
+	0x00000016,0x00000004,0x00000001,0x00040020,0x00000017,0x00000003,0x0000000e,0x0004003b,
+	0x00000017,0x00000005,0x00000003,0x0008001e,0x00000007,0x0000000e,0x0000000e,0x0000000c,
+	0x0000000b,0x0000000b,0x0000000f,0x00040020,0x00000018,0x00000009,0x00000007,0x0004003b,
+	0x00000018,0x00000008,0x00000009,0x00040020,0x00000019,0x00000009,0x0000000e,0x00040020,
+	0x0000001a,0x00000009,0x0000000c,0x00040020,0x0000001b,0x00000009,0x0000000b,0x00040020,
+	0x0000001c,0x00000009,0x0000000f,0x0004002b,0x00000010,0x0000001d,0x00000000,0x0004002b,
+	0x00000010,0x0000001e,0x00000001,0x0004002b,0x00000010,0x0000001f,0x00000002,0x0004002b,
+	0x00000010,0x00000020,0x00000003,0x0004002b,0x00000010,0x00000021,0x00000004,0x0004002b,
+	0x00000010,0x00000022,0x00000005,0x0004002b,0x0000000f,0x00000023,0x00000000,0x0004002b,
+	0x0000000b,0x00000024,0x00000000,0x0004002b,0x0000000b,0x00000025,0x3f800000,0x0004002b,
+	0x0000000b,0x00000026,0x3f000000,0x0004002b,0x0000000b,0x00000027,0x38d1b717,0x00050036,
+	0x00000009,0x00000002,0x00000000,0x0000000a,0x000200f8,0x00000028,0x0004003d,0x00000013,
+	0x00000029,0x00000006,0x0004003d,0x0000000c,0x0000002a,0x00000003,0x00050057,0x0000000e,
+	0x0000002b,0x00000029,0x0000002a,0x00050051,0x0000000b,0x0000002c,0x0000002b,0x00000000,
+	0x00050041,0x0000001a,0x0000002d,0x00000008,0x0000001f,0x0004003d,0x0000000c,0x0000002e,
+	0x0000002d,0x00050083,0x0000000c,0x0000002f,0x0000002a,0x0000002e,0x00050057,0x0000000e,
+	0x00000030,0x00000029,0x0000002f,0x00050051,0x0000000b,0x00000031,0x00000030,0x00000000,
+	0x000400d1,0x0000000b,0x00000032,0x0000002c,0x0007000c,0x0000000b,0x00000033,0x00000001,
+	0x00000028,0x00000032,0x00000027,0x00050041,0x0000001b,0x00000034,0x00000008,0x00000020,
+	0x0004003d,0x0000000b,0x00000035,0x00000034,0x00050083,0x0000000b,0x00000036,0x00000026,
+	0x00000035,0x00050041,0x0000001c,0x00000037,0x00000008,0x00000022,0x0004003d,0x0000000f,
+	0x00000038,0x00000037,0x000500ab,0x00000011,0x00000039,0x00000038,0x00000023,0x00050083,
+	0x0000000b,0x0000003a,0x00000026,0x00000033,0x00050081,0x0000000b,0x0000003b,0x00000026,
+	0x00000033,0x0008000c,0x0000000b,0x0000003c,0x00000001,0x00000031,0x0000003a,0x0000003b,
+	0x0000002c,0x000600a9,0x0000000b,0x0000003d,0x00000039,0x0000003c,0x0000002c,0x00050083,
+	0x0000000b,0x0000003e,0x00000036,0x00000033,0x00050081,0x0000000b,0x0000003f,0x00000036,
+	0x00000033,0x0008000c,0x0000000b,0x00000040,0x00000001,0x00000031,0x0000003e,0x0000003f,
+	0x0000002c,0x000600a9,0x0000000b,0x00000041,0x00000039,0x00000040,0x0000002c,0x00050041,
+	0x0000001b,0x00000042,0x00000008,0x00000021,0x0004003d,0x0000000b,0x00000043,0x00000042,
+	0x00050083,0x0000000b,0x00000044,0x0000003e,0x00000043,0x00050081,0x0000000b,0x00000045,
+	0x0000003f,0x00000043,0x0008000c,0x0000000b,0x00000046,0x00000001,0x00000031,0x00000044,
+	0x00000045,0x00000031,0x000600a9,0x0000000b,0x00000047,0x00000039,0x00000046,0x00000024,
+	0x0004003d,0x0000000e,0x00000048,0x00000004,0x00050051,0x0000000b,0x00000049,0x00000048,
+	0x00000003,0x00050085,0x0000000b,0x0000004a,0x00000049,0x0000003d,0x00050041,0x00000019,
+	0x0000004b,0x00000008,0x0000001d,0x0004003d,0x0000000e,0x0000004c,0x0000004b,0x00050051,
+	0x0000000b,0x0000004d,0x0000004c,0x00000003,0x00050083,0x0000000b,0x0000004e,0x00000041,
+	0x0000003d,0x00050085,0x0000000b,0x0000004f,0x0000004d,0x0000004e,0x0008004f,0x0000000d,
+	0x00000050,0x00000048,0x00000048,0x00000000,0x00000001,0x00000002,0x0008004f,0x0000000d,
+	0x00000051,0x0000004c,0x0000004c,0x00000000,0x00000001,0x00000002,0x0005008e,0x0000000d,
+	0x00000052,0x00000050,0x0000004a,0x0005008e,0x0000000d,0x00000053,0x00000051,0x0000004f,
+	0x00050081,0x0000000d,0x00000054,0x00000052,0x00000053,0x00050081,0x0000000b,0x00000055,
+	0x0000004a,0x0000004f,0x00050041,0x00000019,0x00000056,0x00000008,0x0000001e,0x0004003d,
+	0x0000000e,0x00000057,0x00000056,0x00050051,0x0000000b,0x00000058,0x00000057,0x00000003,
+	0x00050085,0x0000000b,0x00000059,0x00000058,0x00000049,0x00050085,0x0000000b,0x0000005a,
+	0x00000059,0x00000047,0x00050083,0x0000000b,0x0000005b,0x00000025,0x00000055,0x00050085,
+	0x0000000b,0x0000005c,0x0000005a,0x0000005b,0x0008004f,0x0000000d,0x0000005d,0x00000057,
+	0x00000057,0x00000000,0x00000001,0x00000002,0x0005008e,0x0000000d,0x0000005e,0x0000005d,
+	0x0000005c,0x00050081,0x0000000d,0x0000005f,0x00000054,0x0000005e,0x00050081,0x0000000b,
+	0x00000060,0x00000055,0x0000005c,0x0007000c,0x0000000b,0x00000061,0x00000001,0x00000028,
+	0x00000060,0x00000027,0x00050088,0x0000000b,0x00000062,0x00000025,0x00000061,0x0005008e,
+	0x0000000d,0x00000063,0x0000005f,0x00000062,0x00050051,0x0000000b,0x00000064,0x00000063,
+	0x00000000,0x00050051,0x0000000b,0x00000065,0x00000063,0x00000001,0x00050051,0x0000000b,
+	0x00000066,0x00000063,0x00000002,0x00070050,0x0000000e,0x00000067,0x00000064,0x00000065,
+	0x00000066,0x00000060,0x0003003e,0x00000005,0x00000067,0x000100fd,0x00010038
 };
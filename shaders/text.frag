@@ -1,10 +1,39 @@
 #version 450
 layout(location = 0) in vec2 fragUV;
+layout(location = 1) in vec4 fragColor;
 layout(location = 0) out vec4 outColor;
 
 layout(binding = 0) uniform sampler2D texSampler;
 
+// TextStyle in flecs_text.h
+layout(push_constant) uniform TextStyle {
+    vec4 outlineColor;
+    vec4 shadowColor;
+    vec2 shadowOffset;   // atlas uv
+    float outlineWidth;  // distance units, 0.5 = edge
+    float shadowSoftness;
+    uint sdf;            // 0: coverage page, alpha straight from the atlas
+} style;
+
 void main() {
-    float alpha = texture(texSampler, fragUV).r;
-    outColor = vec4(1.0, 1.0, 1.0, alpha); // White text, alpha from atlas
-}
\ No newline at end of file
+    float d = texture(texSampler, fragUV).r;
+    float s = texture(texSampler, fragUV - style.shadowOffset).r;
+    // screen-space antialiasing width, crisp at any scale
+    float w = max(fwidth(d), 1e-4);
+    float edge = 0.5 - style.outlineWidth;
+    bool isSdf = style.sdf != 0u;
+
+    float fill = isSdf ? smoothstep(0.5 - w, 0.5 + w, d) : d;
+    float outline = isSdf ? smoothstep(edge - w, edge + w, d) : d;
+    float shadow = isSdf ? smoothstep(edge - w - style.shadowSoftness, edge + w + style.shadowSoftness, s) : 0.0;
+
+    // premultiplied: text over outline over shadow
+    float textA = fragColor.a * fill;
+    float ringA = style.outlineColor.a * (outline - fill);
+    vec3 rgb = fragColor.rgb * textA + style.outlineColor.rgb * ringA;
+    float a = textA + ringA;
+    float shadowA = style.shadowColor.a * fragColor.a * shadow * (1.0 - a);
+    rgb += style.shadowColor.rgb * shadowA;
+    a += shadowA;
+    outColor = vec4(rgb / max(a, 1e-4), a);
+}
@@ -1,10 +1,22 @@
 #version 450
-layout(location = 0) in vec2 inPosition; // Now in NDC (-1 to 1)
-layout(location = 1) in vec2 inUV;
+// one instance per glyph (TextGlyph in flecs_text.c), a 4 vertex strip
+layout(location = 0) in ivec2 inPos;  // top-left, 1/8 pixels
+layout(location = 1) in uvec2 inSize; // 1/8 pixels
+layout(location = 2) in uvec4 inRect; // atlas page texels x, y, width, height
+layout(location = 3) in vec4 inColor;
 
 layout(location = 0) out vec2 fragUV;
+layout(location = 1) out vec4 fragColor;
+
+// TextView in flecs_text.h, after the fragment TextStyle
+layout(push_constant) uniform TextView {
+    layout(offset = 56) vec2 pixelToNdc; // 2 / screen size
+} view;
 
 void main() {
-    gl_Position = vec4(inPosition, 0.0, 1.0);
-    fragUV = inUV;
-}
\ No newline at end of file
+    vec2 corner = vec2(gl_VertexIndex & 1, gl_VertexIndex >> 1);
+    vec2 pixel = (vec2(inPos) + corner * vec2(inSize)) * 0.125;
+    gl_Position = vec4(pixel * view.pixelToNdc - 1.0, 0.0, 1.0);
+    fragUV = (vec2(inRect.xy) + corner * vec2(inRect.zw)) * (1.0 / 1024.0); // GLYPH_PAGE_SIZE
+    fragColor = inColor;
+}
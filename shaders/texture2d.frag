@@ -3,8 +3,13 @@ layout(location = 0) in vec2 fragTexCoord;
 
 layout(location = 0) out vec4 outColor;
 
-layout(binding = 0) uniform sampler2D textureSampler;
+// texture set, one layer per material
+layout(binding = 0) uniform sampler2DArray textureSampler;
+
+layout(push_constant) uniform PushConstants {
+    uint layer;
+} pc;
 
 void main() {
-    outColor = texture(textureSampler, fragTexCoord);
-}
\ No newline at end of file
+    outColor = texture(textureSampler, vec3(fragTexCoord, float(pc.layer)));
+}
@@ -0,0 +1,694 @@
+// asset cooker
+// Offline build step, separate executable. Cooks the assets/ tree (and
+// script.lua) into what the runtime loads without decoding: binary meshes,
+// BC textures with mips, baked font atlases, LuaJIT bytecode. Everything is
+// packed into assets.pak, which the game memory maps (flecs_vfs_mount_pack).
+//
+// usage: asset_cooker [-o assets.pak] [-j jobs] [-f] [-z] [paths...]
+//   paths default to "assets" and "script.lua" (vfs paths, directories recurse)
+//   -f cooks everything again, ignoring the manifest
+//   -z stores text, script and shader entries LZ4 compressed (always
+//      rewrites the pack), everything else stays raw for zero copy views
+//
+// Incremental: cache/cooked/manifest.json records for every source its
+// cooked output, the settings hash and each file it read (size, mtime and
+// FNV-1a hash). Unchanged size + mtime skips without reading, changed ones
+// are hashed and only cooked again when the bytes differ.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <SDL3/SDL.h>
+#include <physfs.h>
+#include "cJSON.h"
+#include "flecs.h"
+#include "flecs_vfs.h"
+#include "flecs_asset_jobs.h"
+#include "flecs_texture_cooker.h"
+#include "flecs_text.h"
+#include <lua.h>
+#include <lualib.h>
+#include <lauxlib.h>
+
+//#define STB_IMAGE_IMPLEMENTATION // flecs_texture2d.c
+#include "stb_image.h"
+
+#define COOKER_VERSION     1
+#define COOKER_CACHE_DIR   "cache/cooked"
+#define COOKER_MANIFEST    COOKER_CACHE_DIR "/manifest.json"
+#define COOKER_MAX_DEPS    8
+#define COOKER_MAX_JOBS    64
+#define COOKER_PACK_ALIGN  16
+#define COOKER_LZ4_HASH_BITS 12
+
+typedef enum {
+  COOK_KIND_COPY,      // packed as is
+  COOK_KIND_MESH,      // "<path>.mesh" + source
+  COOK_KIND_TEXTURE,   // "<path>.ktx2" + source (raw loads, non BC devices)
+  COOK_KIND_FONT,      // "<path>.atlas" + source
+  COOK_KIND_LUA        // bytecode under the source name, luaL_loadbuffer takes both
+} CookKind;
+
+typedef struct {
+  char path[VFS_PACK_NAME_MAX];
+  uint64_t hash;
+  int64_t size;
+  int64_t mtime;
+} CookDep;
+
+typedef struct {
+  char source[VFS_PACK_NAME_MAX];
+  char output[VFS_PACK_NAME_MAX];   // pack entry of the cooked artefact, empty for COPY
+  CookKind kind;
+  uint64_t params;                  // cooker + format versions, a change cooks again
+  CookDep deps[COOKER_MAX_DEPS];    // deps[0] is the source
+  int depCount;
+  bool dirty;
+  bool failed;
+  const char *error;
+} CookItem;
+
+typedef struct {
+  CookItem *items;
+  int count;
+  int capacity;
+  SDL_AtomicInt next;               // workers take items in order
+  int textureThreads;
+} CookerState;
+
+//===============================================
+// helpers
+//===============================================
+
+static uint64_t cookerHash(uint64_t h, const void *data, size_t size) {
+  const uint8_t *bytes = data;
+  for (size_t i = 0; i < size; i++) {
+    h ^= bytes[i];
+    h *= 0x100000001b3ull;
+  }
+  return h;
+}
+
+static bool cookerEndsWith(const char *path, const char *ext) {
+  size_t len = strlen(path), extLen = strlen(ext);
+  return len >= extLen && SDL_strcasecmp(path + len - extLen, ext) == 0;
+}
+
+static CookKind cookerKind(const char *path) {
+  if (cookerEndsWith(path, ".obj") || cookerEndsWith(path, ".fbx") || cookerEndsWith(path, ".gltf") || cookerEndsWith(path, ".glb")) {
+    return COOK_KIND_MESH;
+  }
+  if (cookerEndsWith(path, ".png") || cookerEndsWith(path, ".jpg") || cookerEndsWith(path, ".tga")) return COOK_KIND_TEXTURE;
+  if (cookerEndsWith(path, ".ttf") || cookerEndsWith(path, ".otf")) return COOK_KIND_FONT;
+  if (cookerEndsWith(path, ".lua")) return COOK_KIND_LUA;
+  return COOK_KIND_COPY;
+}
+
+static uint64_t cookerParams(CookKind kind) {
+  uint32_t versions[3] = { COOKER_VERSION, (uint32_t)kind, 0 };
+  switch (kind) {
+    case COOK_KIND_MESH:    versions[2] = ASSET_MESH_VERSION | (uint32_t)sizeof(Vertex3d) << 16; break;
+    case COOK_KIND_TEXTURE: versions[2] = TEXTURE_COOK_VERSION; break;
+    case COOK_KIND_FONT:    versions[2] = TEXT_ATLAS_VERSION | (uint32_t)TEXT_FONT_MODE << 16; break;
+    default: break;
+  }
+  uint64_t h = cookerHash(0xcbf29ce484222325ull, versions, sizeof(versions));
+  // bytecode is tied to the LuaJIT build
+  if (kind == COOK_KIND_LUA) h = cookerHash(h, LUA_RELEASE, strlen(LUA_RELEASE));
+  return h;
+}
+
+static void cookerCachePath(const char *name, char *out, size_t size) {
+  snprintf(out, size, "%s/%s", COOKER_CACHE_DIR, name);
+}
+
+// size and mtime of a loose file, false for pack / archive entries
+static bool cookerStat(const char *path, int64_t *size, int64_t *mtime) {
+  char realPath[512];
+  SDL_PathInfo info;
+  if (!flecs_vfs_real_path(path, realPath, sizeof(realPath)) || !SDL_GetPathInfo(realPath, &info)) return false;
+  *size = (int64_t)info.size;
+  *mtime = (int64_t)info.modify_time;
+  return true;
+}
+
+static bool cookerFillDep(CookDep *dep) {
+  size_t size = 0;
+  void *data = flecs_vfs_read_all(dep->path, &size);
+  if (!data) return false;
+  dep->hash = flecs_texture_source_hash(data, size);
+  free(data);
+  if (!cookerStat(dep->path, &dep->size, &dep->mtime)) {
+    dep->size = (int64_t)size;
+    dep->mtime = 0;
+  }
+  return true;
+}
+
+static void cookerAddDep(void *user, const char *path) {
+  CookItem *item = user;
+  for (int i = 0; i < item->depCount; i++) {
+    if (strcmp(item->deps[i].path, path) == 0) return;
+  }
+  if (item->depCount == COOKER_MAX_DEPS) return;
+  snprintf(item->deps[item->depCount++].path, VFS_PACK_NAME_MAX, "%s", path);
+}
+
+// next to the target then rename, an interrupted run never leaves half a file
+static bool cookerWriteFile(const char *path, const void *data, size_t size) {
+  char dir[512];
+  snprintf(dir, sizeof(dir), "%s", path);
+  char *slash = strrchr(dir, '/');
+  if (slash) {
+    *slash = '\0';
+    SDL_CreateDirectory(dir);
+  }
+  return flecs_write_file_atomic(path, data, size);
+}
+
+//===============================================
+// collect
+//===============================================
+
+static void cookerAddItem(CookerState *state, const char *path) {
+  if (cookerEndsWith(path, ".tmp")) return;
+  if (strlen(path) + 8 >= VFS_PACK_NAME_MAX) {
+    fprintf(stderr, "asset_cooker: path too long for the pack, skipped: %s\n", path);
+    return;
+  }
+  if (state->count == state->capacity) {
+    int capacity = state->capacity ? state->capacity * 2 : 64;
+    CookItem *grown = realloc(state->items, sizeof(CookItem) * capacity);
+    if (!grown) return;
+    state->items = grown;
+    state->capacity = capacity;
+  }
+  CookItem *item = &state->items[state->count++];
+  memset(item, 0, sizeof(CookItem));
+  snprintf(item->source, sizeof(item->source), "%s", path);
+  item->kind = cookerKind(path);
+  item->params = cookerParams(item->kind);
+  switch (item->kind) {
+    case COOK_KIND_MESH:    snprintf(item->output, sizeof(item->output), "%s%s", path, ASSET_MESH_COOKED_EXT); break;
+    case COOK_KIND_TEXTURE: snprintf(item->output, sizeof(item->output), "%s%s", path, TEXTURE_COOKED_EXT); break;
+    case COOK_KIND_FONT:    snprintf(item->output, sizeof(item->output), "%s%s", path, TEXT_ATLAS_COOKED_EXT); break;
+    case COOK_KIND_LUA:     snprintf(item->output, sizeof(item->output), "%s", path); break;
+    default: break;
+  }
+}
+
+static void cookerWalk(CookerState *state, const char *path) {
+  PHYSFS_Stat st;
+  if (!PHYSFS_stat(path, &st)) {
+    fprintf(stderr, "asset_cooker: %s not found\n", path);
+    return;
+  }
+  if (st.filetype == PHYSFS_FILETYPE_REGULAR) {
+    cookerAddItem(state, path);
+    return;
+  }
+  if (st.filetype != PHYSFS_FILETYPE_DIRECTORY) return;
+  char **files = PHYSFS_enumerateFiles(path);
+  for (char **f = files; f && *f; f++) {
+    char child[VFS_PACK_NAME_MAX * 2];
+    snprintf(child, sizeof(child), "%s/%s", path, *f);
+    cookerWalk(state, child);
+  }
+  PHYSFS_freeList(files);
+}
+
+//===============================================
+// manifest
+//===============================================
+
+static uint64_t cookerJsonHex(const cJSON *object, const char *name) {
+  const cJSON *value = cJSON_GetObjectItemCaseSensitive(object, name);
+  return cJSON_IsString(value) ? strtoull(value->valuestring, NULL, 16) : 0;
+}
+
+static void cookerJsonSetHex(cJSON *object, const char *name, uint64_t value) {
+  char hex[17];
+  snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)value);
+  cJSON_AddStringToObject(object, name, hex);
+}
+
+static cJSON *cookerLoadManifest(void) {
+  FILE *f = fopen(COOKER_MANIFEST, "rb");
+  if (!f) return NULL;
+  fseek(f, 0, SEEK_END);
+  long size = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  char *text = size > 0 ? malloc((size_t)size + 1) : NULL;
+  cJSON *manifest = NULL;
+  if (text && fread(text, 1, (size_t)size, f) == (size_t)size) {
+    text[size] = '\0';
+    manifest = cJSON_Parse(text);
+  }
+  free(text);
+  fclose(f);
+  const cJSON *version = manifest ? cJSON_GetObjectItemCaseSensitive(manifest, "version") : NULL;
+  if (!cJSON_IsNumber(version) || version->valueint != COOKER_VERSION) {
+    cJSON_Delete(manifest);
+    return NULL;
+  }
+  return manifest;
+}
+
+// same settings, cached output still there and every file it read unchanged
+static bool cookerUpToDate(CookItem *item, const cJSON *items) {
+  const cJSON *entry = items ? cJSON_GetObjectItemCaseSensitive(items, item->source) : NULL;
+  if (!entry || cookerJsonHex(entry, "params") != item->params) return false;
+  if (item->output[0]) {
+    char cachePath[512];
+    cookerCachePath(item->output, cachePath, sizeof(cachePath));
+    if (!SDL_GetPathInfo(cachePath, NULL)) return false;
+  }
+
+  const cJSON *deps = cJSON_GetObjectItemCaseSensitive(entry, "deps");
+  const cJSON *dep;
+  item->depCount = 0;
+  cJSON_ArrayForEach(dep, deps) {
+    const cJSON *path = cJSON_GetObjectItemCaseSensitive(dep, "path");
+    if (!cJSON_IsString(path) || item->depCount == COOKER_MAX_DEPS) return false;
+    CookDep *d = &item->deps[item->depCount++];
+    snprintf(d->path, sizeof(d->path), "%s", path->valuestring);
+    d->hash = cookerJsonHex(dep, "hash");
+    d->size = (int64_t)cookerJsonHex(dep, "size");
+    d->mtime = (int64_t)cookerJsonHex(dep, "mtime");
+
+    int64_t size, mtime;
+    if (cookerStat(d->path, &size, &mtime) && size == d->size && mtime == d->mtime) continue;
+    // touched or moved: only the bytes decide
+    uint64_t previous = d->hash;
+    if (!cookerFillDep(d) || d->hash != previous) return false;
+  }
+  return item->depCount > 0;
+}
+
+static bool cookerSaveManifest(const CookerState *state) {
+  cJSON *manifest = cJSON_CreateObject();
+  cJSON_AddNumberToObject(manifest, "version", COOKER_VERSION);
+  cJSON *items = cJSON_AddObjectToObject(manifest, "items");
+  for (int i = 0; i < state->count; i++) {
+    const CookItem *item = &state->items[i];
+    if (item->failed) continue; // cooked again next run
+    cJSON *entry = cJSON_AddObjectToObject(items, item->source);
+    cookerJsonSetHex(entry, "params", item->params);
+    cJSON_AddStringToObject(entry, "output", item->output);
+    cJSON *deps = cJSON_AddArrayToObject(entry, "deps");
+    for (int d = 0; d < item->depCount; d++) {
+      cJSON *dep = cJSON_CreateObject();
+      cJSON_AddStringToObject(dep, "path", item->deps[d].path);
+      cookerJsonSetHex(dep, "hash", item->deps[d].hash);
+      cookerJsonSetHex(dep, "size", (uint64_t)item->deps[d].size);
+      cookerJsonSetHex(dep, "mtime", (uint64_t)item->deps[d].mtime);
+      cJSON_AddItemToArray(deps, dep);
+    }
+  }
+  char *text = cJSON_Print(manifest);
+  bool ok = text && cookerWriteFile(COOKER_MANIFEST, text, strlen(text));
+  cJSON_free(text);
+  cJSON_Delete(manifest);
+  return ok;
+}
+
+//===============================================
+// cook (worker threads)
+//===============================================
+
+typedef struct {
+  uint8_t *data;
+  size_t size;
+  size_t capacity;
+} CookerBuffer;
+
+static int cookerLuaWriter(lua_State *L, const void *p, size_t size, void *ud) {
+  CookerBuffer *buffer = ud;
+  if (buffer->size + size > buffer->capacity) {
+    size_t capacity = buffer->capacity ? buffer->capacity * 2 : 4096;
+    while (capacity < buffer->size + size) capacity *= 2;
+    uint8_t *grown = realloc(buffer->data, capacity);
+    if (!grown) return 1;
+    buffer->data = grown;
+    buffer->capacity = capacity;
+  }
+  memcpy(buffer->data + buffer->size, p, size);
+  buffer->size += size;
+  return 0;
+}
+
+static bool cookLua(CookItem *item, void **blob, size_t *size) {
+  size_t sourceSize = 0;
+  char *source = flecs_vfs_read_all(item->source, &sourceSize);
+  if (!source) {
+    item->error = "read failed";
+    return false;
+  }
+  char chunkName[VFS_PACK_NAME_MAX + 1];
+  snprintf(chunkName, sizeof(chunkName), "@%s", item->source);
+
+  lua_State *L = luaL_newstate();
+  CookerBuffer buffer = {0};
+  bool ok = L && luaL_loadbuffer(L, source, sourceSize, chunkName) == 0;
+  if (!ok) {
+    fprintf(stderr, "asset_cooker: %s\n", L ? lua_tostring(L, -1) : "lua state");
+    item->error = "lua syntax error";
+  } else {
+    ok = lua_dump(L, cookerLuaWriter, &buffer) == 0;
+    if (!ok) item->error = "lua_dump failed";
+  }
+  if (L) lua_close(L);
+  free(source);
+  if (!ok) {
+    free(buffer.data);
+    return false;
+  }
+  *blob = buffer.data;
+  *size = buffer.size;
+  return true;
+}
+
+static bool cookTexture(CookItem *item, int threads, void **blob, size_t *size) {
+  VfsView view;
+  if (!flecs_vfs_open_view(item->source, &view)) {
+    item->error = "read failed";
+    return false;
+  }
+  uint64_t hash = flecs_texture_source_hash(view.data, view.size);
+  int width, height, channels;
+  uint8_t *pixels = stbi_load_from_memory(view.data, (int)view.size, &width, &height, &channels, STBI_rgb_alpha);
+  flecs_vfs_close_view(&view);
+  if (!pixels) {
+    item->error = stbi_failure_reason();
+    return false;
+  }
+  CookedTexture cooked;
+  bool ok = flecs_texture_cook(pixels, (uint32_t)width, (uint32_t)height, TEXTURE_COOK_AUTO, hash, threads, &cooked);
+  stbi_image_free(pixels);
+  if (!ok) {
+    item->error = "encode failed";
+    return false;
+  }
+  // the container is the artefact, hand the buffer over
+  *blob = cooked.file;
+  *size = cooked.fileSize;
+  return true;
+}
+
+static void cookItem(CookerState *state, CookItem *item) {
+  item->depCount = 0;
+  cookerAddDep(item, item->source);
+
+  void *blob = NULL;
+  size_t size = 0;
+  bool ok = true;
+  AssetResult result = {0};
+  switch (item->kind) {
+    case COOK_KIND_MESH:
+      ok = flecs_asset_import_mesh(item->source, &result, cookerAddDep, item);
+      if (ok) blob = flecs_asset_mesh_serialize(&result, &size);
+      if (!ok) item->error = result.error;
+      break;
+    case COOK_KIND_TEXTURE:
+      ok = cookTexture(item, state->textureThreads, &blob, &size);
+      break;
+    case COOK_KIND_FONT:
+      ok = flecs_text_bake_font_atlas(item->source, TEXT_FONT_MODE, &result);
+      if (ok) blob = flecs_text_atlas_serialize(&result, &size);
+      if (!ok) item->error = result.error;
+      break;
+    case COOK_KIND_LUA:
+      ok = cookLua(item, &blob, &size);
+      break;
+    default:
+      break;
+  }
+  flecs_asset_result_free(&result);
+
+  if (ok && item->output[0]) {
+    char cachePath[512];
+    cookerCachePath(item->output, cachePath, sizeof(cachePath));
+    ok = blob && cookerWriteFile(cachePath, blob, size);
+    if (!ok && !item->error) item->error = "write failed";
+  }
+  free(blob);
+  for (int i = 0; ok && i < item->depCount; i++) ok = cookerFillDep(&item->deps[i]);
+  item->failed = !ok;
+  if (ok && item->kind != COOK_KIND_COPY) printf("  cooked %s\n", item->output);
+  if (!ok) fprintf(stderr, "asset_cooker: failed %s: %s\n", item->source, item->error ? item->error : "unknown");
+}
+
+static int cookerWorker(void *data) {
+  CookerState *state = data;
+  for (;;) {
+    int i = SDL_AddAtomicInt(&state->next, 1);
+    if (i >= state->count) break;
+    if (state->items[i].dirty) cookItem(state, &state->items[i]);
+  }
+  return 0;
+}
+
+//===============================================
+// pack
+//===============================================
+
+typedef struct {
+  const char *name;
+  const CookItem *item;
+  bool cooked;           // cache/cooked file, else the source through the vfs
+} CookerPackSource;
+
+// entries read whole and parsed, nothing maps them: text, scripts (source or
+// bytecode) and shaders
+static bool cookerPackCompressible(const CookerPackSource *src) {
+  static const char *exts[] = { ".lua", ".txt", ".json", ".md", ".csv", ".xml", ".ini", ".cfg",
+                                ".glsl", ".vert", ".frag", ".comp", ".hlsl", ".spv" };
+  if (src->item->kind == COOK_KIND_LUA) return true;
+  if (src->item->kind != COOK_KIND_COPY) return false;
+  for (size_t i = 0; i < sizeof(exts) / sizeof(exts[0]); i++) {
+    if (cookerEndsWith(src->name, exts[i])) return true;
+  }
+  return false;
+}
+
+static inline uint32_t cookerLz4Hash(const uint8_t *p) {
+  uint32_t v;
+  memcpy(&v, p, 4);
+  return (v * 2654435761u) >> (32 - COOKER_LZ4_HASH_BITS);
+}
+
+// length past the 15 in the token nibble
+static uint8_t *cookerLz4Length(uint8_t *op, size_t len) {
+  for (len -= 15; len >= 255; len -= 255) *op++ = 255;
+  *op++ = (uint8_t)len;
+  return op;
+}
+
+// LZ4 block format, greedy with one hash slot per 4 byte prefix, what
+// flecs_vfs_lz4_decompress reads. The last match starts 12 bytes and ends 5
+// bytes before the end, like the reference encoder. Returns the compressed
+// size, 0 when it does not fit in capacity
+static size_t cookerLz4Compress(const uint8_t *src, size_t size, uint8_t *dst, size_t capacity) {
+  uint32_t table[1 << COOKER_LZ4_HASH_BITS] = {0}; // position + 1, 0 = empty
+  const uint8_t *ip = src, *anchor = src, *end = src + size;
+  const uint8_t *mflimit = size > 12 ? end - 12 : src;
+  const uint8_t *matchlimit = size > 5 ? end - 5 : src;
+  uint8_t *op = dst, *oend = dst + capacity;
+
+  while (ip < mflimit) {
+    uint32_t h = cookerLz4Hash(ip);
+    const uint8_t *ref = table[h] ? src + table[h] - 1 : NULL;
+    table[h] = (uint32_t)(ip - src) + 1;
+    if (!ref || ip - ref > 65535 || memcmp(ref, ip, 4) != 0) {
+      ip++;
+      continue;
+    }
+    const uint8_t *m = ip + 4, *r = ref + 4;
+    while (m < matchlimit && *m == *r) {
+      m++;
+      r++;
+    }
+    size_t litLen = (size_t)(ip - anchor), matchLen = (size_t)(m - ip) - 4;
+    // token, literal length, literals, offset, match length
+    if ((size_t)(oend - op) < 1 + litLen / 255 + 1 + litLen + 2 + matchLen / 255 + 1) return 0;
+    uint8_t *token = op++;
+    *token = (uint8_t)((litLen < 15 ? litLen : 15) << 4 | (matchLen < 15 ? matchLen : 15));
+    if (litLen >= 15) op = cookerLz4Length(op, litLen);
+    memcpy(op, anchor, litLen);
+    op += litLen;
+    size_t offset = (size_t)(ip - ref);
+    *op++ = (uint8_t)(offset & 0xff);
+    *op++ = (uint8_t)(offset >> 8);
+    if (matchLen >= 15) op = cookerLz4Length(op, matchLen);
+    ip = anchor = m;
+  }
+
+  // the rest as literals, no match
+  size_t litLen = (size_t)(end - anchor);
+  if ((size_t)(oend - op) < 1 + litLen / 255 + 1 + litLen) return 0;
+  *op++ = (uint8_t)((litLen < 15 ? litLen : 15) << 4);
+  if (litLen >= 15) op = cookerLz4Length(op, litLen);
+  memcpy(op, anchor, litLen);
+  op += litLen;
+  return (size_t)(op - dst);
+}
+
+static void *cookerPackRead(const CookerPackSource *src, size_t *size) {
+  if (!src->cooked) return flecs_vfs_read_all(src->name, size);
+  char cachePath[512];
+  cookerCachePath(src->name, cachePath, sizeof(cachePath));
+  return SDL_LoadFile(cachePath, size);
+}
+
+static bool cookerWritePack(const CookerState *state, const char *packPath, bool compress) {
+  CookerPackSource *sources = calloc((size_t)state->count * 2 + 1, sizeof(CookerPackSource));
+  if (!sources) return false;
+  uint32_t count = 0;
+  for (int i = 0; i < state->count; i++) {
+    const CookItem *item = &state->items[i];
+    if (item->failed) continue;
+    // bytecode replaces the script, everything else keeps the source for raw loads
+    if (item->kind != COOK_KIND_LUA) sources[count++] = (CookerPackSource){ item->source, item, false };
+    if (item->output[0]) sources[count++] = (CookerPackSource){ item->output, item, true };
+  }
+
+  char tmpPath[512];
+  snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", packPath);
+  FILE *f = fopen(tmpPath, "wb");
+  VfsPackEntry *entries = calloc(count ? count : 1, sizeof(VfsPackEntry));
+  bool ok = f && entries;
+
+  // header and table first with zeroed offsets, patched once the data is written
+  VfsPackHeader header = { VFS_PACK_MAGIC, VFS_PACK_VERSION, count, 0 };
+  if (ok) ok = fwrite(&header, sizeof(header), 1, f) == 1 && fwrite(entries, sizeof(VfsPackEntry), count, f) == count;
+  uint64_t offset = sizeof(header) + sizeof(VfsPackEntry) * (uint64_t)count;
+  uint64_t rawBytes = 0;
+  uint32_t compressed = 0;
+  static const uint8_t zeros[COOKER_PACK_ALIGN] = {0};
+  for (uint32_t i = 0; ok && i < count; i++) {
+    size_t pad = (size_t)((COOKER_PACK_ALIGN - offset % COOKER_PACK_ALIGN) % COOKER_PACK_ALIGN);
+    if (pad && fwrite(zeros, 1, pad, f) != pad) ok = false;
+    offset += pad;
+
+    size_t size = 0;
+    void *data = cookerPackRead(&sources[i], &size);
+    if (!data || size > UINT32_MAX) {
+      fprintf(stderr, "asset_cooker: cannot pack %s\n", sources[i].name);
+      SDL_free(data);
+      ok = false;
+      break;
+    }
+    snprintf(entries[i].name, sizeof(entries[i].name), "%s", sources[i].name);
+    entries[i].offset = offset;
+    entries[i].size = (uint32_t)size;
+    entries[i].compression = VFS_COMPRESSION_NONE; // raw, zero copy views out of the mapping
+
+    // kept raw unless it saves an eighth, the decode is not free
+    uint8_t *packed = compress && size >= 64 && cookerPackCompressible(&sources[i]) ? malloc(size) : NULL;
+    size_t packedSize = packed ? cookerLz4Compress(data, size, packed, size - size / 8) : 0;
+    if (packedSize) {
+      entries[i].compression = VFS_COMPRESSION_LZ4;
+      compressed++;
+    }
+    const void *bytes = packedSize ? (const void *)packed : data;
+    size_t written = packedSize ? packedSize : size;
+    entries[i].packedSize = (uint32_t)written;
+    ok = fwrite(bytes, 1, written, f) == written;
+    offset += written;
+    rawBytes += size;
+    free(packed);
+    // vfs_read_all is malloc, SDL_LoadFile is SDL_malloc
+    if (sources[i].cooked) SDL_free(data);
+    else free(data);
+  }
+  if (ok) ok = fseek(f, (long)sizeof(header), SEEK_SET) == 0 && fwrite(entries, sizeof(VfsPackEntry), count, f) == count;
+  if (f) ok = fclose(f) == 0 && ok;
+  if (ok) ok = SDL_RenamePath(tmpPath, packPath);
+  if (!ok) SDL_RemovePath(tmpPath);
+  if (ok) {
+    printf("packed %u entries into %s (%llu KB, %u LZ4, %llu KB raw)\n", count, packPath, (unsigned long long)(offset >> 10),
+           compressed, (unsigned long long)(rawBytes >> 10));
+  }
+  free(entries);
+  free(sources);
+  return ok;
+}
+
+//===============================================
+// main
+//===============================================
+
+int main(int argc, char *argv[]) {
+  ecs_os_set_api_defaults();
+
+  const char *packPath = "assets.pak";
+  int jobs = SDL_GetNumLogicalCPUCores();
+  bool force = false;
+  bool compress = false;
+  const char *roots[64];
+  int rootCount = 0;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) packPath = argv[++i];
+    else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) jobs = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-f") == 0) force = true;
+    else if (strcmp(argv[i], "-z") == 0) compress = true;
+    else if (argv[i][0] == '-') {
+      fprintf(stderr, "usage: asset_cooker [-o assets.pak] [-j jobs] [-f] [-z] [paths...]\n");
+      return 1;
+    } else if (rootCount < (int)(sizeof(roots) / sizeof(roots[0]))) roots[rootCount++] = argv[i];
+  }
+  if (!rootCount) {
+    roots[rootCount++] = "assets";
+    roots[rootCount++] = "script.lua";
+  }
+  if (jobs < 1) jobs = 1;
+  if (jobs > COOKER_MAX_JOBS) jobs = COOKER_MAX_JOBS;
+
+  // sources only, the old pack is not mounted
+  if (!flecs_vfs_init(argv[0])) return 1;
+  Uint64 start = SDL_GetTicks();
+
+  CookerState state = {0};
+  for (int i = 0; i < rootCount; i++) cookerWalk(&state, roots[i]);
+
+  cJSON *manifest = force ? NULL : cookerLoadManifest();
+  const cJSON *manifestItems = manifest ? cJSON_GetObjectItemCaseSensitive(manifest, "items") : NULL;
+  int dirty = 0;
+  for (int i = 0; i < state.count; i++) {
+    state.items[i].dirty = !cookerUpToDate(&state.items[i], manifestItems);
+    if (state.items[i].dirty) dirty++;
+  }
+  // a removed source changes the pack too
+  bool removed = manifestItems && cJSON_GetArraySize(manifestItems) != state.count;
+  cJSON_Delete(manifest);
+
+  if (dirty) {
+    int workers = jobs < dirty ? jobs : dirty;
+    // one file at a time gets the block encoder threads instead
+    state.textureThreads = workers > 1 ? 1 : 0;
+    SDL_Thread *threads[COOKER_MAX_JOBS] = {0};
+    for (int i = 1; i < workers; i++) threads[i] = SDL_CreateThread(cookerWorker, "asset_cooker", &state);
+    cookerWorker(&state);
+    for (int i = 1; i < workers; i++) {
+      if (threads[i]) SDL_WaitThread(threads[i], NULL);
+    }
+  }
+
+  int failed = 0;
+  for (int i = 0; i < state.count; i++) failed += state.items[i].failed;
+  bool ok = cookerSaveManifest(&state);
+  if (!ok) fprintf(stderr, "asset_cooker: failed to write %s\n", COOKER_MANIFEST);
+
+  // the old pack's compression is unknown, -z always writes it
+  if (dirty || removed || compress || !SDL_GetPathInfo(packPath, NULL)) {
+    ok = cookerWritePack(&state, packPath, compress) && ok;
+  } else {
+    printf("%s is up to date\n", packPath);
+  }
+  printf("%d sources, %d cooked, %d up to date, %d failed in %llu ms (%d jobs)\n", state.count, dirty - failed,
+         state.count - dirty, failed, (unsigned long long)(SDL_GetTicks() - start), jobs);
+
+  free(state.items);
+  flecs_vfs_deinit();
+  return ok && !failed ? 0 : 1;
+}
@@ -0,0 +1,608 @@
+// asset job system
+// decode on worker threads (stbi_load, aiImportFile, font bytes), then the
+// completion queue is drained on LogicUpdatePhase into the module upload
+// callback so the GPU work stays on the main thread.
+
+#include "flecs_asset_jobs.h"
+#include <stdio.h>
+#include <string.h>
+#include <assimp/cimport.h>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+#include <assimp/cfileio.h>
+#include "flecs_sdl.h"
+#include "flecs_vulkan.h"
+#include "flecs_vfs.h"
+
+//#define STB_IMAGE_IMPLEMENTATION // flecs_texture2d.c
+#include "stb_image.h"
+
+#define ASSET_MAX_WORKERS 4
+
+typedef struct AssetJob {
+  struct AssetJob *next;
+  ecs_entity_t entity;
+  char path[ASSET_PATH_MAX];
+  AssetType type;
+  AssetDecodeFn decode;
+  AssetUploadFn upload;
+  AssetResult result;
+  bool success;
+  bool reload;
+} AssetJob;
+
+struct AssetJobQueue {
+  // main -> workers
+  SDL_Mutex *lock;
+  SDL_Condition *cond;
+  AssetJob *pendingHead;
+  AssetJob *pendingTail;
+  bool quit;
+  // workers -> main, lock free stack (single consumer takes all)
+  void *completed;
+  // main thread only, drained but over upload budget
+  AssetJob *readyHead;
+  AssetJob *readyTail;
+  SDL_Thread *workers[ASSET_MAX_WORKERS];
+  int workerCount;
+};
+
+//===============================================
+// assimp aiFileIO over the vfs
+//===============================================
+
+typedef struct {
+  VfsView view;
+  size_t pos;
+} AssetVfsFile;
+
+typedef struct {
+  AssetImportOpenFn onOpen;
+  void *user;
+} AssetImportTracker;
+
+static size_t asset_aifile_read(struct aiFile *file, char *buffer, size_t size, size_t count) {
+  AssetVfsFile *vf = (AssetVfsFile *)file->UserData;
+  if (size == 0 || vf->pos >= vf->view.size) return 0;
+  size_t avail = (vf->view.size - vf->pos) / size;
+  size_t n = count < avail ? count : avail;
+  memcpy(buffer, (const char *)vf->view.data + vf->pos, n * size);
+  vf->pos += n * size;
+  return n;
+}
+
+static size_t asset_aifile_write(struct aiFile *file, const char *buffer, size_t size, size_t count) {
+  return 0; // read only
+}
+
+static size_t asset_aifile_tell(struct aiFile *file) {
+  return ((AssetVfsFile *)file->UserData)->pos;
+}
+
+static size_t asset_aifile_size(struct aiFile *file) {
+  return ((AssetVfsFile *)file->UserData)->view.size;
+}
+
+static enum aiReturn asset_aifile_seek(struct aiFile *file, size_t offset, enum aiOrigin origin) {
+  AssetVfsFile *vf = (AssetVfsFile *)file->UserData;
+  size_t base = origin == aiOrigin_CUR ? vf->pos : origin == aiOrigin_END ? vf->view.size : 0;
+  if (base + offset > vf->view.size) return aiReturn_FAILURE;
+  vf->pos = base + offset;
+  return aiReturn_SUCCESS;
+}
+
+static void asset_aifile_flush(struct aiFile *file) {
+}
+
+static struct aiFile *asset_aifile_open(struct aiFileIO *io, const char *path, const char *mode) {
+  if (strchr(mode, 'w') || strchr(mode, 'a')) return NULL;
+
+  // assimp builds related paths (.mtl) with native separators
+  char fixed[ASSET_PATH_MAX];
+  size_t len = strlen(path);
+  if (len >= sizeof(fixed)) return NULL;
+  for (size_t i = 0; i <= len; i++) fixed[i] = path[i] == '\\' ? '/' : path[i];
+
+  AssetVfsFile *vf = calloc(1, sizeof(AssetVfsFile));
+  struct aiFile *file = calloc(1, sizeof(struct aiFile));
+  if (!vf || !file || !flecs_vfs_open_view(fixed, &vf->view)) {
+    free(vf);
+    free(file);
+    return NULL;
+  }
+  file->ReadProc = asset_aifile_read;
+  file->WriteProc = asset_aifile_write;
+  file->TellProc = asset_aifile_tell;
+  file->FileSizeProc = asset_aifile_size;
+  file->SeekProc = asset_aifile_seek;
+  file->FlushProc = asset_aifile_flush;
+  file->UserData = (aiUserData)vf;
+  AssetImportTracker *tracker = (AssetImportTracker *)io->UserData;
+  if (tracker && tracker->onOpen) tracker->onOpen(tracker->user, fixed);
+  return file;
+}
+
+static void asset_aifile_close(struct aiFileIO *io, struct aiFile *file) {
+  if (!file) return;
+  AssetVfsFile *vf = (AssetVfsFile *)file->UserData;
+  flecs_vfs_close_view(&vf->view);
+  free(vf);
+  free(file);
+}
+
+static const struct aiScene *asset_import_scene_tracked(const char *path, unsigned int flags, AssetImportTracker *tracker) {
+  struct aiFileIO io = { asset_aifile_open, asset_aifile_close, (aiUserData)tracker };
+  return aiImportFileEx(path, flags, &io);
+}
+
+const struct aiScene *flecs_asset_import_scene(const char *path, unsigned int flags) {
+  return asset_import_scene_tracked(path, flags, NULL);
+}
+
+//===============================================
+// decoders (worker thread)
+//===============================================
+
+static bool asset_decode_texture(const char *path, AssetResult *result) {
+  VfsView view;
+  if (!flecs_vfs_open_view(path, &view)) {
+    result->error = "file not found";
+    return false;
+  }
+  result->contentHash = flecs_texture_source_hash(view.data, view.size);
+  result->pixels = stbi_load_from_memory(view.data, (int)view.size, &result->width, &result->height, &result->channels, STBI_rgb_alpha);
+  flecs_vfs_close_view(&view);
+  if (!result->pixels) {
+    result->error = stbi_failure_reason();
+    return false;
+  }
+  result->channels = 4;
+  return true;
+}
+
+// BC1 / BC3 from the texture cache, cooks and writes the cache on a miss
+static bool asset_decode_texture_cooked(const char *path, AssetResult *result) {
+  if (!flecs_texture_load_cooked(path, TEXTURE_COOK_AUTO, &result->cooked)) {
+    // not a format the cooker handles, fall back to plain pixels
+    return asset_decode_texture(path, result);
+  }
+  result->width = (int)result->cooked.width;
+  result->height = (int)result->cooked.height;
+  result->channels = 4;
+  result->contentHash = result->cooked.sourceHash;
+  return true;
+}
+
+bool flecs_asset_import_mesh(const char *path, AssetResult *result, AssetImportOpenFn onOpen, void *user) {
+  AssetImportTracker tracker = { onOpen, user };
+  const struct aiScene *scene = asset_import_scene_tracked(path, aiProcess_Triangulate | aiProcess_FlipUVs, &tracker);
+  if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode || scene->mNumMeshes == 0) {
+    result->error = "assimp import failed";
+    if (scene) aiReleaseImport(scene);
+    return false;
+  }
+
+  struct aiMesh *mesh = scene->mMeshes[0];
+  result->vertexCount = mesh->mNumVertices;
+  result->vertices = malloc(sizeof(Vertex3d) * result->vertexCount);
+  result->indexCount = mesh->mNumFaces * 3;
+  result->indices = malloc(sizeof(uint32_t) * result->indexCount);
+  if (!result->vertices || !result->indices) {
+    result->error = "out of memory";
+    aiReleaseImport(scene);
+    return false;
+  }
+
+  for (uint32_t i = 0; i < mesh->mNumVertices; i++) {
+    result->vertices[i].pos[0] = mesh->mVertices[i].x;
+    result->vertices[i].pos[1] = mesh->mVertices[i].y;
+    result->vertices[i].pos[2] = mesh->mVertices[i].z;
+    result->vertices[i].color[0] = 1.0f;
+    result->vertices[i].color[1] = 1.0f;
+    result->vertices[i].color[2] = 1.0f;
+    result->vertices[i].texCoord[0] = mesh->mTextureCoords[0] ? mesh->mTextureCoords[0][i].x : 0.0f;
+    result->vertices[i].texCoord[1] = mesh->mTextureCoords[0] ? mesh->mTextureCoords[0][i].y : 0.0f;
+  }
+
+  for (uint32_t i = 0; i < mesh->mNumFaces; i++) {
+    struct aiFace face = mesh->mFaces[i];
+    for (uint32_t j = 0; j < face.mNumIndices && j < 3; j++) {
+      result->indices[i * 3 + j] = face.mIndices[j];
+    }
+  }
+
+  aiReleaseImport(scene);
+  return true;
+}
+
+void *flecs_asset_mesh_serialize(const AssetResult *result, size_t *size) {
+  AssetMeshHeader header = {
+    .magic = ASSET_MESH_MAGIC,
+    .version = ASSET_MESH_VERSION,
+    .vertexCount = result->vertexCount,
+    .indexCount = result->indexCount,
+    .vertexSize = sizeof(Vertex3d)
+  };
+  size_t vertexBytes = sizeof(Vertex3d) * result->vertexCount;
+  size_t indexBytes = sizeof(uint32_t) * result->indexCount;
+  uint8_t *blob = malloc(sizeof(header) + vertexBytes + indexBytes);
+  if (!blob) return NULL;
+  memcpy(blob, &header, sizeof(header));
+  memcpy(blob + sizeof(header), result->vertices, vertexBytes);
+  memcpy(blob + sizeof(header) + vertexBytes, result->indices, indexBytes);
+  *size = sizeof(header) + vertexBytes + indexBytes;
+  return blob;
+}
+
+// asset_cooker output, straight copy out of the (mapped) pack entry
+static bool asset_load_cooked_mesh(const char *path, AssetResult *result) {
+  char cookedPath[VFS_PACK_NAME_MAX];
+  if (snprintf(cookedPath, sizeof(cookedPath), "%s%s", path, ASSET_MESH_COOKED_EXT) >= (int)sizeof(cookedPath)) return false;
+  VfsView view;
+  if (!flecs_vfs_exists(cookedPath) || !flecs_vfs_open_view(cookedPath, &view)) return false;
+
+  AssetMeshHeader header;
+  bool ok = view.size >= sizeof(header);
+  if (ok) {
+    memcpy(&header, view.data, sizeof(header));
+    ok = header.magic == ASSET_MESH_MAGIC && header.version == ASSET_MESH_VERSION && header.vertexSize == sizeof(Vertex3d) &&
+         view.size >= sizeof(header) + (uint64_t)header.vertexCount * sizeof(Vertex3d) + (uint64_t)header.indexCount * sizeof(uint32_t);
+  }
+  if (ok) {
+    const uint8_t *data = (const uint8_t *)view.data + sizeof(header);
+    result->vertexCount = header.vertexCount;
+    result->indexCount = header.indexCount;
+    result->vertices = malloc(sizeof(Vertex3d) * header.vertexCount);
+    result->indices = malloc(sizeof(uint32_t) * header.indexCount);
+    ok = result->vertices && result->indices;
+    if (ok) {
+      memcpy(result->vertices, data, sizeof(Vertex3d) * header.vertexCount);
+      memcpy(result->indices, data + sizeof(Vertex3d) * header.vertexCount, sizeof(uint32_t) * header.indexCount);
+      result->contentHash = flecs_texture_source_hash(view.data, view.size);
+    }
+  }
+  flecs_vfs_close_view(&view);
+  if (!ok) {
+    free(result->vertices);
+    free(result->indices);
+    result->vertices = NULL;
+    result->indices = NULL;
+    ecs_err("[asset] bad cooked mesh %s", cookedPath);
+  }
+  return ok;
+}
+
+static bool asset_decode_mesh(const char *path, AssetResult *result) {
+  if (asset_load_cooked_mesh(path, result)) return true;
+  return flecs_asset_import_mesh(path, result, NULL, NULL);
+}
+
+static bool asset_decode_file(const char *path, AssetResult *result) {
+  result->data = flecs_vfs_read_all(path, &result->size);
+  if (!result->data) {
+    result->error = "file not found";
+    return false;
+  }
+  result->contentHash = flecs_texture_source_hash(result->data, result->size);
+  return true;
+}
+
+static AssetDecodeFn asset_default_decoder(AssetType type) {
+  switch (type) {
+    case ASSET_TYPE_TEXTURE: return asset_decode_texture;
+    case ASSET_TYPE_MESH:    return asset_decode_mesh;
+    case ASSET_TYPE_FONT:
+    case ASSET_TYPE_FILE:
+    default:                 return asset_decode_file;
+  }
+}
+
+void flecs_asset_result_free(AssetResult *result) {
+  if (!result) return;
+  if (result->pixels) free(result->pixels); // stbi uses malloc
+  if (result->vertices) free(result->vertices);
+  if (result->indices) free(result->indices);
+  if (result->userData) free(result->userData);
+  if (result->data) free(result->data);
+  flecs_texture_cooked_free(&result->cooked);
+  memset(result, 0, sizeof(AssetResult));
+}
+
+//===============================================
+// queue
+//===============================================
+
+static void asset_completed_push(AssetJobQueue *q, AssetJob *job) {
+  void *head;
+  do {
+    head = SDL_GetAtomicPointer(&q->completed);
+    job->next = head;
+  } while (!SDL_CompareAndSwapAtomicPointer(&q->completed, head, job));
+}
+
+static int asset_worker_main(void *data) {
+  AssetJobQueue *q = data;
+  for (;;) {
+    SDL_LockMutex(q->lock);
+    while (!q->pendingHead && !q->quit) {
+      SDL_WaitCondition(q->cond, q->lock);
+    }
+    if (q->quit) {
+      SDL_UnlockMutex(q->lock);
+      break;
+    }
+    AssetJob *job = q->pendingHead;
+    q->pendingHead = job->next;
+    if (!q->pendingHead) q->pendingTail = NULL;
+    SDL_UnlockMutex(q->lock);
+
+    job->next = NULL;
+    job->success = job->decode(job->path, &job->result);
+    asset_completed_push(q, job);
+  }
+  return 0;
+}
+
+static void asset_job_free(AssetJob *job) {
+  flecs_asset_result_free(&job->result);
+  free(job);
+}
+
+static void asset_job_list_free(AssetJob *job) {
+  while (job) {
+    AssetJob *next = job->next;
+    asset_job_free(job);
+    job = next;
+  }
+}
+
+static bool asset_submit(ecs_world_t *world, ecs_entity_t e, const AssetHandle *handle, bool reload) {
+  AssetJobContext *job_ctx = ecs_singleton_ensure(world, AssetJobContext);
+  if (!job_ctx || !job_ctx->queue) return false;
+
+  AssetJob *job = calloc(1, sizeof(AssetJob));
+  if (!job) {
+    ecs_err("Failed to allocate asset job");
+    return false;
+  }
+  job->entity = e;
+  job->type = handle->type;
+  job->reload = reload;
+  job->decode = handle->decode ? handle->decode : asset_default_decoder(handle->type);
+  if (!handle->decode && !handle->raw && handle->type == ASSET_TYPE_TEXTURE) {
+    VulkanContext *v_ctx = ecs_singleton_ensure(world, VulkanContext);
+    if (v_ctx && v_ctx->textureCompressionBC) job->decode = asset_decode_texture_cooked;
+  }
+  job->upload = handle->upload;
+  memcpy(job->path, handle->path, sizeof(job->path));
+
+  AssetJobQueue *q = job_ctx->queue;
+  SDL_LockMutex(q->lock);
+  if (q->pendingTail) q->pendingTail->next = job;
+  else q->pendingHead = job;
+  q->pendingTail = job;
+  SDL_SignalCondition(q->cond);
+  SDL_UnlockMutex(q->lock);
+
+  job_ctx->pendingCount++;
+  ecs_log(1, "[asset] %s %s", reload ? "reload" : "queued", handle->path);
+  return true;
+}
+
+ecs_entity_t flecs_asset_load(ecs_world_t *world, const AssetLoadDesc *desc) {
+  AssetJobContext *job_ctx = ecs_singleton_ensure(world, AssetJobContext);
+  if (!job_ctx || !job_ctx->queue || !desc || !desc->path) {
+    ecs_err("asset job system not initialized");
+    return 0;
+  }
+
+  AssetHandle handle = {
+    .type = desc->type,
+    .state = ASSET_STATE_LOADING,
+    .decode = desc->decode,
+    .upload = desc->upload,
+    .raw = desc->raw
+  };
+  #ifdef _MSC_VER
+      strncpy_s(handle.path, sizeof(handle.path), desc->path, _TRUNCATE);
+  #else
+      strncpy(handle.path, desc->path, sizeof(handle.path) - 1);
+      handle.path[sizeof(handle.path) - 1] = '\0';
+  #endif
+
+  ecs_entity_t e = ecs_new(world);
+  ecs_set_id(world, e, ecs_id(AssetHandle), sizeof(AssetHandle), &handle);
+  asset_submit(world, e, &handle, false);
+  return e;
+}
+
+bool flecs_asset_reload(ecs_world_t *world, ecs_entity_t asset) {
+  AssetHandle *handle = ecs_get_mut(world, asset, AssetHandle);
+  // first load still running, it will pick up the new file anyway
+  if (!handle || handle->state == ASSET_STATE_LOADING || handle->reloading) return false;
+  if (!asset_submit(world, asset, handle, true)) return false;
+  handle->reloading = true;
+  return true;
+}
+
+//===============================================
+// systems
+//===============================================
+
+static void asset_finish_job(ecs_world_t *world, AssetJob *job) {
+  bool alive = ecs_is_alive(world, job->entity);
+  bool ok = job->success;
+  if (ok && job->upload && alive) {
+    ok = job->upload(world, job->entity, &job->result);
+  }
+  if (!job->success) {
+    ecs_err("[asset] failed %s: %s", job->path, job->result.error ? job->result.error : "unknown");
+  }
+
+  if (alive) {
+    AssetHandle *handle = ecs_get_mut(world, job->entity, AssetHandle);
+    if (handle) {
+      if (job->reload) {
+        // a broken save keeps the old data on screen
+        handle->reloading = false;
+        if (!ok) ecs_err("[asset] reload of %s failed, keeping the old version", job->path);
+      } else {
+        handle->state = ok ? ASSET_STATE_READY : ASSET_STATE_FAILED;
+      }
+      if (ok) {
+        handle->version++;
+        handle->contentHash = job->result.contentHash;
+      }
+      ecs_modified(world, job->entity, AssetHandle);
+    }
+  }
+  asset_job_free(job);
+}
+
+void AssetJobDrainSystem(ecs_iter_t *it) {
+  SDLContext *sdl_ctx = ecs_field(it, SDLContext, 0);
+  if (!sdl_ctx || sdl_ctx->hasError || sdl_ctx->isShutDown) return;
+  AssetJobContext *job_ctx = ecs_field(it, AssetJobContext, 1);
+  if (!job_ctx || !job_ctx->queue || job_ctx->pendingCount == 0) return;
+  AssetJobQueue *q = job_ctx->queue;
+
+  // take everything the workers finished, stack is LIFO so reverse it
+  AssetJob *list = SDL_SetAtomicPointer(&q->completed, NULL);
+  AssetJob *fifo = NULL;
+  while (list) {
+    AssetJob *next = list->next;
+    list->next = fifo;
+    fifo = list;
+    list = next;
+  }
+  if (fifo) {
+    if (q->readyTail) q->readyTail->next = fifo;
+    else q->readyHead = fifo;
+    AssetJob *tail = fifo;
+    while (tail->next) tail = tail->next;
+    q->readyTail = tail;
+  }
+
+  int uploads = 0;
+  bool idle = false;
+  while (q->readyHead && uploads < job_ctx->maxUploadsPerFrame) {
+    AssetJob *job = q->readyHead;
+    q->readyHead = job->next;
+    if (!q->readyHead) q->readyTail = NULL;
+    job->next = NULL;
+    if (job->reload && job->success && !idle) {
+      // frame boundary: nothing in flight, so the upload can rewrite
+      // descriptor sets, old objects go through flecs_vulkan_defer_destroy
+      VulkanContext *v_ctx = ecs_field(it, VulkanContext, 2);
+      if (v_ctx && v_ctx->graphicsQueue) vkQueueWaitIdle(v_ctx->graphicsQueue);
+      idle = true;
+    }
+    asset_finish_job(it->world, job);
+    job_ctx->pendingCount--;
+    uploads++;
+  }
+}
+
+void flecs_asset_jobs_cleanup(ecs_world_t *world) {
+  AssetJobContext *job_ctx = ecs_singleton_ensure(world, AssetJobContext);
+  if (!job_ctx || !job_ctx->queue) return;
+  AssetJobQueue *q = job_ctx->queue;
+
+  ecs_log(1, "Asset jobs cleanup starting...");
+
+  SDL_LockMutex(q->lock);
+  q->quit = true;
+  SDL_BroadcastCondition(q->cond);
+  SDL_UnlockMutex(q->lock);
+
+  for (int i = 0; i < q->workerCount; i++) {
+    if (q->workers[i]) SDL_WaitThread(q->workers[i], NULL);
+  }
+
+  // jobs that never got uploaded, GPU is going away
+  asset_job_list_free(q->pendingHead);
+  asset_job_list_free(SDL_SetAtomicPointer(&q->completed, NULL));
+  asset_job_list_free(q->readyHead);
+
+  SDL_DestroyCondition(q->cond);
+  SDL_DestroyMutex(q->lock);
+  free(q);
+  job_ctx->queue = NULL;
+  job_ctx->pendingCount = 0;
+
+  ecs_log(1, "Asset jobs cleanup completed");
+}
+
+// registry slot, marked cleaned by the cleanup observer
+static ModuleHandle asset_jobs_module_handle = MODULE_HANDLE_NONE;
+
+void asset_jobs_cleanup_event_system(ecs_iter_t *it) {
+  ecs_print(1, "[cleanup] asset_jobs_cleanup_event_system");
+  flecs_asset_jobs_cleanup(it->world);
+  module_set_state(it->world, asset_jobs_module_handle, MODULE_STATE_CLEANED);
+}
+
+void asset_jobs_register_components(ecs_world_t *world) {
+  ECS_COMPONENT_DEFINE(world, AssetHandle);
+  ECS_COMPONENT_DEFINE(world, AssetJobContext);
+}
+
+void asset_jobs_register_systems(ecs_world_t *world) {
+  ecs_observer(world, {
+    .query.terms = {{ EcsAny, .src.id = CleanUpModule }},
+    .events = { CleanUpEvent },
+    .callback = asset_jobs_cleanup_event_system
+  });
+
+  ecs_system_init(world, &(ecs_system_desc_t){
+    .entity = ecs_entity(world, { .name = "AssetJobDrainSystem", .add = ecs_ids(ecs_dependson(GlobalPhases.LogicUpdatePhase)) }),
+    .query.terms = { ECS_SINGLETON_IN(SDLContext), ECS_SINGLETON_INOUT(AssetJobContext), ECS_SINGLETON_INOUT(VulkanContext) },
+    .callback = AssetJobDrainSystem
+  });
+}
+
+void flecs_asset_jobs_module_init(ecs_world_t *world) {
+  ecs_log(1, "Initializing asset jobs module...");
+
+  asset_jobs_register_components(world);
+
+  AssetJobQueue *q = calloc(1, sizeof(AssetJobQueue));
+  if (!q) {
+    ecs_abort(ECS_INTERNAL_ERROR, "Failed to allocate asset job queue");
+  }
+  q->lock = SDL_CreateMutex();
+  q->cond = SDL_CreateCondition();
+  if (!q->lock || !q->cond) {
+    ecs_abort(ECS_INTERNAL_ERROR, SDL_GetError());
+  }
+
+  // leave one core for the main thread
+  int workers = SDL_GetNumLogicalCPUCores() - 1;
+  if (workers < 1) workers = 1;
+  if (workers > ASSET_MAX_WORKERS) workers = ASSET_MAX_WORKERS;
+  for (int i = 0; i < workers; i++) {
+    q->workers[i] = SDL_CreateThread(asset_worker_main, "asset_worker", q);
+    if (!q->workers[i]) {
+      ecs_err("Failed to create asset worker: %s", SDL_GetError());
+      break;
+    }
+    q->workerCount++;
+  }
+  if (q->workerCount == 0) {
+    ecs_abort(ECS_INTERNAL_ERROR, "No asset worker threads");
+  }
+
+  ecs_singleton_set(world, AssetJobContext, {
+    .queue = q,
+    .workerCount = q->workerCount,
+    .pendingCount = 0,
+    .maxUploadsPerFrame = 2
+  });
+
+  asset_jobs_module_handle = module_register(world, "asset_jobs_module");
+
+  asset_jobs_register_systems(world);
+  module_set_state(world, asset_jobs_module_handle, MODULE_STATE_READY);
+
+  ecs_log(1, "Asset jobs module initialized (%d workers)", q->workerCount);
+}
@@ -0,0 +1,342 @@
+// asset registry
+// path and content indexes over asset entities, refcounted through
+// (AssetUses, asset) pairs on the owners
+
+#include "flecs_asset_registry.h"
+#include <stdio.h>
+#include <string.h>
+#include "flecs_utils.h"
+#include "flecs_vulkan.h"
+
+// FNV-1a, continued from h
+static uint64_t registryHash(uint64_t h, const void *data, size_t size) {
+  const uint8_t *bytes = data;
+  for (size_t i = 0; i < size; i++) {
+    h ^= bytes[i];
+    h *= 0x100000001b3ull;
+  }
+  return h;
+}
+
+static uint64_t pathKey(AssetKind kind, const char *path, uint64_t salt) {
+  uint64_t h = 0xcbf29ce484222325ull;
+  h = registryHash(h, &kind, sizeof(kind));
+  h = registryHash(h, &salt, sizeof(salt));
+  h = registryHash(h, path, strlen(path));
+  return h ? h : 1;
+}
+
+static uint64_t contentKey(AssetKind kind, uint64_t contentHash) {
+  return contentHash ^ ((uint64_t)kind + 1) * 0x9e3779b97f4a7c15ull;
+}
+
+// registry context during the frame, NULL once cleanup dropped the maps
+static AssetRegistryContext *registryContext(ecs_world_t *world) {
+  if (!ecs_id(AssetRegistryContext)) return NULL; // module not initialized
+  AssetRegistryContext *ctx = ecs_get_mut(world, ecs_id(AssetRegistryContext), AssetRegistryContext);
+  return ctx && ctx->ready ? ctx : NULL;
+}
+
+bool flecs_asset_normalize_path(const char *path, char *out, size_t size) {
+  if (!path || !out || size == 0) return false;
+  size_t len = 0;
+  size_t segments[ASSET_PATH_MAX / 2];
+  int depth = 0;
+  const char *p = path;
+  while (*p) {
+    while (*p == '/' || *p == '\\') p++;
+    const char *start = p;
+    while (*p && *p != '/' && *p != '\\') p++;
+    size_t n = (size_t)(p - start);
+    if (n == 0 || (n == 1 && start[0] == '.')) continue;
+    if (n == 2 && start[0] == '.' && start[1] == '.' && depth > 0) {
+      len = segments[--depth];
+      continue;
+    }
+    if (depth == (int)(sizeof(segments) / sizeof(segments[0]))) return false;
+    segments[depth++] = len;
+    size_t sep = len ? 1 : 0;
+    if (len + sep + n >= size) return false;
+    if (sep) out[len++] = '/';
+    memcpy(out + len, start, n);
+    len += n;
+  }
+  out[len] = '\0';
+  return len > 0;
+}
+
+//===============================================
+// index
+//===============================================
+
+ecs_entity_t flecs_asset_registry_find(ecs_world_t *world, AssetKind kind, const char *path, uint64_t salt) {
+  AssetRegistryContext *ctx = registryContext(world);
+  char normalised[ASSET_PATH_MAX];
+  if (!ctx || !flecs_asset_normalize_path(path, normalised, sizeof(normalised))) return 0;
+  ecs_map_val_t *found = ecs_map_get(&ctx->paths, pathKey(kind, normalised, salt));
+  if (!found || !ecs_is_alive(world, (ecs_entity_t)*found)) return 0;
+  return (ecs_entity_t)*found;
+}
+
+ecs_entity_t flecs_asset_registry_find_content(ecs_world_t *world, AssetKind kind, uint64_t contentHash) {
+  AssetRegistryContext *ctx = registryContext(world);
+  if (!ctx || !contentHash) return 0;
+  ecs_map_val_t *found = ecs_map_get(&ctx->contents, contentKey(kind, contentHash));
+  if (!found || !ecs_is_alive(world, (ecs_entity_t)*found)) return 0;
+  return (ecs_entity_t)*found;
+}
+
+// indexes right away, the entry itself may be deferred until the system ends
+static void registryInsert(ecs_world_t *world, AssetRegistryContext *ctx, ecs_entity_t asset, AssetKind kind, const char *path, uint64_t salt, uint64_t contentHash) {
+  AssetRegistryEntry entry = { .kind = kind, .contentHash = contentHash };
+  if (path && flecs_asset_normalize_path(path, entry.path, sizeof(entry.path))) {
+    entry.key = pathKey(kind, entry.path, salt);
+    ecs_map_insert(&ctx->paths, entry.key, (ecs_map_val_t)asset);
+  }
+  if (contentHash) ecs_map_insert(&ctx->contents, contentKey(kind, contentHash), (ecs_map_val_t)asset);
+  ecs_set_id(world, asset, ecs_id(AssetRegistryEntry), sizeof(AssetRegistryEntry), &entry);
+  ctx->loads++;
+}
+
+void flecs_asset_registry_add(ecs_world_t *world, ecs_entity_t asset, AssetKind kind, const char *path, uint64_t salt) {
+  AssetRegistryContext *ctx = registryContext(world);
+  if (!ctx || !asset) return;
+  registryInsert(world, ctx, asset, kind, path, salt, 0);
+}
+
+void flecs_asset_registry_set_content(ecs_world_t *world, ecs_entity_t asset, uint64_t contentHash) {
+  AssetRegistryContext *ctx = registryContext(world);
+  AssetRegistryEntry *entry = ecs_get_mut(world, asset, AssetRegistryEntry);
+  if (!ctx || !entry || entry->contentHash == contentHash) return;
+
+  // hot reload changed the bytes, drop the old index if it was ours
+  if (entry->contentHash) {
+    uint64_t old = contentKey(entry->kind, entry->contentHash);
+    ecs_map_val_t *found = ecs_map_get(&ctx->contents, old);
+    if (found && (ecs_entity_t)*found == asset) ecs_map_remove(&ctx->contents, old);
+  }
+  entry->contentHash = contentHash;
+  if (!contentHash) return;
+
+  uint64_t key = contentKey(entry->kind, contentHash);
+  ecs_map_val_t *found = ecs_map_get(&ctx->contents, key);
+  if (!found || !ecs_is_alive(world, (ecs_entity_t)*found)) {
+    ecs_map_insert(&ctx->contents, key, (ecs_map_val_t)asset);
+  } else if ((ecs_entity_t)*found != asset) {
+    const AssetRegistryEntry *first = ecs_get(world, (ecs_entity_t)*found, AssetRegistryEntry);
+    ecs_log(1, "[asset_registry] %s has the same content as %s", entry->path, first ? first->path : "?");
+  }
+}
+
+//===============================================
+// ownership
+//===============================================
+
+void flecs_asset_use(ecs_world_t *world, ecs_entity_t owner, ecs_entity_t asset) {
+  if (!owner || !asset) return;
+  ecs_add_pair(world, owner, AssetUses, asset);
+}
+
+void flecs_asset_release(ecs_world_t *world, ecs_entity_t owner, ecs_entity_t asset) {
+  if (!owner || !asset || !ecs_is_alive(world, owner)) return;
+  ecs_remove_pair(world, owner, AssetUses, asset);
+}
+
+ecs_entity_t flecs_asset_acquire(ecs_world_t *world, ecs_entity_t owner, const AssetLoadDesc *desc) {
+  AssetRegistryContext *ctx = registryContext(world);
+  if (!ctx || !desc || !desc->path) {
+    ecs_err("asset registry not initialized");
+    return 0;
+  }
+  char path[ASSET_PATH_MAX];
+  if (!flecs_asset_normalize_path(desc->path, path, sizeof(path))) {
+    ecs_err("[asset_registry] bad path %s", desc->path);
+    return 0;
+  }
+
+  // the same file through another decoder/upload is a different product
+  uint64_t salt = 0xcbf29ce484222325ull;
+  salt = registryHash(salt, &desc->type, sizeof(desc->type));
+  salt = registryHash(salt, &desc->decode, sizeof(desc->decode));
+  salt = registryHash(salt, &desc->upload, sizeof(desc->upload));
+  salt = registryHash(salt, &desc->raw, sizeof(desc->raw));
+
+  ecs_entity_t asset = flecs_asset_registry_find(world, ASSET_KIND_HANDLE, path, salt);
+  if (asset) {
+    ctx->hits++;
+    ecs_log(1, "[asset_registry] shared %s", path);
+  } else {
+    AssetLoadDesc normalised = *desc;
+    normalised.path = path;
+    asset = flecs_asset_load(world, &normalised);
+    if (!asset) return 0;
+    flecs_asset_registry_add(world, asset, ASSET_KIND_HANDLE, path, salt);
+  }
+  flecs_asset_use(world, owner, asset);
+  return asset;
+}
+
+ecs_entity_t flecs_asset_shader_acquire(ecs_world_t *world, ecs_entity_t owner, const uint32_t *code, size_t codeSize) {
+  AssetRegistryContext *ctx = registryContext(world);
+  VulkanContext *v_ctx = ecs_singleton_ensure(world, VulkanContext);
+  if (!ctx || !v_ctx || !v_ctx->device || !code || !codeSize) return 0;
+
+  uint64_t hash = registryHash(0xcbf29ce484222325ull, code, codeSize);
+  ecs_entity_t shader = flecs_asset_registry_find_content(world, ASSET_KIND_SHADER, hash);
+  if (shader) {
+    ctx->hits++;
+  } else {
+    VkShaderModule module = createShaderModuleH(v_ctx->device, code, codeSize);
+    if (!module) return 0;
+    shader = ecs_new(world);
+    ecs_set(world, shader, ShaderAsset, { .module = module, .codeSize = codeSize });
+    registryInsert(world, ctx, shader, ASSET_KIND_SHADER, NULL, 0, hash);
+    ecs_map_insert(&ctx->shaders, (ecs_map_key_t)shader, (ecs_map_val_t)module);
+  }
+  flecs_asset_use(world, owner, shader);
+  return shader;
+}
+
+VkShaderModule flecs_asset_shader_module(ecs_world_t *world, ecs_entity_t shader) {
+  AssetRegistryContext *ctx = registryContext(world);
+  ecs_map_val_t *module = ctx && shader ? ecs_map_get(&ctx->shaders, (ecs_map_key_t)shader) : NULL;
+  return module ? (VkShaderModule)*module : VK_NULL_HANDLE;
+}
+
+//===============================================
+// hooks and observers
+//===============================================
+
+static void AssetRegistryEntryRemove(ecs_iter_t *it) {
+  AssetRegistryContext *ctx = registryContext(it->world);
+  if (!ctx) return;
+  AssetRegistryEntry *entries = ecs_field(it, AssetRegistryEntry, 0);
+  for (int i = 0; i < it->count; i++) {
+    ecs_map_val_t *found = entries[i].key ? ecs_map_get(&ctx->paths, entries[i].key) : NULL;
+    if (found && (ecs_entity_t)*found == it->entities[i]) ecs_map_remove(&ctx->paths, entries[i].key);
+    if (entries[i].contentHash) {
+      uint64_t key = contentKey(entries[i].kind, entries[i].contentHash);
+      found = ecs_map_get(&ctx->contents, key);
+      if (found && (ecs_entity_t)*found == it->entities[i]) ecs_map_remove(&ctx->contents, key);
+    }
+  }
+}
+
+static void ShaderAssetRemove(ecs_iter_t *it) {
+  AssetRegistryContext *ctx = registryContext(it->world);
+  const VulkanContext *v_ctx = ecs_get(it->world, ecs_id(VulkanContext), VulkanContext);
+  ShaderAsset *shaders = ecs_field(it, ShaderAsset, 0);
+  for (int i = 0; i < it->count; i++) {
+    if (ctx) ecs_map_remove(&ctx->shaders, (ecs_map_key_t)it->entities[i]);
+    // pipelines keep their own copy, the module can go right away
+    if (v_ctx && v_ctx->device && shaders[i].module) vkDestroyShaderModule(v_ctx->device, shaders[i].module, NULL);
+    shaders[i].module = VK_NULL_HANDLE;
+  }
+}
+
+// the content hash of an AssetHandle is known after its upload
+void AssetRegistryHandleObserver(ecs_iter_t *it) {
+  AssetHandle *handles = ecs_field(it, AssetHandle, 0);
+  for (int i = 0; i < it->count; i++) {
+    if (handles[i].contentHash) flecs_asset_registry_set_content(it->world, it->entities[i], handles[i].contentHash);
+  }
+}
+
+void AssetUsesAddObserver(ecs_iter_t *it) {
+  ecs_entity_t asset = ecs_pair_second(it->world, ecs_field_id(it, 0));
+  AssetRegistryEntry *entry = asset ? ecs_get_mut(it->world, asset, AssetRegistryEntry) : NULL;
+  if (entry) entry->refCount += it->count;
+}
+
+// last owner gone: delete the asset, its OnRemove hooks free the resources
+void AssetUsesRemoveObserver(ecs_iter_t *it) {
+  if (ecs_is_fini(it->world)) return;
+  ecs_entity_t asset = ecs_pair_second(it->world, ecs_field_id(it, 0));
+  AssetRegistryEntry *entry = asset ? ecs_get_mut(it->world, asset, AssetRegistryEntry) : NULL;
+  if (!entry) return; // the asset itself is being deleted
+  entry->refCount -= it->count;
+  if (entry->refCount > 0) return;
+  ecs_log(1, "[asset_registry] released %s", entry->path[0] ? entry->path : "(content)");
+  ecs_delete(it->world, asset);
+}
+
+//===============================================
+// module
+//===============================================
+
+void flecs_asset_registry_cleanup(ecs_world_t *world) {
+  AssetRegistryContext *ctx = registryContext(world);
+  if (!ctx) return;
+  ecs_log(1, "Asset registry cleanup starting...");
+  ecs_log(1, "[asset_registry] %u loads, %u shared acquires", ctx->loads, ctx->hits);
+  ctx->ready = false;
+  ecs_map_fini(&ctx->paths);
+  ecs_map_fini(&ctx->contents);
+  ecs_map_fini(&ctx->shaders);
+  ecs_log(1, "Asset registry cleanup completed");
+}
+
+// registry slot, marked cleaned by the cleanup observer
+static ModuleHandle asset_registry_module_handle = MODULE_HANDLE_NONE;
+
+void asset_registry_cleanup_event_system(ecs_iter_t *it) {
+  ecs_print(1, "[cleanup] asset_registry_cleanup_event_system");
+  flecs_asset_registry_cleanup(it->world);
+  module_set_state(it->world, asset_registry_module_handle, MODULE_STATE_CLEANED);
+}
+
+void asset_registry_register_components(ecs_world_t *world) {
+  ECS_COMPONENT_DEFINE(world, AssetRegistryEntry);
+  ECS_COMPONENT_DEFINE(world, ShaderAsset);
+  ECS_COMPONENT_DEFINE(world, AssetRegistryContext);
+  ECS_TAG_DEFINE(world, AssetUses);
+
+  ecs_set_hooks(world, AssetRegistryEntry, { .on_remove = AssetRegistryEntryRemove });
+  ecs_set_hooks(world, ShaderAsset, { .on_remove = ShaderAssetRemove });
+}
+
+void asset_registry_register_systems(ecs_world_t *world) {
+  ecs_observer(world, {
+    .query.terms = {{ EcsAny, .src.id = CleanUpModule }},
+    .events = { CleanUpEvent },
+    .callback = asset_registry_cleanup_event_system
+  });
+
+  ecs_observer(world, {
+    .query.terms = {{ ecs_id(AssetHandle) }, { ecs_id(AssetRegistryEntry) }},
+    .events = { EcsOnSet },
+    .callback = AssetRegistryHandleObserver
+  });
+
+  ecs_observer(world, {
+    .query.terms = {{ ecs_pair(AssetUses, EcsWildcard) }},
+    .events = { EcsOnAdd },
+    .callback = AssetUsesAddObserver
+  });
+
+  ecs_observer(world, {
+    .query.terms = {{ ecs_pair(AssetUses, EcsWildcard) }},
+    .events = { EcsOnRemove },
+    .callback = AssetUsesRemoveObserver
+  });
+}
+
+void flecs_asset_registry_module_init(ecs_world_t *world) {
+  ecs_log(1, "Initializing asset registry module...");
+
+  asset_registry_register_components(world);
+
+  AssetRegistryContext *ctx = ecs_singleton_ensure(world, AssetRegistryContext);
+  ecs_map_init(&ctx->paths, NULL);
+  ecs_map_init(&ctx->contents, NULL);
+  ecs_map_init(&ctx->shaders, NULL);
+  ctx->ready = true;
+  ecs_singleton_modified(world, AssetRegistryContext);
+
+  asset_registry_module_handle = module_register(world, "asset_registry_module");
+
+  asset_registry_register_systems(world);
+  module_set_state(world, asset_registry_module_handle, MODULE_STATE_READY);
+
+  ecs_log(1, "Asset registry module initialized");
+}
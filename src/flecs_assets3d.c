@@ -5,6 +5,9 @@
 #include "flecs_sdl.h"
 #include "flecs_vulkan.h"
 #include "flecs_utils.h"
+#include "flecs_asset_jobs.h"
+#include "flecs_asset_registry.h"
+#include "flecs_timestep.h"
 #include "shaders/assets3d_shader3d_vert.spv.h"
 #include "shaders/assets3d_shader3d_frag.spv.h"
 #include <cglm/cglm.h> // Include cglm
@@ -15,42 +18,6 @@ typedef struct {
   mat4 proj;
 } UniformBufferObject;
 
-// Helper to load model using Assets3d
-static bool Assets3d_load_model(const char *filePath, Vertex3d **vertices, uint32_t *vertexCount, uint32_t **indices, uint32_t *indexCount) {
-  const struct aiScene *scene = aiImportFile(filePath, aiProcess_Triangulate | aiProcess_FlipUVs);
-  if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
-      ecs_err("Assets3d error: %s", aiGetErrorString());
-      return false;
-  }
-
-  struct aiMesh *mesh = scene->mMeshes[0];
-  *vertexCount = mesh->mNumVertices;
-  *vertices = malloc(sizeof(Vertex3d) * (*vertexCount));
-  *indexCount = mesh->mNumFaces * 3;
-  *indices = malloc(sizeof(uint32_t) * (*indexCount));
-
-  for (uint32_t i = 0; i < mesh->mNumVertices; i++) {
-      (*vertices)[i].pos[0] = mesh->mVertices[i].x;
-      (*vertices)[i].pos[1] = mesh->mVertices[i].y;
-      (*vertices)[i].pos[2] = mesh->mVertices[i].z;
-      (*vertices)[i].color[0] = 1.0f;
-      (*vertices)[i].color[1] = 1.0f;
-      (*vertices)[i].color[2] = 1.0f;
-      (*vertices)[i].texCoord[0] = mesh->mTextureCoords[0] ? mesh->mTextureCoords[0][i].x : 0.0f;
-      (*vertices)[i].texCoord[1] = mesh->mTextureCoords[0] ? mesh->mTextureCoords[0][i].y : 0.0f;
-  }
-
-  for (uint32_t i = 0; i < mesh->mNumFaces; i++) {
-      struct aiFace face = mesh->mFaces[i];
-      for (uint32_t j = 0; j < face.mNumIndices; j++) {
-          (*indices)[i * 3 + j] = face.mIndices[j];
-      }
-  }
-
-  aiReleaseImport(scene);
-  return true;
-}
-
 // Create uniform buffer
 static bool Assets3d_create_uniform_buffer(VulkanContext *v_ctx, Assets3DModelContext *assets3d_ctx, SDLContext *sdl_ctx) {
   VkDeviceSize bufferSize = sizeof(UniformBufferObject);
@@ -98,26 +65,31 @@ static bool Assets3d_create_uniform_buffer(VulkanContext *v_ctx, Assets3DModelCo
   return true;
 }
 
-// Setup system
-void Assets3dModelSetupSystem(ecs_iter_t *it) {
-  ecs_log(1, "Assets3dModelSetupSystem");
-
-  SDLContext *sdl_ctx = ecs_singleton_ensure(it->world, SDLContext);
-  if (!sdl_ctx || sdl_ctx->hasError) return;
-  VulkanContext *v_ctx = ecs_singleton_ensure(it->world, VulkanContext);
-  if (!v_ctx) return;
-  Assets3DModelContext *assets3d_ctx = ecs_singleton_ensure(it->world, Assets3DModelContext);
-  if (!assets3d_ctx) return;
-
-  // Load model
-  Vertex3d *vertices = NULL;
-  uint32_t *indices = NULL;
-  if (!Assets3d_load_model("assets/cube.obj", &vertices, &assets3d_ctx->assets3d_vertexCount, &indices, &assets3d_ctx->assets3d_indexCount)) {
-      ecs_err("Failed to load model");
-      sdl_ctx->hasError = true;
-      sdl_ctx->errorMessage = "Failed to load model";
-      return;
-  }
+// Upload mesh decoded on the asset worker (main thread, AssetJobDrainSystem)
+static bool Assets3dUploadMesh(ecs_world_t *world, ecs_entity_t asset, AssetResult *result) {
+  SDLContext *sdl_ctx = ecs_singleton_ensure(world, SDLContext);
+  if (!sdl_ctx || sdl_ctx->hasError) return false;
+  VulkanContext *v_ctx = ecs_singleton_ensure(world, VulkanContext);
+  if (!v_ctx) return false;
+  Assets3DModelContext *assets3d_ctx = ecs_singleton_ensure(world, Assets3DModelContext);
+  if (!assets3d_ctx) return false;
+
+  // hot reload, the old buffers may still be used by the frame in flight
+  if (assets3d_ctx->assets3d_vertexBuffer != VK_NULL_HANDLE) {
+      flecs_vulkan_defer_destroy(v_ctx, VK_OBJECT_TYPE_BUFFER, (uint64_t)assets3d_ctx->assets3d_vertexBuffer);
+      flecs_vulkan_defer_destroy(v_ctx, VK_OBJECT_TYPE_DEVICE_MEMORY, (uint64_t)assets3d_ctx->assets3d_vertexBufferMemory);
+      flecs_vulkan_defer_destroy(v_ctx, VK_OBJECT_TYPE_BUFFER, (uint64_t)assets3d_ctx->assets3d_indexBuffer);
+      flecs_vulkan_defer_destroy(v_ctx, VK_OBJECT_TYPE_DEVICE_MEMORY, (uint64_t)assets3d_ctx->assets3d_indexBufferMemory);
+      assets3d_ctx->assets3d_vertexBuffer = VK_NULL_HANDLE;
+      assets3d_ctx->assets3d_vertexBufferMemory = VK_NULL_HANDLE;
+      assets3d_ctx->assets3d_indexBuffer = VK_NULL_HANDLE;
+      assets3d_ctx->assets3d_indexBufferMemory = VK_NULL_HANDLE;
+  }
+
+  Vertex3d *vertices = result->vertices;
+  uint32_t *indices = result->indices;
+  assets3d_ctx->assets3d_vertexCount = result->vertexCount;
+  assets3d_ctx->assets3d_indexCount = result->indexCount;
 
   // Vertex Buffer Setup
   VkDeviceSize vertexBufferSize = sizeof(Vertex3d) * assets3d_ctx->assets3d_vertexCount;
@@ -130,9 +102,7 @@ void Assets3dModelSetupSystem(ecs_iter_t *it) {
       ecs_err("Failed to create Assets3d vertex buffer");
       sdl_ctx->hasError = true;
       sdl_ctx->errorMessage = "Failed to create Assets3d vertex buffer";
-      free(vertices);
-      free(indices);
-      return;
+      return false;
   }
 
   VkMemoryRequirements vertexMemRequirements;
@@ -154,18 +124,14 @@ void Assets3dModelSetupSystem(ecs_iter_t *it) {
       ecs_err("Failed to allocate Assets3d vertex buffer memory");
       sdl_ctx->hasError = true;
       sdl_ctx->errorMessage = "Failed to allocate Assets3d vertex buffer memory";
-      free(vertices);
-      free(indices);
-      return;
+      return false;
   }
 
   if (vkBindBufferMemory(v_ctx->device, assets3d_ctx->assets3d_vertexBuffer, assets3d_ctx->assets3d_vertexBufferMemory, 0) != VK_SUCCESS) {
       ecs_err("Failed to bind Assets3d vertex buffer memory");
       sdl_ctx->hasError = true;
       sdl_ctx->errorMessage = "Failed to bind Assets3d vertex buffer memory";
-      free(vertices);
-      free(indices);
-      return;
+      return false;
   }
 
   void *vertexData;
@@ -173,13 +139,10 @@ void Assets3dModelSetupSystem(ecs_iter_t *it) {
       ecs_err("Failed to map Assets3d vertex buffer memory");
       sdl_ctx->hasError = true;
       sdl_ctx->errorMessage = "Failed to map Assets3d vertex buffer memory";
-      free(vertices);
-      free(indices);
-      return;
+      return false;
   }
   memcpy(vertexData, vertices, (size_t)vertexBufferSize);
   vkUnmapMemory(v_ctx->device, assets3d_ctx->assets3d_vertexBufferMemory);
-  free(vertices);
 
   // Index Buffer Setup (unchanged)
   VkDeviceSize indexBufferSize = sizeof(uint32_t) * assets3d_ctx->assets3d_indexCount;
@@ -192,8 +155,7 @@ void Assets3dModelSetupSystem(ecs_iter_t *it) {
       ecs_err("Failed to create Assets3d index buffer");
       sdl_ctx->hasError = true;
       sdl_ctx->errorMessage = "Failed to create Assets3d index buffer";
-      free(indices);
-      return;
+      return false;
   }
 
   VkMemoryRequirements indexMemRequirements;
@@ -213,16 +175,14 @@ void Assets3dModelSetupSystem(ecs_iter_t *it) {
       ecs_err("Failed to allocate Assets3d index buffer memory");
       sdl_ctx->hasError = true;
       sdl_ctx->errorMessage = "Failed to allocate Assets3d index buffer memory";
-      free(indices);
-      return;
+      return false;
   }
 
   if (vkBindBufferMemory(v_ctx->device, assets3d_ctx->assets3d_indexBuffer, assets3d_ctx->assets3d_indexBufferMemory, 0) != VK_SUCCESS) {
       ecs_err("Failed to bind Assets3d index buffer memory");
       sdl_ctx->hasError = true;
       sdl_ctx->errorMessage = "Failed to bind Assets3d index buffer memory";
-      free(indices);
-      return;
+      return false;
   }
 
   void *indexData;
@@ -230,12 +190,32 @@ void Assets3dModelSetupSystem(ecs_iter_t *it) {
       ecs_err("Failed to map Assets3d index buffer memory");
       sdl_ctx->hasError = true;
       sdl_ctx->errorMessage = "Failed to map Assets3d index buffer memory";
-      free(indices);
-      return;
+      return false;
   }
   memcpy(indexData, indices, (size_t)indexBufferSize);
   vkUnmapMemory(v_ctx->device, assets3d_ctx->assets3d_indexBufferMemory);
-  free(indices);
+
+  ecs_log(1, "Assets3d mesh uploaded (%u vertices)", assets3d_ctx->assets3d_vertexCount);
+  return true;
+}
+
+// Setup system
+void Assets3dModelSetupSystem(ecs_iter_t *it) {
+  ecs_log(1, "Assets3dModelSetupSystem");
+
+  SDLContext *sdl_ctx = ecs_singleton_ensure(it->world, SDLContext);
+  if (!sdl_ctx || sdl_ctx->hasError) return;
+  VulkanContext *v_ctx = ecs_singleton_ensure(it->world, VulkanContext);
+  if (!v_ctx) return;
+  Assets3DModelContext *assets3d_ctx = ecs_singleton_ensure(it->world, Assets3DModelContext);
+  if (!assets3d_ctx) return;
+
+  // Load model on asset worker, buffers are created in Assets3dUploadMesh
+  assets3d_ctx->assets3d_meshAsset = flecs_asset_acquire(it->world, ecs_id(Assets3DModelContext), &(AssetLoadDesc){
+    .path = "assets/cube.obj",
+    .type = ASSET_TYPE_MESH,
+    .upload = Assets3dUploadMesh
+  });
 
   // Uniform Buffer Setup
   if (!Assets3d_create_uniform_buffer(v_ctx, assets3d_ctx, sdl_ctx)) {
@@ -419,12 +399,11 @@ void Assets3dModelSetupSystem(ecs_iter_t *it) {
 }
 
 // Update uniform buffer
-static void Assets3d_update_uniform_buffer(VulkanContext *v_ctx, Assets3DModelContext *assets3d_ctx, SDLContext *sdl_ctx, float time) {
+static void Assets3d_update_uniform_buffer(VulkanContext *v_ctx, Assets3DModelContext *assets3d_ctx, SDLContext *sdl_ctx, const WorldTransform *model) {
   UniformBufferObject ubo;
 
-  // Model matrix: rotate around Y-axis
-  glm_mat4_identity(ubo.model);
-  glm_rotate_y(ubo.model, time, ubo.model);
+  // Model matrix: the model entity's WorldTransform
+  glm_mat4_copy((vec4 *)model->matrix, ubo.model);
 
   // View matrix: camera at (0, 0, 5) looking at origin
   vec3 eye = {0.0f, 0.0f, 5.0f};
@@ -443,28 +422,37 @@ static void Assets3d_update_uniform_buffer(VulkanContext *v_ctx, Assets3DModelCo
   vkUnmapMemory(v_ctx->device, assets3d_ctx->assets3d_uniformBufferMemory);
 }
 
+// Fixed tick, spin the model around the Y axis
+void Assets3dModelSimSystem(ecs_iter_t *it) {
+  SimTransform *model = ecs_field(it, SimTransform, 0);
+  versor spin;
+  glm_quatv(spin, it->delta_time, (vec3){0.0f, 1.0f, 0.0f});
+  glm_quat_mul(spin, model->rotation, model->rotation);
+  glm_quat_normalize(model->rotation);
+}
+
 // Update uniform buffer system
 void Assets3dModelUpdateSystem(ecs_iter_t *it) {
-  SDLContext *sdl_ctx = ecs_singleton_ensure(it->world, SDLContext);
+  SDLContext *sdl_ctx = ecs_field(it, SDLContext, 0);
   if (!sdl_ctx || sdl_ctx->hasError || sdl_ctx->isShutDown) return;
-  VulkanContext *v_ctx = ecs_singleton_ensure(it->world, VulkanContext);
+  VulkanContext *v_ctx = ecs_field(it, VulkanContext, 1);
   if (!v_ctx) return;
-  Assets3DModelContext *assets3d_ctx = ecs_singleton_ensure(it->world, Assets3DModelContext);
+  Assets3DModelContext *assets3d_ctx = ecs_field(it, Assets3DModelContext, 2);
   if (!assets3d_ctx) return;
+  const WorldTransform *model = ecs_field(it, WorldTransform, 3);
 
-  static float time = 0.0f;
-  time += it->delta_time;
-  Assets3d_update_uniform_buffer(v_ctx, assets3d_ctx, sdl_ctx, time);
+  Assets3d_update_uniform_buffer(v_ctx, assets3d_ctx, sdl_ctx, model);
 }
 
 // Render system
 void Assets3dModelRenderSystem(ecs_iter_t *it) {
-  SDLContext *sdl_ctx = ecs_singleton_ensure(it->world, SDLContext);
+  SDLContext *sdl_ctx = ecs_field(it, SDLContext, 0);
   if (!sdl_ctx || sdl_ctx->hasError || sdl_ctx->isShutDown) return;
-  VulkanContext *v_ctx = ecs_singleton_ensure(it->world, VulkanContext);
+  VulkanContext *v_ctx = ecs_field(it, VulkanContext, 1);
   if (!v_ctx) return;
-  Assets3DModelContext *assets3d_ctx = ecs_singleton_ensure(it->world, Assets3DModelContext);
+  Assets3DModelContext *assets3d_ctx = ecs_field(it, Assets3DModelContext, 2);
   if (!assets3d_ctx) return;
+  if (assets3d_ctx->assets3d_vertexBuffer == VK_NULL_HANDLE || assets3d_ctx->assets3d_indexCount == 0) return; // still loading
 
   vkCmdBindPipeline(v_ctx->commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, assets3d_ctx->assets3d_graphicsPipeline);
   VkDeviceSize offsets[] = {0};
@@ -523,15 +511,22 @@ void flecs_Assets3d_model_cleanup(ecs_world_t *world) {
       vkDestroyPipelineLayout(v_ctx->device, ctx->assets3d_pipelineLayout, NULL);
       ctx->assets3d_pipelineLayout = VK_NULL_HANDLE;
   }
+  // releasing moves the context to another table, clear the field first
+  ecs_entity_t mesh = ctx->assets3d_meshAsset;
+  ctx->assets3d_meshAsset = 0;
+  flecs_asset_release(world, ecs_id(Assets3DModelContext), mesh);
 
   ecs_log(1, "Assets3d model cleanup completed");
 }
 
+// registry slot, marked cleaned by the cleanup observer
+static ModuleHandle assets3d_module_handle = MODULE_HANDLE_NONE;
+
 // Cleanup system
 void Assets3d_model_cleanup_event_system(ecs_iter_t *it) {
   ecs_print(1, "[cleanup] Assets3d_model_cleanup_event_system");
   flecs_Assets3d_model_cleanup(it->world);
-  module_break_name(it, "Assets3d_model_module");
+  module_set_state(it->world, assets3d_module_handle, MODULE_STATE_CLEANED);
 }
 
 // Register components
@@ -552,13 +547,25 @@ void Assets3d_model_register_systems(ecs_world_t *world) {
         .callback = Assets3dModelSetupSystem
     });
 
+    ecs_entity_t model = ecs_singleton_get(world, Assets3DModelContext)->assets3d_model;
+
     ecs_system_init(world, &(ecs_system_desc_t){
-        .entity = ecs_entity(world, { .name = "Assets3dModelUpdateSystem", .add = ecs_ids(ecs_dependson(GlobalPhases.LogicUpdatePhase)) }),
+        .entity = ecs_entity(world, { .name = "Assets3dModelSimSystem", .add = ecs_ids(GlobalPhases.FixedUpdatePhase) }),
+        .query.terms = {{ ecs_id(SimTransform), .src.id = model, .inout = EcsInOut }},
+        .callback = Assets3dModelSimSystem
+    });
+
+    // after TransformPhase built the model matrix, and after the frame fence
+    // wait so the uniform buffer is not in use
+    ecs_system_init(world, &(ecs_system_desc_t){
+        .entity = ecs_entity(world, { .name = "Assets3dModelUpdateSystem", .add = ecs_ids(ecs_dependson(GlobalPhases.BeginCMDBufferPhase)) }),
+        .query.terms = { ECS_SINGLETON_IN(SDLContext), ECS_SINGLETON_IN(VulkanContext), ECS_SINGLETON_INOUT(Assets3DModelContext), { ecs_id(WorldTransform), .src.id = model, .inout = EcsIn } },
         .callback = Assets3dModelUpdateSystem
     });
 
     ecs_system_init(world, &(ecs_system_desc_t){
         .entity = ecs_entity(world, { .name = "Assets3dModelRenderSystem", .add = ecs_ids(ecs_dependson(GlobalPhases.CMDBufferPhase)) }),
+        .query.terms = { ECS_SINGLETON_IN(SDLContext), ECS_SINGLETON_IN(VulkanContext), ECS_SINGLETON_IN(Assets3DModelContext) },
         .callback = Assets3dModelRenderSystem
     });
 }
@@ -569,12 +576,16 @@ void flecs_assets3d_module_init(ecs_world_t *world){
 
   Assets3d_register_components(world);
 
-  ecs_singleton_set(world, Assets3DModelContext, {0});
+  // blended from the fixed tick into LocalTransform, WorldTransform by TransformPhase
+  ecs_entity_t model = ecs_entity(world, { .name = "Assets3dModel" });
+  flecs_timestep_set_transform(world, model, &TRANSFORM_IDENTITY);
+
+  ecs_singleton_set(world, Assets3DModelContext, { .assets3d_model = model });
 
-  ecs_entity_t e = ecs_new(world);
-  ecs_set(world, e, PluginModule, { .name = "Assets3d_model_module", .isCleanUp = false });
+  assets3d_module_handle = module_register(world, "Assets3d_model_module");
 
   Assets3d_model_register_systems(world);
+  module_set_state(world, assets3d_module_handle, MODULE_STATE_READY);
 
   ecs_log(1, "Assets3d module initialized");
 }
@@ -5,6 +5,7 @@
 #include "flecs_sdl.h"
 #include "flecs_vulkan.h"
 #include "flecs_utils.h"
+#include "flecs_asset_jobs.h" // flecs_asset_import_scene (vfs)
 #include "shaders/assimp_shader3d_vert.spv.h"
 #include "shaders/assimp_shader3d_frag.spv.h"
 #include <cglm/cglm.h> // Include cglm
@@ -17,7 +18,7 @@ typedef struct {
 
 // Helper to load model using Assimp
 static bool assimp_load_model(const char *filePath, Vertex3d **vertices, uint32_t *vertexCount, uint32_t **indices, uint32_t *indexCount) {
-  const struct aiScene *scene = aiImportFile(filePath, aiProcess_Triangulate | aiProcess_FlipUVs);
+  const struct aiScene *scene = flecs_asset_import_scene(filePath, aiProcess_Triangulate | aiProcess_FlipUVs);
   if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
       ecs_err("Assimp error: %s", aiGetErrorString());
       return false;
@@ -445,11 +446,11 @@ static void assimp_update_uniform_buffer(VulkanContext *v_ctx, AssimpModelContex
 
 // Update uniform buffer system
 void AssimpModelUpdateSystem(ecs_iter_t *it) {
-  SDLContext *sdl_ctx = ecs_singleton_ensure(it->world, SDLContext);
+  SDLContext *sdl_ctx = ecs_field(it, SDLContext, 0);
   if (!sdl_ctx || sdl_ctx->hasError || sdl_ctx->isShutDown) return;
-  VulkanContext *v_ctx = ecs_singleton_ensure(it->world, VulkanContext);
+  VulkanContext *v_ctx = ecs_field(it, VulkanContext, 1);
   if (!v_ctx) return;
-  AssimpModelContext *assimp_ctx = ecs_singleton_ensure(it->world, AssimpModelContext);
+  AssimpModelContext *assimp_ctx = ecs_field(it, AssimpModelContext, 2);
   if (!assimp_ctx) return;
 
   static float time = 0.0f;
@@ -459,11 +460,11 @@ void AssimpModelUpdateSystem(ecs_iter_t *it) {
 
 // Render system
 void AssimpModelRenderSystem(ecs_iter_t *it) {
-  SDLContext *sdl_ctx = ecs_singleton_ensure(it->world, SDLContext);
+  SDLContext *sdl_ctx = ecs_field(it, SDLContext, 0);
   if (!sdl_ctx || sdl_ctx->hasError || sdl_ctx->isShutDown) return;
-  VulkanContext *v_ctx = ecs_singleton_ensure(it->world, VulkanContext);
+  VulkanContext *v_ctx = ecs_field(it, VulkanContext, 1);
   if (!v_ctx) return;
-  AssimpModelContext *assimp_ctx = ecs_singleton_ensure(it->world, AssimpModelContext);
+  AssimpModelContext *assimp_ctx = ecs_field(it, AssimpModelContext, 2);
   if (!assimp_ctx) return;
 
   vkCmdBindPipeline(v_ctx->commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, assimp_ctx->assimp_graphicsPipeline);
@@ -527,11 +528,14 @@ void flecs_assimp_model_cleanup(ecs_world_t *world) {
   ecs_log(1, "Assimp model cleanup completed");
 }
 
+// registry slot, marked cleaned by the cleanup observer
+static ModuleHandle assimp_module_handle = MODULE_HANDLE_NONE;
+
 // Cleanup system
 void assimp_model_cleanup_event_system(ecs_iter_t *it) {
   ecs_print(1, "[cleanup] assimp_model_cleanup_event_system");
   flecs_assimp_model_cleanup(it->world);
-  module_break_name(it, "assimp_model_module");
+  module_set_state(it->world, assimp_module_handle, MODULE_STATE_CLEANED);
 }
 
 // Register components
@@ -554,11 +558,13 @@ void assimp_model_register_systems(ecs_world_t *world) {
 
     ecs_system_init(world, &(ecs_system_desc_t){
         .entity = ecs_entity(world, { .name = "AssimpModelUpdateSystem", .add = ecs_ids(ecs_dependson(GlobalPhases.LogicUpdatePhase)) }),
+        .query.terms = { ECS_SINGLETON_IN(SDLContext), ECS_SINGLETON_IN(VulkanContext), ECS_SINGLETON_IN(AssimpModelContext) },
         .callback = AssimpModelUpdateSystem
     });
 
     ecs_system_init(world, &(ecs_system_desc_t){
         .entity = ecs_entity(world, { .name = "AssimpModelRenderSystem", .add = ecs_ids(ecs_dependson(GlobalPhases.CMDBufferPhase)) }),
+        .query.terms = { ECS_SINGLETON_IN(SDLContext), ECS_SINGLETON_IN(VulkanContext), ECS_SINGLETON_IN(AssimpModelContext) },
         .callback = AssimpModelRenderSystem
     });
 }
@@ -571,10 +577,10 @@ void flecs_assimp_module_init(ecs_world_t *world) {
 
   ecs_singleton_set(world, AssimpModelContext, {0});
 
-  ecs_entity_t e = ecs_new(world);
-  ecs_set(world, e, PluginModule, { .name = "assimp_model_module", .isCleanUp = false });
+  assimp_module_handle = module_register(world, "assimp_model_module");
 
   assimp_model_register_systems(world);
+  module_set_state(world, assimp_module_handle, MODULE_STATE_READY);
 
   ecs_log(1, "Assimp module initialized");
 }
\ No newline at end of file
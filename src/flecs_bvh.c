@@ -0,0 +1,187 @@
+#include "flecs_bvh.h"
+#include <math.h>
+
+// world AABB of a local box under a model matrix (Arvo): per output axis take
+// the smaller / larger product of each matrix entry with the box extents
+static void bvh_world_aabb(const Bounds *local, const WorldTransform *world, BvhAabb *out) {
+  for (int i = 0; i < 3; i++) {
+    float lo = world->matrix[3][i];
+    float hi = world->matrix[3][i];
+    for (int j = 0; j < 3; j++) {
+      float a = world->matrix[j][i] * local->min[j];
+      float b = world->matrix[j][i] * local->max[j];
+      lo += fminf(a, b);
+      hi += fmaxf(a, b);
+    }
+    out->min[i] = lo;
+    out->max[i] = hi;
+  }
+}
+
+// TransformPhase, after TransformPropagateSystem: insert new entities and
+// refit moved ones. Tables without a changed Bounds or WorldTransform column
+// are skipped, a static scene costs one ecs_query_changed
+void BvhUpdateSystem(ecs_iter_t *it) {
+  BvhContext *bvh_ctx = ecs_field(it, BvhContext, 0);
+  bvh_ctx->insertedCount = 0;
+  bvh_ctx->movedCount = 0;
+  if (!bvh_ctx->query || !bvh_ctx->proxiesReady || !ecs_query_changed(bvh_ctx->query)) return;
+
+  ecs_iter_t qit = ecs_query_iter(it->world, bvh_ctx->query);
+  while (ecs_query_next(&qit)) {
+    if (!ecs_iter_changed(&qit)) {
+      ecs_iter_skip(&qit);
+      continue;
+    }
+    const Bounds *bounds = ecs_field(&qit, Bounds, 0);
+    const WorldTransform *world = ecs_field(&qit, WorldTransform, 1);
+
+    for (int i = 0; i < qit.count; i++) {
+      BvhAabb aabb;
+      bvh_world_aabb(&bounds[i], &world[i], &aabb);
+      ecs_entity_t e = qit.entities[i];
+      ecs_map_val_t *found = ecs_map_get(&bvh_ctx->proxies, e);
+      if (found) {
+        if (flecs_bvh_tree_move(&bvh_ctx->tree, (int32_t)*found, &aabb)) bvh_ctx->movedCount++;
+      } else {
+        int32_t proxy = flecs_bvh_tree_insert(&bvh_ctx->tree, &aabb, e);
+        if (proxy == BVH_NULL) {
+          ecs_err("[bvh] out of memory inserting %s", ecs_get_name(it->world, e));
+          continue;
+        }
+        ecs_map_insert(&bvh_ctx->proxies, e, (ecs_map_val_t)proxy);
+        bvh_ctx->insertedCount++;
+      }
+    }
+  }
+}
+
+// entity deleted or lost Bounds / WorldTransform
+static void BvhRemoveObserver(ecs_iter_t *it) {
+  BvhContext *bvh_ctx = ecs_get_mut(it->world, ecs_id(BvhContext), BvhContext);
+  if (!bvh_ctx || !bvh_ctx->proxiesReady) return;
+  for (int i = 0; i < it->count; i++) {
+    ecs_map_val_t *found = ecs_map_get(&bvh_ctx->proxies, it->entities[i]);
+    if (!found) continue;
+    flecs_bvh_tree_remove(&bvh_ctx->tree, (int32_t)*found);
+    ecs_map_remove(&bvh_ctx->proxies, it->entities[i]);
+  }
+}
+
+void flecs_bvh_cleanup(ecs_world_t *world) {
+  BvhContext *bvh_ctx = ecs_get_mut(world, ecs_id(BvhContext), BvhContext);
+  if (!bvh_ctx) return;
+  if (bvh_ctx->query) {
+    ecs_query_fini(bvh_ctx->query);
+    bvh_ctx->query = NULL;
+  }
+  if (bvh_ctx->proxiesReady) {
+    bvh_ctx->proxiesReady = false;
+    ecs_map_fini(&bvh_ctx->proxies);
+  }
+  flecs_bvh_tree_fini(&bvh_ctx->tree);
+}
+
+// registry slot, marked cleaned by the cleanup observer
+static ModuleHandle bvh_module_handle = MODULE_HANDLE_NONE;
+
+void bvh_cleanup_event_system(ecs_iter_t *it) {
+  ecs_print(1, "[cleanup] bvh_cleanup_event_system");
+  flecs_bvh_cleanup(it->world);
+  module_set_state(it->world, bvh_module_handle, MODULE_STATE_CLEANED);
+}
+
+void bvh_register_components(ecs_world_t *world) {
+  ECS_COMPONENT_DEFINE(world, Bounds);
+  ECS_COMPONENT_DEFINE(world, BvhContext);
+}
+
+void bvh_register_systems(ecs_world_t *world) {
+  ecs_observer(world, {
+    .query.terms = {{ EcsAny, .src.id = CleanUpModule }},
+    .events = { CleanUpEvent },
+    .callback = bvh_cleanup_event_system
+  });
+
+  ecs_observer(world, {
+    .query.terms = {
+      { ecs_id(Bounds) },
+      { ecs_id(WorldTransform) }
+    },
+    .events = { EcsOnRemove },
+    .callback = BvhRemoveObserver
+  });
+
+  // same phase as TransformPropagateSystem, created later so it runs later
+  ecs_system_init(world, &(ecs_system_desc_t){
+    .entity = ecs_entity(world, { .name = "BvhUpdateSystem", .add = ecs_ids(ecs_dependson(GlobalPhases.TransformPhase)) }),
+    .query.terms = { ECS_SINGLETON_INOUT(BvhContext) },
+    .callback = BvhUpdateSystem
+  });
+}
+
+// BvhContext for the query functions, bound in module init. ecs_ref_get
+// refreshes the cached record inside the ref, so these are main thread only
+static ecs_ref_t bvh_ref;
+
+static const BvhContext *bvh_context(ecs_world_t *world) {
+  const BvhContext *bvh_ctx = bvh_ref.entity ? ecs_ref_get(world, &bvh_ref, BvhContext) : NULL;
+  return bvh_ctx && bvh_ctx->proxiesReady ? bvh_ctx : NULL;
+}
+
+void flecs_bvh_module_init(ecs_world_t *world) {
+  ecs_log(1, "Initializing bvh module...");
+
+  bvh_register_components(world);
+
+  ecs_singleton_set(world, BvhContext, {
+    .query = ecs_query(world, {
+      .terms = {
+        { ecs_id(Bounds), .inout = EcsIn },
+        { ecs_id(WorldTransform), .inout = EcsIn }
+      },
+      .cache_kind = EcsQueryCacheAuto,
+      .flags = ECS_QUERY_DETECT_CHANGES
+    })
+  });
+
+  bvh_ref = ECS_SINGLETON_REF(world, BvhContext);
+  BvhContext *bvh_ctx = ecs_ref_get(world, &bvh_ref, BvhContext);
+  flecs_bvh_tree_init(&bvh_ctx->tree, BVH_MARGIN);
+  ecs_map_init(&bvh_ctx->proxies, NULL);
+  bvh_ctx->proxiesReady = true;
+  ecs_singleton_modified(world, BvhContext);
+
+  bvh_module_handle = module_register(world, "bvh_module");
+
+  bvh_register_systems(world);
+  module_set_state(world, bvh_module_handle, MODULE_STATE_READY);
+
+  ecs_log(1, "Bvh module initialized");
+}
+
+int32_t flecs_bvh_query_aabb(ecs_world_t *world, const BvhAabb *aabb, BvhQueryFn fn, void *ctx) {
+  const BvhContext *bvh_ctx = bvh_context(world);
+  if (!bvh_ctx) return 0;
+  return flecs_bvh_tree_query_aabb(&bvh_ctx->tree, aabb, fn, ctx);
+}
+
+int32_t flecs_bvh_query_sphere(ecs_world_t *world, const vec3 center, float radius, BvhQueryFn fn, void *ctx) {
+  const BvhContext *bvh_ctx = bvh_context(world);
+  if (!bvh_ctx) return 0;
+  return flecs_bvh_tree_query_sphere(&bvh_ctx->tree, center, radius, fn, ctx);
+}
+
+int32_t flecs_bvh_query_frustum(ecs_world_t *world, const mat4 viewProj, BvhQueryFn fn, void *ctx) {
+  const BvhContext *bvh_ctx = bvh_context(world);
+  if (!bvh_ctx) return 0;
+  float planes[6][4];
+  flecs_bvh_frustum_planes(viewProj, planes);
+  return flecs_bvh_tree_query_frustum(&bvh_ctx->tree, (const float (*)[4])planes, fn, ctx);
+}
+
+int32_t flecs_bvh_raycast(ecs_world_t *world, const vec3 origin, const vec3 dir, float maxT, BvhRayFn fn, void *ctx) {
+  const BvhContext *bvh_ctx = bvh_context(world);
+  if (!bvh_ctx) return 0;
+  return flecs_bvh_tree_raycast(&bvh_ctx->tree, origin, dir, maxT, fn, ctx);
+}
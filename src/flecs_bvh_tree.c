@@ -0,0 +1,529 @@
+#include "flecs_bvh_tree.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+static inline float bvh_minf(float a, float b) { return a < b ? a : b; }
+static inline float bvh_maxf(float a, float b) { return a > b ? a : b; }
+static inline int32_t bvh_maxi(int32_t a, int32_t b) { return a > b ? a : b; }
+
+static inline BvhAabb bvh_union(const BvhAabb *a, const BvhAabb *b) {
+  BvhAabb r;
+  for (int i = 0; i < 3; i++) {
+    r.min[i] = bvh_minf(a->min[i], b->min[i]);
+    r.max[i] = bvh_maxf(a->max[i], b->max[i]);
+  }
+  return r;
+}
+
+// surface area, the cost of a node is the chance a random query visits it
+static inline float bvh_area(const BvhAabb *a) {
+  float dx = a->max[0] - a->min[0];
+  float dy = a->max[1] - a->min[1];
+  float dz = a->max[2] - a->min[2];
+  return 2.0f * (dx * dy + dy * dz + dz * dx);
+}
+
+static inline bool bvh_contains(const BvhAabb *outer, const BvhAabb *inner) {
+  for (int i = 0; i < 3; i++) {
+    if (inner->min[i] < outer->min[i] || inner->max[i] > outer->max[i]) return false;
+  }
+  return true;
+}
+
+static inline bool bvh_overlaps(const BvhAabb *a, const BvhAabb *b) {
+  for (int i = 0; i < 3; i++) {
+    if (a->max[i] < b->min[i] || b->max[i] < a->min[i]) return false;
+  }
+  return true;
+}
+
+// squared distance from a point to the box, 0 inside
+static inline float bvh_distance2(const BvhAabb *a, const float p[3]) {
+  float d2 = 0.0f;
+  for (int i = 0; i < 3; i++) {
+    if (p[i] < a->min[i]) d2 += (a->min[i] - p[i]) * (a->min[i] - p[i]);
+    else if (p[i] > a->max[i]) d2 += (p[i] - a->max[i]) * (p[i] - a->max[i]);
+  }
+  return d2;
+}
+
+// slab test against [0, maxT], entry distance or -1 on a miss
+static inline float bvh_ray_enter(const BvhAabb *a, const float origin[3], const float inv[3], float maxT) {
+  float tmin = 0.0f, tmax = maxT;
+  for (int i = 0; i < 3; i++) {
+    if (inv[i] == INFINITY) {
+      if (origin[i] < a->min[i] || origin[i] > a->max[i]) return -1.0f;
+      continue;
+    }
+    float t1 = (a->min[i] - origin[i]) * inv[i];
+    float t2 = (a->max[i] - origin[i]) * inv[i];
+    tmin = bvh_maxf(tmin, bvh_minf(t1, t2));
+    tmax = bvh_minf(tmax, bvh_maxf(t1, t2));
+    if (tmin > tmax) return -1.0f;
+  }
+  return tmin;
+}
+
+// false when the box is outside one of the planes in *mask; planes the box
+// is fully inside are cleared from *mask
+static inline bool bvh_frustum_test(const BvhAabb *a, const float planes[6][4], uint8_t *mask) {
+  for (int p = 0; p < 6; p++) {
+    if (!(*mask & (1u << p))) continue;
+    const float *pl = planes[p];
+    // farthest corner along the normal, then the nearest one
+    float far = pl[3], near = pl[3];
+    for (int i = 0; i < 3; i++) {
+      float lo = pl[i] * a->min[i];
+      float hi = pl[i] * a->max[i];
+      far += bvh_maxf(lo, hi);
+      near += bvh_minf(lo, hi);
+    }
+    if (far < 0.0f) return false;
+    if (near >= 0.0f) *mask &= (uint8_t)~(1u << p);
+  }
+  return true;
+}
+
+static inline BvhAabb bvh_fatten(const BvhAabb *a, float margin) {
+  BvhAabb r;
+  for (int i = 0; i < 3; i++) {
+    r.min[i] = a->min[i] - margin;
+    r.max[i] = a->max[i] + margin;
+  }
+  return r;
+}
+
+static inline bool bvh_is_leaf(const BvhNode *node) {
+  return node->child1 == BVH_NULL;
+}
+
+static void bvh_link_free(BvhTree *tree, int32_t from) {
+  for (int32_t i = from; i < tree->nodeCapacity - 1; i++) {
+    tree->nodes[i].parent = i + 1;
+    tree->nodes[i].height = -1;
+  }
+  tree->nodes[tree->nodeCapacity - 1].parent = BVH_NULL;
+  tree->nodes[tree->nodeCapacity - 1].height = -1;
+  tree->freeList = from;
+}
+
+static int32_t bvh_alloc_node(BvhTree *tree) {
+  if (tree->freeList == BVH_NULL) {
+    int32_t capacity = tree->nodeCapacity ? tree->nodeCapacity * 2 : 64;
+    BvhNode *nodes = realloc(tree->nodes, sizeof(BvhNode) * (size_t)capacity);
+    if (!nodes) return BVH_NULL;
+    tree->nodes = nodes;
+    int32_t old = tree->nodeCapacity;
+    tree->nodeCapacity = capacity;
+    bvh_link_free(tree, old);
+  }
+  int32_t index = tree->freeList;
+  BvhNode *node = &tree->nodes[index];
+  tree->freeList = node->parent;
+  node->parent = BVH_NULL;
+  node->child1 = BVH_NULL;
+  node->child2 = BVH_NULL;
+  node->height = 0;
+  node->userData = 0;
+  tree->nodeCount++;
+  return index;
+}
+
+static void bvh_free_node(BvhTree *tree, int32_t index) {
+  tree->nodes[index].parent = tree->freeList;
+  tree->nodes[index].height = -1;
+  tree->freeList = index;
+  tree->nodeCount--;
+}
+
+static void bvh_refit_node(BvhTree *tree, int32_t index) {
+  BvhNode *node = &tree->nodes[index];
+  const BvhNode *c1 = &tree->nodes[node->child1];
+  const BvhNode *c2 = &tree->nodes[node->child2];
+  node->height = 1 + bvh_maxi(c1->height, c2->height);
+  node->aabb = bvh_union(&c1->aabb, &c2->aabb);
+}
+
+static void bvh_replace_child(BvhTree *tree, int32_t parent, int32_t oldChild, int32_t newChild) {
+  if (parent == BVH_NULL) {
+    tree->root = newChild;
+  } else if (tree->nodes[parent].child1 == oldChild) {
+    tree->nodes[parent].child1 = newChild;
+  } else {
+    tree->nodes[parent].child2 = newChild;
+  }
+}
+
+// AVL rotation when one side of iA is 2 levels taller, returns the node now
+// in iA's place
+static int32_t bvh_balance(BvhTree *tree, int32_t iA) {
+  BvhNode *nodes = tree->nodes;
+  BvhNode *A = &nodes[iA];
+  if (bvh_is_leaf(A) || A->height < 2) return iA;
+
+  int32_t iB = A->child1;
+  int32_t iC = A->child2;
+  BvhNode *B = &nodes[iB];
+  BvhNode *C = &nodes[iC];
+  int32_t balance = C->height - B->height;
+
+  // rotate C up
+  if (balance > 1) {
+    int32_t iF = C->child1;
+    int32_t iG = C->child2;
+    BvhNode *F = &nodes[iF];
+    BvhNode *G = &nodes[iG];
+
+    C->child1 = iA;
+    C->parent = A->parent;
+    A->parent = iC;
+    bvh_replace_child(tree, C->parent, iA, iC);
+
+    if (F->height > G->height) {
+      C->child2 = iF;
+      A->child2 = iG;
+      G->parent = iA;
+      A->aabb = bvh_union(&B->aabb, &G->aabb);
+      C->aabb = bvh_union(&A->aabb, &F->aabb);
+      A->height = 1 + bvh_maxi(B->height, G->height);
+      C->height = 1 + bvh_maxi(A->height, F->height);
+    } else {
+      C->child2 = iG;
+      A->child2 = iF;
+      F->parent = iA;
+      A->aabb = bvh_union(&B->aabb, &F->aabb);
+      C->aabb = bvh_union(&A->aabb, &G->aabb);
+      A->height = 1 + bvh_maxi(B->height, F->height);
+      C->height = 1 + bvh_maxi(A->height, G->height);
+    }
+    return iC;
+  }
+
+  // rotate B up
+  if (balance < -1) {
+    int32_t iD = B->child1;
+    int32_t iE = B->child2;
+    BvhNode *D = &nodes[iD];
+    BvhNode *E = &nodes[iE];
+
+    B->child1 = iA;
+    B->parent = A->parent;
+    A->parent = iB;
+    bvh_replace_child(tree, B->parent, iA, iB);
+
+    if (D->height > E->height) {
+      B->child2 = iD;
+      A->child1 = iE;
+      E->parent = iA;
+      A->aabb = bvh_union(&C->aabb, &E->aabb);
+      B->aabb = bvh_union(&A->aabb, &D->aabb);
+      A->height = 1 + bvh_maxi(C->height, E->height);
+      B->height = 1 + bvh_maxi(A->height, D->height);
+    } else {
+      B->child2 = iE;
+      A->child1 = iD;
+      D->parent = iA;
+      A->aabb = bvh_union(&C->aabb, &D->aabb);
+      B->aabb = bvh_union(&A->aabb, &E->aabb);
+      A->height = 1 + bvh_maxi(C->height, D->height);
+      B->height = 1 + bvh_maxi(A->height, E->height);
+    }
+    return iB;
+  }
+
+  return iA;
+}
+
+// rebalance and refit from index to the root
+static void bvh_fix_upwards(BvhTree *tree, int32_t index) {
+  while (index != BVH_NULL) {
+    index = bvh_balance(tree, index);
+    bvh_refit_node(tree, index);
+    index = tree->nodes[index].parent;
+  }
+}
+
+static void bvh_insert_leaf(BvhTree *tree, int32_t leaf) {
+  BvhNode *nodes = tree->nodes;
+  if (tree->root == BVH_NULL) {
+    tree->root = leaf;
+    nodes[leaf].parent = BVH_NULL;
+    return;
+  }
+
+  // descend towards the cheapest sibling: the cost of pairing here against
+  // the lower bound of pushing the leaf into either child
+  BvhAabb leafAabb = nodes[leaf].aabb;
+  int32_t index = tree->root;
+  while (!bvh_is_leaf(&nodes[index])) {
+    const BvhNode *node = &nodes[index];
+    float area = bvh_area(&node->aabb);
+    BvhAabb combined = bvh_union(&node->aabb, &leafAabb);
+    float combinedArea = bvh_area(&combined);
+
+    float cost = 2.0f * combinedArea;
+    float inheritance = 2.0f * (combinedArea - area);
+
+    float childCost[2];
+    int32_t children[2] = { node->child1, node->child2 };
+    for (int c = 0; c < 2; c++) {
+      const BvhNode *child = &nodes[children[c]];
+      BvhAabb merged = bvh_union(&leafAabb, &child->aabb);
+      childCost[c] = bvh_is_leaf(child)
+        ? bvh_area(&merged) + inheritance
+        : bvh_area(&merged) - bvh_area(&child->aabb) + inheritance;
+    }
+
+    if (cost < childCost[0] && cost < childCost[1]) break;
+    index = childCost[0] < childCost[1] ? children[0] : children[1];
+  }
+
+  int32_t sibling = index;
+  int32_t oldParent = nodes[sibling].parent;
+  int32_t newParent = bvh_alloc_node(tree);
+  nodes = tree->nodes; // may have grown
+  if (newParent == BVH_NULL) return;
+
+  nodes[newParent].parent = oldParent;
+  nodes[newParent].aabb = bvh_union(&leafAabb, &nodes[sibling].aabb);
+  nodes[newParent].height = nodes[sibling].height + 1;
+  nodes[newParent].child1 = sibling;
+  nodes[newParent].child2 = leaf;
+  nodes[sibling].parent = newParent;
+  nodes[leaf].parent = newParent;
+  bvh_replace_child(tree, oldParent, sibling, newParent);
+
+  bvh_fix_upwards(tree, nodes[leaf].parent);
+}
+
+static void bvh_remove_leaf(BvhTree *tree, int32_t leaf) {
+  BvhNode *nodes = tree->nodes;
+  if (leaf == tree->root) {
+    tree->root = BVH_NULL;
+    return;
+  }
+
+  int32_t parent = nodes[leaf].parent;
+  int32_t grandParent = nodes[parent].parent;
+  int32_t sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+  bvh_replace_child(tree, grandParent, parent, sibling);
+  nodes[sibling].parent = grandParent;
+  bvh_free_node(tree, parent);
+
+  bvh_fix_upwards(tree, grandParent);
+}
+
+void flecs_bvh_tree_init(BvhTree *tree, float margin) {
+  memset(tree, 0, sizeof(*tree));
+  tree->root = BVH_NULL;
+  tree->freeList = BVH_NULL;
+  tree->margin = margin;
+}
+
+void flecs_bvh_tree_fini(BvhTree *tree) {
+  free(tree->nodes);
+  flecs_bvh_tree_init(tree, tree->margin);
+}
+
+int32_t flecs_bvh_tree_insert(BvhTree *tree, const BvhAabb *aabb, uint64_t userData) {
+  int32_t proxy = bvh_alloc_node(tree);
+  if (proxy == BVH_NULL) return BVH_NULL;
+  tree->nodes[proxy].aabb = bvh_fatten(aabb, tree->margin);
+  tree->nodes[proxy].tight = *aabb;
+  tree->nodes[proxy].userData = userData;
+  bvh_insert_leaf(tree, proxy);
+  if (tree->nodes[proxy].parent == BVH_NULL && tree->root != proxy) {
+    bvh_free_node(tree, proxy); // no memory for its parent
+    return BVH_NULL;
+  }
+  tree->proxyCount++;
+  return proxy;
+}
+
+void flecs_bvh_tree_remove(BvhTree *tree, int32_t proxy) {
+  if (proxy < 0 || proxy >= tree->nodeCapacity || tree->nodes[proxy].height != 0) return;
+  bvh_remove_leaf(tree, proxy);
+  bvh_free_node(tree, proxy);
+  tree->proxyCount--;
+}
+
+bool flecs_bvh_tree_move(BvhTree *tree, int32_t proxy, const BvhAabb *aabb) {
+  if (proxy < 0 || proxy >= tree->nodeCapacity || tree->nodes[proxy].height != 0) return false;
+  BvhNode *node = &tree->nodes[proxy];
+  node->tight = *aabb;
+
+  // still inside the fat box, and the fat box is not much larger than needed
+  // (a shrunk object would otherwise keep a huge box forever)
+  if (bvh_contains(&node->aabb, aabb)) {
+    BvhAabb huge = bvh_fatten(aabb, tree->margin * 4.0f);
+    if (bvh_contains(&huge, &node->aabb)) return false;
+  }
+
+  bvh_remove_leaf(tree, proxy);
+  tree->nodes[proxy].aabb = bvh_fatten(aabb, tree->margin);
+  bvh_insert_leaf(tree, proxy);
+  return true;
+}
+
+int32_t flecs_bvh_tree_query_aabb(const BvhTree *tree, const BvhAabb *aabb, BvhQueryFn fn, void *ctx) {
+  if (tree->root == BVH_NULL) return 0;
+  int32_t stack[BVH_STACK_SIZE];
+  int32_t top = 0, found = 0;
+  stack[top++] = tree->root;
+
+  while (top > 0) {
+    const BvhNode *node = &tree->nodes[stack[--top]];
+    if (!bvh_overlaps(&node->aabb, aabb)) continue;
+    if (bvh_is_leaf(node)) {
+      if (!bvh_overlaps(&node->tight, aabb)) continue;
+      found++;
+      if (!fn(ctx, (int32_t)(node - tree->nodes), node->userData)) return found;
+    } else if (top + 2 <= BVH_STACK_SIZE) {
+      stack[top++] = node->child1;
+      stack[top++] = node->child2;
+    }
+  }
+  return found;
+}
+
+int32_t flecs_bvh_tree_query_sphere(const BvhTree *tree, const float center[3], float radius, BvhQueryFn fn, void *ctx) {
+  if (tree->root == BVH_NULL) return 0;
+  int32_t stack[BVH_STACK_SIZE];
+  int32_t top = 0, found = 0;
+  float radius2 = radius * radius;
+  stack[top++] = tree->root;
+
+  while (top > 0) {
+    const BvhNode *node = &tree->nodes[stack[--top]];
+    if (bvh_distance2(&node->aabb, center) > radius2) continue;
+    if (bvh_is_leaf(node)) {
+      if (bvh_distance2(&node->tight, center) > radius2) continue;
+      found++;
+      if (!fn(ctx, (int32_t)(node - tree->nodes), node->userData)) return found;
+    } else if (top + 2 <= BVH_STACK_SIZE) {
+      stack[top++] = node->child1;
+      stack[top++] = node->child2;
+    }
+  }
+  return found;
+}
+
+// report every leaf under index without testing, the subtree is inside
+static bool bvh_report_all(const BvhTree *tree, int32_t index, BvhQueryFn fn, void *ctx, int32_t *found) {
+  int32_t stack[BVH_STACK_SIZE];
+  int32_t top = 0;
+  stack[top++] = index;
+  while (top > 0) {
+    const BvhNode *node = &tree->nodes[stack[--top]];
+    if (bvh_is_leaf(node)) {
+      (*found)++;
+      if (!fn(ctx, (int32_t)(node - tree->nodes), node->userData)) return false;
+    } else if (top + 2 <= BVH_STACK_SIZE) {
+      stack[top++] = node->child1;
+      stack[top++] = node->child2;
+    }
+  }
+  return true;
+}
+
+int32_t flecs_bvh_tree_query_frustum(const BvhTree *tree, const float planes[6][4], BvhQueryFn fn, void *ctx) {
+  if (tree->root == BVH_NULL) return 0;
+  // node + planes still to test (bit per plane), children inherit the mask
+  int32_t stack[BVH_STACK_SIZE];
+  uint8_t masks[BVH_STACK_SIZE];
+  int32_t top = 0, found = 0;
+  stack[top] = tree->root;
+  masks[top++] = 0x3F;
+
+  while (top > 0) {
+    top--;
+    int32_t index = stack[top];
+    uint8_t mask = masks[top];
+    const BvhNode *node = &tree->nodes[index];
+
+    if (!bvh_frustum_test(&node->aabb, planes, &mask)) continue;
+
+    if (mask == 0) {
+      if (!bvh_report_all(tree, index, fn, ctx, &found)) return found;
+    } else if (bvh_is_leaf(node)) {
+      // tight box against the planes the fat box straddles
+      if (!bvh_frustum_test(&node->tight, planes, &mask)) continue;
+      found++;
+      if (!fn(ctx, index, node->userData)) return found;
+    } else if (top + 2 <= BVH_STACK_SIZE) {
+      stack[top] = node->child1;
+      masks[top++] = mask;
+      stack[top] = node->child2;
+      masks[top++] = mask;
+    }
+  }
+  return found;
+}
+
+int32_t flecs_bvh_tree_raycast(const BvhTree *tree, const float origin[3], const float dir[3], float maxT, BvhRayFn fn, void *ctx) {
+  if (tree->root == BVH_NULL) return 0;
+  float inv[3];
+  for (int i = 0; i < 3; i++) inv[i] = dir[i] != 0.0f ? 1.0f / dir[i] : INFINITY;
+
+  int32_t stack[BVH_STACK_SIZE];
+  int32_t top = 0, found = 0;
+  stack[top++] = tree->root;
+
+  while (top > 0) {
+    const BvhNode *node = &tree->nodes[stack[--top]];
+    if (bvh_ray_enter(&node->aabb, origin, inv, maxT) < 0.0f) continue;
+
+    if (bvh_is_leaf(node)) {
+      float tmin = bvh_ray_enter(&node->tight, origin, inv, maxT);
+      if (tmin < 0.0f) continue;
+      found++;
+      float t = fn(ctx, (int32_t)(node - tree->nodes), node->userData, tmin);
+      if (t <= 0.0f) return found;
+      maxT = bvh_minf(maxT, t);
+    } else if (top + 2 <= BVH_STACK_SIZE) {
+      stack[top++] = node->child1;
+      stack[top++] = node->child2;
+    }
+  }
+  return found;
+}
+
+void flecs_bvh_frustum_planes(const float m[4][4], float planes[6][4]) {
+  // rows of the column major matrix, clip = M * v
+  float r[4][4];
+  for (int row = 0; row < 4; row++) {
+    for (int col = 0; col < 4; col++) r[row][col] = m[col][row];
+  }
+  for (int i = 0; i < 4; i++) {
+    planes[0][i] = r[3][i] + r[0][i]; // left
+    planes[1][i] = r[3][i] - r[0][i]; // right
+    planes[2][i] = r[3][i] + r[1][i]; // bottom
+    planes[3][i] = r[3][i] - r[1][i]; // top
+    planes[4][i] = r[2][i];           // near, z >= 0
+    planes[5][i] = r[3][i] - r[2][i]; // far
+  }
+  for (int p = 0; p < 6; p++) {
+    float len = sqrtf(planes[p][0] * planes[p][0] + planes[p][1] * planes[p][1] + planes[p][2] * planes[p][2]);
+    if (len > 0.0f) {
+      for (int i = 0; i < 4; i++) planes[p][i] /= len;
+    }
+  }
+}
+
+int32_t flecs_bvh_tree_height(const BvhTree *tree) {
+  return tree->root == BVH_NULL ? 0 : tree->nodes[tree->root].height;
+}
+
+float flecs_bvh_tree_area_ratio(const BvhTree *tree) {
+  if (tree->root == BVH_NULL) return 0.0f;
+  float rootArea = bvh_area(&tree->nodes[tree->root].aabb);
+  if (rootArea <= 0.0f) return 0.0f;
+  double total = 0.0;
+  for (int32_t i = 0; i < tree->nodeCapacity; i++) {
+    const BvhNode *node = &tree->nodes[i];
+    if (node->height > 0) total += bvh_area(&node->aabb);
+  }
+  return (float)(total / rootArea);
+}
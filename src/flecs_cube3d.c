@@ -268,12 +268,12 @@ void Cube3DSetupSystem(ecs_iter_t *it) {
 }
 
 void Cube3DRenderSystem(ecs_iter_t *it) {
-    VulkanContext *v_ctx = ecs_singleton_ensure(it->world, VulkanContext);
+    VulkanContext *v_ctx = ecs_field(it, VulkanContext, 1);
     if (!v_ctx) return;
-    SDLContext *sdl_ctx = ecs_singleton_ensure(it->world, SDLContext);
+    SDLContext *sdl_ctx = ecs_field(it, SDLContext, 0);
     // if(sdl_ctx->isShutDown)return;
     if (!sdl_ctx || sdl_ctx->hasError || sdl_ctx->isShutDown) return;
-    Cube3DContext *cube_ctx = ecs_singleton_ensure(it->world, Cube3DContext);
+    Cube3DContext *cube_ctx = ecs_field(it, Cube3DContext, 2);
     if (!cube_ctx) return;
 
     // Update uniform buffer with rightward spin
@@ -370,6 +370,9 @@ ecs_entity_t ecs_cube3d_render_sys;
 //   ecs_print(1,"LIST....");
 // }
 
+// registry slot, marked cleaned by the cleanup observer
+static ModuleHandle cube3d_module_handle = MODULE_HANDLE_NONE;
+
 void flecs_cube3d_cleanup_event_system(ecs_iter_t *it){
   ecs_print(1,"[cleanup] flecs_cube3d_cleanup_event_system");
   //disable runtime for cleanup
@@ -379,7 +382,7 @@ void flecs_cube3d_cleanup_event_system(ecs_iter_t *it){
   //clean up
   flecs_cube3d_cleanup(it->world);
   // after some testing it need loop check since it will not disable next loop.
-  module_break_name(it, "cube3d_module");
+  module_set_state(it->world, cube3d_module_handle, MODULE_STATE_CLEANED);
 
 }
 
@@ -396,6 +399,7 @@ void cube3d_register_systems(ecs_world_t *world){
 
   ecs_cube3d_render_sys = ecs_system_init(world, &(ecs_system_desc_t){
       .entity = ecs_entity(world, { .name = "Cube3DRenderSystem", .add = ecs_ids(ecs_dependson(GlobalPhases.CMDBufferPhase)) }),
+      .query.terms = { ECS_SINGLETON_IN(SDLContext), ECS_SINGLETON_IN(VulkanContext), ECS_SINGLETON_IN(Cube3DContext) },
       .callback = Cube3DRenderSystem
   });
   ecs_enable(world, ecs_cube3d_render_sys, true); // Store and disable
@@ -422,11 +426,10 @@ void flecs_cube3d_module_init(ecs_world_t *world) {
 
   ecs_singleton_set(world, Cube3DContext, {0});
 
-  // add_module_name(world,"cube3d_module");
-  ecs_entity_t e = ecs_new(world);
-  ecs_set(world, e, PluginModule, { .name = "cube3d_module", .isCleanUp = false });
+  cube3d_module_handle = module_register(world, "cube3d_module");
 
   cube3d_register_systems(world);
+  module_set_state(world, cube3d_module_handle, MODULE_STATE_READY);
 
   ecs_log(1, "Cube3d module initialized");
 }
\ No newline at end of file
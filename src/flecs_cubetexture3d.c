@@ -5,6 +5,9 @@
 #include "flecs_utils.h" // createShaderModuleLen(v_ctx->device, text_vert_spv)
 #include "flecs_sdl.h"
 #include "flecs_vulkan.h"
+#include "flecs_asset_jobs.h"
+#include "flecs_texture_stream.h"
+#include <math.h>
 
 //#define STB_IMAGE_IMPLEMENTATION //might have already define other module need work.
 #include "stb_image.h"
@@ -78,142 +81,7 @@ static void updateBuffer(VulkanContext *v_ctx, VkDeviceMemory memory, VkDeviceSi
   vkUnmapMemory(v_ctx->device, memory);
 }
 
-static void createTextureImage(VulkanContext *v_ctx, CubeText3DContext *cubetext3d_ctx) {
-  int width, height, channels;
-  unsigned char *imageData = stbi_load("assets/textures/light/texture_08.png", &width, &height, &channels, STBI_rgb_alpha);
-  if (!imageData) {
-      ecs_err("Failed to load texture_08.png: %s", stbi_failure_reason());
-      v_ctx->hasError = true;
-      return;
-  }
-
-  VkDeviceSize imageSize = width * height * 4;
-  VkBuffer stagingBuffer;
-  VkDeviceMemory stagingMemory;
-  createBuffer(v_ctx, imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &stagingBuffer, &stagingMemory);
-  updateBuffer(v_ctx, stagingMemory, imageSize, imageData);
-
-  VkImageCreateInfo imageInfo = {VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
-  imageInfo.imageType = VK_IMAGE_TYPE_2D;
-  imageInfo.format = VK_FORMAT_R8G8B8A8_SRGB;
-  imageInfo.extent.width = width;
-  imageInfo.extent.height = height;
-  imageInfo.extent.depth = 1;
-  imageInfo.mipLevels = 1;
-  imageInfo.arrayLayers = 1;
-  imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
-  imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-  imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-  imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-
-  if (vkCreateImage(v_ctx->device, &imageInfo, NULL, &cubetext3d_ctx->cubetexture3dImage) != VK_SUCCESS) {
-      ecs_err("Failed to create texture image");
-      stbi_image_free(imageData);
-      v_ctx->hasError = true;
-      return;
-  }
-
-  VkMemoryRequirements memReqs;
-  vkGetImageMemoryRequirements(v_ctx->device, cubetext3d_ctx->cubetexture3dImage, &memReqs);
-  VkMemoryAllocateInfo allocInfo = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
-  allocInfo.allocationSize = memReqs.size;
-  VkPhysicalDeviceMemoryProperties memProps;
-  vkGetPhysicalDeviceMemoryProperties(v_ctx->physicalDevice, &memProps);
-  for (uint32_t i = 0; i < memProps.memoryTypeCount; i++) {
-      if ((memReqs.memoryTypeBits & (1 << i)) && (memProps.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)) {
-          allocInfo.memoryTypeIndex = i;
-          break;
-      }
-  }
-
-  if (vkAllocateMemory(v_ctx->device, &allocInfo, NULL, &cubetext3d_ctx->cubetexture3dImageMemory) != VK_SUCCESS) {
-      vkDestroyImage(v_ctx->device, cubetext3d_ctx->cubetexture3dImage, NULL);
-      stbi_image_free(imageData);
-      v_ctx->hasError = true;
-      return;
-  }
-
-  vkBindImageMemory(v_ctx->device, cubetext3d_ctx->cubetexture3dImage, cubetext3d_ctx->cubetexture3dImageMemory, 0);
-
-  VkCommandBuffer commandBuffer;
-  VkCommandBufferAllocateInfo cmdAllocInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
-  cmdAllocInfo.commandPool = v_ctx->commandPool;
-  cmdAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-  cmdAllocInfo.commandBufferCount = 1;
-  vkAllocateCommandBuffers(v_ctx->device, &cmdAllocInfo, &commandBuffer);
-
-  VkCommandBufferBeginInfo beginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
-  beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-  vkBeginCommandBuffer(commandBuffer, &beginInfo);
-
-  VkImageMemoryBarrier barrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
-  barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-  barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-  barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-  barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-  barrier.image = cubetext3d_ctx->cubetexture3dImage;
-  barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-  barrier.subresourceRange.levelCount = 1;
-  barrier.subresourceRange.layerCount = 1;
-  barrier.srcAccessMask = 0;
-  barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-
-  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, NULL, 0, NULL, 1, &barrier);
-
-  VkBufferImageCopy region = {0};
-  region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-  region.imageSubresource.layerCount = 1;
-  region.imageExtent.width = width;
-  region.imageExtent.height = height;
-  region.imageExtent.depth = 1;
-  vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, cubetext3d_ctx->cubetexture3dImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-
-  barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-  barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-  barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-  barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, NULL, 0, NULL, 1, &barrier);
-
-  vkEndCommandBuffer(commandBuffer);
-
-  VkSubmitInfo submitInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
-  submitInfo.commandBufferCount = 1;
-  submitInfo.pCommandBuffers = &commandBuffer;
-  vkQueueSubmit(v_ctx->graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-  vkQueueWaitIdle(v_ctx->graphicsQueue);
-
-  vkFreeCommandBuffers(v_ctx->device, v_ctx->commandPool, 1, &commandBuffer);
-  vkFreeMemory(v_ctx->device, stagingMemory, NULL);
-  vkDestroyBuffer(v_ctx->device, stagingBuffer, NULL);
-  stbi_image_free(imageData);
-
-  VkImageViewCreateInfo viewInfo = {VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
-  viewInfo.image = cubetext3d_ctx->cubetexture3dImage;
-  viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-  viewInfo.format = VK_FORMAT_R8G8B8A8_SRGB;
-  viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-  viewInfo.subresourceRange.levelCount = 1;
-  viewInfo.subresourceRange.layerCount = 1;
-  if (vkCreateImageView(v_ctx->device, &viewInfo, NULL, &cubetext3d_ctx->cubetexture3dImageView) != VK_SUCCESS) {
-      ecs_err("Failed to create texture image view");
-      v_ctx->hasError = true;
-      return;
-  }
-
-  VkSamplerCreateInfo samplerInfo = {VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO};
-  samplerInfo.magFilter = VK_FILTER_LINEAR;
-  samplerInfo.minFilter = VK_FILTER_LINEAR;
-  samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
-  samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-  samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-  samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-  if (vkCreateSampler(v_ctx->device, &samplerInfo, NULL, &cubetext3d_ctx->cubetexture3dSampler) != VK_SUCCESS) {
-      ecs_err("Failed to create texture sampler");
-      v_ctx->hasError = true;
-      return;
-  }
-}
-
+// imageData is RGBA8 decoded on the asset worker, cooked is set for BC cache hits
 static void createUniformBuffer(VulkanContext *v_ctx, CubeText3DContext *cubetext3d_ctx) {
   VkDeviceSize bufferSize = sizeof(UniformBufferObject);
   createBuffer(v_ctx, bufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
@@ -288,9 +156,9 @@ void CubeTexture3DSetupSystem(ecs_iter_t *it) {
       return;
   }
 
-  // Create Texture
-  createTextureImage(v_ctx, cubetext3d_ctx);
-  if (v_ctx->hasError) return;
+  // Create Texture, streamed: tail mips first, finer ones from the on screen size
+  // through the asset registry, other modules asking for the same file share it
+  cubetext3d_ctx->texture = flecs_texture_stream_acquire(it->world, ecs_id(CubeText3DContext), "assets/textures/light/texture_08.png");
 
   // Create Buffers
   CubeTextureVertex vertices[] = {
@@ -358,13 +226,8 @@ void CubeTexture3DSetupSystem(ecs_iter_t *it) {
   bufferInfo.offset = 0;
   bufferInfo.range = sizeof(UniformBufferObject);
 
-  VkDescriptorImageInfo imageInfo = {0};
-  imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-  imageInfo.imageView = cubetext3d_ctx->cubetexture3dImageView;
-  imageInfo.sampler = cubetext3d_ctx->cubetexture3dSampler;
-
-  VkWriteDescriptorSet descriptorWrites[2] = {
-      {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET},
+  // binding 1 (texture) is written when the asset upload finishes
+  VkWriteDescriptorSet descriptorWrites[1] = {
       {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET}
   };
   descriptorWrites[0].dstSet = cubetext3d_ctx->cubetexture3dDescriptorSet;
@@ -372,18 +235,16 @@ void CubeTexture3DSetupSystem(ecs_iter_t *it) {
   descriptorWrites[0].descriptorCount = 1;
   descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
   descriptorWrites[0].pBufferInfo = &bufferInfo;
-  descriptorWrites[1].dstSet = cubetext3d_ctx->cubetexture3dDescriptorSet;
-  descriptorWrites[1].dstBinding = 1;
-  descriptorWrites[1].descriptorCount = 1;
-  descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-  descriptorWrites[1].pImageInfo = &imageInfo;
 
-  vkUpdateDescriptorSets(v_ctx->device, 2, descriptorWrites, 0, NULL);
+  vkUpdateDescriptorSets(v_ctx->device, 1, descriptorWrites, 0, NULL);
 
   // VkShaderModule vertShaderModule = createShaderModule(v_ctx->device, cubetexture3d_vert_spv, sizeof(cubetexture3d_vert_spv));
   // VkShaderModule fragShaderModule = createShaderModule(v_ctx->device, cubetexture3d_frag_spv, sizeof(cubetexture3d_frag_spv));
-  VkShaderModule vertShaderModule = createShaderModuleH(v_ctx->device, cubetexture3d_vert_spv, sizeof(cubetexture3d_vert_spv));
-  VkShaderModule fragShaderModule = createShaderModuleH(v_ctx->device, cubetexture3d_frag_spv, sizeof(cubetexture3d_frag_spv));
+  // shared shader modules, released once the pipeline is built
+  ecs_entity_t vertShader = flecs_asset_shader_acquire(it->world, ecs_id(CubeText3DContext), cubetexture3d_vert_spv, sizeof(cubetexture3d_vert_spv));
+  ecs_entity_t fragShader = flecs_asset_shader_acquire(it->world, ecs_id(CubeText3DContext), cubetexture3d_frag_spv, sizeof(cubetexture3d_frag_spv));
+  VkShaderModule vertShaderModule = flecs_asset_shader_module(it->world, vertShader);
+  VkShaderModule fragShaderModule = flecs_asset_shader_module(it->world, fragShader);
   
   if (!vertShaderModule || !fragShaderModule) {
       ecs_err("Failed to create shader modules");
@@ -470,27 +331,45 @@ void CubeTexture3DSetupSystem(ecs_iter_t *it) {
       return;
   }
 
-  vkDestroyShaderModule(v_ctx->device, fragShaderModule, NULL);
-  vkDestroyShaderModule(v_ctx->device, vertShaderModule, NULL);
+  flecs_asset_release(it->world, ecs_id(CubeText3DContext), fragShader);
+  flecs_asset_release(it->world, ecs_id(CubeText3DContext), vertShader);
 
   ecs_log(1, "CubeTexture3DSetupSystem completed");
 }
 
 void CubeTexture3DRenderSystem(ecs_iter_t *it) {
-  SDLContext *sdl_ctx = ecs_singleton_ensure(it->world, SDLContext);
+  SDLContext *sdl_ctx = ecs_field(it, SDLContext, 0);
   if (!sdl_ctx || sdl_ctx->hasError || sdl_ctx->isShutDown) return;
 
-  VulkanContext *v_ctx = ecs_singleton_ensure(it->world, VulkanContext);
+  VulkanContext *v_ctx = ecs_field(it, VulkanContext, 1);
   if (!v_ctx || !v_ctx->device) {
       ecs_err("VulkanContext not available or device not initialized");
       return;
   }
 
-  CubeText3DContext *cubetext3d_ctx = ecs_singleton_ensure(it->world, CubeText3DContext);
+  CubeText3DContext *cubetext3d_ctx = ecs_field(it, CubeText3DContext, 2);
   if (!cubetext3d_ctx) {
       ecs_err("CubeText3DContext not available");
       return;
   }
+  const StreamedTexture *tex = flecs_texture_stream_get(it->world, cubetext3d_ctx->texture);
+  if (!tex) return; // still loading
+  if (tex->generation != cubetext3d_ctx->textureGeneration) {
+      // residency changed, the old view is gone
+      VkDescriptorImageInfo imageInfo = {0};
+      imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+      imageInfo.imageView = tex->view;
+      imageInfo.sampler = tex->sampler;
+
+      VkWriteDescriptorSet descriptorWrite = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+      descriptorWrite.dstSet = cubetext3d_ctx->cubetexture3dDescriptorSet;
+      descriptorWrite.dstBinding = 1;
+      descriptorWrite.descriptorCount = 1;
+      descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+      descriptorWrite.pImageInfo = &imageInfo;
+      vkUpdateDescriptorSets(v_ctx->device, 1, &descriptorWrite, 0, NULL);
+      cubetext3d_ctx->textureGeneration = tex->generation;
+  }
 
   static float angleY = 0.0f;
   static float angleX = 0.0f;
@@ -550,6 +429,11 @@ void CubeTexture3DRenderSystem(ecs_iter_t *it) {
 
   updateBuffer(v_ctx, cubetext3d_ctx->cubetexture3dUniformBufferMemory, sizeof(ubo), &ubo);
 
+  // a face (1 unit) at the view distance, in pixels, drives the streamed mip
+  float distance = -ubo.view[14];
+  float facePixels = (float)sdl_ctx->height / (2.0f * distance * tanHalfFov);
+  flecs_texture_stream_feedback(it->world, cubetext3d_ctx->texture, facePixels);
+
   vkCmdBindPipeline(v_ctx->commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, cubetext3d_ctx->cubetexture3dPipeline);
   VkDeviceSize offsets[] = {0};
   vkCmdBindVertexBuffers(v_ctx->commandBuffer, 0, 1, &cubetext3d_ctx->cubetexture3dVertexBuffer, offsets);
@@ -558,29 +442,14 @@ void CubeTexture3DRenderSystem(ecs_iter_t *it) {
   vkCmdDrawIndexed(v_ctx->commandBuffer, 36, 1, 0, 0, 0);
 }
 
+// registry slot, marked cleaned by the cleanup observer
+static ModuleHandle cubetexture3d_module_handle = MODULE_HANDLE_NONE;
+
 void cubetexture3d_cleanup_event_system(ecs_iter_t *it){
   ecs_print(1,"[cleanup] cubetexture3d_cleanup_event_system");
   flecs_cubetexture3d_cleanup(it->world);
 
-  ecs_query_t *q = ecs_query(it->world, {
-    .terms = {
-      { .id = ecs_id(PluginModule) },
-    }
-  });
-
-  ecs_iter_t s_it = ecs_query_iter(it->world, q);
-
-  while (ecs_query_next(&s_it)) {
-    PluginModule *p = ecs_field(&s_it, PluginModule, 0);
-    for (int i = 0; i < s_it.count; i ++) {
-      //ecs_print(1,"TEXT CHECK... Module Name : %s", p[i].name);
-      if(strcmp(p[i].name, "cubetexture3d_module") == 0){
-        p[i].isCleanUp = true;
-        //ecs_print(1,"text_module XXXXXXXXXX");
-        break;
-      }
-    }
-  }
+  module_set_state(it->world, cubetexture3d_module_handle, MODULE_STATE_CLEANED);
 
 
 }
@@ -605,16 +474,16 @@ void flecs_cubetexture3d_cleanup(ecs_world_t *world) {
     if (cubetext3d_ctx->cubetexture3dPipelineLayout != VK_NULL_HANDLE) vkDestroyPipelineLayout(v_ctx->device, cubetext3d_ctx->cubetexture3dPipelineLayout, NULL);
     if (cubetext3d_ctx->cubetexture3dDescriptorSetLayout != VK_NULL_HANDLE) vkDestroyDescriptorSetLayout(v_ctx->device, cubetext3d_ctx->cubetexture3dDescriptorSetLayout, NULL);
     if (cubetext3d_ctx->cubetexture3dDescriptorPool != VK_NULL_HANDLE) vkDestroyDescriptorPool(v_ctx->device, cubetext3d_ctx->cubetexture3dDescriptorPool, NULL);
-    if (cubetext3d_ctx->cubetexture3dSampler != VK_NULL_HANDLE) vkDestroySampler(v_ctx->device, cubetext3d_ctx->cubetexture3dSampler, NULL);
-    if (cubetext3d_ctx->cubetexture3dImageView != VK_NULL_HANDLE) vkDestroyImageView(v_ctx->device, cubetext3d_ctx->cubetexture3dImageView, NULL);
-    if (cubetext3d_ctx->cubetexture3dImageMemory != VK_NULL_HANDLE) vkFreeMemory(v_ctx->device, cubetext3d_ctx->cubetexture3dImageMemory, NULL);
-    if (cubetext3d_ctx->cubetexture3dImage != VK_NULL_HANDLE) vkDestroyImage(v_ctx->device, cubetext3d_ctx->cubetexture3dImage, NULL);
     if (cubetext3d_ctx->cubetexture3dVertexBufferMemory != VK_NULL_HANDLE) vkFreeMemory(v_ctx->device, cubetext3d_ctx->cubetexture3dVertexBufferMemory, NULL);
     if (cubetext3d_ctx->cubetexture3dVertexBuffer != VK_NULL_HANDLE) vkDestroyBuffer(v_ctx->device, cubetext3d_ctx->cubetexture3dVertexBuffer, NULL);
     if (cubetext3d_ctx->cubetexture3dIndexBufferMemory != VK_NULL_HANDLE) vkFreeMemory(v_ctx->device, cubetext3d_ctx->cubetexture3dIndexBufferMemory, NULL);
     if (cubetext3d_ctx->cubetexture3dIndexBuffer != VK_NULL_HANDLE) vkDestroyBuffer(v_ctx->device, cubetext3d_ctx->cubetexture3dIndexBuffer, NULL);
     if (cubetext3d_ctx->cubetexture3dUniformBufferMemory != VK_NULL_HANDLE) vkFreeMemory(v_ctx->device, cubetext3d_ctx->cubetexture3dUniformBufferMemory, NULL);
     if (cubetext3d_ctx->cubetexture3dUniformBuffer != VK_NULL_HANDLE) vkDestroyBuffer(v_ctx->device, cubetext3d_ctx->cubetexture3dUniformBuffer, NULL);
+    // releasing moves the context to another table, clear the field first
+    ecs_entity_t texture = cubetext3d_ctx->texture;
+    cubetext3d_ctx->texture = 0;
+    flecs_asset_release(world, ecs_id(CubeText3DContext), texture);
 
     ecs_log(1, "CubeTexture3D cleanup completed");
 }
@@ -640,6 +509,7 @@ void cubetext3d_register_systems(ecs_world_t *world){
 
   ecs_system_init(world, &(ecs_system_desc_t){
       .entity = ecs_entity(world, { .name = "CubeTexture3DRenderSystem", .add = ecs_ids(ecs_dependson(GlobalPhases.CMDBufferPhase)) }),
+      .query.terms = { ECS_SINGLETON_IN(SDLContext), ECS_SINGLETON_IN(VulkanContext), ECS_SINGLETON_INOUT(CubeText3DContext) },
       .callback = CubeTexture3DRenderSystem
   });
 }
@@ -651,10 +521,10 @@ void flecs_cubetexture3d_module_init(ecs_world_t *world) {
 
   ecs_singleton_set(world, CubeText3DContext, {0});
 
-  ecs_entity_t e = ecs_new(world);
-  ecs_set(world, e, PluginModule, { .name = "cubetexture3d_module", .isCleanUp = false });
+  cubetexture3d_module_handle = module_register(world, "cubetexture3d_module");
 
   cubetext3d_register_systems(world);
+  module_set_state(world, cubetexture3d_module_handle, MODULE_STATE_READY);
 
   ecs_log(1, "CubeTexture3d module initialized");
 }
@@ -0,0 +1,658 @@
+// glyph cache
+// R8 atlas pages filled on demand, see flecs_glyph_cache.h
+
+#include "flecs_glyph_cache.h"
+#include <stdlib.h>
+#include <string.h>
+#include <flecs.h>
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include FT_MODULE_H
+
+typedef struct {
+  uint16_t y;
+  uint16_t height;
+  uint16_t x;             // next free texel
+} GlyphShelf;
+
+typedef struct {
+  VkImage image;
+  VkDeviceMemory memory;
+  VkImageView view;
+  VkDescriptorSet set;
+  GlyphShelf shelves[GLYPH_MAX_SHELVES];
+  uint32_t shelfCount;
+  uint32_t nextY;         // top of the unused area below the shelves
+  uint64_t lastUsed;      // frame, least recently used page is cleared first
+  bool initialized;       // layout is SHADER_READ_ONLY (else UNDEFINED)
+  bool clear;             // clear before this frame's copies
+  GlyphCacheMode mode;    // glyphs of one mode per page, taken by an empty page
+  uint32_t generation;    // bumped on reset
+} GlyphPage;
+
+typedef struct {
+  FT_Face face;           // opened on the first glyph not inserted from a baked atlas
+  void *data;             // font file, the face points into it
+  size_t size;
+  bool faceFailed;        // not a font FreeType can open, glyphs cache as blanks
+  uint32_t pixelSize;     // current FT_Set_Pixel_Sizes
+  GlyphCacheMode mode;
+} GlyphFont;
+
+typedef struct {
+  uint64_t key;           // 0 = free slot
+  GlyphCacheGlyph glyph;
+} GlyphSlot;
+
+struct GlyphCache {
+  VkDevice device;
+  VkPhysicalDevice physicalDevice;
+  FT_Library ft;          // created with the first face
+  GlyphFont fonts[GLYPH_MAX_FONTS];
+  GlyphPage pages[GLYPH_MAX_PAGES];
+  uint32_t pageCount;
+  ecs_map_t glyphs;       // key -> slot index
+  GlyphSlot *slots;
+  uint32_t slotCount;
+  uint32_t slotCapacity;
+  uint32_t freeSlot;      // first slot with key 0 to try
+  VkDescriptorPool pool;
+  VkDescriptorSetLayout layout;
+  VkSampler sampler;
+  // per frame upload
+  VkBuffer staging;
+  VkDeviceMemory stagingMemory;
+  uint8_t *stagingMapped;
+  VkDeviceSize stagingUsed;
+  VkBufferImageCopy copies[GLYPH_MAX_COPIES];
+  uint8_t copyPage[GLYPH_MAX_COPIES];
+  uint32_t copyCount;
+  VkCommandBuffer commandBuffer;
+  VkFence fence;
+  bool submitted;
+  uint64_t frame;
+};
+
+static uint64_t glyphKey(int font, uint32_t pixelSize, uint32_t codepoint) {
+  // never 0, slot keys use 0 for free
+  return ((uint64_t)(font + 1) << 56) | ((uint64_t)pixelSize << 32) | codepoint;
+}
+
+static int glyphKeyFont(uint64_t key) {
+  return (int)(key >> 56) - 1;
+}
+
+static uint32_t findMemoryType(VkPhysicalDevice physicalDevice, uint32_t typeBits, VkMemoryPropertyFlags properties) {
+  VkPhysicalDeviceMemoryProperties memProps;
+  vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProps);
+  for (uint32_t i = 0; i < memProps.memoryTypeCount; i++) {
+    if ((typeBits & (1u << i)) && (memProps.memoryTypes[i].propertyFlags & properties) == properties) return i;
+  }
+  return UINT32_MAX;
+}
+
+static bool createPage(GlyphCache *cache, GlyphPage *page) {
+  VkDevice device = cache->device;
+  VkImageCreateInfo imageInfo = {VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+  imageInfo.imageType = VK_IMAGE_TYPE_2D;
+  imageInfo.format = VK_FORMAT_R8_UNORM;
+  imageInfo.extent = (VkExtent3D){GLYPH_PAGE_SIZE, GLYPH_PAGE_SIZE, 1};
+  imageInfo.mipLevels = 1; // glyphs are rasterised at the size they are drawn
+  imageInfo.arrayLayers = 1;
+  imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+  imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+  imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+  imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  if (vkCreateImage(device, &imageInfo, NULL, &page->image) != VK_SUCCESS) {
+    ecs_err("[glyph_cache] failed to create page image");
+    return false;
+  }
+
+  VkMemoryRequirements memReqs;
+  vkGetImageMemoryRequirements(device, page->image, &memReqs);
+  VkMemoryAllocateInfo allocInfo = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+  allocInfo.allocationSize = memReqs.size;
+  allocInfo.memoryTypeIndex = findMemoryType(cache->physicalDevice, memReqs.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+  if (allocInfo.memoryTypeIndex == UINT32_MAX || vkAllocateMemory(device, &allocInfo, NULL, &page->memory) != VK_SUCCESS) {
+    ecs_err("[glyph_cache] failed to allocate page memory");
+    vkDestroyImage(device, page->image, NULL);
+    page->image = VK_NULL_HANDLE;
+    return false;
+  }
+  vkBindImageMemory(device, page->image, page->memory, 0);
+
+  VkImageViewCreateInfo viewInfo = {VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
+  viewInfo.image = page->image;
+  viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+  viewInfo.format = VK_FORMAT_R8_UNORM;
+  viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  viewInfo.subresourceRange.levelCount = 1;
+  viewInfo.subresourceRange.layerCount = 1;
+  VkDescriptorSetAllocateInfo setInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
+  setInfo.descriptorPool = cache->pool;
+  setInfo.descriptorSetCount = 1;
+  setInfo.pSetLayouts = &cache->layout;
+  if (vkCreateImageView(device, &viewInfo, NULL, &page->view) != VK_SUCCESS ||
+      vkAllocateDescriptorSets(device, &setInfo, &page->set) != VK_SUCCESS) {
+    ecs_err("[glyph_cache] failed to create page view / descriptor set");
+    if (page->view) vkDestroyImageView(device, page->view, NULL);
+    vkFreeMemory(device, page->memory, NULL);
+    vkDestroyImage(device, page->image, NULL);
+    memset(page, 0, sizeof(GlyphPage));
+    return false;
+  }
+
+  VkDescriptorImageInfo imageDesc = {cache->sampler, page->view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+  VkWriteDescriptorSet write = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+  write.dstSet = page->set;
+  write.dstBinding = 0;
+  write.descriptorCount = 1;
+  write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  write.pImageInfo = &imageDesc;
+  vkUpdateDescriptorSets(device, 1, &write, 0, NULL);
+
+  page->clear = true; // padding and unused texels must read 0
+  return true;
+}
+
+GlyphCache *flecs_glyph_cache_create(VulkanContext *v_ctx, VkDescriptorPool pool, VkDescriptorSetLayout layout) {
+  GlyphCache *cache = calloc(1, sizeof(GlyphCache));
+  if (!cache) return NULL;
+  cache->device = v_ctx->device;
+  cache->physicalDevice = v_ctx->physicalDevice;
+  cache->pool = pool;
+  cache->layout = layout;
+  ecs_map_init(&cache->glyphs, NULL);
+
+  VkSamplerCreateInfo samplerInfo = {VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO};
+  samplerInfo.magFilter = VK_FILTER_LINEAR;
+  samplerInfo.minFilter = VK_FILTER_LINEAR;
+  samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+  samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+  samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+  samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+
+  VkBufferCreateInfo bufferInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+  bufferInfo.size = GLYPH_STAGING_SIZE;
+  bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+  bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+  VkCommandBufferAllocateInfo cmdInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+  cmdInfo.commandPool = v_ctx->commandPool;
+  cmdInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+  cmdInfo.commandBufferCount = 1;
+  VkFenceCreateInfo fenceInfo = {VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+
+  bool ok = vkCreateSampler(v_ctx->device, &samplerInfo, NULL, &cache->sampler) == VK_SUCCESS &&
+            vkCreateBuffer(v_ctx->device, &bufferInfo, NULL, &cache->staging) == VK_SUCCESS &&
+            vkAllocateCommandBuffers(v_ctx->device, &cmdInfo, &cache->commandBuffer) == VK_SUCCESS &&
+            vkCreateFence(v_ctx->device, &fenceInfo, NULL, &cache->fence) == VK_SUCCESS;
+  if (ok) {
+    VkMemoryRequirements memReqs;
+    vkGetBufferMemoryRequirements(v_ctx->device, cache->staging, &memReqs);
+    VkMemoryAllocateInfo allocInfo = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+    allocInfo.allocationSize = memReqs.size;
+    allocInfo.memoryTypeIndex = findMemoryType(v_ctx->physicalDevice, memReqs.memoryTypeBits,
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    ok = allocInfo.memoryTypeIndex != UINT32_MAX &&
+         vkAllocateMemory(v_ctx->device, &allocInfo, NULL, &cache->stagingMemory) == VK_SUCCESS &&
+         vkBindBufferMemory(v_ctx->device, cache->staging, cache->stagingMemory, 0) == VK_SUCCESS &&
+         vkMapMemory(v_ctx->device, cache->stagingMemory, 0, GLYPH_STAGING_SIZE, 0, (void **)&cache->stagingMapped) == VK_SUCCESS;
+  }
+  if (!ok) {
+    ecs_err("[glyph_cache] failed to create sampler / staging / upload command buffer");
+    flecs_glyph_cache_destroy(cache, v_ctx);
+    return NULL;
+  }
+  return cache;
+}
+
+void flecs_glyph_cache_destroy(GlyphCache *cache, VulkanContext *v_ctx) {
+  if (!cache) return;
+  if (v_ctx && v_ctx->device) {
+    for (uint32_t i = 0; i < cache->pageCount; i++) {
+      GlyphPage *page = &cache->pages[i];
+      // descriptor sets go with the module's pool
+      if (page->view) vkDestroyImageView(v_ctx->device, page->view, NULL);
+      if (page->image) vkDestroyImage(v_ctx->device, page->image, NULL);
+      if (page->memory) vkFreeMemory(v_ctx->device, page->memory, NULL);
+    }
+    if (cache->sampler) vkDestroySampler(v_ctx->device, cache->sampler, NULL);
+    if (cache->stagingMemory) vkFreeMemory(v_ctx->device, cache->stagingMemory, NULL);
+    if (cache->staging) vkDestroyBuffer(v_ctx->device, cache->staging, NULL);
+    if (cache->fence) vkDestroyFence(v_ctx->device, cache->fence, NULL);
+    if (cache->commandBuffer) vkFreeCommandBuffers(v_ctx->device, v_ctx->commandPool, 1, &cache->commandBuffer);
+  }
+  for (int i = 0; i < GLYPH_MAX_FONTS; i++) {
+    if (cache->fonts[i].face) FT_Done_Face(cache->fonts[i].face);
+    free(cache->fonts[i].data);
+  }
+  if (cache->ft) FT_Done_FreeType(cache->ft);
+  ecs_map_fini(&cache->glyphs);
+  free(cache->slots);
+  free(cache);
+}
+
+//===============================================
+// slots
+//===============================================
+
+static void freeSlot(GlyphCache *cache, uint32_t index) {
+  ecs_map_remove(&cache->glyphs, cache->slots[index].key);
+  cache->slots[index].key = 0;
+  if (index < cache->freeSlot) cache->freeSlot = index;
+}
+
+static bool storeGlyph(GlyphCache *cache, uint64_t key, const GlyphCacheGlyph *glyph) {
+  while (cache->freeSlot < cache->slotCount && cache->slots[cache->freeSlot].key) cache->freeSlot++;
+  uint32_t index = cache->freeSlot;
+  if (index == cache->slotCount) {
+    if (cache->slotCount == cache->slotCapacity) {
+      uint32_t capacity = cache->slotCapacity ? cache->slotCapacity * 2 : 256;
+      GlyphSlot *grown = realloc(cache->slots, sizeof(GlyphSlot) * capacity);
+      if (!grown) return false;
+      cache->slots = grown;
+      cache->slotCapacity = capacity;
+    }
+    cache->slotCount++;
+  }
+  cache->slots[index].key = key;
+  cache->slots[index].glyph = *glyph;
+  cache->freeSlot = index + 1;
+  ecs_map_insert(&cache->glyphs, key, (ecs_map_val_t)index);
+  return true;
+}
+
+//===============================================
+// shelf packer
+//===============================================
+
+static bool shelfAlloc(GlyphPage *page, uint32_t w, uint32_t h, uint16_t *x, uint16_t *y) {
+  // tightest existing shelf, at most half again as tall as the glyph
+  GlyphShelf *best = NULL;
+  for (uint32_t i = 0; i < page->shelfCount; i++) {
+    GlyphShelf *shelf = &page->shelves[i];
+    if (shelf->height < h || shelf->height > h + h / 2 + 2 || shelf->x + w > GLYPH_PAGE_SIZE) continue;
+    if (!best || shelf->height < best->height) best = shelf;
+  }
+  if (!best) {
+    uint32_t height = (h + 3) & ~3u; // rounded up, neighbouring sizes share shelves
+    if (page->shelfCount == GLYPH_MAX_SHELVES || page->nextY + height > GLYPH_PAGE_SIZE) return false;
+    best = &page->shelves[page->shelfCount++];
+    best->y = (uint16_t)page->nextY;
+    best->height = (uint16_t)height;
+    best->x = 0;
+    page->nextY += height;
+  }
+  *x = best->x;
+  *y = best->y;
+  best->x += (uint16_t)w;
+  return true;
+}
+
+static void resetPage(GlyphCache *cache, uint32_t pageIndex) {
+  GlyphPage *page = &cache->pages[pageIndex];
+  for (uint32_t i = 0; i < cache->slotCount; i++) {
+    GlyphSlot *slot = &cache->slots[i];
+    if (slot->key && slot->glyph.width && slot->glyph.page == pageIndex) freeSlot(cache, i);
+  }
+  // copies not flushed yet would land on the new glyphs
+  uint32_t kept = 0;
+  for (uint32_t i = 0; i < cache->copyCount; i++) {
+    if (cache->copyPage[i] == pageIndex) continue;
+    cache->copies[kept] = cache->copies[i];
+    cache->copyPage[kept++] = cache->copyPage[i];
+  }
+  cache->copyCount = kept;
+  page->shelfCount = 0;
+  page->nextY = 0;
+  page->clear = true;
+  page->generation++;
+  ecs_dbg("[glyph_cache] page %u evicted", pageIndex);
+}
+
+static bool placeGlyph(GlyphCache *cache, GlyphCacheMode mode, uint32_t w, uint32_t h, uint32_t *pageIndex, uint16_t *x, uint16_t *y) {
+  for (uint32_t i = 0; i < cache->pageCount; i++) {
+    if (cache->pages[i].mode == mode && shelfAlloc(&cache->pages[i], w, h, x, y)) {
+      *pageIndex = i;
+      return true;
+    }
+  }
+  if (cache->pageCount < GLYPH_MAX_PAGES) {
+    if (createPage(cache, &cache->pages[cache->pageCount])) {
+      *pageIndex = cache->pageCount++;
+      cache->pages[*pageIndex].mode = mode;
+      return shelfAlloc(&cache->pages[*pageIndex], w, h, x, y);
+    }
+  }
+  // full: clear the least recently used page, never one drawn this frame
+  int lru = -1;
+  for (uint32_t i = 0; i < cache->pageCount; i++) {
+    if (cache->pages[i].lastUsed == cache->frame) continue;
+    if (lru < 0 || cache->pages[i].lastUsed < cache->pages[lru].lastUsed) lru = (int)i;
+  }
+  if (lru < 0) return false;
+  resetPage(cache, (uint32_t)lru);
+  cache->pages[lru].mode = mode;
+  *pageIndex = (uint32_t)lru;
+  return shelfAlloc(&cache->pages[lru], w, h, x, y);
+}
+
+//===============================================
+// insert / get
+//===============================================
+
+// last flush was submitted ahead of the previous frame, long done by now
+static void waitUpload(GlyphCache *cache) {
+  if (!cache->submitted) return;
+  vkWaitForFences(cache->device, 1, &cache->fence, VK_TRUE, UINT64_MAX);
+  vkResetFences(cache->device, 1, &cache->fence);
+  cache->submitted = false;
+  cache->stagingUsed = 0;
+}
+
+bool flecs_glyph_cache_insert(GlyphCache *cache, int font, uint32_t pixelSize, uint32_t codepoint,
+                              const uint8_t *bitmap, int pitch, const GlyphCacheGlyph *metrics) {
+  if (font < 0 || font >= GLYPH_MAX_FONTS || pixelSize > GLYPH_MAX_PIXEL_SIZE) return false;
+  GlyphCacheMode mode = cache->fonts[font].mode;
+  if (mode == GLYPH_MODE_SDF && pixelSize != GLYPH_SDF_PIXEL_SIZE) return false;
+  uint64_t key = glyphKey(font, pixelSize, codepoint);
+  if (ecs_map_get(&cache->glyphs, key)) return true;
+  GlyphCacheGlyph glyph = *metrics;
+  glyph.page = 0;
+  glyph.x = glyph.y = 0;
+  glyph.u0 = glyph.v0 = glyph.u1 = glyph.v1 = 0.0f;
+  glyph.scale = 1.0f;
+  if (!glyph.width || !glyph.height) {
+    glyph.width = glyph.height = 0;
+    return storeGlyph(cache, key, &glyph);
+  }
+
+  waitUpload(cache);
+  // padded rect, the padding texels are uploaded as 0 so an evicted page's
+  // old pixels never show at the glyph edges
+  uint32_t w = glyph.width + GLYPH_PADDING;
+  uint32_t h = glyph.height + GLYPH_PADDING;
+  VkDeviceSize offset = (cache->stagingUsed + 3) & ~(VkDeviceSize)3;
+  if (offset + (VkDeviceSize)w * h > GLYPH_STAGING_SIZE || cache->copyCount == GLYPH_MAX_COPIES) return false;
+
+  uint32_t pageIndex;
+  if (!placeGlyph(cache, mode, w, h, &pageIndex, &glyph.x, &glyph.y)) return false;
+  glyph.page = (uint16_t)pageIndex;
+  glyph.u0 = (float)glyph.x / GLYPH_PAGE_SIZE;
+  glyph.v0 = (float)glyph.y / GLYPH_PAGE_SIZE;
+  glyph.u1 = (float)(glyph.x + glyph.width) / GLYPH_PAGE_SIZE;
+  glyph.v1 = (float)(glyph.y + glyph.height) / GLYPH_PAGE_SIZE;
+  if (!storeGlyph(cache, key, &glyph)) return false;
+  cache->pages[pageIndex].lastUsed = cache->frame;
+
+  uint8_t *dst = cache->stagingMapped + offset;
+  for (uint32_t row = 0; row < glyph.height; row++) {
+    memcpy(dst + row * w, bitmap + (ptrdiff_t)row * pitch, glyph.width);
+    memset(dst + row * w + glyph.width, 0, GLYPH_PADDING);
+  }
+  memset(dst + (size_t)glyph.height * w, 0, (size_t)GLYPH_PADDING * w);
+  cache->stagingUsed = offset + (VkDeviceSize)w * h;
+
+  VkBufferImageCopy *copy = &cache->copies[cache->copyCount];
+  memset(copy, 0, sizeof(*copy));
+  copy->bufferOffset = offset;
+  copy->imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  copy->imageSubresource.layerCount = 1;
+  copy->imageOffset = (VkOffset3D){glyph.x, glyph.y, 0};
+  copy->imageExtent = (VkExtent3D){w, h, 1};
+  cache->copyPage[cache->copyCount++] = (uint8_t)pageIndex;
+  return true;
+}
+
+// FreeType only starts when a glyph is missing from the baked atlas, a cold
+// start that stays within it never initialises the library
+static bool openFace(GlyphCache *cache, GlyphFont *f) {
+  if (!cache->ft) {
+    if (FT_Init_FreeType(&cache->ft)) {
+      ecs_err("[glyph_cache] FreeType init failed");
+      cache->ft = NULL;
+      return false;
+    }
+    // outline ("sdf") and bitmap ("bsdf") renderers, same range the shader expects
+    FT_Int spread = GLYPH_SDF_SPREAD;
+    FT_Property_Set(cache->ft, "sdf", "spread", &spread);
+    FT_Property_Set(cache->ft, "bsdf", "spread", &spread);
+  }
+  if (FT_New_Memory_Face(cache->ft, f->data, (FT_Long)f->size, 0, &f->face)) {
+    ecs_err("[glyph_cache] font load failed");
+    f->face = NULL;
+    return false;
+  }
+  f->pixelSize = 0;
+  return true;
+}
+
+static bool rasterizeGlyph(GlyphCache *cache, int font, uint32_t pixelSize, uint32_t codepoint) {
+  GlyphFont *f = &cache->fonts[font];
+  GlyphCacheGlyph metrics = {0};
+  if (!f->data) return false;
+  if (!f->face && (f->faceFailed || !openFace(cache, f))) {
+    f->faceFailed = true;
+    return flecs_glyph_cache_insert(cache, font, pixelSize, codepoint, NULL, 0, &metrics);
+  }
+  if (f->pixelSize != pixelSize) {
+    if (FT_Set_Pixel_Sizes(f->face, 0, pixelSize)) return false;
+    f->pixelSize = pixelSize;
+  }
+  // missing glyphs render the font's .notdef box, cached like any other.
+  // SDF is its own render mode, not a load flag
+  FT_Error error = f->mode == GLYPH_MODE_SDF
+    ? FT_Load_Char(f->face, codepoint, FT_LOAD_DEFAULT) || FT_Render_Glyph(f->face->glyph, FT_RENDER_MODE_SDF)
+    : FT_Load_Char(f->face, codepoint, FT_LOAD_RENDER);
+  if (error) {
+    return flecs_glyph_cache_insert(cache, font, pixelSize, codepoint, NULL, 0, &metrics);
+  }
+  FT_GlyphSlot slot = f->face->glyph;
+  metrics.width = (uint16_t)slot->bitmap.width;
+  metrics.height = (uint16_t)slot->bitmap.rows;
+  metrics.bearingX = (int16_t)slot->bitmap_left;
+  metrics.bearingY = (int16_t)slot->bitmap_top;
+  metrics.advanceX = slot->advance.x / 64.0f;
+  return flecs_glyph_cache_insert(cache, font, pixelSize, codepoint, slot->bitmap.buffer, slot->bitmap.pitch, &metrics);
+}
+
+bool flecs_glyph_cache_get(GlyphCache *cache, int font, uint32_t pixelSize, uint32_t codepoint, GlyphCacheGlyph *glyph) {
+  if (!cache || font < 0 || font >= GLYPH_MAX_FONTS || !pixelSize) return false;
+  // one distance field serves every size of an SDF font
+  uint32_t rasterSize = cache->fonts[font].mode == GLYPH_MODE_SDF ? GLYPH_SDF_PIXEL_SIZE : pixelSize;
+  if (rasterSize > GLYPH_MAX_PIXEL_SIZE) return false;
+  uint64_t key = glyphKey(font, rasterSize, codepoint);
+  ecs_map_val_t *found = ecs_map_get(&cache->glyphs, key);
+  if (!found) {
+    if (!rasterizeGlyph(cache, font, rasterSize, codepoint)) return false;
+    found = ecs_map_get(&cache->glyphs, key);
+    if (!found) return false;
+  }
+  *glyph = cache->slots[*found].glyph;
+  glyph->scale = (float)pixelSize / rasterSize;
+  if (glyph->width) cache->pages[glyph->page].lastUsed = cache->frame;
+  return true;
+}
+
+int flecs_glyph_cache_set_font(GlyphCache *cache, int font, GlyphCacheMode mode, void *data, size_t size) {
+  if (!cache || !data) return -1;
+  if (font < 0) {
+    for (int i = 0; i < GLYPH_MAX_FONTS && font < 0; i++) {
+      if (!cache->fonts[i].data) font = i;
+    }
+    if (font < 0) {
+      ecs_err("[glyph_cache] more than %d fonts", GLYPH_MAX_FONTS);
+      return -1;
+    }
+  } else if (font >= GLYPH_MAX_FONTS) {
+    return -1;
+  }
+
+  // the face opens on the first glyph that has to be rasterised
+  GlyphFont *f = &cache->fonts[font];
+  if (f->face) FT_Done_Face(f->face);
+  free(f->data);
+  f->face = NULL;
+  f->data = data;
+  f->size = size;
+  f->faceFailed = false;
+  f->pixelSize = 0;
+  f->mode = mode;
+
+  // reload: the new outlines replace every cached size, their texels stay
+  // allocated until the page is evicted
+  for (uint32_t i = 0; i < cache->slotCount; i++) {
+    if (cache->slots[i].key && glyphKeyFont(cache->slots[i].key) == font) freeSlot(cache, i);
+  }
+  return font;
+}
+
+GlyphCacheMode flecs_glyph_cache_font_mode(const GlyphCache *cache, int font) {
+  return cache && font >= 0 && font < GLYPH_MAX_FONTS ? cache->fonts[font].mode : GLYPH_MODE_COVERAGE;
+}
+
+//===============================================
+// frame
+//===============================================
+
+void flecs_glyph_cache_begin_frame(GlyphCache *cache) {
+  if (cache) cache->frame++;
+}
+
+static void pageBarrier(VkCommandBuffer cmd, VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout,
+                        VkAccessFlags srcAccess, VkAccessFlags dstAccess, VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage) {
+  VkImageMemoryBarrier barrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+  barrier.oldLayout = oldLayout;
+  barrier.newLayout = newLayout;
+  barrier.srcAccessMask = srcAccess;
+  barrier.dstAccessMask = dstAccess;
+  barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.image = image;
+  barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  barrier.subresourceRange.levelCount = 1;
+  barrier.subresourceRange.layerCount = 1;
+  vkCmdPipelineBarrier(cmd, srcStage, dstStage, 0, 0, NULL, 0, NULL, 1, &barrier);
+}
+
+void flecs_glyph_cache_flush(GlyphCache *cache, VulkanContext *v_ctx) {
+  if (!cache) return;
+  bool work = cache->copyCount > 0;
+  for (uint32_t i = 0; i < cache->pageCount; i++) work = work || cache->pages[i].clear;
+  if (!work) return;
+
+  VkCommandBufferBeginInfo beginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+  beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  vkResetCommandBuffer(cache->commandBuffer, 0);
+  if (vkBeginCommandBuffer(cache->commandBuffer, &beginInfo) != VK_SUCCESS) {
+    ecs_err("[glyph_cache] failed to begin upload command buffer");
+    return;
+  }
+  VkCommandBuffer cmd = cache->commandBuffer;
+  VkBufferImageCopy regions[GLYPH_MAX_COPIES];
+  for (uint32_t p = 0; p < cache->pageCount; p++) {
+    GlyphPage *page = &cache->pages[p];
+    uint32_t regionCount = 0;
+    for (uint32_t i = 0; i < cache->copyCount; i++) {
+      if (cache->copyPage[i] == p) regions[regionCount++] = cache->copies[i];
+    }
+    if (!regionCount && !page->clear) continue;
+
+    pageBarrier(cmd, page->image,
+                page->initialized ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+    if (page->clear) {
+      VkClearColorValue zero = {{0.0f, 0.0f, 0.0f, 0.0f}};
+      VkImageSubresourceRange range = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+      vkCmdClearColorImage(cmd, page->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &zero, 1, &range);
+      if (regionCount) {
+        pageBarrier(cmd, page->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                    VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+      }
+    }
+    if (regionCount) {
+      vkCmdCopyBufferToImage(cmd, cache->staging, page->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, regionCount, regions);
+    }
+    pageBarrier(cmd, page->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+    page->initialized = true;
+    page->clear = false;
+  }
+  if (vkEndCommandBuffer(cmd) != VK_SUCCESS) {
+    ecs_err("[glyph_cache] failed to end upload command buffer");
+    return;
+  }
+
+  // no semaphore: same queue, the barriers above order it before the frame
+  VkSubmitInfo submitInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
+  submitInfo.commandBufferCount = 1;
+  submitInfo.pCommandBuffers = &cmd;
+  if (vkQueueSubmit(v_ctx->graphicsQueue, 1, &submitInfo, cache->fence) != VK_SUCCESS) {
+    ecs_err("[glyph_cache] failed to submit glyph upload");
+    return;
+  }
+  cache->submitted = true;
+  cache->copyCount = 0;
+}
+
+uint32_t flecs_glyph_cache_page_count(const GlyphCache *cache) {
+  return cache ? cache->pageCount : 0;
+}
+
+VkDescriptorSet flecs_glyph_cache_page_set(const GlyphCache *cache, uint32_t page) {
+  return cache && page < cache->pageCount ? cache->pages[page].set : VK_NULL_HANDLE;
+}
+
+GlyphCacheMode flecs_glyph_cache_page_mode(const GlyphCache *cache, uint32_t page) {
+  return cache && page < cache->pageCount ? cache->pages[page].mode : GLYPH_MODE_COVERAGE;
+}
+
+uint32_t flecs_glyph_cache_page_generation(const GlyphCache *cache, uint32_t page) {
+  return cache && page < cache->pageCount ? cache->pages[page].generation : 0;
+}
+
+void flecs_glyph_cache_touch_page(GlyphCache *cache, uint32_t page) {
+  if (cache && page < cache->pageCount) cache->pages[page].lastUsed = cache->frame;
+}
+
+//===============================================
+// utf-8
+//===============================================
+
+uint32_t flecs_utf8_next(const char **text) {
+  const uint8_t *s = (const uint8_t *)*text;
+  uint32_t c = s[0];
+  int extra = 0;
+  if (c < 0x80) {
+    *text += 1;
+    return c;
+  } else if ((c & 0xE0) == 0xC0) {
+    c &= 0x1F;
+    extra = 1;
+  } else if ((c & 0xF0) == 0xE0) {
+    c &= 0x0F;
+    extra = 2;
+  } else if ((c & 0xF8) == 0xF0) {
+    c &= 0x07;
+    extra = 3;
+  } else {
+    *text += 1;
+    return 0xFFFD;
+  }
+  for (int i = 1; i <= extra; i++) {
+    if ((s[i] & 0xC0) != 0x80) {
+      *text += i; // stop at the byte that broke the sequence
+      return 0xFFFD;
+    }
+    c = (c << 6) | (s[i] & 0x3F);
+  }
+  *text += extra + 1;
+  // overlong forms and surrogates are not code points
+  static const uint32_t minimum[4] = {0, 0x80, 0x800, 0x10000};
+  if (c < minimum[extra] || c > 0x10FFFF || (c >= 0xD800 && c <= 0xDFFF)) return 0xFFFD;
+  return c;
+}
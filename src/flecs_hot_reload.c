@@ -0,0 +1,331 @@
+// asset hot reload
+// watcher thread marks changed files, HotReloadSystem waits for the writes to
+// settle (debounce) and re-queues the matching AssetHandle jobs.
+
+#include "flecs_hot_reload.h"
+#include <stdio.h>
+#include <string.h>
+#include "flecs_sdl.h"
+#include "flecs_vfs.h"
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+typedef struct {
+  char path[ASSET_PATH_MAX];          // vfs path, same as AssetHandle.path
+  char realPath[HOT_RELOAD_PATH_MAX]; // os path being watched
+  SDL_Time modifyTime;                // polling
+  Uint64 size;
+  Uint64 changedAt;                   // SDL_GetTicks of the last change, 0 = clean
+} WatchedFile;
+
+#ifdef __linux__
+typedef struct {
+  int wd;
+  char dir[HOT_RELOAD_PATH_MAX];
+} WatchedDir;
+#endif
+
+struct HotReloadWatcher {
+  SDL_Mutex *lock;                    // files, dirs
+  SDL_Thread *thread;
+  SDL_AtomicInt quit;
+  WatchedFile *files;
+  int fileCount;
+  int fileCapacity;
+#ifdef __linux__
+  int inotifyFd;                      // -1 = polling
+  WatchedDir *dirs;
+  int dirCount;
+  int dirCapacity;
+#endif
+};
+
+static void markChanged(HotReloadWatcher *w, const char *realPath) {
+  for (int i = 0; i < w->fileCount; i++) {
+    if (strcmp(w->files[i].realPath, realPath) == 0) w->files[i].changedAt = SDL_GetTicks();
+  }
+}
+
+static void pollFiles(HotReloadWatcher *w) {
+  SDL_LockMutex(w->lock);
+  for (int i = 0; i < w->fileCount; i++) {
+    WatchedFile *f = &w->files[i];
+    SDL_PathInfo info;
+    if (!SDL_GetPathInfo(f->realPath, &info)) continue; // mid save (delete + rename)
+    if (info.modify_time != f->modifyTime || info.size != f->size) {
+      f->modifyTime = info.modify_time;
+      f->size = info.size;
+      f->changedAt = SDL_GetTicks();
+    }
+  }
+  SDL_UnlockMutex(w->lock);
+}
+
+#ifdef __linux__
+static void readInotify(HotReloadWatcher *w) {
+  // aligned for struct inotify_event
+  char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+  ssize_t len;
+  while ((len = read(w->inotifyFd, buffer, sizeof(buffer))) > 0) {
+    SDL_LockMutex(w->lock);
+    for (char *p = buffer; p < buffer + len;) {
+      const struct inotify_event *event = (const struct inotify_event *)p;
+      p += sizeof(struct inotify_event) + event->len;
+      if (!event->len) continue;
+      for (int d = 0; d < w->dirCount; d++) {
+        if (w->dirs[d].wd != event->wd) continue;
+        char realPath[HOT_RELOAD_PATH_MAX];
+        snprintf(realPath, sizeof(realPath), "%s/%s", w->dirs[d].dir, event->name);
+        markChanged(w, realPath);
+        break;
+      }
+    }
+    SDL_UnlockMutex(w->lock);
+  }
+}
+#endif
+
+static int hot_reload_watcher_main(void *data) {
+  HotReloadWatcher *w = data;
+  while (!SDL_GetAtomicInt(&w->quit)) {
+#ifdef __linux__
+    if (w->inotifyFd >= 0) {
+      struct pollfd pfd = { .fd = w->inotifyFd, .events = POLLIN };
+      if (poll(&pfd, 1, HOT_RELOAD_POLL_MS) > 0) readInotify(w);
+      continue;
+    }
+#endif
+    SDL_Delay(HOT_RELOAD_POLL_MS);
+    pollFiles(w);
+  }
+  return 0;
+}
+
+void flecs_hot_reload_watch(ecs_world_t *world, const char *path) {
+  HotReloadContext *ctx = ecs_singleton_ensure(world, HotReloadContext);
+  if (!ctx || !ctx->watcher || !path) return;
+  HotReloadWatcher *w = ctx->watcher;
+
+  char realPath[HOT_RELOAD_PATH_MAX];
+  if (!flecs_vfs_real_path(path, realPath, sizeof(realPath))) return; // packed, nothing to watch
+
+  SDL_LockMutex(w->lock);
+  for (int i = 0; i < w->fileCount; i++) {
+    if (strcmp(w->files[i].path, path) == 0) {
+      SDL_UnlockMutex(w->lock);
+      return;
+    }
+  }
+  if (w->fileCount == w->fileCapacity) {
+    int capacity = w->fileCapacity ? w->fileCapacity * 2 : 32;
+    WatchedFile *grown = realloc(w->files, sizeof(WatchedFile) * capacity);
+    if (!grown) {
+      SDL_UnlockMutex(w->lock);
+      return;
+    }
+    w->files = grown;
+    w->fileCapacity = capacity;
+  }
+  WatchedFile *f = &w->files[w->fileCount++];
+  memset(f, 0, sizeof(WatchedFile));
+  snprintf(f->path, sizeof(f->path), "%s", path);
+  snprintf(f->realPath, sizeof(f->realPath), "%s", realPath);
+  SDL_PathInfo info;
+  if (SDL_GetPathInfo(realPath, &info)) {
+    f->modifyTime = info.modify_time;
+    f->size = info.size;
+  }
+
+#ifdef __linux__
+  // one watch per directory, atomic saves (write tmp + rename) show up as IN_MOVED_TO
+  if (w->inotifyFd >= 0) {
+    char dir[HOT_RELOAD_PATH_MAX];
+    snprintf(dir, sizeof(dir), "%s", realPath);
+    char *slash = strrchr(dir, '/');
+    if (slash) *slash = '\0';
+    int wd = inotify_add_watch(w->inotifyFd, dir, IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+    bool known = wd < 0;
+    for (int d = 0; d < w->dirCount && !known; d++) known = w->dirs[d].wd == wd;
+    if (!known) {
+      if (w->dirCount == w->dirCapacity) {
+        int capacity = w->dirCapacity ? w->dirCapacity * 2 : 16;
+        WatchedDir *grown = realloc(w->dirs, sizeof(WatchedDir) * capacity);
+        if (grown) {
+          w->dirs = grown;
+          w->dirCapacity = capacity;
+        }
+      }
+      if (w->dirCount < w->dirCapacity) {
+        w->dirs[w->dirCount].wd = wd;
+        snprintf(w->dirs[w->dirCount].dir, HOT_RELOAD_PATH_MAX, "%s", dir);
+        w->dirCount++;
+      }
+    }
+  }
+#endif
+  ctx->watchedCount = (uint32_t)w->fileCount;
+  SDL_UnlockMutex(w->lock);
+  ecs_log(1, "[hot_reload] watching %s", realPath);
+}
+
+//===============================================
+// systems
+//===============================================
+
+// every AssetHandle that gets set (load, reload) is watched
+void HotReloadWatchObserver(ecs_iter_t *it) {
+  AssetHandle *handles = ecs_field(it, AssetHandle, 0);
+  for (int i = 0; i < it->count; i++) {
+    flecs_hot_reload_watch(it->world, handles[i].path);
+  }
+}
+
+void HotReloadSystem(ecs_iter_t *it) {
+  SDLContext *sdl_ctx = ecs_field(it, SDLContext, 0);
+  if (!sdl_ctx || sdl_ctx->hasError || sdl_ctx->isShutDown) return;
+  HotReloadContext *ctx = ecs_field(it, HotReloadContext, 1);
+  if (!ctx || !ctx->watcher) return;
+  HotReloadWatcher *w = ctx->watcher;
+
+  // settled files only, a half written png would just fail to decode
+  char changed[16][ASSET_PATH_MAX];
+  int changedCount = 0;
+  Uint64 now = SDL_GetTicks();
+  SDL_LockMutex(w->lock);
+  for (int i = 0; i < w->fileCount && changedCount < 16; i++) {
+    WatchedFile *f = &w->files[i];
+    if (!f->changedAt || now - f->changedAt < ctx->debounceMs) continue;
+    f->changedAt = 0;
+    memcpy(changed[changedCount++], f->path, ASSET_PATH_MAX);
+  }
+  SDL_UnlockMutex(w->lock);
+  if (!changedCount) return;
+
+  for (int c = 0; c < changedCount; c++) {
+    ecs_entity_t assets[32];
+    int assetCount = 0;
+    bool busy = false;
+    ecs_iter_t ait = ecs_each(it->world, AssetHandle);
+    while (ecs_each_next(&ait)) {
+      AssetHandle *handles = ecs_field(&ait, AssetHandle, 0);
+      for (int i = 0; i < ait.count; i++) {
+        if (strcmp(handles[i].path, changed[c]) != 0) continue;
+        busy = busy || handles[i].state == ASSET_STATE_LOADING || handles[i].reloading;
+        if (assetCount < 32) assets[assetCount++] = ait.entities[i];
+      }
+    }
+
+    if (busy) {
+      // still decoding the previous version, try again once it lands
+      SDL_LockMutex(w->lock);
+      for (int i = 0; i < w->fileCount; i++) {
+        if (strcmp(w->files[i].path, changed[c]) == 0) w->files[i].changedAt = now;
+      }
+      SDL_UnlockMutex(w->lock);
+      continue;
+    }
+
+    ecs_print(1, "[hot_reload] %s changed, reloading %d asset(s)", changed[c], assetCount);
+    for (int i = 0; i < assetCount; i++) {
+      if (flecs_asset_reload(it->world, assets[i])) ctx->reloadCount++;
+    }
+  }
+}
+
+void flecs_hot_reload_cleanup(ecs_world_t *world) {
+  HotReloadContext *ctx = ecs_singleton_ensure(world, HotReloadContext);
+  if (!ctx || !ctx->watcher) return;
+  HotReloadWatcher *w = ctx->watcher;
+
+  ecs_log(1, "Hot reload cleanup starting...");
+  SDL_SetAtomicInt(&w->quit, 1);
+  if (w->thread) SDL_WaitThread(w->thread, NULL);
+#ifdef __linux__
+  if (w->inotifyFd >= 0) close(w->inotifyFd);
+  free(w->dirs);
+#endif
+  free(w->files);
+  SDL_DestroyMutex(w->lock);
+  free(w);
+  ctx->watcher = NULL;
+  ecs_log(1, "Hot reload cleanup completed");
+}
+
+// registry slot, marked cleaned by the cleanup observer
+static ModuleHandle hot_reload_module_handle = MODULE_HANDLE_NONE;
+
+void hot_reload_cleanup_event_system(ecs_iter_t *it) {
+  ecs_print(1, "[cleanup] hot_reload_cleanup_event_system");
+  flecs_hot_reload_cleanup(it->world);
+  module_set_state(it->world, hot_reload_module_handle, MODULE_STATE_CLEANED);
+}
+
+void hot_reload_register_components(ecs_world_t *world) {
+  ECS_COMPONENT_DEFINE(world, HotReloadContext);
+}
+
+void hot_reload_register_systems(ecs_world_t *world) {
+  ecs_observer(world, {
+    .query.terms = {{ EcsAny, .src.id = CleanUpModule }},
+    .events = { CleanUpEvent },
+    .callback = hot_reload_cleanup_event_system
+  });
+
+  ecs_observer(world, {
+    .query.terms = {{ ecs_id(AssetHandle) }},
+    .events = { EcsOnSet },
+    .callback = HotReloadWatchObserver
+  });
+
+  ecs_system_init(world, &(ecs_system_desc_t){
+    .entity = ecs_entity(world, { .name = "HotReloadSystem", .add = ecs_ids(ecs_dependson(GlobalPhases.LogicUpdatePhase)) }),
+    .query.terms = { ECS_SINGLETON_IN(SDLContext), ECS_SINGLETON_INOUT(HotReloadContext) },
+    .callback = HotReloadSystem
+  });
+}
+
+void flecs_hot_reload_module_init(ecs_world_t *world) {
+  ecs_log(1, "Initializing hot reload module...");
+
+  hot_reload_register_components(world);
+
+  HotReloadWatcher *w = calloc(1, sizeof(HotReloadWatcher));
+  if (!w) {
+    ecs_err("[hot_reload] out of memory, disabled");
+    return;
+  }
+  w->lock = SDL_CreateMutex();
+  bool inotify = false;
+#ifdef __linux__
+  w->inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  inotify = w->inotifyFd >= 0;
+  if (!inotify) ecs_log(1, "[hot_reload] inotify unavailable, polling every %d ms", HOT_RELOAD_POLL_MS);
+#endif
+  w->thread = w->lock ? SDL_CreateThread(hot_reload_watcher_main, "hot_reload", w) : NULL;
+  if (!w->thread) {
+    ecs_err("[hot_reload] failed to start watcher: %s", SDL_GetError());
+#ifdef __linux__
+    if (w->inotifyFd >= 0) close(w->inotifyFd);
+#endif
+    if (w->lock) SDL_DestroyMutex(w->lock);
+    free(w);
+    return;
+  }
+
+  ecs_singleton_set(world, HotReloadContext, {
+    .watcher = w,
+    .inotify = inotify,
+    .debounceMs = HOT_RELOAD_DEBOUNCE_MS
+  });
+
+  hot_reload_module_handle = module_register(world, "hot_reload_module");
+
+  hot_reload_register_systems(world);
+  module_set_state(world, hot_reload_module_handle, MODULE_STATE_READY);
+
+  ecs_log(1, "Hot reload module initialized (%s)", inotify ? "inotify" : "polling");
+}
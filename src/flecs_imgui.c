@@ -1,5 +1,8 @@
 #include "flecs_imgui.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "flecs_vfs.h"
 #include "flecs_sdl.h"
 #include "flecs_vulkan.h"
 #include "flecs_sdl.h"
@@ -42,6 +45,145 @@ static void check_vk_result(VkResult err) {
   }
 }
 
+// ImGui's font atlas, restored from IMGUI_ATLAS_CACHE_DIR instead of running
+// the FreeType builder. Keyed on the ImGui version (the embedded default
+// font) and the atlas settings, written after the first build.
+static uint64_t imguiAtlasHash(uint64_t h, const void *data, size_t size) {
+  const uint8_t *p = data;
+  for (size_t i = 0; i < size; i++) {
+    h ^= p[i];
+    h *= 0x100000001b3ull;
+  }
+  return h;
+}
+
+static uint64_t imguiAtlasKey(const ImFontAtlas *atlas) {
+  const char *version = igGetVersion();
+  float size = IMGUI_FONT_PIXEL_SIZE;
+  uint64_t h = imguiAtlasHash(0xcbf29ce484222325ull, version, strlen(version));
+  h = imguiAtlasHash(h, &size, sizeof(size));
+  h = imguiAtlasHash(h, &atlas->Flags, sizeof(atlas->Flags));
+  h = imguiAtlasHash(h, &atlas->FontBuilderFlags, sizeof(atlas->FontBuilderFlags));
+  return imguiAtlasHash(h, &atlas->TexGlyphPadding, sizeof(atlas->TexGlyphPadding));
+}
+
+static bool imguiAtlasRestore(ImFontAtlas *atlas, ImFont *font, const uint8_t *data, size_t size, uint64_t key) {
+  ImGuiAtlasHeader header;
+  if (size < sizeof(header)) return false;
+  memcpy(&header, data, sizeof(header));
+  size_t lineBytes = sizeof(atlas->TexUvLines);
+  size_t glyphBytes = sizeof(ImGuiAtlasGlyph) * header.glyphCount;
+  size_t pixelBytes = (size_t)header.width * header.height;
+  if (header.magic != IMGUI_ATLAS_MAGIC || header.version != IMGUI_ATLAS_VERSION || header.key != key ||
+      header.lineBytes != lineBytes || !header.width || !header.height ||
+      size < sizeof(header) + lineBytes + glyphBytes + pixelBytes) {
+    return false;
+  }
+  // the atlas frees it with IM_FREE
+  unsigned char *pixels = igMemAlloc(pixelBytes);
+  if (!pixels) return false;
+  const uint8_t *p = data + sizeof(header);
+  memcpy(atlas->TexUvLines, p, lineBytes);
+  p += lineBytes;
+
+  // what ImFontAtlasBuildSetupFont + ImFontAtlasBuildFinish leave behind,
+  // AddFontDefault already linked the font to its config
+  font->ContainerAtlas = atlas;
+  font->FontSize = header.fontSize;
+  font->Ascent = header.ascent;
+  font->Descent = header.descent;
+  for (uint32_t i = 0; i < header.glyphCount; i++, p += sizeof(ImGuiAtlasGlyph)) {
+    ImGuiAtlasGlyph g;
+    memcpy(&g, p, sizeof(g));
+    ImFont_AddGlyph(font, NULL, (ImWchar)g.codepoint, g.x0, g.y0, g.x1, g.y1, g.u0, g.v0, g.u1, g.v1, g.advanceX);
+  }
+  ImFont_BuildLookupTable(font);
+
+  memcpy(pixels, p, pixelBytes);
+  atlas->TexPixelsAlpha8 = pixels;
+  atlas->TexWidth = (int)header.width;
+  atlas->TexHeight = (int)header.height;
+  atlas->TexUvScale = (ImVec2){1.0f / header.width, 1.0f / header.height};
+  atlas->TexUvWhitePixel = (ImVec2){header.whitePixel[0], header.whitePixel[1]};
+  // the software cursor rects are not part of the cache (io.MouseDrawCursor is off)
+  atlas->Flags |= ImFontAtlasFlags_NoMouseCursors;
+  atlas->TexReady = true;
+  return true;
+}
+
+static void imguiAtlasStore(ImFontAtlas *atlas, ImFont *font, const char *path, uint64_t key) {
+  unsigned char *pixels = NULL;
+  int width = 0, height = 0;
+  ImFontAtlas_GetTexDataAsAlpha8(atlas, &pixels, &width, &height, NULL);
+  if (!pixels) return;
+
+  ImGuiAtlasHeader header = {
+    .magic = IMGUI_ATLAS_MAGIC,
+    .version = IMGUI_ATLAS_VERSION,
+    .width = (uint32_t)width,
+    .height = (uint32_t)height,
+    .glyphCount = (uint32_t)font->Glyphs.Size,
+    .lineBytes = (uint32_t)sizeof(atlas->TexUvLines),
+    .fontSize = font->FontSize,
+    .ascent = font->Ascent,
+    .descent = font->Descent,
+    .whitePixel = {atlas->TexUvWhitePixel.x, atlas->TexUvWhitePixel.y},
+    .key = key
+  };
+  size_t glyphBytes = sizeof(ImGuiAtlasGlyph) * header.glyphCount;
+  size_t pixelBytes = (size_t)width * height;
+  size_t size = sizeof(header) + header.lineBytes + glyphBytes + pixelBytes;
+  uint8_t *blob = malloc(size);
+  if (!blob) return;
+  uint8_t *p = blob;
+  memcpy(p, &header, sizeof(header));
+  p += sizeof(header);
+  memcpy(p, atlas->TexUvLines, header.lineBytes);
+  p += header.lineBytes;
+  for (int i = 0; i < font->Glyphs.Size; i++, p += sizeof(ImGuiAtlasGlyph)) {
+    const ImFontGlyph *src = &font->Glyphs.Data[i];
+    ImGuiAtlasGlyph g = {src->Codepoint, src->AdvanceX, src->X0, src->Y0, src->X1, src->Y1, src->U0, src->V0, src->U1, src->V1};
+    memcpy(p, &g, sizeof(g));
+  }
+  memcpy(p, pixels, pixelBytes);
+
+  SDL_CreateDirectory(IMGUI_ATLAS_CACHE_DIR);
+  if (!flecs_write_file_atomic(path, blob, size)) {
+    ecs_log(1, "[imgui] failed to write %s", path);
+  }
+  free(blob);
+}
+
+// default font at IMGUI_FONT_PIXEL_SIZE, from the cache when there is one
+static void imguiLoadFontAtlas(ImFontAtlas *atlas) {
+  ImFontConfig *config = ImFontConfig_ImFontConfig();
+  config->SizePixels = IMGUI_FONT_PIXEL_SIZE;
+  // registers the font only, the build is what the cache replaces
+  ImFont *font = ImFontAtlas_AddFontDefault(atlas, config);
+  ImFontConfig_destroy(config);
+  if (!font) return;
+
+  uint64_t key = imguiAtlasKey(atlas);
+  char path[256];
+  snprintf(path, sizeof(path), "%s/imgui_%016llx_%d_v%d.atlas", IMGUI_ATLAS_CACHE_DIR, (unsigned long long)key,
+           (int)IMGUI_FONT_PIXEL_SIZE, IMGUI_ATLAS_VERSION);
+  VfsView view;
+  if (flecs_vfs_exists(path) && flecs_vfs_open_view(path, &view)) {
+    bool ok = imguiAtlasRestore(atlas, font, view.data, view.size, key);
+    flecs_vfs_close_view(&view);
+    if (ok) {
+      ecs_log(1, "[imgui] font atlas from %s", path);
+      return;
+    }
+    ecs_log(1, "[imgui] stale font atlas %s", path);
+  }
+
+  Uint64 start = SDL_GetTicks();
+  if (!ImFontAtlas_Build(atlas)) return; // CreateFontsTexture reports it
+  ecs_log(1, "[imgui] built font atlas in %llu ms", (unsigned long long)(SDL_GetTicks() - start));
+  imguiAtlasStore(atlas, font, path, key);
+}
+
 void ImGuiSetupSystem(ecs_iter_t *it) {
   // WorldContext *ctx = ecs_get_ctx(it->world);
   // if (!ctx || ctx->hasError) return;
@@ -96,7 +238,9 @@ void ImGuiSetupSystem(ecs_iter_t *it) {
   // ecs_print(1, "Pre-font fence: %p", (void*)ctx->inFlightFence);
   // ecs_print(1, "Context pointer pre-font: %p", (void*)ctx);
 
-  // Use ImGui’s default font creation (like the example)
+  // Use ImGui’s default font creation (like the example), the atlas comes
+  // from the cache after the first run
+  imguiLoadFontAtlas(io->Fonts);
   // ecs_print(1, "ImGui_ImplVulkan_CreateFontsTexture");
   if (!ImGui_ImplVulkan_CreateFontsTexture()) {
       ecs_err("Failed to create ImGui font texture");
@@ -113,11 +257,11 @@ void ImGuiSetupSystem(ecs_iter_t *it) {
 }
 
 void ImguiInputSystem(ecs_iter_t *it){
-  SDLContext *sdl_ctx = ecs_singleton_ensure(it->world,SDLContext);
+  SDLContext *sdl_ctx = ecs_field(it, SDLContext, 0);
   if (!sdl_ctx || sdl_ctx->hasError || sdl_ctx->isShutDown) return;
-  const ECS_SDL_INPUT_T *input = ecs_singleton_get(it->world, ECS_SDL_INPUT_T);
+  const ECS_SDL_INPUT_T *input = ecs_field(it, ECS_SDL_INPUT_T, 1);
   if(!input)return;
-  IMGUIContext *imgui_ctx = ecs_singleton_ensure(it->world,IMGUIContext);
+  IMGUIContext *imgui_ctx = ecs_field(it, IMGUIContext, 2);
   if (!imgui_ctx) return;
   if (imgui_ctx->isImGuiInitialized) {
     ImGui_ImplSDL3_ProcessEvent(&input->event);
@@ -177,9 +321,9 @@ void ImGuiCMDBufferSystem(ecs_iter_t *it){
 }
 
 void ImGuiBeginSystem(ecs_iter_t *it) {
-  SDLContext *sdl_ctx = ecs_singleton_ensure(it->world, SDLContext);
+  SDLContext *sdl_ctx = ecs_field(it, SDLContext, 0);
   if (!sdl_ctx || sdl_ctx->hasError || sdl_ctx->isShutDown) return;
-  IMGUIContext *imgui_ctx = ecs_singleton_ensure(it->world,IMGUIContext);
+  IMGUIContext *imgui_ctx = ecs_field(it, IMGUIContext, 1);
   if (!imgui_ctx) return;
   if (!imgui_ctx->isImGuiInitialized)return;
 
@@ -197,9 +341,9 @@ void ImGuiBeginSystem(ecs_iter_t *it) {
 void ImGuiUpdateSystem(ecs_iter_t *it) {
   // WorldContext *ctx = ecs_get_ctx(it->world);
   // if (!ctx || ctx->hasError) return;
-  SDLContext *sdl_ctx = ecs_singleton_ensure(it->world, SDLContext);
+  SDLContext *sdl_ctx = ecs_field(it, SDLContext, 0);
   if (!sdl_ctx || sdl_ctx->hasError || sdl_ctx->isShutDown) return;
-  IMGUIContext *imgui_ctx = ecs_singleton_ensure(it->world,IMGUIContext);
+  IMGUIContext *imgui_ctx = ecs_field(it, IMGUIContext, 1);
   if (!imgui_ctx) return;
   if (!imgui_ctx->isImGuiInitialized)return;
 
@@ -230,12 +374,12 @@ void ImGuiUpdateSystem(ecs_iter_t *it) {
 }
 
 void ImGuiEndSystem(ecs_iter_t *it) {
-  SDLContext *sdl_ctx = ecs_singleton_ensure(it->world, SDLContext);
+  SDLContext *sdl_ctx = ecs_field(it, SDLContext, 0);
   if (!sdl_ctx || sdl_ctx->hasError || sdl_ctx->isShutDown) return;
-  IMGUIContext *imgui_ctx = ecs_singleton_ensure(it->world,IMGUIContext);
+  IMGUIContext *imgui_ctx = ecs_field(it, IMGUIContext, 1);
   if (!imgui_ctx) return;
   if (!imgui_ctx->isImGuiInitialized)return;
-  VulkanContext *v_ctx = ecs_singleton_ensure(it->world, VulkanContext);
+  VulkanContext *v_ctx = ecs_field(it, VulkanContext, 2);
   if (!v_ctx) return;
 
   // ecs_print(1, "ImGuiEndSystem starting...");
@@ -252,27 +396,14 @@ void OnClick(ecs_iter_t *it){
   ecs_print(1,"Click Event System...");
 }
 
+// registry slot, marked cleaned by the cleanup observer
+static ModuleHandle imgui_module_handle = MODULE_HANDLE_NONE;
+
 void imgui_cleanup_event_system(ecs_iter_t *it){
   ecs_print(1,"[cleanup] imgui_cleanup_event_system");
   flecs_imgui_cleanup(it->world);
 
-  ecs_query_t *q = ecs_query(it->world, {
-    .terms = {
-      { .id = ecs_id(PluginModule) },
-    }
-  });
-
-  ecs_iter_t s_it = ecs_query_iter(it->world, q);
-
-  while (ecs_query_next(&s_it)) {
-    PluginModule *p = ecs_field(&s_it, PluginModule, 0);
-    for (int i = 0; i < s_it.count; i ++) {
-      if(strcmp(p[i].name, "imgui_module") == 0){
-        p[i].isCleanUp = true;
-        break;
-      }
-    }
-  }
+  module_set_state(it->world, imgui_module_handle, MODULE_STATE_CLEANED);
 }
 
 void flecs_imgui_cleanup(ecs_world_t *world) {
@@ -349,21 +480,25 @@ void imgui_register_systems(ecs_world_t *world){
 
   ecs_system_init(world, &(ecs_system_desc_t){
       .entity = ecs_entity(world, { .name = "ImguiInputSystem", .add = ecs_ids(ecs_dependson(GlobalPhases.LogicUpdatePhase)) }),
+      .query.terms = { ECS_SINGLETON_IN(SDLContext), ECS_SINGLETON_IN(ECS_SDL_INPUT_T), ECS_SINGLETON_INOUT(IMGUIContext) },
       .callback = ImguiInputSystem
   });
   // ecs_print(1, "ImGuiBeginSystem");
   ecs_system_init(world, &(ecs_system_desc_t){
       .entity = ecs_entity(world, { .name = "ImGuiBeginSystem", .add = ecs_ids(ecs_dependson(GlobalPhases.CMDBufferPhase)) }),
+      .query.terms = { ECS_SINGLETON_IN(SDLContext), ECS_SINGLETON_INOUT(IMGUIContext) },
       .callback = ImGuiBeginSystem
   });
   // ecs_print(1, "ImGuiUpdateSystem");
   ecs_system_init(world, &(ecs_system_desc_t){
       .entity = ecs_entity(world, { .name = "ImGuiUpdateSystem", .add = ecs_ids(ecs_dependson(GlobalPhases.CMDBuffer1Phase)) }),
+      .query.terms = { ECS_SINGLETON_IN(SDLContext), ECS_SINGLETON_INOUT(IMGUIContext) },
       .callback = ImGuiUpdateSystem
   });
   // ecs_print(1, "ImGuiEndSystem");
   ecs_system_init(world, &(ecs_system_desc_t){
       .entity = ecs_entity(world, { .name = "ImGuiEndSystem", .add = ecs_ids(ecs_dependson(GlobalPhases.CMDBuffer2Phase)) }),
+      .query.terms = { ECS_SINGLETON_IN(SDLContext), ECS_SINGLETON_INOUT(IMGUIContext), ECS_SINGLETON_IN(VulkanContext) },
       .callback = ImGuiEndSystem
   });
 }
@@ -379,11 +514,10 @@ void flecs_imgui_module_init(ecs_world_t *world) {
   Clicked = ecs_new(world);
   widget = ecs_entity(world, { .name = "widget" });
 
-  // add_module_name(world,"imgui_module");
-  ecs_entity_t e = ecs_new(world);
-  ecs_set(world, e, PluginModule, { .name = "imgui_module", .isCleanUp = false });
+  imgui_module_handle = module_register(world, "imgui_module");
 
   imgui_register_systems(world);
+  module_set_state(world, imgui_module_handle, MODULE_STATE_READY);
 
   ecs_log(1, "ImGui module initialized");
 }
\ No newline at end of file
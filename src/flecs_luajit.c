@@ -1,5 +1,6 @@
 #include "flecs_luajit.h"
 #include "flecs_sdl.h"
+#include "flecs_vfs.h"
 
 typedef struct { float x, y; } Position;
 
@@ -25,9 +26,9 @@ void error(lua_State *L, const char *fmt, ...) {
 
 // Lua system to call update function
 static void LuaUpdateSystem(ecs_iter_t *it) {
-  SDLContext *sdl_ctx = ecs_singleton_ensure(it->world, SDLContext);
+  const SDLContext *sdl_ctx = ecs_field(it, SDLContext, 0);
   if (!sdl_ctx || sdl_ctx->hasError || sdl_ctx->isShutDown) return;
-  LuaContext *lua_ctx = ecs_singleton_ensure(it->world, LuaContext);
+  const LuaContext *lua_ctx = ecs_field(it, LuaContext, 1);
   if (!lua_ctx || !lua_ctx->L) return;
 
   lua_State *L = lua_ctx->L;
@@ -47,11 +48,14 @@ static void LuaUpdateSystem(ecs_iter_t *it) {
   }
 }
 
+// registry slot, marked cleaned by the cleanup observer
+static ModuleHandle luajit_module_handle = MODULE_HANDLE_NONE;
+
 void luajit_cleanup_event_system(ecs_iter_t *it){
   ecs_print(1,"[cleanup] luajit_cleanup_event_system");
   flecs_luajit_cleanup(it->world);
 
-  module_break_name(it, "luajit_module");
+  module_set_state(it->world, luajit_module_handle, MODULE_STATE_CLEANED);
 }
 
 void flecs_luajit_cleanup(ecs_world_t *world) {
@@ -86,10 +90,7 @@ void flecs_luajit_register_systems(ecs_world_t *world){
       .name = "LuaUpdateSystem",
       .add = ecs_ids(ecs_dependson(EcsOnUpdate)) 
     }),
-    .query.terms = {{ 
-      ecs_id(LuaContext), 
-      .inout = EcsIn 
-    }},
+    .query.terms = { ECS_SINGLETON_IN(SDLContext), ECS_SINGLETON_IN(LuaContext) },
     .callback = LuaUpdateSystem,
     });
     ecs_enable(world, ecs_lua_update_sys, false); // Store and disable
@@ -101,10 +102,7 @@ void flecs_luajit_module_init(ecs_world_t *world) {
   
   luajit_register_components(world);
 
-  // ecs_entity_t e = ecs_new(world);
-  // ecs_set(world, e, PluginModule, { .name = "luajit_module", .isCleanUp = false });
-
-  add_module_name(world, "luajit_module");
+  luajit_module_handle = module_register(world, "luajit_module");
 
   LuaContext lua_ctx = {0};
   lua_ctx.L = luaL_newstate();
@@ -121,9 +119,18 @@ void flecs_luajit_module_init(ecs_world_t *world) {
 
   // Register systems (disabled by default)
   flecs_luajit_register_systems(world);
+  module_set_state(world, luajit_module_handle, MODULE_STATE_READY);
 
-  // Try loading script.lua
-  if (luaL_loadfile(lua_ctx.L, "script.lua")) {
+  // Try loading script.lua (vfs, pack or loose file)
+  size_t scriptSize = 0;
+  char *script = flecs_vfs_read_all("script.lua", &scriptSize);
+  if (!script) {
+    error(lua_ctx.L, "Error loading script.lua: not found\n");
+    return;
+  }
+  int loadStatus = luaL_loadbuffer(lua_ctx.L, script, scriptSize, "@script.lua");
+  free(script);
+  if (loadStatus) {
     error(lua_ctx.L, "Error loading script.lua: %s\n", lua_tostring(lua_ctx.L, -1));
     return;
   }
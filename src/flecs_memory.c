@@ -0,0 +1,321 @@
+#include "flecs_memory.h"
+#include <SDL3/SDL.h>
+#include <mimalloc.h>
+#include <string.h>
+
+// hooks run before ecs_init and on every thread. Each thread counts into its
+// own slot (index in SDL TLS), so the allocation path takes no shared lock;
+// stats add the slots up. A slot outlives its thread: the counts stay in the
+// sums and the next new thread reuses it. Past MEMORY_THREAD_SLOTS live
+// threads the rest share the last slot behind a spinlock
+#define MEMORY_THREAD_SLOTS 64
+
+typedef struct {
+  int64_t liveBytes;
+  int64_t allocs;
+  int64_t frees;
+} MemoryCounter;
+
+typedef struct {
+  MemoryCounter tags[MEMORY_TAG_COUNT];
+} MemorySlot;
+
+static MemorySlot memorySlots[MEMORY_THREAD_SLOTS];
+static SDL_TLSID memorySlotTLS;
+static SDL_SpinLock memorySlotLock;       // slot free list, shared slot counts
+static int memorySlotFree[MEMORY_THREAD_SLOTS];
+static int memorySlotFreeCount;
+static int memorySlotUsed;
+
+// peak of the summed live bytes, sampled by flecs_memory_stats and once per
+// frame by FrameArenaResetSystem
+static int64_t memoryPeak[MEMORY_TAG_COUNT];
+
+static const char *memoryTagNames[MEMORY_TAG_COUNT] = {
+  "engine", "flecs", "vulkan", "text", "texture", "frame"
+};
+
+// heap block handed out when the arena is full, freed at the next reset
+typedef struct MemoryOverflow {
+  struct MemoryOverflow *next;
+  size_t size;
+} MemoryOverflow;
+
+#define MEMORY_OVERFLOW_HEADER ((sizeof(MemoryOverflow) + MEMORY_FRAME_ALIGN - 1) & ~(size_t)(MEMORY_FRAME_ALIGN - 1))
+
+typedef struct {
+  uint8_t *base;
+  size_t capacity;
+  SDL_AtomicInt offset;        // bump, may run past capacity once full
+  SDL_AtomicInt overflowBytes;
+  void *overflow;              // MemoryOverflow list, SDL atomic pointer ops
+} FrameArena;
+
+static FrameArena frameArena;
+
+static inline size_t memory_align(size_t size) {
+  return (size + MEMORY_FRAME_ALIGN - 1) & ~(size_t)(MEMORY_FRAME_ALIGN - 1);
+}
+
+static void memory_slot_release(void *value) {
+  int slot = (int)(intptr_t)value - 1;
+  if (slot < 0 || slot == MEMORY_THREAD_SLOTS - 1) return;
+  SDL_LockSpinlock(&memorySlotLock);
+  memorySlotFree[memorySlotFreeCount++] = slot;
+  SDL_UnlockSpinlock(&memorySlotLock);
+}
+
+static int memory_slot(void) {
+  int slot = (int)(intptr_t)SDL_GetTLS(&memorySlotTLS) - 1;
+  if (slot >= 0) return slot;
+  SDL_LockSpinlock(&memorySlotLock);
+  if (memorySlotFreeCount) slot = memorySlotFree[--memorySlotFreeCount];
+  else if (memorySlotUsed < MEMORY_THREAD_SLOTS - 1) slot = memorySlotUsed++;
+  else slot = MEMORY_THREAD_SLOTS - 1;
+  SDL_UnlockSpinlock(&memorySlotLock);
+  SDL_SetTLS(&memorySlotTLS, (void *)(intptr_t)(slot + 1), memory_slot_release);
+  return slot;
+}
+
+// freedBytes of a block given back (realloc counts both), allocBytes of the new one
+static void memory_count(MemoryTag tag, int64_t freedBytes, int64_t allocBytes) {
+  int slot = memory_slot();
+  bool shared = slot == MEMORY_THREAD_SLOTS - 1;
+  if (shared) SDL_LockSpinlock(&memorySlotLock);
+  MemoryCounter *c = &memorySlots[slot].tags[tag];
+  c->liveBytes += allocBytes - freedBytes;
+  if (freedBytes) c->frees++;
+  if (allocBytes) c->allocs++;
+  if (shared) SDL_UnlockSpinlock(&memorySlotLock);
+}
+
+static void memory_count_alloc(MemoryTag tag, void *ptr) {
+  if (ptr) memory_count(tag, 0, (int64_t)mi_usable_size(ptr));
+}
+
+static void memory_count_free(MemoryTag tag, void *ptr) {
+  if (ptr) memory_count(tag, (int64_t)mi_usable_size(ptr), 0);
+}
+
+void *flecs_mem_alloc(MemoryTag tag, size_t size) {
+  void *ptr = mi_malloc(size);
+  memory_count_alloc(tag, ptr);
+  return ptr;
+}
+
+void *flecs_mem_calloc(MemoryTag tag, size_t count, size_t size) {
+  void *ptr = mi_calloc(count, size);
+  memory_count_alloc(tag, ptr);
+  return ptr;
+}
+
+void *flecs_mem_realloc(MemoryTag tag, void *ptr, size_t size) {
+  // counted as a free of the old block and an alloc of the new one
+  int64_t oldBytes = ptr ? (int64_t)mi_usable_size(ptr) : 0;
+  void *grown = mi_realloc(ptr, size);
+  if (!grown) return NULL;
+  memory_count(tag, oldBytes, (int64_t)mi_usable_size(grown));
+  return grown;
+}
+
+void flecs_mem_free(MemoryTag tag, void *ptr) {
+  memory_count_free(tag, ptr);
+  mi_free(ptr);
+}
+
+// other threads keep counting while this adds up, the sums may be a few
+// allocations behind
+void flecs_memory_stats(MemoryTag tag, MemoryTagStats *out) {
+  memset(out, 0, sizeof(*out));
+  for (int s = 0; s < MEMORY_THREAD_SLOTS; s++) {
+    const MemoryCounter *c = &memorySlots[s].tags[tag];
+    out->liveBytes += c->liveBytes;
+    out->allocs += c->allocs;
+    out->frees += c->frees;
+  }
+  if (out->liveBytes > memoryPeak[tag]) memoryPeak[tag] = out->liveBytes;
+  out->peakBytes = memoryPeak[tag];
+}
+
+const char *flecs_memory_tag_name(MemoryTag tag) {
+  return tag >= 0 && tag < MEMORY_TAG_COUNT ? memoryTagNames[tag] : "?";
+}
+
+// flecs' allocator hooks
+static void *memory_os_malloc(ecs_size_t size) {
+  return flecs_mem_alloc(MEMORY_TAG_FLECS, (size_t)size);
+}
+
+static void *memory_os_calloc(ecs_size_t size) {
+  return flecs_mem_calloc(MEMORY_TAG_FLECS, 1, (size_t)size);
+}
+
+static void *memory_os_realloc(void *ptr, ecs_size_t size) {
+  return flecs_mem_realloc(MEMORY_TAG_FLECS, ptr, (size_t)size);
+}
+
+static void memory_os_free(void *ptr) {
+  flecs_mem_free(MEMORY_TAG_FLECS, ptr);
+}
+
+void flecs_memory_os_api_init(void) {
+  ecs_os_set_api_defaults();
+  ecs_os_api_t api = ecs_os_api;
+  api.malloc_ = memory_os_malloc;
+  api.calloc_ = memory_os_calloc;
+  api.realloc_ = memory_os_realloc;
+  api.free_ = memory_os_free;
+  ecs_os_set_api(&api);
+}
+
+static bool frame_arena_reserve(size_t capacity) {
+  uint8_t *base = mi_malloc_aligned(capacity, 64);
+  if (!base) return false;
+  if (frameArena.base) flecs_mem_free(MEMORY_TAG_FRAME, frameArena.base);
+  memory_count_alloc(MEMORY_TAG_FRAME, base);
+  frameArena.base = base;
+  frameArena.capacity = capacity;
+  return true;
+}
+
+static void *frame_overflow_alloc(size_t size) {
+  MemoryOverflow *block = flecs_mem_alloc(MEMORY_TAG_FRAME, MEMORY_OVERFLOW_HEADER + size);
+  if (!block) return NULL;
+  block->size = size;
+  void *head;
+  do {
+    head = SDL_GetAtomicPointer(&frameArena.overflow);
+    block->next = head;
+  } while (!SDL_CompareAndSwapAtomicPointer(&frameArena.overflow, head, block));
+  SDL_AddAtomicInt(&frameArena.overflowBytes, (int)size);
+  return (uint8_t *)block + MEMORY_OVERFLOW_HEADER;
+}
+
+void *flecs_frame_alloc(size_t size) {
+  size = memory_align(size ? size : 1);
+  int old = SDL_AddAtomicInt(&frameArena.offset, (int)size);
+  if (old >= 0 && (size_t)old + size <= frameArena.capacity) {
+    return frameArena.base + old;
+  }
+  return frame_overflow_alloc(size);
+}
+
+void *flecs_frame_realloc(void *ptr, size_t oldSize, size_t size) {
+  if (!ptr) return flecs_frame_alloc(size);
+  uint8_t *p = ptr;
+  if (p >= frameArena.base && p < frameArena.base + frameArena.capacity) {
+    // newest allocation: move the bump pointer instead of copying
+    int end = (int)(p - frameArena.base + memory_align(oldSize));
+    size_t newEnd = (size_t)(p - frameArena.base) + memory_align(size);
+    if (newEnd <= frameArena.capacity && SDL_CompareAndSwapAtomicInt(&frameArena.offset, end, (int)newEnd)) {
+      return ptr;
+    }
+  }
+  void *grown = flecs_frame_alloc(size);
+  if (grown) memcpy(grown, ptr, oldSize < size ? oldSize : size);
+  return grown;
+}
+
+// BeginRenderPhase, first system, so it runs before BeginRenderSystem waits
+// on the frame fence. That is fine because the arena is cpu only: every
+// system of the previous frame has returned, nothing reads the old data.
+// No GPU-visible data (mapped buffers, memory a submitted command reads)
+// may live in the arena. Rewind and size for the next frame
+void FrameArenaResetSystem(ecs_iter_t *it) {
+  MemoryContext *mem_ctx = ecs_field(it, MemoryContext, 0);
+
+  int offset = SDL_GetAtomicInt(&frameArena.offset);
+  size_t bumped = offset < 0 ? frameArena.capacity : (size_t)offset;
+  if (bumped > frameArena.capacity) bumped = frameArena.capacity;
+  size_t overflow = (size_t)SDL_GetAtomicInt(&frameArena.overflowBytes);
+
+  MemoryOverflow *block = SDL_GetAtomicPointer(&frameArena.overflow);
+  while (block) {
+    MemoryOverflow *next = block->next;
+    flecs_mem_free(MEMORY_TAG_FRAME, block);
+    block = next;
+  }
+  SDL_SetAtomicPointer(&frameArena.overflow, NULL);
+  SDL_SetAtomicInt(&frameArena.overflowBytes, 0);
+
+  // spilled last frame: grow to 1.5x what was needed, the next frame fits
+  if (overflow) {
+    size_t wanted = bumped + overflow;
+    size_t capacity = frameArena.capacity ? frameArena.capacity : MEMORY_FRAME_ARENA_SIZE;
+    while (capacity < wanted + wanted / 2) capacity *= 2;
+    if (frame_arena_reserve(capacity)) {
+      mem_ctx->arenaGrowths++;
+      ecs_dbg("[memory] frame arena grown to %zu bytes", capacity);
+    }
+  }
+  SDL_SetAtomicInt(&frameArena.offset, 0);
+
+  // samples the per tag peaks
+  MemoryTagStats stats;
+  for (int t = 0; t < MEMORY_TAG_COUNT; t++) flecs_memory_stats((MemoryTag)t, &stats);
+
+  mem_ctx->frame++;
+  mem_ctx->arenaCapacity = frameArena.capacity;
+  mem_ctx->arenaUsed = bumped + overflow;
+  mem_ctx->arenaOverflow = overflow;
+  if (mem_ctx->arenaUsed > mem_ctx->arenaPeak) mem_ctx->arenaPeak = mem_ctx->arenaUsed;
+}
+
+void flecs_memory_print(void) {
+  ecs_print(1, "[memory] %-8s %12s %12s %10s %10s", "tag", "live KB", "peak KB", "allocs", "frees");
+  for (int t = 0; t < MEMORY_TAG_COUNT; t++) {
+    MemoryTagStats s;
+    flecs_memory_stats((MemoryTag)t, &s);
+    if (!s.allocs) continue;
+    ecs_print(1, "[memory] %-8s %12.1f %12.1f %10lld %10lld", memoryTagNames[t],
+              (double)s.liveBytes / 1024.0, (double)s.peakBytes / 1024.0,
+              (long long)s.allocs, (long long)s.frees);
+  }
+}
+
+static void frame_arena_fini(ecs_world_t *world, void *ctx) {
+  (void)world;
+  (void)ctx;
+  MemoryOverflow *block = SDL_GetAtomicPointer(&frameArena.overflow);
+  while (block) {
+    MemoryOverflow *next = block->next;
+    flecs_mem_free(MEMORY_TAG_FRAME, block);
+    block = next;
+  }
+  SDL_SetAtomicPointer(&frameArena.overflow, NULL);
+  if (frameArena.base) flecs_mem_free(MEMORY_TAG_FRAME, frameArena.base);
+  frameArena.base = NULL;
+  frameArena.capacity = 0;
+  SDL_SetAtomicInt(&frameArena.offset, 0);
+}
+
+void memory_register_components(ecs_world_t *world) {
+  ECS_COMPONENT_DEFINE(world, MemoryContext);
+}
+
+void memory_register_systems(ecs_world_t *world) {
+  ecs_system_init(world, &(ecs_system_desc_t){
+    .entity = ecs_entity(world, { .name = "FrameArenaResetSystem", .add = ecs_ids(ecs_dependson(GlobalPhases.BeginRenderPhase)) }),
+    .query.terms = { ECS_SINGLETON_INOUT(MemoryContext) },
+    .callback = FrameArenaResetSystem
+  });
+}
+
+void flecs_memory_module_init(ecs_world_t *world) {
+  ecs_log(1, "Initializing memory module...");
+
+  memory_register_components(world);
+
+  if (!frame_arena_reserve(MEMORY_FRAME_ARENA_SIZE)) {
+    ecs_err("[memory] no memory for the %u byte frame arena", MEMORY_FRAME_ARENA_SIZE);
+  }
+  SDL_SetAtomicInt(&frameArena.offset, 0);
+  ecs_singleton_set(world, MemoryContext, { .arenaCapacity = frameArena.capacity });
+
+  // arena outlives every module's cleanup, released with the world
+  ecs_atfini(world, frame_arena_fini, NULL);
+
+  memory_register_systems(world);
+
+  ecs_log(1, "Memory module initialized (%zu byte frame arena)", frameArena.capacity);
+}
@@ -0,0 +1,335 @@
+#include "flecs_profile.h"
+#include <SDL3/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+  int32_t slot;
+  Uint64 begin;
+  Uint64 end;
+} ProfileSample;
+
+// single producer (the stage's thread), single consumer (frame_end)
+typedef struct {
+  ProfileSample samples[PROFILE_RING_SIZE];
+  SDL_AtomicU32 head;
+  SDL_AtomicU32 tail;
+  SDL_AtomicInt dropped;
+} ProfileRing;
+
+// run_ctx of a timed system
+typedef struct {
+  ProfileState *state;
+  int32_t slot;
+} ProfileBinding;
+
+typedef struct {
+  float ms[PROFILE_WINDOW];
+  int32_t count;
+  int32_t next;
+} ProfileHistory;
+
+struct ProfileState {
+  ProfileRing *rings;                          // one per stage
+  int32_t ringCount;
+  double msPerTick;
+  Uint64 frameBegin;
+  ProfileBinding bindings[PROFILE_MAX_SLOTS];
+  int32_t phaseOf[PROFILE_MAX_SLOTS];          // phase slot of a system slot, -1 = none
+  ProfileHistory history[PROFILE_MAX_SLOTS];
+  ProfileHistory frameHistory;
+  // this frame
+  Uint64 ticks[PROFILE_MAX_SLOTS];
+  Uint64 first[PROFILE_MAX_SLOTS];
+  Uint64 last[PROFILE_MAX_SLOTS];
+  bool ran[PROFILE_MAX_SLOTS];
+};
+
+static void profile_push(ProfileRing *ring, int32_t slot, Uint64 begin, Uint64 end) {
+  Uint32 head = SDL_GetAtomicU32(&ring->head);
+  if (head - SDL_GetAtomicU32(&ring->tail) >= PROFILE_RING_SIZE) {
+    SDL_AddAtomicInt(&ring->dropped, 1);
+    return;
+  }
+  ProfileSample *sample = &ring->samples[head & (PROFILE_RING_SIZE - 1)];
+  sample->slot = slot;
+  sample->begin = begin;
+  sample->end = end;
+  SDL_SetAtomicU32(&ring->head, head + 1);
+}
+
+// run callback of every attached system, the usual iterate + callback loop
+// between two counter reads. Multi threaded systems push one sample per stage
+static void profile_run(ecs_iter_t *it) {
+  ProfileBinding *binding = it->run_ctx;
+  Uint64 begin = SDL_GetPerformanceCounter();
+  while (ecs_iter_next(it)) {
+    it->callback(it);
+  }
+  Uint64 end = SDL_GetPerformanceCounter();
+
+  ProfileState *state = binding->state;
+  int32_t stage = ecs_stage_get_id(it->world);
+  if (stage < 0 || stage >= state->ringCount) return;
+  profile_push(&state->rings[stage], binding->slot, begin, end);
+}
+
+static const char *profile_phase_name(ecs_world_t *world, ecs_entity_t phase) {
+#define PROFILE_PHASE(field) if (phase == GlobalPhases.field) return #field;
+  PROFILE_PHASE(LogicUpdatePhase)
+  PROFILE_PHASE(TransformPhase)
+  PROFILE_PHASE(BeginRenderPhase)
+  PROFILE_PHASE(BeginCMDBufferPhase)
+  PROFILE_PHASE(CMDBufferPhase)
+  PROFILE_PHASE(CMDBuffer1Phase)
+  PROFILE_PHASE(CMDBuffer2Phase)
+  PROFILE_PHASE(EndCMDBufferPhase)
+  PROFILE_PHASE(EndRenderPhase)
+  PROFILE_PHASE(FixedUpdatePhase)
+  PROFILE_PHASE(SetupPhase)
+  PROFILE_PHASE(InstanceSetupPhase)
+  PROFILE_PHASE(SurfaceSetupPhase)
+  PROFILE_PHASE(DeviceSetupPhase)
+  PROFILE_PHASE(SwapchainSetupPhase)
+  PROFILE_PHASE(RenderPassSetupPhase)
+  PROFILE_PHASE(FramebufferSetupPhase)
+  PROFILE_PHASE(CommandPoolSetupPhase)
+  PROFILE_PHASE(CommandBufferSetupPhase)
+  PROFILE_PHASE(PipelineSetupPhase)
+  PROFILE_PHASE(SyncSetupPhase)
+  PROFILE_PHASE(SetupModulePhase)
+#undef PROFILE_PHASE
+  const char *name = ecs_get_name(world, phase);
+  return name ? name : "phase";
+}
+
+static int32_t profile_add_slot(ProfileContext *ctx, ecs_entity_t entity, ecs_entity_t phase, bool isPhase, const char *name) {
+  if (ctx->statCount >= PROFILE_MAX_SLOTS) return -1;
+  int32_t slot = ctx->statCount++;
+  ProfileStat *stat = &ctx->stats[slot];
+  memset(stat, 0, sizeof(*stat));
+  snprintf(stat->name, sizeof(stat->name), "%s", name ? name : "system");
+  stat->entity = entity;
+  stat->phase = phase;
+  stat->isPhase = isPhase;
+  ctx->state->phaseOf[slot] = -1;
+  return slot;
+}
+
+static int32_t profile_phase_slot(ecs_world_t *world, ProfileContext *ctx, ecs_entity_t phase) {
+  for (int32_t i = 0; i < ctx->statCount; i++) {
+    if (ctx->stats[i].isPhase && ctx->stats[i].entity == phase) return i;
+  }
+  return profile_add_slot(ctx, phase, 0, true, profile_phase_name(world, phase));
+}
+
+static int profile_compare_ms(const void *a, const void *b) {
+  float x = *(const float *)a, y = *(const float *)b;
+  return (x > y) - (x < y);
+}
+
+static void profile_history_push(ProfileHistory *history, float ms) {
+  history->ms[history->next] = ms;
+  history->next = (history->next + 1) % PROFILE_WINDOW;
+  if (history->count < PROFILE_WINDOW) history->count++;
+}
+
+// nearest rank percentiles over the window
+static void profile_history_stats(const ProfileHistory *history, ProfileStat *stat) {
+  int32_t n = history->count;
+  if (n == 0) return;
+  float sorted[PROFILE_WINDOW];
+  memcpy(sorted, history->ms, sizeof(float) * (size_t)n);
+  qsort(sorted, (size_t)n, sizeof(float), profile_compare_ms);
+
+  double sum = 0.0;
+  for (int32_t i = 0; i < n; i++) sum += sorted[i];
+  int32_t p95 = (n * 95 + 99) / 100 - 1;
+  int32_t p99 = (n * 99 + 99) / 100 - 1;
+  stat->minMs = sorted[0];
+  stat->avgMs = (float)(sum / n);
+  stat->p95Ms = sorted[p95 < 0 ? 0 : p95];
+  stat->p99Ms = sorted[p99 < 0 ? 0 : p99];
+}
+
+static void profile_fini(ecs_world_t *world, void *ctx) {
+  (void)world;
+  ProfileState *state = ctx;
+  free(state->rings);
+  free(state);
+}
+
+void profile_register_components(ecs_world_t *world) {
+  ECS_COMPONENT_DEFINE(world, ProfileContext);
+}
+
+// ProfileContext for flecs_profile_frame_end, unbound when init failed
+static ecs_ref_t profile_ref;
+
+void flecs_profile_module_init(ecs_world_t *world) {
+  ecs_log(1, "Initializing profile module...");
+
+  profile_register_components(world);
+
+  ProfileState *state = calloc(1, sizeof(ProfileState));
+  if (!state) {
+    ecs_err("[profile] out of memory, disabled");
+    return;
+  }
+  state->msPerTick = 1000.0 / (double)SDL_GetPerformanceFrequency();
+  ecs_atfini(world, profile_fini, state);
+
+  ecs_singleton_set(world, ProfileContext, { .state = state });
+  profile_ref = ECS_SINGLETON_REF(world, ProfileContext);
+
+  snprintf(ecs_ref_get(world, &profile_ref, ProfileContext)->frame.name, PROFILE_NAME_MAX, "frame");
+
+  ecs_log(1, "Profile module initialized");
+}
+
+void flecs_profile_attach(ecs_world_t *world) {
+  ProfileContext *ctx = ecs_singleton_ensure(world, ProfileContext);
+  ProfileState *state = ctx ? ctx->state : NULL;
+  if (!state) return;
+
+  // stage count is fixed once ecs_set_threads ran
+  if (!state->rings) {
+    int32_t stages = ecs_get_stage_count(world);
+    state->rings = calloc((size_t)(stages > 0 ? stages : 1), sizeof(ProfileRing));
+    if (!state->rings) {
+      ecs_err("[profile] out of memory, systems not timed");
+      return;
+    }
+    state->ringCount = stages > 0 ? stages : 1;
+  }
+
+  // disabled systems too, the shutdown drain check is off until shutdown
+  ecs_query_t *q = ecs_query(world, {
+    .terms = {{ .id = EcsSystem }},
+    .flags = EcsQueryMatchDisabled
+  });
+
+  ecs_entity_t systems[PROFILE_MAX_SLOTS];
+  int32_t systemCount = 0;
+  ecs_iter_t s_it = ecs_query_iter(world, q);
+  while (ecs_query_next(&s_it)) {
+    for (int i = 0; i < s_it.count && systemCount < PROFILE_MAX_SLOTS; i++) {
+      systems[systemCount++] = s_it.entities[i];
+    }
+  }
+  ecs_query_fini(q);
+
+  int32_t attached = 0;
+  for (int32_t i = 0; i < systemCount; i++) {
+    ecs_entity_t e = systems[i];
+    const ecs_system_t *system = ecs_system_get(world, e);
+    if (!system || system->run) continue; // already timed or has its own run
+
+    ecs_entity_t phase = ecs_get_target(world, e, EcsDependsOn, 0);
+    if (!phase && ecs_has_id(world, e, GlobalPhases.FixedUpdatePhase)) phase = GlobalPhases.FixedUpdatePhase;
+
+    int32_t slot = profile_add_slot(ctx, e, phase, false, ecs_get_name(world, e));
+    if (slot < 0) {
+      ecs_err("[profile] more than %d systems + phases, the rest are not timed", PROFILE_MAX_SLOTS);
+      break;
+    }
+    if (phase) state->phaseOf[slot] = profile_phase_slot(world, ctx, phase);
+
+    state->bindings[slot] = (ProfileBinding){ .state = state, .slot = slot };
+    ecs_system_init(world, &(ecs_system_desc_t){
+      .entity = e,
+      .run = profile_run,
+      .run_ctx = &state->bindings[slot]
+    });
+    attached++;
+  }
+
+  ecs_log(1, "[profile] timing %d systems, %d stages", attached, state->ringCount);
+}
+
+void flecs_profile_frame_end(ecs_world_t *world) {
+  ProfileContext *ctx = profile_ref.entity ? ecs_ref_get(world, &profile_ref, ProfileContext) : NULL;
+  ProfileState *state = ctx ? ctx->state : NULL;
+  if (!state || !state->rings) return;
+
+  Uint64 now = SDL_GetPerformanceCounter();
+  int32_t count = ctx->statCount;
+  for (int32_t i = 0; i < count; i++) {
+    state->ticks[i] = 0;
+    state->first[i] = UINT64_MAX;
+    state->last[i] = 0;
+    state->ran[i] = false;
+  }
+
+  for (int32_t r = 0; r < state->ringCount; r++) {
+    ProfileRing *ring = &state->rings[r];
+    Uint32 head = SDL_GetAtomicU32(&ring->head);
+    Uint32 tail = SDL_GetAtomicU32(&ring->tail);
+    for (; tail != head; tail++) {
+      const ProfileSample *sample = &ring->samples[tail & (PROFILE_RING_SIZE - 1)];
+      int32_t slot = sample->slot;
+      state->ticks[slot] += sample->end - sample->begin;
+      state->ran[slot] = true;
+      int32_t phase = state->phaseOf[slot];
+      if (phase >= 0) {
+        if (sample->begin < state->first[phase]) state->first[phase] = sample->begin;
+        if (sample->end > state->last[phase]) state->last[phase] = sample->end;
+        state->ran[phase] = true;
+      }
+    }
+    SDL_SetAtomicU32(&ring->tail, tail);
+    ctx->droppedSamples += (uint64_t)SDL_SetAtomicInt(&ring->dropped, 0);
+  }
+
+  for (int32_t i = 0; i < count; i++) {
+    if (!state->ran[i]) continue;
+    Uint64 ticks = ctx->stats[i].isPhase ? state->last[i] - state->first[i] : state->ticks[i];
+    float ms = (float)(ticks * state->msPerTick);
+    ctx->stats[i].lastMs = ms;
+    profile_history_push(&state->history[i], ms);
+  }
+
+  if (state->frameBegin) {
+    float ms = (float)((now - state->frameBegin) * state->msPerTick);
+    ctx->frame.lastMs = ms;
+    profile_history_push(&state->frameHistory, ms);
+  }
+  state->frameBegin = now;
+  ctx->frameCount++;
+
+  if (ctx->frameCount % PROFILE_STATS_INTERVAL == 0) {
+    for (int32_t i = 0; i < count; i++) {
+      profile_history_stats(&state->history[i], &ctx->stats[i]);
+    }
+    profile_history_stats(&state->frameHistory, &ctx->frame);
+  }
+}
+
+static const ProfileContext *profile_sort_ctx;
+
+static int profile_compare_avg(const void *a, const void *b) {
+  float x = profile_sort_ctx->stats[*(const int32_t *)a].avgMs;
+  float y = profile_sort_ctx->stats[*(const int32_t *)b].avgMs;
+  return (x < y) - (x > y);
+}
+
+void flecs_profile_print(ecs_world_t *world) {
+  const ProfileContext *ctx = ecs_singleton_get(world, ProfileContext);
+  if (!ctx || !ctx->state) return;
+
+  int32_t order[PROFILE_MAX_SLOTS];
+  for (int32_t i = 0; i < ctx->statCount; i++) order[i] = i;
+  profile_sort_ctx = ctx;
+  qsort(order, (size_t)ctx->statCount, sizeof(int32_t), profile_compare_avg);
+
+  const ProfileStat *f = &ctx->frame;
+  ecs_print(1, "[profile] %llu frames, %llu dropped samples, ms over the last %d frames",
+    (unsigned long long)ctx->frameCount, (unsigned long long)ctx->droppedSamples, PROFILE_WINDOW);
+  ecs_print(1, "[profile] %-40s min %7.3f avg %7.3f p95 %7.3f p99 %7.3f", f->name, f->minMs, f->avgMs, f->p95Ms, f->p99Ms);
+  for (int32_t i = 0; i < ctx->statCount; i++) {
+    const ProfileStat *s = &ctx->stats[order[i]];
+    ecs_print(1, "[profile] %s%-38s min %7.3f avg %7.3f p95 %7.3f p99 %7.3f",
+      s->isPhase ? "* " : "  ", s->name, s->minMs, s->avgMs, s->p95Ms, s->p99Ms);
+  }
+}
@@ -0,0 +1,265 @@
+#include "flecs_replay.h"
+#include "flecs_timestep.h"
+#include "flecs_memory.h"
+#include <string.h>
+
+// ImGui gets the frame's last event through ECS_SDL_INPUT_T.event. Keyboard
+// and mouse events are plain data and replay as they are; anything else
+// (drop file, text input) may hold pointers and is not kept
+static void replay_sanitize_event(SDL_Event *event) {
+  switch (event->type) {
+    case SDL_EVENT_KEY_DOWN:
+    case SDL_EVENT_KEY_UP:
+    case SDL_EVENT_MOUSE_MOTION:
+    case SDL_EVENT_MOUSE_BUTTON_DOWN:
+    case SDL_EVENT_MOUSE_BUTTON_UP:
+    case SDL_EVENT_MOUSE_WHEEL:
+      break;
+    default:
+      memset(event, 0, sizeof(*event));
+  }
+}
+
+static void replay_print_summary(const ReplayContext *r) {
+  double seconds = (double)(SDL_GetTicksNS() - r->startNS) / SDL_NS_PER_SECOND;
+  ecs_print(1, "[replay] %u frames in %.3f s, avg %.3f ms, min %.3f ms, max %.3f ms",
+            r->frameCount, seconds, r->frameCount ? seconds * 1000.0 / r->frameCount : 0.0,
+            r->minFrameMs, r->maxFrameMs);
+}
+
+// LogicUpdatePhase, after SDLInputSystem: save or replace this frame's input
+void ReplayInputSystem(ecs_iter_t *it) {
+  ReplayContext *r = ecs_field(it, ReplayContext, 0);
+  SDLContext *sdl_ctx = ecs_field(it, SDLContext, 1);
+  ECS_SDL_INPUT_T *input = ecs_field(it, ECS_SDL_INPUT_T, 2);
+  if (r->mode == REPLAY_OFF || r->finished || !sdl_ctx || sdl_ctx->isShutDown) return;
+
+  if (r->mode == REPLAY_RECORD) {
+    if (!r->file) return;
+    ReplayFrame frame = { .delta = r->pendingDelta, .input = *input };
+    replay_sanitize_event(&frame.input.event);
+    if (fwrite(&frame, sizeof(frame), 1, r->file) != 1) {
+      ecs_err("[replay] write failed, recording stopped at frame %u", r->frame);
+      r->finished = true;
+      return;
+    }
+    r->frame++;
+    return;
+  }
+
+  if (r->frame >= r->frameCount) {
+    // same path as closing the window
+    r->finished = true;
+    replay_print_summary(r);
+    ecs_emit(it->world, &(ecs_event_desc_t) {
+      .event = ShutDownEvent,
+      .entity = ShutDownModule
+    });
+    sdl_ctx->isShutDown = true;
+    return;
+  }
+  *input = r->frames[r->frame++].input;
+}
+
+// ReplayContext / TimeStepContext for flecs_replay_frame_delta, bound in
+// module init
+static ecs_ref_t replay_ref;
+static ecs_ref_t replay_timestep_ref;
+
+float flecs_replay_frame_delta(ecs_world_t *world, float wallDelta) {
+  ReplayContext *r = replay_ref.entity ? ecs_ref_get(world, &replay_ref, ReplayContext) : NULL;
+  if (!r || r->mode == REPLAY_OFF || r->finished) return wallDelta;
+
+  if (r->mode == REPLAY_RECORD) {
+    r->pendingDelta = wallDelta;
+    return wallDelta;
+  }
+
+  // frame time of the previous frame, waiting excluded
+  Uint64 now = SDL_GetTicksNS();
+  if (r->lastNS) {
+    double ms = (double)(now - r->lastNS) / 1e6;
+    if (ms < r->minFrameMs || r->minFrameMs == 0.0) r->minFrameMs = ms;
+    if (ms > r->maxFrameMs) r->maxFrameMs = ms;
+  } else {
+    r->startNS = now;
+  }
+
+  float delta = r->frame < r->frameCount ? r->frames[r->frame].delta : 0.0f;
+  if (r->pace == REPLAY_PACE_FIXED) {
+    const TimeStepContext *ts = ecs_ref_get(world, &replay_timestep_ref, TimeStepContext);
+    delta = ts ? ts->fixedDelta : 1.0f / TIMESTEP_DEFAULT_RATE;
+  } else if (r->pace == REPLAY_PACE_RECORDED && r->lastNS) {
+    Uint64 target = r->lastNS + (Uint64)((double)delta * SDL_NS_PER_SECOND);
+    if (target > now) SDL_DelayNS(target - now);
+  }
+  r->lastNS = SDL_GetTicksNS();
+  return delta;
+}
+
+static ReplayHeader replay_header(ecs_world_t *world, uint32_t frameCount) {
+  const TimeStepContext *ts = ecs_singleton_get(world, TimeStepContext);
+  const SDLContext *sdl_ctx = ecs_singleton_get(world, SDLContext);
+  return (ReplayHeader){
+    .magic = REPLAY_MAGIC,
+    .version = REPLAY_VERSION,
+    .inputSize = sizeof(ECS_SDL_INPUT_T),
+    .frameCount = frameCount,
+    .tickRate = ts ? ts->tickRate : TIMESTEP_DEFAULT_RATE,
+    .width = sdl_ctx ? sdl_ctx->width : 0,
+    .height = sdl_ctx ? sdl_ctx->height : 0
+  };
+}
+
+static bool replay_open_record(ecs_world_t *world, ReplayContext *r, const char *path) {
+  r->file = fopen(path, "wb");
+  if (!r->file) {
+    ecs_err("[replay] cannot write %s", path);
+    return false;
+  }
+  ReplayHeader header = replay_header(world, 0);
+  if (fwrite(&header, sizeof(header), 1, r->file) != 1) {
+    ecs_err("[replay] cannot write %s", path);
+    fclose(r->file);
+    r->file = NULL;
+    return false;
+  }
+  return true;
+}
+
+static bool replay_open_play(ecs_world_t *world, ReplayContext *r, const char *path) {
+  size_t size = 0;
+  uint8_t *data = SDL_LoadFile(path, &size);
+  if (!data) {
+    ecs_err("[replay] cannot read %s: %s", path, SDL_GetError());
+    return false;
+  }
+  ReplayHeader header;
+  bool ok = size >= sizeof(header);
+  if (ok) memcpy(&header, data, sizeof(header));
+  ok = ok && header.magic == REPLAY_MAGIC && header.version == REPLAY_VERSION &&
+       header.inputSize == sizeof(ECS_SDL_INPUT_T);
+  if (!ok) {
+    ecs_err("[replay] %s is not a replay of this build (input layout changed?)", path);
+    SDL_free(data);
+    return false;
+  }
+
+  // frameCount is 0 when the recording program did not shut down cleanly
+  uint32_t available = (uint32_t)((size - sizeof(header)) / sizeof(ReplayFrame));
+  r->frameCount = header.frameCount && header.frameCount <= available ? header.frameCount : available;
+  r->frames = flecs_mem_alloc(MEMORY_TAG_ENGINE, sizeof(ReplayFrame) * (r->frameCount ? r->frameCount : 1));
+  if (!r->frames) {
+    SDL_free(data);
+    return false;
+  }
+  memcpy(r->frames, data + sizeof(header), sizeof(ReplayFrame) * r->frameCount);
+  SDL_free(data);
+
+  // the fixed ticks only match with the recorded rate
+  TimeStepContext *ts = ecs_singleton_ensure(world, TimeStepContext);
+  if (ts && header.tickRate > 0.0f && ts->tickRate != header.tickRate) {
+    ecs_log(1, "[replay] tick rate %.0f from the recording", header.tickRate);
+    ts->tickRate = header.tickRate;
+    ts->fixedDelta = 1.0f / header.tickRate;
+  }
+
+  // mouse coordinates only hit the same widgets at the recorded size. Runs
+  // before the vulkan module, the swapchain is created at that size
+  SDLContext *sdl_ctx = ecs_singleton_ensure(world, SDLContext);
+  if (sdl_ctx && sdl_ctx->window && header.width && header.height &&
+      (sdl_ctx->width != header.width || sdl_ctx->height != header.height)) {
+    int width = 0, height = 0;
+    if (SDL_SetWindowSize(sdl_ctx->window, (int)header.width, (int)header.height)) SDL_SyncWindow(sdl_ctx->window);
+    SDL_GetWindowSize(sdl_ctx->window, &width, &height);
+    sdl_ctx->width = (uint32_t)width;
+    sdl_ctx->height = (uint32_t)height;
+    if (sdl_ctx->width != header.width || sdl_ctx->height != header.height) {
+      ecs_warn("[replay] recorded at %ux%u, window is %dx%d: mouse input will not line up",
+               header.width, header.height, width, height);
+    } else {
+      ecs_log(1, "[replay] window resized to the recorded %ux%u", header.width, header.height);
+    }
+  }
+  ecs_log(1, "[replay] %u frames from %s", r->frameCount, path);
+  return true;
+}
+
+void flecs_replay_cleanup(ecs_world_t *world) {
+  ReplayContext *r = ecs_singleton_ensure(world, ReplayContext);
+  if (!r) return;
+  if (r->file) {
+    // frame count into the header now that it is known
+    FILE *f = r->file;
+    r->file = NULL;
+    if (fseek(f, 0, SEEK_SET) == 0) {
+      ReplayHeader header = replay_header(world, r->frame);
+      fwrite(&header, sizeof(header), 1, f);
+    }
+    fclose(f);
+    ecs_log(1, "[replay] recorded %u frames", r->frame);
+  }
+  if (r->frames) {
+    flecs_mem_free(MEMORY_TAG_ENGINE, r->frames);
+    r->frames = NULL;
+  }
+  r->mode = REPLAY_OFF;
+}
+
+// registry slot, marked cleaned by the cleanup observer
+static ModuleHandle replay_module_handle = MODULE_HANDLE_NONE;
+
+void replay_cleanup_event_system(ecs_iter_t *it) {
+  ecs_print(1, "[cleanup] replay_cleanup_event_system");
+  flecs_replay_cleanup(it->world);
+  module_set_state(it->world, replay_module_handle, MODULE_STATE_CLEANED);
+}
+
+void replay_register_components(ecs_world_t *world) {
+  ECS_COMPONENT_DEFINE(world, ReplayContext);
+}
+
+void replay_register_systems(ecs_world_t *world) {
+  ecs_observer(world, {
+    .query.terms = {{ EcsAny, .src.id = CleanUpModule }},
+    .events = { CleanUpEvent },
+    .callback = replay_cleanup_event_system
+  });
+
+  // same phase as SDLInputSystem, created later so it runs later
+  ecs_system_init(world, &(ecs_system_desc_t){
+    .entity = ecs_entity(world, { .name = "ReplayInputSystem", .add = ecs_ids(ecs_dependson(GlobalPhases.LogicUpdatePhase)) }),
+    .query.terms = {
+      ECS_SINGLETON_INOUT(ReplayContext),
+      ECS_SINGLETON_INOUT(SDLContext),
+      ECS_SINGLETON_INOUT(ECS_SDL_INPUT_T)
+    },
+    .callback = ReplayInputSystem
+  });
+}
+
+void flecs_replay_module_init(ecs_world_t *world, ReplayMode mode, const char *path, ReplayPace pace) {
+  ecs_log(1, "Initializing replay module...");
+
+  replay_register_components(world);
+  ecs_singleton_set(world, ReplayContext, { .mode = REPLAY_OFF, .pace = pace });
+
+  replay_ref = ECS_SINGLETON_REF(world, ReplayContext);
+  replay_timestep_ref = ECS_SINGLETON_REF(world, TimeStepContext);
+
+  ReplayContext *r = ecs_ref_get(world, &replay_ref, ReplayContext);
+  if (path && mode == REPLAY_RECORD && replay_open_record(world, r, path)) {
+    r->mode = REPLAY_RECORD;
+  } else if (path && mode == REPLAY_PLAY && replay_open_play(world, r, path)) {
+    r->mode = REPLAY_PLAY;
+  }
+  ecs_singleton_modified(world, ReplayContext);
+
+  replay_module_handle = module_register(world, "replay_module");
+
+  replay_register_systems(world);
+  module_set_state(world, replay_module_handle, MODULE_STATE_READY);
+
+  ecs_log(1, "Replay module initialized (%s)",
+          r->mode == REPLAY_RECORD ? "recording" : r->mode == REPLAY_PLAY ? "playing" : "off");
+}
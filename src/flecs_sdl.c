@@ -38,13 +38,13 @@ void SDLInputSystem(ecs_iter_t *it) {
   // WorldContext *ctx = ecs_get_ctx(it->world);
   // if (!ctx) return;
   //ECS_SDL_INPUT_T *input = ecs_field(it, ECS_SDL_INPUT_T, 0);
-  SDLContext *sdl_ctx = ecs_singleton_ensure(it->world, SDLContext);
+  SDLContext *sdl_ctx = ecs_field(it, SDLContext, 0);
   if (!sdl_ctx || sdl_ctx->hasError || sdl_ctx->isShutDown) return;
 
   // prevent loop input when in shutdown state
   if(sdl_ctx->isShutDown) return;
 
-  ECS_SDL_INPUT_T *input = ecs_singleton_ensure(it->world, ECS_SDL_INPUT_T);
+  ECS_SDL_INPUT_T *input = ecs_field(it, ECS_SDL_INPUT_T, 1);
   if (!input) return; // Safety check
 
   bool isMotion = false;
@@ -264,6 +264,7 @@ void sdl_register_systems(ecs_world_t *world){
           .name = "SDLInputSystem", 
           .add = ecs_ids(ecs_dependson(GlobalPhases.LogicUpdatePhase)) 
       }),
+      .query.terms = { ECS_SINGLETON_INOUT(SDLContext), ECS_SINGLETON_INOUT(ECS_SDL_INPUT_T) },
       .callback = SDLInputSystem
   });
 
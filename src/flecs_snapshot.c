@@ -0,0 +1,687 @@
+#include "flecs_snapshot.h"
+#include "flecs_memory.h"
+#include "flecs_transform.h"
+#include "flecs_timestep.h"
+#include "flecs_bvh.h"
+#include "flecs_vfs.h"
+#include <SDL3/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cJSON.h"
+
+typedef struct {
+  uint32_t magic;
+  uint32_t formatVersion;
+  uint32_t componentCount;
+  uint32_t tableCount;
+  uint64_t entityCount;
+  uint64_t reserved;
+} SnapshotHeader;
+
+typedef struct {
+  char name[SNAPSHOT_NAME_MAX];
+  uint32_t size;
+  uint32_t version;
+} SnapshotSchema;
+
+typedef struct {
+  uint32_t count;
+  uint32_t columnCount;
+  uint64_t parent;       // ChildOf target shared by the table, 0 = root
+} SnapshotTableHeader;
+
+// a table being saved, pointers into the live table storage
+typedef struct {
+  const ecs_entity_t *entities;
+  const void *columns[SNAPSHOT_MAX_COMPONENTS];
+  uint32_t schema[SNAPSHOT_MAX_COMPONENTS];
+  int32_t columnCount;
+  int32_t count;
+  int32_t depth;
+  ecs_entity_t parent;
+} SnapshotTable;
+
+typedef struct {
+  SnapshotTable *tables;
+  int32_t count;
+  int32_t capacity;
+  uint64_t entityCount;
+} SnapshotTables;
+
+static inline size_t snapshot_align(size_t size) {
+  return (size + SNAPSHOT_ALIGN - 1) & ~(size_t)(SNAPSHOT_ALIGN - 1);
+}
+
+static double snapshot_ms(Uint64 begin) {
+  return (double)(SDL_GetPerformanceCounter() - begin) * 1000.0 / (double)SDL_GetPerformanceFrequency();
+}
+
+bool flecs_snapshot_register(ecs_world_t *world, ecs_entity_t component, uint32_t version,
+                             const SnapshotField *fields, int32_t fieldCount, SnapshotMigrateFn migrate) {
+  SnapshotContext *ctx = ecs_singleton_ensure(world, SnapshotContext);
+  const EcsComponent *info = ecs_get(world, component, EcsComponent);
+  const char *name = ecs_get_name(world, component);
+  if (!ctx || !info || !name || ctx->count == SNAPSHOT_MAX_COMPONENTS || fieldCount > SNAPSHOT_MAX_FIELDS) {
+    ecs_err("[snapshot] cannot register component %s", name ? name : "(unnamed)");
+    return false;
+  }
+  SnapshotComponent *c = &ctx->components[ctx->count++];
+  memset(c, 0, sizeof(*c));
+  c->id = component;
+  snprintf(c->name, sizeof(c->name), "%s", name);
+  c->size = (uint32_t)info->size;
+  c->version = version;
+  if (fields && fieldCount > 0) memcpy(c->fields, fields, sizeof(SnapshotField) * (size_t)fieldCount);
+  c->fieldCount = fieldCount > 0 ? fieldCount : 0;
+  c->migrate = migrate;
+  return true;
+}
+
+static int snapshot_table_compare(const void *a, const void *b) {
+  const SnapshotTable *ta = a;
+  const SnapshotTable *tb = b;
+  return (ta->depth > tb->depth) - (ta->depth < tb->depth);
+}
+
+// every non prefab table with at least one registered component, parents
+// first. A table with several registered components is only taken once
+static bool snapshot_collect(ecs_world_t *world, const SnapshotContext *ctx, SnapshotTables *out) {
+  memset(out, 0, sizeof(*out));
+  ecs_map_t seen;
+  ecs_map_init(&seen, NULL);
+
+  for (int32_t c = 0; c < ctx->count; c++) {
+    ecs_iter_t it = ecs_each_id(world, ctx->components[c].id);
+    while (ecs_each_next(&it)) {
+      if (!it.count || ecs_map_get(&seen, (ecs_map_key_t)(uintptr_t)it.table)) continue;
+      ecs_map_insert(&seen, (ecs_map_key_t)(uintptr_t)it.table, 1);
+      if (ecs_table_has_id(world, it.table, EcsPrefab)) continue;
+
+      if (out->count == out->capacity) {
+        int32_t capacity = out->capacity ? out->capacity * 2 : 64;
+        SnapshotTable *grown = flecs_mem_realloc(MEMORY_TAG_ENGINE, out->tables, sizeof(SnapshotTable) * (size_t)capacity);
+        if (!grown) {
+          ecs_map_fini(&seen);
+          return false;
+        }
+        out->tables = grown;
+        out->capacity = capacity;
+      }
+      SnapshotTable *t = &out->tables[out->count++];
+      memset(t, 0, sizeof(*t));
+      t->entities = it.entities;
+      t->count = it.count;
+      for (int32_t k = 0; k < ctx->count; k++) {
+        if (!ecs_table_has_id(world, it.table, ctx->components[k].id)) continue;
+        t->columns[t->columnCount] = ecs_table_get_id(world, it.table, ctx->components[k].id, 0);
+        t->schema[t->columnCount++] = (uint32_t)k;
+      }
+      t->parent = ecs_get_target(world, it.entities[0], EcsChildOf, 0);
+      t->depth = t->parent ? ecs_get_depth(world, t->parent, EcsChildOf) + 1 : 0;
+      out->entityCount += (uint64_t)it.count;
+    }
+  }
+  ecs_map_fini(&seen);
+
+  qsort(out->tables, (size_t)out->count, sizeof(SnapshotTable), snapshot_table_compare);
+  return true;
+}
+
+void *flecs_snapshot_save_mem(ecs_world_t *world, size_t *size) {
+  Uint64 begin = SDL_GetPerformanceCounter();
+  SnapshotContext *ctx = ecs_singleton_ensure(world, SnapshotContext);
+  if (!ctx) return NULL;
+  SnapshotTables tables;
+  if (!snapshot_collect(world, ctx, &tables)) return NULL;
+
+  // one allocation, sized up front
+  size_t total = snapshot_align(sizeof(SnapshotHeader) + sizeof(SnapshotSchema) * (size_t)ctx->count);
+  for (int32_t t = 0; t < tables.count; t++) {
+    const SnapshotTable *table = &tables.tables[t];
+    total += snapshot_align(sizeof(SnapshotTableHeader) + sizeof(uint32_t) * (size_t)table->columnCount);
+    total += snapshot_align(sizeof(uint64_t) * (size_t)table->count);
+    for (int32_t c = 0; c < table->columnCount; c++) {
+      total += snapshot_align((size_t)ctx->components[table->schema[c]].size * (size_t)table->count);
+    }
+  }
+
+  uint8_t *buffer = flecs_mem_calloc(MEMORY_TAG_ENGINE, 1, total);
+  if (!buffer) {
+    flecs_mem_free(MEMORY_TAG_ENGINE, tables.tables);
+    return NULL;
+  }
+
+  uint8_t *cursor = buffer;
+  SnapshotHeader header = {
+    .magic = SNAPSHOT_MAGIC,
+    .formatVersion = SNAPSHOT_FORMAT_VERSION,
+    .componentCount = (uint32_t)ctx->count,
+    .tableCount = (uint32_t)tables.count,
+    .entityCount = tables.entityCount
+  };
+  memcpy(cursor, &header, sizeof(header));
+  SnapshotSchema *schema = (SnapshotSchema *)(cursor + sizeof(header));
+  for (int32_t c = 0; c < ctx->count; c++) {
+    memcpy(schema[c].name, ctx->components[c].name, SNAPSHOT_NAME_MAX);
+    schema[c].size = ctx->components[c].size;
+    schema[c].version = ctx->components[c].version;
+  }
+  cursor += snapshot_align(sizeof(header) + sizeof(SnapshotSchema) * (size_t)ctx->count);
+
+  for (int32_t t = 0; t < tables.count; t++) {
+    const SnapshotTable *table = &tables.tables[t];
+    SnapshotTableHeader th = { (uint32_t)table->count, (uint32_t)table->columnCount, table->parent };
+    memcpy(cursor, &th, sizeof(th));
+    memcpy(cursor + sizeof(th), table->schema, sizeof(uint32_t) * (size_t)table->columnCount);
+    cursor += snapshot_align(sizeof(th) + sizeof(uint32_t) * (size_t)table->columnCount);
+
+    memcpy(cursor, table->entities, sizeof(uint64_t) * (size_t)table->count);
+    cursor += snapshot_align(sizeof(uint64_t) * (size_t)table->count);
+
+    for (int32_t c = 0; c < table->columnCount; c++) {
+      size_t bytes = (size_t)ctx->components[table->schema[c]].size * (size_t)table->count;
+      memcpy(cursor, table->columns[c], bytes);
+      cursor += snapshot_align(bytes);
+    }
+  }
+
+  flecs_mem_free(MEMORY_TAG_ENGINE, tables.tables);
+  ctx->lastSaveMs = snapshot_ms(begin);
+  ctx->lastEntityCount = header.entityCount;
+  ecs_log(1, "[snapshot] saved %llu entities in %u tables, %zu bytes, %.2f ms",
+          (unsigned long long)header.entityCount, header.tableCount, total, ctx->lastSaveMs);
+  *size = total;
+  return buffer;
+}
+
+// insert or restore count entities that share ids[], columns in data[]
+static int64_t snapshot_insert(ecs_world_t *world, SnapshotLoadMode mode, const uint64_t *saved, int32_t count,
+                               const ecs_id_t *ids, void *const *data, const uint32_t *sizes, int32_t idCount,
+                               ecs_map_t *remap) {
+  ecs_bulk_desc_t desc = { .count = count };
+  memcpy(desc.ids, ids, sizeof(ecs_id_t) * (size_t)idCount);
+  void *runData[FLECS_ID_DESC_MAX];
+
+  if (mode == SNAPSHOT_LOAD_NEW) {
+    desc.data = (void **)data;
+    const ecs_entity_t *created = ecs_bulk_init(world, &desc);
+    if (!created) return 0;
+    if (remap) {
+      for (int32_t i = 0; i < count; i++) ecs_map_insert(remap, saved[i], created[i]);
+    }
+    return count;
+  }
+
+  // restore: runs of dead ids go in bulk, ids alive again (module entities
+  // after a restart) get their components set one by one
+  int64_t restored = 0;
+  int32_t i = 0;
+  while (i < count) {
+    ecs_entity_t e = (ecs_entity_t)saved[i];
+    if (!e) {
+      ecs_err("[snapshot] entity id 0, skipped");
+      i++;
+      continue;
+    }
+    if (ecs_is_alive(world, e)) {
+      for (int32_t c = 0; c < idCount; c++) {
+        if (data[c]) ecs_set_id(world, e, ids[c], sizes[c], (const uint8_t *)data[c] + (size_t)sizes[c] * (size_t)i);
+        else ecs_add_id(world, e, ids[c]);
+      }
+      restored++;
+      i++;
+      continue;
+    }
+    if (ecs_get_alive(world, e)) {
+      ecs_err("[snapshot] entity %llu is taken by another generation, skipped", (unsigned long long)e);
+      i++;
+      continue;
+    }
+    int32_t run = i;
+    while (run < count && saved[run] && !ecs_get_alive(world, (ecs_entity_t)saved[run])) {
+      ecs_make_alive(world, (ecs_entity_t)saved[run]);
+      run++;
+    }
+    desc.entities = (ecs_entity_t *)(uintptr_t)(saved + i);
+    desc.count = run - i;
+    for (int32_t c = 0; c < idCount; c++) {
+      runData[c] = data[c] ? (uint8_t *)data[c] + (size_t)sizes[c] * (size_t)i : NULL;
+    }
+    desc.data = runData;
+    ecs_bulk_init(world, &desc);
+    restored += run - i;
+    i = run;
+  }
+  return restored;
+}
+
+int64_t flecs_snapshot_load_mem(ecs_world_t *world, const void *data, size_t size, SnapshotLoadMode mode) {
+  Uint64 begin = SDL_GetPerformanceCounter();
+  SnapshotContext *ctx = ecs_singleton_ensure(world, SnapshotContext);
+  if (!ctx) return -1;
+  const uint8_t *bytes = data;
+  const uint8_t *end = bytes + size;
+
+  SnapshotHeader header;
+  if (size < sizeof(header)) return -1;
+  memcpy(&header, bytes, sizeof(header));
+  if (header.magic != SNAPSHOT_MAGIC || header.formatVersion != SNAPSHOT_FORMAT_VERSION ||
+      header.componentCount > SNAPSHOT_MAX_COMPONENTS ||
+      size < sizeof(header) + sizeof(SnapshotSchema) * header.componentCount) {
+    ecs_err("[snapshot] not a snapshot or unsupported format version");
+    return -1;
+  }
+
+  // saved schema -> registered component, by name
+  const SnapshotSchema *schema = (const SnapshotSchema *)(bytes + sizeof(header));
+  int32_t local[SNAPSHOT_MAX_COMPONENTS];
+  for (uint32_t s = 0; s < header.componentCount; s++) {
+    local[s] = -1;
+    for (int32_t c = 0; c < ctx->count; c++) {
+      const SnapshotComponent *comp = &ctx->components[c];
+      if (strncmp(comp->name, schema[s].name, SNAPSHOT_NAME_MAX) != 0) continue;
+      if (comp->version == schema[s].version && comp->size == schema[s].size) local[s] = c;
+      else if (comp->migrate) local[s] = c;
+      else ecs_err("[snapshot] %s: saved version %u, current %u without migrate, dropped",
+                   comp->name, schema[s].version, comp->version);
+      break;
+    }
+  }
+
+  const uint8_t *cursor = bytes + snapshot_align(sizeof(header) + sizeof(SnapshotSchema) * header.componentCount);
+  ecs_map_t remap;
+  bool remapping = mode == SNAPSHOT_LOAD_NEW;
+  if (remapping) ecs_map_init(&remap, NULL);
+
+  int64_t loaded = 0;
+  for (uint32_t t = 0; t < header.tableCount; t++) {
+    SnapshotTableHeader th;
+    if (cursor + sizeof(th) > end) break;
+    memcpy(&th, cursor, sizeof(th));
+    if (th.columnCount > SNAPSHOT_MAX_COMPONENTS) break;
+    const uint32_t *columns = (const uint32_t *)(cursor + sizeof(th));
+    cursor += snapshot_align(sizeof(th) + sizeof(uint32_t) * th.columnCount);
+    const uint64_t *saved = (const uint64_t *)cursor;
+    cursor += snapshot_align(sizeof(uint64_t) * th.count);
+    if (cursor > end) break;
+
+    ecs_id_t ids[FLECS_ID_DESC_MAX];
+    void *columnData[FLECS_ID_DESC_MAX];
+    uint32_t sizes[FLECS_ID_DESC_MAX];
+    void *migrated[SNAPSHOT_MAX_COMPONENTS];
+    int32_t idCount = 0, migratedCount = 0;
+    bool truncated = false;
+
+    for (uint32_t c = 0; c < th.columnCount; c++) {
+      uint32_t s = columns[c];
+      if (s >= header.componentCount) {
+        truncated = true;
+        break;
+      }
+      size_t columnBytes = (size_t)schema[s].size * th.count;
+      const uint8_t *column = cursor;
+      cursor += snapshot_align(columnBytes);
+      if (cursor > end) {
+        truncated = true;
+        break;
+      }
+      // ids stay 0 terminated with room for the ChildOf pair
+      if (local[s] < 0 || idCount >= FLECS_ID_DESC_MAX - 2) continue;
+      const SnapshotComponent *comp = &ctx->components[local[s]];
+      void *values = (void *)(uintptr_t)column;
+      if (comp->version != schema[s].version || comp->size != schema[s].size) {
+        values = flecs_mem_calloc(MEMORY_TAG_ENGINE, th.count ? th.count : 1, comp->size);
+        if (!values) continue;
+        comp->migrate(schema[s].version, column, schema[s].size, values, (int32_t)th.count);
+        migrated[migratedCount++] = values;
+      }
+      ids[idCount] = comp->id;
+      sizes[idCount] = comp->size;
+      columnData[idCount++] = values;
+    }
+
+    if (!truncated && idCount && th.count) {
+      // a parent outside the snapshot has no new id, the raw saved id
+      // could name an unrelated entity: leave the table unparented
+      ecs_entity_t parent = (ecs_entity_t)th.parent;
+      if (parent && remapping) {
+        ecs_map_val_t *mapped = ecs_map_get(&remap, parent);
+        if (!mapped) ecs_err("[snapshot] parent %llu not in the snapshot, table %u loaded unparented",
+                             (unsigned long long)parent, t);
+        parent = mapped ? (ecs_entity_t)*mapped : 0;
+      }
+      if (parent && ecs_is_alive(world, parent)) {
+        ids[idCount] = ecs_pair(EcsChildOf, parent);
+        sizes[idCount] = 0;
+        columnData[idCount++] = NULL;
+      }
+      loaded += snapshot_insert(world, mode, saved, (int32_t)th.count, ids, columnData, sizes, idCount,
+                                remapping ? &remap : NULL);
+    }
+    for (int32_t m = 0; m < migratedCount; m++) flecs_mem_free(MEMORY_TAG_ENGINE, migrated[m]);
+    if (truncated) {
+      ecs_err("[snapshot] truncated at table %u", t);
+      break;
+    }
+  }
+
+  if (remapping) ecs_map_fini(&remap);
+  ctx = ecs_singleton_ensure(world, SnapshotContext); // inserts may have moved it
+  ctx->lastLoadMs = snapshot_ms(begin);
+  ctx->lastEntityCount = (uint64_t)loaded;
+  ecs_log(1, "[snapshot] loaded %lld entities in %.2f ms", (long long)loaded, ctx->lastLoadMs);
+  return loaded;
+}
+
+bool flecs_snapshot_save(ecs_world_t *world, const char *path) {
+  size_t size = 0;
+  void *data = flecs_snapshot_save_mem(world, &size);
+  if (!data) return false;
+  // temp file + rename, a crash mid write keeps the previous snapshot
+  bool ok = flecs_write_file_atomic(path, data, size);
+  if (!ok) ecs_err("[snapshot] failed to write %s", path);
+  flecs_mem_free(MEMORY_TAG_ENGINE, data);
+  return ok;
+}
+
+int64_t flecs_snapshot_load(ecs_world_t *world, const char *path, SnapshotLoadMode mode) {
+  size_t size = 0;
+  void *data = SDL_LoadFile(path, &size);
+  if (!data) {
+    ecs_err("[snapshot] failed to read %s: %s", path, SDL_GetError());
+    return -1;
+  }
+  int64_t loaded = flecs_snapshot_load_mem(world, data, size, mode);
+  SDL_free(data);
+  return loaded;
+}
+
+//===============================================
+// JSON
+//===============================================
+
+static void snapshot_json_set_hex(cJSON *object, const char *name, uint64_t value) {
+  char hex[17];
+  snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)value);
+  cJSON_AddStringToObject(object, name, hex);
+}
+
+static uint64_t snapshot_json_hex(const cJSON *object, const char *name) {
+  const cJSON *value = cJSON_GetObjectItemCaseSensitive(object, name);
+  return cJSON_IsString(value) ? strtoull(value->valuestring, NULL, 16) : 0;
+}
+
+// U64 goes out as a decimal string, a double only holds 53 bits
+static cJSON *snapshot_field_get(const uint8_t *p, SnapshotFieldType type) {
+  switch (type) {
+    case SNAPSHOT_FIELD_F32: { float v; memcpy(&v, p, sizeof(v)); return cJSON_CreateNumber(v); }
+    case SNAPSHOT_FIELD_I32: { int32_t v; memcpy(&v, p, sizeof(v)); return cJSON_CreateNumber(v); }
+    case SNAPSHOT_FIELD_U32: { uint32_t v; memcpy(&v, p, sizeof(v)); return cJSON_CreateNumber(v); }
+    case SNAPSHOT_FIELD_U64: {
+      uint64_t v;
+      memcpy(&v, p, sizeof(v));
+      char text[21];
+      snprintf(text, sizeof(text), "%llu", (unsigned long long)v);
+      return cJSON_CreateString(text);
+    }
+    case SNAPSHOT_FIELD_BOOL: return cJSON_CreateNumber(*p ? 1.0 : 0.0);
+  }
+  return cJSON_CreateNull();
+}
+
+// numbers for every type, strings for U64 (numbers still read for older JSON)
+static void snapshot_field_set(uint8_t *p, SnapshotFieldType type, const cJSON *item) {
+  if (type == SNAPSHOT_FIELD_U64 && cJSON_IsString(item)) {
+    uint64_t v = strtoull(item->valuestring, NULL, 10);
+    memcpy(p, &v, sizeof(v));
+    return;
+  }
+  if (!cJSON_IsNumber(item)) return;
+  double value = item->valuedouble;
+  switch (type) {
+    case SNAPSHOT_FIELD_F32: { float v = (float)value; memcpy(p, &v, sizeof(v)); break; }
+    case SNAPSHOT_FIELD_I32: { int32_t v = (int32_t)value; memcpy(p, &v, sizeof(v)); break; }
+    case SNAPSHOT_FIELD_U32: { uint32_t v = (uint32_t)value; memcpy(p, &v, sizeof(v)); break; }
+    case SNAPSHOT_FIELD_U64: { uint64_t v = (uint64_t)value; memcpy(p, &v, sizeof(v)); break; }
+    case SNAPSHOT_FIELD_BOOL: *p = value != 0.0; break;
+  }
+}
+
+static size_t snapshot_field_size(SnapshotFieldType type) {
+  switch (type) {
+    case SNAPSHOT_FIELD_U64: return 8;
+    case SNAPSHOT_FIELD_BOOL: return 1;
+    default: return 4;
+  }
+}
+
+static cJSON *snapshot_json_value(const SnapshotComponent *comp, const uint8_t *value) {
+  if (!comp->fieldCount) {
+    // no descriptors: raw bytes, still diffable
+    char *hex = flecs_mem_alloc(MEMORY_TAG_ENGINE, (size_t)comp->size * 2 + 1);
+    if (!hex) return cJSON_CreateNull();
+    for (uint32_t i = 0; i < comp->size; i++) snprintf(hex + i * 2, 3, "%02x", value[i]);
+    cJSON *item = cJSON_CreateString(hex);
+    flecs_mem_free(MEMORY_TAG_ENGINE, hex);
+    return item;
+  }
+  cJSON *object = cJSON_CreateObject();
+  for (int32_t f = 0; f < comp->fieldCount; f++) {
+    const SnapshotField *field = &comp->fields[f];
+    const uint8_t *p = value + field->offset;
+    if (field->count == 1) {
+      cJSON_AddItemToObject(object, field->name, snapshot_field_get(p, field->type));
+      continue;
+    }
+    cJSON *array = cJSON_AddArrayToObject(object, field->name);
+    for (uint16_t i = 0; i < field->count; i++) {
+      cJSON_AddItemToArray(array, snapshot_field_get(p + i * snapshot_field_size(field->type), field->type));
+    }
+  }
+  return object;
+}
+
+// fields by name, so JSON survives layout changes that keep the field names
+static void snapshot_json_read(const SnapshotComponent *comp, const cJSON *item, uint8_t *value) {
+  if (cJSON_IsString(item)) {
+    const char *hex = item->valuestring;
+    for (uint32_t i = 0; i < comp->size && hex[i * 2] && hex[i * 2 + 1]; i++) {
+      char byte[3] = { hex[i * 2], hex[i * 2 + 1], 0 };
+      value[i] = (uint8_t)strtoul(byte, NULL, 16);
+    }
+    return;
+  }
+  for (int32_t f = 0; f < comp->fieldCount; f++) {
+    const SnapshotField *field = &comp->fields[f];
+    const cJSON *v = cJSON_GetObjectItemCaseSensitive(item, field->name);
+    uint8_t *p = value + field->offset;
+    if (cJSON_IsArray(v)) {
+      uint16_t i = 0;
+      const cJSON *element;
+      cJSON_ArrayForEach(element, v) {
+        if (i == field->count) break;
+        snapshot_field_set(p + i * snapshot_field_size(field->type), field->type, element);
+        i++;
+      }
+    } else if (v) {
+      snapshot_field_set(p, field->type, v);
+    }
+  }
+}
+
+char *flecs_snapshot_export_json(ecs_world_t *world) {
+  SnapshotContext *ctx = ecs_singleton_ensure(world, SnapshotContext);
+  if (!ctx) return NULL;
+  SnapshotTables tables;
+  if (!snapshot_collect(world, ctx, &tables)) return NULL;
+
+  cJSON *root = cJSON_CreateObject();
+  cJSON_AddNumberToObject(root, "format", SNAPSHOT_FORMAT_VERSION);
+  cJSON *components = cJSON_AddArrayToObject(root, "components");
+  for (int32_t c = 0; c < ctx->count; c++) {
+    cJSON *comp = cJSON_CreateObject();
+    cJSON_AddStringToObject(comp, "name", ctx->components[c].name);
+    cJSON_AddNumberToObject(comp, "size", ctx->components[c].size);
+    cJSON_AddNumberToObject(comp, "version", ctx->components[c].version);
+    cJSON_AddItemToArray(components, comp);
+  }
+
+  cJSON *entities = cJSON_AddArrayToObject(root, "entities");
+  for (int32_t t = 0; t < tables.count; t++) {
+    const SnapshotTable *table = &tables.tables[t];
+    for (int32_t i = 0; i < table->count; i++) {
+      cJSON *entity = cJSON_CreateObject();
+      snapshot_json_set_hex(entity, "id", table->entities[i]);
+      if (table->parent) snapshot_json_set_hex(entity, "parent", table->parent);
+      for (int32_t c = 0; c < table->columnCount; c++) {
+        const SnapshotComponent *comp = &ctx->components[table->schema[c]];
+        const uint8_t *value = (const uint8_t *)table->columns[c] + (size_t)comp->size * (size_t)i;
+        cJSON_AddItemToObject(entity, comp->name, snapshot_json_value(comp, value));
+      }
+      cJSON_AddItemToArray(entities, entity);
+    }
+  }
+  flecs_mem_free(MEMORY_TAG_ENGINE, tables.tables);
+
+  char *text = cJSON_Print(root);
+  cJSON_Delete(root);
+  return text;
+}
+
+int64_t flecs_snapshot_import_json(ecs_world_t *world, const char *json, SnapshotLoadMode mode) {
+  cJSON *root = cJSON_Parse(json);
+  const cJSON *format = root ? cJSON_GetObjectItemCaseSensitive(root, "format") : NULL;
+  if (!cJSON_IsNumber(format) || format->valueint != SNAPSHOT_FORMAT_VERSION) {
+    ecs_err("[snapshot] not a snapshot JSON or unsupported format");
+    cJSON_Delete(root);
+    return -1;
+  }
+
+  ecs_map_t remap;
+  ecs_map_init(&remap, NULL);
+  uint8_t value[1024];
+  int64_t loaded = 0;
+
+  // entities are written parents first, a parent is always created before its children
+  const cJSON *entity;
+  cJSON_ArrayForEach(entity, cJSON_GetObjectItemCaseSensitive(root, "entities")) {
+    ecs_entity_t saved = (ecs_entity_t)snapshot_json_hex(entity, "id");
+    if (!saved) {
+      ecs_err("[snapshot] entity without an id, skipped");
+      continue;
+    }
+    ecs_entity_t e = 0;
+    if (mode == SNAPSHOT_LOAD_NEW) {
+      e = ecs_new(world);
+      ecs_map_insert(&remap, saved, e);
+    } else if (ecs_is_alive(world, saved) || !ecs_get_alive(world, saved)) {
+      ecs_make_alive(world, saved);
+      e = saved;
+    }
+    if (!e) {
+      ecs_err("[snapshot] entity %llu is taken by another generation, skipped", (unsigned long long)saved);
+      continue;
+    }
+
+    ecs_entity_t parent = (ecs_entity_t)snapshot_json_hex(entity, "parent");
+    if (parent && mode == SNAPSHOT_LOAD_NEW) {
+      ecs_map_val_t *mapped = ecs_map_get(&remap, parent);
+      if (!mapped) ecs_err("[snapshot] parent %llu of %llu not in the snapshot, loaded unparented",
+                           (unsigned long long)parent, (unsigned long long)saved);
+      parent = mapped ? (ecs_entity_t)*mapped : 0;
+    }
+    if (parent && ecs_is_alive(world, parent)) ecs_add_pair(world, e, EcsChildOf, parent);
+
+    // look the registry up per entity, sets can move the singleton
+    const SnapshotContext *ctx = ecs_singleton_get(world, SnapshotContext);
+    for (int32_t c = 0; ctx && c < ctx->count; c++) {
+      const SnapshotComponent *comp = &ctx->components[c];
+      const cJSON *item = cJSON_GetObjectItemCaseSensitive(entity, comp->name);
+      if (!item || comp->size > sizeof(value)) continue;
+      const void *current = ecs_get_id(world, e, comp->id);
+      if (current) memcpy(value, current, comp->size);
+      else memset(value, 0, comp->size);
+      snapshot_json_read(comp, item, value);
+      ecs_entity_t id = comp->id;
+      uint32_t size = comp->size;
+      ecs_set_id(world, e, id, size, value);
+      ctx = ecs_singleton_get(world, SnapshotContext);
+    }
+    loaded++;
+  }
+
+  ecs_map_fini(&remap);
+  cJSON_Delete(root);
+  ecs_log(1, "[snapshot] imported %lld entities from JSON", (long long)loaded);
+  return loaded;
+}
+
+//===============================================
+// module
+//===============================================
+
+void flecs_snapshot_cleanup(ecs_world_t *world) {
+  SnapshotContext *ctx = ecs_singleton_ensure(world, SnapshotContext);
+  if (!ctx) return;
+  // the registry points at component entities that go away with the world
+  memset(ctx->components, 0, sizeof(ctx->components));
+  ctx->count = 0;
+}
+
+// registry slot, marked cleaned by the cleanup observer
+static ModuleHandle snapshot_module_handle = MODULE_HANDLE_NONE;
+
+void snapshot_cleanup_event_system(ecs_iter_t *it) {
+  ecs_print(1, "[cleanup] snapshot_cleanup_event_system");
+  flecs_snapshot_cleanup(it->world);
+  module_set_state(it->world, snapshot_module_handle, MODULE_STATE_CLEANED);
+}
+
+void snapshot_register_components(ecs_world_t *world) {
+  ECS_COMPONENT_DEFINE(world, SnapshotContext);
+}
+
+// plain data components of the engine modules
+static void snapshot_register_builtin(ecs_world_t *world) {
+  SnapshotField transformFields[] = {
+    SNAPSHOT_FIELD(LocalTransform, position, SNAPSHOT_FIELD_F32, 3),
+    SNAPSHOT_FIELD(LocalTransform, rotation, SNAPSHOT_FIELD_F32, 4),
+    SNAPSHOT_FIELD(LocalTransform, scale, SNAPSHOT_FIELD_F32, 3)
+  };
+  SnapshotField matrixFields[] = {
+    SNAPSHOT_FIELD(WorldTransform, matrix, SNAPSHOT_FIELD_F32, 16)
+  };
+  SnapshotField boundsFields[] = {
+    SNAPSHOT_FIELD(Bounds, min, SNAPSHOT_FIELD_F32, 3),
+    SNAPSHOT_FIELD(Bounds, max, SNAPSHOT_FIELD_F32, 3)
+  };
+  flecs_snapshot_register(world, ecs_id(LocalTransform), 1, transformFields, 3, NULL);
+  flecs_snapshot_register(world, ecs_id(WorldTransform), 1, matrixFields, 1, NULL);
+  flecs_snapshot_register(world, ecs_id(SimTransform), 1, transformFields, 3, NULL);
+  flecs_snapshot_register(world, ecs_id(SimTransformPrev), 1, transformFields, 3, NULL);
+  flecs_snapshot_register(world, ecs_id(Bounds), 1, boundsFields, 2, NULL);
+}
+
+void snapshot_register_systems(ecs_world_t *world) {
+  ecs_observer(world, {
+    .query.terms = {{ EcsAny, .src.id = CleanUpModule }},
+    .events = { CleanUpEvent },
+    .callback = snapshot_cleanup_event_system
+  });
+}
+
+void flecs_snapshot_module_init(ecs_world_t *world) {
+  ecs_log(1, "Initializing snapshot module...");
+
+  snapshot_register_components(world);
+  ecs_singleton_set(world, SnapshotContext, {0});
+  snapshot_register_builtin(world);
+
+  snapshot_module_handle = module_register(world, "snapshot_module");
+
+  snapshot_register_systems(world);
+  module_set_state(world, snapshot_module_handle, MODULE_STATE_READY);
+
+  ecs_log(1, "Snapshot module initialized (%d components)", ecs_singleton_get(world, SnapshotContext)->count);
+}
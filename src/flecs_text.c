@@ -1,16 +1,28 @@
 #include "flecs_text.h"
 #include <flecs.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "shaders/text_vert.spv.h"
 #include "shaders/text_frag.spv.h"
 #include "flecs_utils.h" // createShaderModuleLen(v_ctx->device, text_vert_spv)
 #include "flecs_sdl.h"
 #include "flecs_vulkan.h"
-
+#include "flecs_asset_jobs.h"
+#include "flecs_asset_registry.h"
+#include "flecs_vfs.h"
+#include "flecs_memory.h"
+#include "flecs_texture_cooker.h"
+#include FT_MODULE_H
+
+// One instance per glyph, text.vert expands it to a 4 vertex strip from
+// gl_VertexIndex. 20 bytes instead of 4 vertices + 6 indices (88 bytes).
 typedef struct {
-    float pos[2];    // 2D position
-    float uv[2];     // Texture coordinates
-} TextVertex;
+    int16_t pos[2];   // top-left, 1/8 pixels
+    uint16_t size[2]; // 1/8 pixels
+    uint16_t rect[4]; // atlas page texels x, y, width, height
+    uint32_t color;   // RGBA8, R in the low byte
+} TextGlyph;
 
 typedef struct {
     float u0, v0, u1, v1; // UV coordinates
@@ -19,6 +31,16 @@ typedef struct {
     int bearingX, bearingY; // Offset from baseline
 } GlyphInfo;
 
+// AssetResult userData of a baked / cooked atlas
+typedef struct {
+    GlyphCacheMode mode;
+    uint32_t pixelSize;
+    uint64_t sourceHash;
+    GlyphInfo glyphs[95];
+    int16_t kerning[95 * 95];  // [left - 32][right - 32], 1/64 pixels
+    uint32_t kerningCount;     // non zero pairs
+} TextBakedGlyphs;
+
 // static VkShaderModule createShaderModule(VkDevice device, const uint32_t *code, size_t codeSize) {
 //   VkShaderModuleCreateInfo createInfo = {VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO};
 //   createInfo.codeSize = codeSize;
@@ -31,36 +53,6 @@ typedef struct {
 //   return module;
 // }
 
-// Unchanged: transitionImageLayout, createShaderModule
-static void transitionImageLayout(VkCommandBuffer commandBuffer, VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout) {
-    VkImageMemoryBarrier barrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
-    barrier.oldLayout = oldLayout;
-    barrier.newLayout = newLayout;
-    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.image = image;
-    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barrier.subresourceRange.levelCount = 1;
-    barrier.subresourceRange.layerCount = 1;
-
-    VkPipelineStageFlags srcStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-    VkPipelineStageFlags dstStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-
-    if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) {
-        barrier.srcAccessMask = 0;
-        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        srcStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-        dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-    } else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) {
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-        srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-        dstStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-    }
-
-    vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 0, NULL, 0, NULL, 1, &barrier);
-}
-
 static void createBuffer(VulkanContext *v_ctx, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer *buffer, VkDeviceMemory *memory) {
     VkBufferCreateInfo bufferInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
     bufferInfo.size = size;
@@ -96,44 +88,53 @@ static void createBuffer(VulkanContext *v_ctx, VkDeviceSize size, VkBufferUsageF
     vkBindBufferMemory(v_ctx->device, *buffer, *memory, 0);
 }
 
-static void updateBuffer(VulkanContext *v_ctx, VkDeviceMemory memory, VkDeviceSize size, void *data) {
-    void *mapped;
-    vkMapMemory(v_ctx->device, memory, 0, size, 0, &mapped);
-    memcpy(mapped, data, (size_t)size);
-    vkUnmapMemory(v_ctx->device, memory);
-}
-
-static void createFontAtlas(VulkanContext *v_ctx, Text2DContext *text_ctx) {
+// Rasterize ASCII 32-126 on the asset worker, FT_Library is per job so
+// workers do not share FreeType state. data is the font file, kept by the caller.
+static bool TextBakeFontMemory(const void *data, size_t size, GlyphCacheMode mode, AssetResult *result) {
     FT_Library ft;
     FT_Face face;
     if (FT_Init_FreeType(&ft)) {
-        ecs_err("Failed to initialize FreeType");
-        v_ctx->hasError = true;
-        v_ctx->errorMessage = "FreeType init failed";
-        return;
+        result->error = "FreeType init failed";
+        return false;
     }
+    // same distance range as the glyph cache rasterises at runtime
+    FT_Int spread = GLYPH_SDF_SPREAD;
+    FT_Property_Set(ft, "sdf", "spread", &spread);
 
-    if (FT_New_Face(ft, "assets/fonts/Kenney Mini.ttf", 0, &face)) {
-        ecs_err("Failed to load Kenney Mini.ttf");
+    if (FT_New_Memory_Face(ft, data, (FT_Long)size, 0, &face)) {
         FT_Done_FreeType(ft);
-        v_ctx->hasError = true;
-        v_ctx->errorMessage = "Font load failed";
-        return;
+        result->error = "Font load failed";
+        return false;
     }
 
-    FT_Set_Pixel_Sizes(face, 0, 48);
+    uint32_t pixelSize = mode == GLYPH_MODE_SDF ? GLYPH_SDF_PIXEL_SIZE : TEXT_BAKED_PIXEL_SIZE;
+    FT_Set_Pixel_Sizes(face, 0, pixelSize);
 
     const int textAtlasWidth = 512;
     const int textAtlasHeight = 512;
     unsigned char *atlasData = calloc(textAtlasWidth * textAtlasHeight, sizeof(unsigned char));
+    TextBakedGlyphs *baked = calloc(1, sizeof(TextBakedGlyphs));
+    if (!atlasData || !baked) {
+        free(atlasData);
+        free(baked);
+        FT_Done_Face(face);
+        FT_Done_FreeType(ft);
+        result->error = "out of memory";
+        return false;
+    }
+    baked->mode = mode;
+    baked->pixelSize = pixelSize;
+    baked->sourceHash = flecs_texture_source_hash(data, size);
+    GlyphInfo *textGlyphs = baked->glyphs;
     int x = 0, y = 0;
     unsigned int maxHeight = 0;
 
-    GlyphInfo textGlyphs[95];
-    memset(textGlyphs, 0, sizeof(textGlyphs));
-
     for (unsigned char c = 32; c < 127; c++) {
-        if (FT_Load_Char(face, c, FT_LOAD_RENDER)) continue;
+        if (mode == GLYPH_MODE_SDF) {
+            if (FT_Load_Char(face, c, FT_LOAD_DEFAULT) || FT_Render_Glyph(face->glyph, FT_RENDER_MODE_SDF)) continue;
+        } else if (FT_Load_Char(face, c, FT_LOAD_RENDER)) {
+            continue;
+        }
 
         if (x + (int)face->glyph->bitmap.width >= textAtlasWidth) {
             x = 0;
@@ -146,7 +147,7 @@ static void createFontAtlas(VulkanContext *v_ctx, Text2DContext *text_ctx) {
                 int atlasX = x + j;
                 int atlasY = y + i;
                 if (atlasX < textAtlasWidth && atlasY < textAtlasHeight) {
-                    atlasData[atlasY * textAtlasWidth + atlasX] = face->glyph->bitmap.buffer[i * face->glyph->bitmap.width + j];
+                    atlasData[atlasY * textAtlasWidth + atlasX] = face->glyph->bitmap.buffer[i * face->glyph->bitmap.pitch + j];
                 }
             }
         }
@@ -165,150 +166,238 @@ static void createFontAtlas(VulkanContext *v_ctx, Text2DContext *text_ctx) {
         maxHeight = face->glyph->bitmap.rows > maxHeight ? face->glyph->bitmap.rows : maxHeight;
     }
 
-    text_ctx->textGlyphs = malloc(sizeof(textGlyphs));
-    memcpy(text_ctx->textGlyphs, textGlyphs, sizeof(textGlyphs));
-    text_ctx->textAtlasWidth = textAtlasWidth;
-    text_ctx->textAtlasHeight = textAtlasHeight;
-
-    VkImageCreateInfo imageInfo = {VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
-    imageInfo.imageType = VK_IMAGE_TYPE_2D;
-    imageInfo.format = VK_FORMAT_R8_UNORM;
-    imageInfo.extent.width = textAtlasWidth;
-    imageInfo.extent.height = textAtlasHeight;
-    imageInfo.extent.depth = 1;
-    imageInfo.mipLevels = 1;
-    imageInfo.arrayLayers = 1;
-    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
-    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-    imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-
-    if (vkCreateImage(v_ctx->device, &imageInfo, NULL, &text_ctx->textFontImage) != VK_SUCCESS) {
-        ecs_err("Failed to create font atlas image");
-        free(atlasData);
-        FT_Done_Face(face);
-        FT_Done_FreeType(ft);
-        v_ctx->hasError = true;
-        v_ctx->errorMessage = "Font atlas image creation failed";
-        return;
+    // legacy 'kern' table pairs (no GPOS without HarfBuzz), 26.6 pixels at the size above
+    if (FT_HAS_KERNING(face)) {
+        for (int left = 0; left < 95; left++) {
+            FT_UInt leftIndex = FT_Get_Char_Index(face, (FT_ULong)(32 + left));
+            if (!leftIndex) continue;
+            for (int right = 0; right < 95; right++) {
+                FT_UInt rightIndex = FT_Get_Char_Index(face, (FT_ULong)(32 + right));
+                FT_Vector delta;
+                if (!rightIndex || FT_Get_Kerning(face, leftIndex, rightIndex, FT_KERNING_UNFITTED, &delta) || !delta.x) continue;
+                baked->kerning[left * 95 + right] = (int16_t)(delta.x < INT16_MIN ? INT16_MIN : delta.x > INT16_MAX ? INT16_MAX : delta.x);
+                baked->kerningCount++;
+            }
+        }
     }
 
-    VkMemoryRequirements memReqs;
-    vkGetImageMemoryRequirements(v_ctx->device, text_ctx->textFontImage, &memReqs);
-    VkMemoryAllocateInfo allocInfo = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
-    allocInfo.allocationSize = memReqs.size;
-    VkPhysicalDeviceMemoryProperties memProps;
-    vkGetPhysicalDeviceMemoryProperties(v_ctx->physicalDevice, &memProps);
-    for (uint32_t i = 0; i < memProps.memoryTypeCount; i++) {
-        if (memReqs.memoryTypeBits & (1 << i) && (memProps.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)) {
-            allocInfo.memoryTypeIndex = i;
-            break;
-        }
+    FT_Done_Face(face);
+    FT_Done_FreeType(ft);
+
+    result->pixels = atlasData;
+    result->width = textAtlasWidth;
+    result->height = textAtlasHeight;
+    result->channels = 1;
+    result->userData = baked;
+    return true;
+}
+
+bool flecs_text_bake_font_atlas(const char *path, GlyphCacheMode mode, AssetResult *result) {
+    // memory face over the vfs view, must outlive the face
+    VfsView fontView;
+    if (!flecs_vfs_open_view(path, &fontView)) {
+        result->error = "Font not found";
+        return false;
     }
+    bool ok = TextBakeFontMemory(fontView.data, fontView.size, mode, result);
+    flecs_vfs_close_view(&fontView);
+    return ok;
+}
 
-    if (vkAllocateMemory(v_ctx->device, &allocInfo, NULL, &text_ctx->textFontImageMemory) != VK_SUCCESS) {
-        vkDestroyImage(v_ctx->device, text_ctx->textFontImage, NULL);
-        free(atlasData);
-        FT_Done_Face(face);
-        FT_Done_FreeType(ft);
-        v_ctx->hasError = true;
-        v_ctx->errorMessage = "Font atlas memory allocation failed";
-        return;
+void *flecs_text_atlas_serialize(const AssetResult *result, size_t *size) {
+    const TextBakedGlyphs *baked = result->userData;
+    TextAtlasHeader header = {
+        .magic = TEXT_ATLAS_MAGIC,
+        .version = TEXT_ATLAS_VERSION,
+        .width = (uint32_t)result->width,
+        .height = (uint32_t)result->height,
+        .glyphCount = 95,
+        .glyphSize = sizeof(GlyphInfo),
+        .mode = (uint32_t)baked->mode,
+        .pixelSize = baked->pixelSize,
+        .kerningCount = baked->kerningCount,
+        .sourceHash = baked->sourceHash
+    };
+    size_t glyphBytes = sizeof(GlyphInfo) * header.glyphCount;
+    size_t pixelBytes = (size_t)header.width * header.height;
+    size_t kerningBytes = sizeof(TextKerningPair) * header.kerningCount;
+    uint8_t *blob = malloc(sizeof(header) + glyphBytes + pixelBytes + kerningBytes);
+    if (!blob) return NULL;
+    memcpy(blob, &header, sizeof(header));
+    memcpy(blob + sizeof(header), baked->glyphs, glyphBytes);
+    memcpy(blob + sizeof(header) + glyphBytes, result->pixels, pixelBytes);
+    TextKerningPair *pairs = (TextKerningPair *)(blob + sizeof(header) + glyphBytes + pixelBytes);
+    for (int i = 0; i < 95 * 95; i++) {
+        if (baked->kerning[i]) *pairs++ = (TextKerningPair){(uint8_t)(32 + i / 95), (uint8_t)(32 + i % 95), baked->kerning[i]};
     }
+    *size = sizeof(header) + glyphBytes + pixelBytes + kerningBytes;
+    return blob;
+}
 
-    vkBindImageMemory(v_ctx->device, text_ctx->textFontImage, text_ctx->textFontImageMemory, 0);
+// a baked atlas blob for this font file (sourceHash) and mode, into result
+static bool TextParseFontAtlas(const void *data, size_t size, uint64_t sourceHash, AssetResult *result) {
+    TextAtlasHeader header;
+    if (size < sizeof(header)) return false;
+    memcpy(&header, data, sizeof(header));
+    size_t glyphBytes = sizeof(GlyphInfo) * 95;
+    size_t pixelBytes = (size_t)header.width * header.height;
+    if (header.magic != TEXT_ATLAS_MAGIC || header.version != TEXT_ATLAS_VERSION || header.sourceHash != sourceHash ||
+        header.glyphCount != 95 || header.glyphSize != sizeof(GlyphInfo) || header.mode != TEXT_FONT_MODE ||
+        header.kerningCount > 95 * 95 ||
+        size < sizeof(header) + glyphBytes + pixelBytes + sizeof(TextKerningPair) * header.kerningCount) {
+        return false;
+    }
 
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingMemory;
-    createBuffer(v_ctx, textAtlasWidth * textAtlasHeight, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &stagingBuffer, &stagingMemory);
-    updateBuffer(v_ctx, stagingMemory, textAtlasWidth * textAtlasHeight, atlasData);
+    const uint8_t *bytes = (const uint8_t *)data + sizeof(header);
+    TextBakedGlyphs *baked = calloc(1, sizeof(TextBakedGlyphs));
+    uint8_t *pixels = malloc(pixelBytes);
+    if (!baked || !pixels) {
+        free(baked);
+        free(pixels);
+        return false;
+    }
+    baked->mode = (GlyphCacheMode)header.mode;
+    baked->pixelSize = header.pixelSize;
+    baked->sourceHash = header.sourceHash;
+    memcpy(baked->glyphs, bytes, glyphBytes);
+    memcpy(pixels, bytes + glyphBytes, pixelBytes);
+    const TextKerningPair *pairs = (const TextKerningPair *)(bytes + glyphBytes + pixelBytes);
+    for (uint32_t i = 0; i < header.kerningCount; i++) {
+        TextKerningPair pair;
+        memcpy(&pair, &pairs[i], sizeof(pair));
+        if (pair.left < 32 || pair.left > 126 || pair.right < 32 || pair.right > 126) continue;
+        baked->kerning[(pair.left - 32) * 95 + (pair.right - 32)] = pair.x;
+        baked->kerningCount++;
+    }
 
-    VkCommandBufferAllocateInfo cmdAllocInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
-    cmdAllocInfo.commandPool = v_ctx->commandPool;
-    cmdAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    cmdAllocInfo.commandBufferCount = 1;
+    result->userData = baked;
+    result->pixels = pixels;
+    result->width = (int)header.width;
+    result->height = (int)header.height;
+    result->channels = 1;
+    return true;
+}
 
-    VkCommandBuffer commandBuffer;
-    if (vkAllocateCommandBuffers(v_ctx->device, &cmdAllocInfo, &commandBuffer) != VK_SUCCESS) {
-        ecs_err("Failed to allocate one-time command buffer");
-        v_ctx->hasError = true;
-        v_ctx->errorMessage = "Command buffer allocation failed";
-        return;
-    }
+static void TextFontCachePath(uint64_t sourceHash, char *out, size_t outSize) {
+    uint32_t pixelSize = TEXT_FONT_MODE == GLYPH_MODE_SDF ? GLYPH_SDF_PIXEL_SIZE : TEXT_BAKED_PIXEL_SIZE;
+    snprintf(out, outSize, "%s/%016llx_%s%u_v%d.atlas", TEXT_ATLAS_CACHE_DIR, (unsigned long long)sourceHash,
+             TEXT_FONT_MODE == GLYPH_MODE_SDF ? "sdf" : "px", pixelSize, TEXT_ATLAS_VERSION);
+}
 
-    VkCommandBufferBeginInfo beginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
-    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-    if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
-        ecs_err("Failed to begin one-time command buffer");
-        vkFreeCommandBuffers(v_ctx->device, v_ctx->commandPool, 1, &commandBuffer);
-        v_ctx->hasError = true;
-        v_ctx->errorMessage = "Command buffer begin failed";
-        return;
+// Baked atlas for the font, no FreeType at all when there is one: the
+// asset_cooker atlas from the pack, else the first run cache, else rasterize
+// now and fill the cache. The font bytes come along for the glyph cache's
+// FreeType face (opened on the first glyph the atlas does not have).
+static bool TextDecodeFontAtlas(const char *path, AssetResult *result) {
+    result->data = flecs_vfs_read_all(path, &result->size);
+    if (!result->data) {
+        result->error = "Font not found";
+        return false;
+    }
+    uint64_t sourceHash = flecs_texture_source_hash(result->data, result->size);
+
+    char cookedPath[VFS_PACK_NAME_MAX];
+    VfsView view;
+    if (snprintf(cookedPath, sizeof(cookedPath), "%s%s", path, TEXT_ATLAS_COOKED_EXT) < (int)sizeof(cookedPath) &&
+        flecs_vfs_exists(cookedPath) && flecs_vfs_open_view(cookedPath, &view)) {
+        bool ok = TextParseFontAtlas(view.data, view.size, sourceHash, result);
+        flecs_vfs_close_view(&view);
+        if (ok) return true;
+        ecs_log(1, "[text] stale cooked atlas %s", cookedPath);
     }
 
-    transitionImageLayout(commandBuffer, text_ctx->textFontImage, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    char cachePath[256];
+    TextFontCachePath(sourceHash, cachePath, sizeof(cachePath));
+    if (flecs_vfs_exists(cachePath) && flecs_vfs_open_view(cachePath, &view)) {
+        bool ok = TextParseFontAtlas(view.data, view.size, sourceHash, result);
+        flecs_vfs_close_view(&view);
+        if (ok) return true;
+        ecs_log(1, "[text] stale atlas cache %s", cachePath);
+    }
 
-    VkBufferImageCopy region = {0};
-    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    region.imageSubresource.layerCount = 1;
-    region.imageExtent.width = textAtlasWidth;
-    region.imageExtent.height = textAtlasHeight;
-    region.imageExtent.depth = 1;
-    vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, text_ctx->textFontImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+    Uint64 start = SDL_GetTicks();
+    if (!TextBakeFontMemory(result->data, result->size, TEXT_FONT_MODE, result)) return false;
+    ecs_log(1, "[text] baked %s in %llu ms", path, (unsigned long long)(SDL_GetTicks() - start));
 
-    transitionImageLayout(commandBuffer, text_ctx->textFontImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    // cache miss is not an error, next launch just bakes again
+    size_t blobSize = 0;
+    void *blob = flecs_text_atlas_serialize(result, &blobSize);
+    SDL_CreateDirectory(TEXT_ATLAS_CACHE_DIR);
+    if (!blob || !flecs_write_file_atomic(cachePath, blob, blobSize)) {
+        ecs_log(1, "[text] failed to write %s", cachePath);
+    }
+    free(blob);
+    return true;
+}
 
-    if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
-        ecs_err("Failed to end one-time command buffer");
-        vkFreeCommandBuffers(v_ctx->device, v_ctx->commandPool, 1, &commandBuffer);
-        v_ctx->hasError = true;
-        v_ctx->errorMessage = "Command buffer end failed";
-        return;
+// main thread, called from AssetJobDrainSystem once the atlas is rasterized.
+// The font file goes to the glyph cache (FreeType face for everything not
+// baked), the baked ASCII glyphs are copied in as they are.
+static bool TextUploadFontAtlas(ecs_world_t *world, ecs_entity_t asset, AssetResult *result) {
+    Text2DContext *text_ctx = ecs_singleton_ensure(world, Text2DContext);
+    if (!text_ctx || !text_ctx->textGlyphCache) return false;
+
+    // hot reload replaces the face and drops the font's cached glyphs
+    TextBakedGlyphs *baked = result->userData;
+    int font = flecs_glyph_cache_set_font(text_ctx->textGlyphCache, text_ctx->textFont, baked->mode, result->data, result->size);
+    if (font < 0) return false;
+    result->data = NULL;
+    text_ctx->textFont = font;
+    text_ctx->textLayoutEpoch++; // new metrics, every retained layout is stale
+
+    flecs_mem_free(MEMORY_TAG_TEXT, text_ctx->textKerning);
+    text_ctx->textKerning = NULL;
+    if (baked->kerningCount && (text_ctx->textKerning = flecs_mem_alloc(MEMORY_TAG_TEXT, sizeof(baked->kerning)))) {
+        memcpy(text_ctx->textKerning, baked->kerning, sizeof(baked->kerning));
+        text_ctx->textKerningPixelSize = baked->pixelSize;
     }
 
-    VkSubmitInfo submitInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &commandBuffer;
-    if (vkQueueSubmit(v_ctx->graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
-        ecs_err("Failed to submit one-time command buffer");
-        v_ctx->hasError = true;
-        v_ctx->errorMessage = "Command buffer submit failed";
-    }
-    vkQueueWaitIdle(v_ctx->graphicsQueue);
-
-    vkFreeCommandBuffers(v_ctx->device, v_ctx->commandPool, 1, &commandBuffer);
-    vkFreeMemory(v_ctx->device, stagingMemory, NULL);
-    vkDestroyBuffer(v_ctx->device, stagingBuffer, NULL);
-
-    VkImageViewCreateInfo viewInfo = {VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
-    viewInfo.image = text_ctx->textFontImage;
-    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-    viewInfo.format = VK_FORMAT_R8_UNORM;
-    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    viewInfo.subresourceRange.levelCount = 1;
-    viewInfo.subresourceRange.layerCount = 1;
-    if (vkCreateImageView(v_ctx->device, &viewInfo, NULL, &text_ctx->textFontImageView) != VK_SUCCESS) {
-        ecs_err("Failed to create font image view");
-        v_ctx->hasError = true;
-        v_ctx->errorMessage = "Font image view creation failed";
-    }
-
-    VkSamplerCreateInfo samplerInfo = {VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO};
-    samplerInfo.magFilter = VK_FILTER_LINEAR;
-    samplerInfo.minFilter = VK_FILTER_LINEAR;
-    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
-    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-    if (vkCreateSampler(v_ctx->device, &samplerInfo, NULL, &text_ctx->textFontSampler) != VK_SUCCESS) {
-        ecs_err("Failed to create font sampler");
-        v_ctx->hasError = true;
-        v_ctx->errorMessage = "Font sampler creation failed";
+    for (int i = 0; i < 95; i++) {
+        GlyphInfo *g = &baked->glyphs[i];
+        int x = (int)(g->u0 * result->width + 0.5f);
+        int y = (int)(g->v0 * result->height + 0.5f);
+        // clipped by the atlas edge, FreeType renders it on first use instead
+        if (x + g->width > result->width || y + g->height > result->height) continue;
+        GlyphCacheGlyph metrics = {
+            .width = (uint16_t)g->width,
+            .height = (uint16_t)g->height,
+            .bearingX = (int16_t)g->bearingX,
+            .bearingY = (int16_t)g->bearingY,
+            .advanceX = (float)g->advanceX
+        };
+        flecs_glyph_cache_insert(text_ctx->textGlyphCache, font, baked->pixelSize, (uint32_t)(32 + i),
+                                 result->pixels + (size_t)y * result->width + x, result->width, &metrics);
     }
+    return true;
+}
 
-    free(atlasData);
-    FT_Done_Face(face);
-    FT_Done_FreeType(ft);
+// Instance buffer for capacity glyphs. The old one may still be read by the
+// frame in flight, it goes through the deferred destroy list.
+static bool TextReserveVertices(VulkanContext *v_ctx, Text2DContext *text_ctx, uint32_t glyphs) {
+    if (glyphs <= text_ctx->textVertexCapacity) return true;
+    uint32_t capacity = text_ctx->textVertexCapacity ? text_ctx->textVertexCapacity : TEXT_INITIAL_GLYPHS;
+    while (capacity < glyphs) capacity *= 2;
+
+    if (text_ctx->textVertexBuffer) {
+        flecs_vulkan_defer_destroy(v_ctx, VK_OBJECT_TYPE_BUFFER, (uint64_t)text_ctx->textVertexBuffer);
+        flecs_vulkan_defer_destroy(v_ctx, VK_OBJECT_TYPE_DEVICE_MEMORY, (uint64_t)text_ctx->textVertexBufferMemory);
+    }
+    text_ctx->textVertexBuffer = VK_NULL_HANDLE;
+    text_ctx->textVertexBufferMemory = VK_NULL_HANDLE;
+    text_ctx->textVertexMapped = NULL;
+    text_ctx->textVertexCapacity = 0;
+
+    // glyph records rewritten through the mapping when a layout changes
+    createBuffer(v_ctx, (VkDeviceSize)capacity * sizeof(TextGlyph), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &text_ctx->textVertexBuffer, &text_ctx->textVertexBufferMemory);
+    if (v_ctx->hasError ||
+        vkMapMemory(v_ctx->device, text_ctx->textVertexBufferMemory, 0, VK_WHOLE_SIZE, 0, &text_ctx->textVertexMapped) != VK_SUCCESS) {
+        ecs_err("[text] failed to grow glyph buffer to %u glyphs", capacity);
+        text_ctx->textVertexMapped = NULL;
+        return false;
+    }
+    text_ctx->textVertexCapacity = capacity;
+    ecs_dbg("[text] glyph buffer holds %u glyphs", capacity);
+    return true;
 }
 
 void TextSetupSystem(ecs_iter_t *it) {
@@ -321,12 +410,12 @@ void TextSetupSystem(ecs_iter_t *it) {
 
     ecs_log(1, "TextSetupSystem starting...");
 
-    // Create text-specific descriptor pool
+    // Create text-specific descriptor pool, one set per glyph cache page
     VkDescriptorPoolSize poolSizes[] = {
-        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1}
+        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, GLYPH_MAX_PAGES}
     };
     VkDescriptorPoolCreateInfo poolInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
-    poolInfo.maxSets = 1;
+    poolInfo.maxSets = GLYPH_MAX_PAGES;
     poolInfo.poolSizeCount = 1;
     poolInfo.pPoolSizes = poolSizes;
     if (vkCreateDescriptorPool(v_ctx->device, &poolInfo, NULL, &text_ctx->textDescriptorPool) != VK_SUCCESS) {
@@ -353,49 +442,40 @@ void TextSetupSystem(ecs_iter_t *it) {
         ecs_abort(ECS_INTERNAL_ERROR, sdl_ctx->errorMessage);
     }
 
-    // Allocate descriptor set
-    VkDescriptorSetAllocateInfo allocInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
-    allocInfo.descriptorPool = text_ctx->textDescriptorPool;
-    allocInfo.descriptorSetCount = 1;
-    allocInfo.pSetLayouts = &text_ctx->textDescriptorSetLayout;
-    if (vkAllocateDescriptorSets(v_ctx->device, &allocInfo, &text_ctx->textDescriptorSet) != VK_SUCCESS) {
-        ecs_err("Failed to allocate text descriptor set");
+    // Glyph pages allocate their descriptor sets from the pool on demand
+    text_ctx->textGlyphCache = flecs_glyph_cache_create(v_ctx, text_ctx->textDescriptorPool, text_ctx->textDescriptorSetLayout);
+    if (!text_ctx->textGlyphCache) {
         sdl_ctx->hasError = true;
-        sdl_ctx->errorMessage = "Failed to allocate text descriptor set";
+        sdl_ctx->errorMessage = "Failed to create glyph cache";
         ecs_abort(ECS_INTERNAL_ERROR, sdl_ctx->errorMessage);
     }
 
-    // Create font atlas
-    createFontAtlas(v_ctx, text_ctx);
-    if (text_ctx->textFontImageView == VK_NULL_HANDLE || text_ctx->textFontSampler == VK_NULL_HANDLE) {
-        ecs_err("Font atlas creation failed: ImageView=%p, Sampler=%p", (void*)text_ctx->textFontImageView, (void*)text_ctx->textFontSampler);
+    // Font file + baked ASCII atlas, read on an asset worker and handed to the
+    // glyph cache in TextUploadFontAtlas
+    text_ctx->textFontAsset = flecs_asset_acquire(it->world, ecs_id(Text2DContext), &(AssetLoadDesc){
+        .path = "assets/fonts/Kenney Mini.ttf",
+        .type = ASSET_TYPE_FONT,
+        .decode = TextDecodeFontAtlas,
+        .upload = TextUploadFontAtlas
+    });
+
+    // Glyph instance buffer, grown by TextLayoutSystem when a frame has more glyphs
+    if (!TextReserveVertices(v_ctx, text_ctx, TEXT_INITIAL_GLYPHS)) {
         sdl_ctx->hasError = true;
-        sdl_ctx->errorMessage = "Font atlas creation failed";
+        sdl_ctx->errorMessage = "Failed to create text buffers";
         ecs_abort(ECS_INTERNAL_ERROR, sdl_ctx->errorMessage);
     }
 
-    // Update descriptor set
-    VkDescriptorImageInfo imageInfo = {0};
-    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    imageInfo.imageView = text_ctx->textFontImageView;
-    imageInfo.sampler = text_ctx->textFontSampler;
-
-    VkWriteDescriptorSet descriptorWrite = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
-    descriptorWrite.dstSet = text_ctx->textDescriptorSet;
-    descriptorWrite.dstBinding = 0;
-    descriptorWrite.descriptorCount = 1;
-    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    descriptorWrite.pImageInfo = &imageInfo;
-
-    vkUpdateDescriptorSets(v_ctx->device, 1, &descriptorWrite, 0, NULL);
-
-    // Create buffers
-    if (!text_ctx->textVertexBuffer) {
-        createBuffer(v_ctx, 44 * sizeof(TextVertex), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &text_ctx->textVertexBuffer, &text_ctx->textVertexBufferMemory);
-    }
-    if (!text_ctx->textIndexBuffer) {
-        createBuffer(v_ctx, 66 * sizeof(uint32_t), VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &text_ctx->textIndexBuffer, &text_ctx->textIndexBufferMemory);
-    }
+    // the old single "Hello World", now a Text entity like any other
+    ecs_entity_t hello = ecs_new(it->world);
+    ecs_set(it->world, hello, Text, {
+        .value = "Hello World",
+        .x = sdl_ctx->width / 2.0f,
+        .y = sdl_ctx->height / 2.0f,
+        .size = TEXT_BAKED_PIXEL_SIZE,
+        .color = 0xFFFFFFFFu,
+        .align = TEXT_ALIGN_CENTER
+    });
 
     // Shader and pipeline setup
     // VkShaderModule vertShaderModule = createShaderModule(v_ctx->device, text_vert_spv, sizeof(text_vert_spv));
@@ -423,29 +503,27 @@ void TextSetupSystem(ecs_iter_t *it) {
 
     VkPipelineShaderStageCreateInfo shaderStages[] = {vertStageInfo, fragStageInfo};
 
+    // per instance, no index buffer: 4 strip vertices per glyph
     VkVertexInputBindingDescription bindingDesc = {0};
     bindingDesc.binding = 0;
-    bindingDesc.stride = sizeof(TextVertex);
-    bindingDesc.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-
-    VkVertexInputAttributeDescription attributeDescs[2] = {0};
-    attributeDescs[0].binding = 0;
-    attributeDescs[0].location = 0;
-    attributeDescs[0].format = VK_FORMAT_R32G32_SFLOAT;
-    attributeDescs[0].offset = offsetof(TextVertex, pos);
-    attributeDescs[1].binding = 0;
-    attributeDescs[1].location = 1;
-    attributeDescs[1].format = VK_FORMAT_R32G32_SFLOAT;
-    attributeDescs[1].offset = offsetof(TextVertex, uv);
+    bindingDesc.stride = sizeof(TextGlyph);
+    bindingDesc.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+
+    VkVertexInputAttributeDescription attributeDescs[4] = {
+        {0, 0, VK_FORMAT_R16G16_SINT, offsetof(TextGlyph, pos)},
+        {1, 0, VK_FORMAT_R16G16_UINT, offsetof(TextGlyph, size)},
+        {2, 0, VK_FORMAT_R16G16B16A16_UINT, offsetof(TextGlyph, rect)},
+        {3, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(TextGlyph, color)}
+    };
 
     VkPipelineVertexInputStateCreateInfo vertexInputInfo = {VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO};
     vertexInputInfo.vertexBindingDescriptionCount = 1;
     vertexInputInfo.pVertexBindingDescriptions = &bindingDesc;
-    vertexInputInfo.vertexAttributeDescriptionCount = 2;
+    vertexInputInfo.vertexAttributeDescriptionCount = 4;
     vertexInputInfo.pVertexAttributeDescriptions = attributeDescs;
 
     VkPipelineInputAssemblyStateCreateInfo inputAssembly = {VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO};
-    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP;
     inputAssembly.primitiveRestartEnable = VK_FALSE;
 
     VkViewport viewport = {0.0f, 0.0f, (float)sdl_ctx->width, (float)sdl_ctx->height, 0.0f, 1.0f};
@@ -482,9 +560,17 @@ void TextSetupSystem(ecs_iter_t *it) {
     colorBlending.attachmentCount = 1;
     colorBlending.pAttachments = &colorBlendAttachment;
 
+    // outline / shadow parameters pushed per draw, screen scale behind them
+    VkPushConstantRange pushConstantRanges[2] = {
+        {VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(TextStyle)},
+        {VK_SHADER_STAGE_VERTEX_BIT, TEXT_VIEW_OFFSET, sizeof(TextView)}
+    };
+
     VkPipelineLayoutCreateInfo pipelineLayoutInfo = {VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO};
     pipelineLayoutInfo.setLayoutCount = 1;
     pipelineLayoutInfo.pSetLayouts = &text_ctx->textDescriptorSetLayout;
+    pipelineLayoutInfo.pushConstantRangeCount = 2;
+    pipelineLayoutInfo.pPushConstantRanges = pushConstantRanges;
     if (vkCreatePipelineLayout(v_ctx->device, &pipelineLayoutInfo, NULL, &text_ctx->textPipelineLayout) != VK_SUCCESS) {
         ecs_err("Failed to create text pipeline layout");
         sdl_ctx->hasError = true;
@@ -518,78 +604,361 @@ void TextSetupSystem(ecs_iter_t *it) {
     ecs_log(1, "TextSetupSystem completed");
 }
 
-void TextRenderSystem(ecs_iter_t *it) {
-    SDLContext *sdl_ctx = ecs_singleton_ensure(it->world, SDLContext);
-    if (!sdl_ctx || sdl_ctx->hasError || sdl_ctx->isShutDown) return;
-    VulkanContext *v_ctx = ecs_singleton_ensure(it->world, VulkanContext);
-    if (!v_ctx) return;
-    Text2DContext *text_ctx = ecs_singleton_ensure(it->world, Text2DContext);
-    if (!text_ctx || !text_ctx->textGlyphs) return;
+typedef struct {
+    uint32_t page;
+    TextGlyph glyph;
+} TextQuad;
 
-    const char *text = "Hello World";
-    size_t textLen = strlen(text);
-    TextVertex vertices[44];
-    uint32_t indices[66];
-    int vertexCount = 0, indexCount = 0;
+// Retained layout of one Text entity, in Text2DContext.textLayouts. The
+// glyphs are grouped by page so a frame only copies ranges.
+typedef struct {
+    Text text;                             // what was laid out
+    uint32_t epoch;                        // Text2DContext.textLayoutEpoch at layout
+    bool incomplete;                       // a glyph could not be placed, lay out again
+    TextGlyph *glyphs;                     // one instance record per visible glyph
+    uint32_t capacity;
+    uint32_t first[GLYPH_MAX_PAGES];       // glyph range per page
+    uint32_t count[GLYPH_MAX_PAGES];
+    uint32_t generation[GLYPH_MAX_PAGES];  // page generation the uvs belong to
+} TextLayoutEntry;
+
+// layout scratch before the page sort (main thread), and this frame's
+// entries in the frame arena
+static TextQuad *textQuads;
+static uint32_t textQuadCapacity;
+static TextLayoutEntry **textEntries;
+static uint32_t textEntryCapacity;
+
+static bool TextReserveQuads(uint32_t count) {
+    if (count <= textQuadCapacity) return true;
+    uint32_t capacity = textQuadCapacity ? textQuadCapacity : TEXT_INITIAL_GLYPHS;
+    while (capacity < count) capacity *= 2;
+    TextQuad *grown = flecs_mem_realloc(MEMORY_TAG_TEXT, textQuads, sizeof(TextQuad) * capacity);
+    if (!grown) return false;
+    textQuads = grown;
+    textQuadCapacity = capacity;
+    return true;
+}
+
+static int16_t TextFixed(float pixels) {
+    float v = pixels * 8.0f + (pixels < 0.0f ? -0.5f : 0.5f);
+    return (int16_t)(v < INT16_MIN ? INT16_MIN : v > INT16_MAX ? INT16_MAX : v);
+}
+
+// baked pair adjustments of the module font, ASCII only
+typedef struct {
+    const int16_t *pairs;  // Text2DContext.textKerning, NULL = none
+    float scale;           // 1/64 pixels at the baked size -> pixels at this size
+} TextKerning;
 
-    GlyphInfo *textGlyphs = text_ctx->textGlyphs;
-    float totalWidth = 0.0f;
-    for (size_t i = 0; i < textLen; i++) {
-        if (text[i] < 32 || text[i] > 126) continue;
-        int glyphIdx = text[i] - 32;
-        totalWidth += textGlyphs[glyphIdx].advanceX;
+static float TextKern(const TextKerning *kerning, uint32_t left, uint32_t right) {
+    if (!kerning->pairs || left - 32 >= 95 || right - 32 >= 95) return 0.0f;
+    return kerning->pairs[(left - 32) * 95 + (right - 32)] * kerning->scale;
+}
+
+// one line of UTF-8 at pixel position (x, baseline), stops after '\n'.
+// Glyphs come from the cache, quads must have room for every byte.
+static uint32_t TextLayoutLine(GlyphCache *cache, const TextKerning *kerning, int font, uint32_t pixelSize, uint32_t color, const char **text,
+                               float x, float y, TextQuad *quads, uint32_t quadCount, bool *incomplete) {
+    GlyphCacheGlyph glyph;
+    uint32_t previous = 0;
+    while (**text) {
+        uint32_t codepoint = flecs_utf8_next(text);
+        if (codepoint == '\n') break;
+        x += TextKern(kerning, previous, codepoint);
+        previous = codepoint;
+        // not placeable this frame (staging full), the line keeps its spacing
+        if (!flecs_glyph_cache_get(cache, font, pixelSize, codepoint, &glyph)) {
+            x += pixelSize * 0.5f;
+            *incomplete = true;
+            continue;
+        }
+        // SDF glyphs are stored at one size, scale 1 for coverage glyphs
+        float s = glyph.scale;
+        if (glyph.width) {
+            float w = glyph.width * s * 8.0f + 0.5f;
+            float h = glyph.height * s * 8.0f + 0.5f;
+            TextQuad *q = &quads[quadCount++];
+            q->page = glyph.page;
+            q->glyph = (TextGlyph){
+                {TextFixed(x + glyph.bearingX * s), TextFixed(y - glyph.bearingY * s)},
+                {(uint16_t)(w > UINT16_MAX ? UINT16_MAX : w), (uint16_t)(h > UINT16_MAX ? UINT16_MAX : h)},
+                {glyph.x, glyph.y, glyph.width, glyph.height},
+                color
+            };
+        }
+        x += glyph.advanceX * s;
+    }
+    return quadCount;
+}
+
+// width of the line starting at text, up to '\n'
+static float TextMeasureLine(GlyphCache *cache, const TextKerning *kerning, int font, uint32_t pixelSize, const char *text, bool *incomplete) {
+    GlyphCacheGlyph glyph;
+    float width = 0.0f;
+    uint32_t previous = 0;
+    while (*text) {
+        uint32_t codepoint = flecs_utf8_next(&text);
+        if (codepoint == '\n') break;
+        width += TextKern(kerning, previous, codepoint);
+        previous = codepoint;
+        if (flecs_glyph_cache_get(cache, font, pixelSize, codepoint, &glyph)) {
+            width += glyph.advanceX * glyph.scale;
+        } else {
+            width += pixelSize * 0.5f;
+            *incomplete = true;
+        }
     }
+    return width;
+}
 
+static uint32_t TextLayoutEntity(const Text2DContext *text_ctx, const Text *text, float screenWidth, float screenHeight, bool *incomplete) {
+    uint32_t pixelSize = (uint32_t)(text->size + 0.5f);
+    if (!pixelSize || !(text->color >> 24) || !text->value[0]) return 0;
+    // below or right of the screen, nothing to lay out
+    if (text->y - text->size > screenHeight) return 0;
+    if (text->align == TEXT_ALIGN_LEFT && text->x > screenWidth) return 0;
+
+    GlyphCache *cache = text_ctx->textGlyphCache;
+    TextKerning kerning = {0};
+    if (text->font == text_ctx->textFont && text_ctx->textKerning) {
+        kerning.pairs = text_ctx->textKerning;
+        kerning.scale = (float)pixelSize / (text_ctx->textKerningPixelSize * 64.0f);
+    }
+
+    uint32_t quadCount = 0;
+    const char *line = text->value;
+    float y = text->y;
+    while (*line) {
+        float x = text->x;
+        if (text->align != TEXT_ALIGN_LEFT) {
+            float width = TextMeasureLine(cache, &kerning, text->font, pixelSize, line, incomplete);
+            x -= text->align == TEXT_ALIGN_CENTER ? width / 2.0f : width;
+        }
+        quadCount = TextLayoutLine(cache, &kerning, text->font, pixelSize, text->color, &line, x, y,
+                                   textQuads, quadCount, incomplete);
+        y += text->size * TEXT_LINE_HEIGHT;
+    }
+    return quadCount;
+}
+
+static TextLayoutEntry *TextLayoutFind(Text2DContext *text_ctx, ecs_entity_t entity) {
+    ecs_map_val_t *found = ecs_map_get(&text_ctx->textLayouts, entity);
+    if (found) return (TextLayoutEntry *)(uintptr_t)*found;
+    TextLayoutEntry *entry = flecs_mem_calloc(MEMORY_TAG_TEXT, 1, sizeof(TextLayoutEntry));
+    if (!entry) return NULL;
+    entry->incomplete = true; // never laid out
+    ecs_map_insert(&text_ctx->textLayouts, entity, (ecs_map_val_t)(uintptr_t)entry);
+    return entry;
+}
+
+// the retained glyphs still match the component, the font, the screen and
+// the glyph pages. Only tables flecs reports as changed are compared.
+static bool TextLayoutValid(const TextLayoutEntry *entry, const Text *text, const GlyphCache *cache, uint32_t epoch, bool changed) {
+    if (entry->incomplete || entry->epoch != epoch) return false;
+    if (changed && memcmp(&entry->text, text, sizeof(Text)) != 0) return false;
+    for (uint32_t page = 0; page < GLYPH_MAX_PAGES; page++) {
+        if (entry->count[page] && entry->generation[page] != flecs_glyph_cache_page_generation(cache, page)) return false;
+    }
+    return true;
+}
+
+static void TextLayoutBuild(const Text2DContext *text_ctx, TextLayoutEntry *entry, const Text *text, float screenWidth, float screenHeight, uint32_t epoch) {
+    GlyphCache *cache = text_ctx->textGlyphCache;
+    entry->text = *text;
+    entry->epoch = epoch;
+    entry->incomplete = false;
+    memset(entry->count, 0, sizeof(entry->count));
+
+    // at most one quad per byte
+    uint32_t length = (uint32_t)strlen(text->value);
+    if (!TextReserveQuads(length)) {
+        entry->incomplete = true;
+        return;
+    }
+    uint32_t quadCount = TextLayoutEntity(text_ctx, text, screenWidth, screenHeight, &entry->incomplete);
+    if (quadCount > entry->capacity) {
+        TextGlyph *grown = flecs_mem_realloc(MEMORY_TAG_TEXT, entry->glyphs, sizeof(TextGlyph) * quadCount);
+        if (!grown) {
+            entry->incomplete = true;
+            return;
+        }
+        entry->glyphs = grown;
+        entry->capacity = quadCount;
+    }
+
+    // counting sort by page, one range per page
+    for (uint32_t i = 0; i < quadCount; i++) entry->count[textQuads[i].page]++;
+    uint32_t next[GLYPH_MAX_PAGES];
+    uint32_t offset = 0;
+    for (uint32_t page = 0; page < GLYPH_MAX_PAGES; page++) {
+        entry->first[page] = next[page] = offset;
+        entry->generation[page] = flecs_glyph_cache_page_generation(cache, page);
+        offset += entry->count[page];
+    }
+    for (uint32_t i = 0; i < quadCount; i++) {
+        entry->glyphs[next[textQuads[i].page]++] = textQuads[i].glyph;
+    }
+}
+
+static void TextLayoutFree(Text2DContext *text_ctx, ecs_entity_t entity) {
+    ecs_map_val_t *found = ecs_map_get(&text_ctx->textLayouts, entity);
+    if (!found) return;
+    TextLayoutEntry *entry = (TextLayoutEntry *)(uintptr_t)*found;
+    ecs_map_remove(&text_ctx->textLayouts, entity);
+    flecs_mem_free(MEMORY_TAG_TEXT, entry->glyphs);
+    flecs_mem_free(MEMORY_TAG_TEXT, entry);
+}
+
+static void TextRemove(ecs_iter_t *it) {
+    Text2DContext *text_ctx = ecs_get_mut(it->world, ecs_id(Text2DContext), Text2DContext);
+    if (!text_ctx || !text_ctx->textLayoutsReady) return;
+    for (int i = 0; i < it->count; i++) TextLayoutFree(text_ctx, it->entities[i]);
+}
+
+// BeginRenderPhase, after the frame fence: bring the retained layouts of the
+// Text entities up to date, copy their page ranges into the mapped vertex
+// buffer (one draw per page) and submit the new glyphs ahead of the frame.
+// A frame where no Text changed keeps last frame's buffer and draws.
+void TextLayoutSystem(ecs_iter_t *it) {
+    SDLContext *sdl_ctx = ecs_field(it, SDLContext, 0);
+    if (!sdl_ctx || sdl_ctx->hasError || sdl_ctx->isShutDown) return;
+    VulkanContext *v_ctx = ecs_field(it, VulkanContext, 1);
+    if (!v_ctx || v_ctx->skipRender) return;
+    Text2DContext *text_ctx = ecs_field(it, Text2DContext, 2);
+    if (!text_ctx || !text_ctx->textGlyphCache || text_ctx->textFont < 0 || !text_ctx->textQuery) return;
+
+    GlyphCache *cache = text_ctx->textGlyphCache;
+    flecs_glyph_cache_begin_frame(cache);
+
+    // layouts are culled against the screen, a resize redoes them
     float screenWidth = (float)sdl_ctx->width;
     float screenHeight = (float)sdl_ctx->height;
-    float x = (screenWidth - totalWidth) / 2.0f;
-    float y = screenHeight / 2.0f;
-    float ndcX = (2.0f * x / screenWidth) - 1.0f;
-    float ndcY = 1.0f - (2.0f * y / screenHeight);
+    if (screenWidth != text_ctx->textScreenWidth || screenHeight != text_ctx->textScreenHeight) {
+        text_ctx->textScreenWidth = screenWidth;
+        text_ctx->textScreenHeight = screenHeight;
+        text_ctx->textLayoutEpoch++;
+    }
+    uint32_t epoch = text_ctx->textLayoutEpoch;
 
-    for (size_t i = 0; i < textLen; i++) {
-        char c = text[i];
-        if (c < 32 || c > 126) continue;
+    if (text_ctx->textDrawnEpoch == epoch && !text_ctx->textIncomplete && !ecs_query_changed(text_ctx->textQuery)) {
+        for (uint32_t i = 0; i < text_ctx->textDrawCount; i++) {
+            flecs_glyph_cache_touch_page(cache, text_ctx->textDraws[i].page);
+        }
+        return;
+    }
 
-        int glyphIdx = c - 32;
-        float x0 = ndcX + (2.0f * textGlyphs[glyphIdx].bearingX / screenWidth);
-        float y0 = ndcY - (2.0f * textGlyphs[glyphIdx].bearingY / screenHeight);
-        float x1 = x0 + (2.0f * textGlyphs[glyphIdx].width / screenWidth);
-        float y1 = y0 + (2.0f * textGlyphs[glyphIdx].height / screenHeight);
+    text_ctx->textDrawCount = 0;
+    bool incomplete = false;
+    uint32_t entryCount = 0;
+    uint32_t pageTotal[GLYPH_MAX_PAGES] = {0};
+    textEntries = NULL;
+    textEntryCapacity = 0;
+    ecs_iter_t qit = ecs_query_iter(it->world, text_ctx->textQuery);
+    while (ecs_query_next(&qit)) {
+        const Text *texts = ecs_field(&qit, Text, 0);
+        bool changed = ecs_iter_changed(&qit);
+        for (int i = 0; i < qit.count; i++) {
+            if (entryCount == textEntryCapacity) {
+                uint32_t capacity = textEntryCapacity ? textEntryCapacity * 2 : 256;
+                TextLayoutEntry **grown = flecs_frame_realloc(textEntries, sizeof(TextLayoutEntry *) * textEntryCapacity, sizeof(TextLayoutEntry *) * capacity);
+                if (!grown) break;
+                textEntries = grown;
+                textEntryCapacity = capacity;
+            }
+            TextLayoutEntry *entry = TextLayoutFind(text_ctx, qit.entities[i]);
+            if (!entry) continue;
+            if (!TextLayoutValid(entry, &texts[i], cache, epoch, changed)) {
+                TextLayoutBuild(text_ctx, entry, &texts[i], screenWidth, screenHeight, epoch);
+            } else {
+                for (uint32_t page = 0; page < GLYPH_MAX_PAGES; page++) {
+                    if (entry->count[page]) flecs_glyph_cache_touch_page(cache, page);
+                }
+            }
+            incomplete = incomplete || entry->incomplete;
+            for (uint32_t page = 0; page < GLYPH_MAX_PAGES; page++) pageTotal[page] += entry->count[page];
+            textEntries[entryCount++] = entry;
+        }
+    }
 
-        vertices[vertexCount + 0] = (TextVertex){{x0, y0}, {textGlyphs[glyphIdx].u0, textGlyphs[glyphIdx].v0}};
-        vertices[vertexCount + 1] = (TextVertex){{x1, y0}, {textGlyphs[glyphIdx].u1, textGlyphs[glyphIdx].v0}};
-        vertices[vertexCount + 2] = (TextVertex){{x1, y1}, {textGlyphs[glyphIdx].u1, textGlyphs[glyphIdx].v1}};
-        vertices[vertexCount + 3] = (TextVertex){{x0, y1}, {textGlyphs[glyphIdx].u0, textGlyphs[glyphIdx].v1}};
+    uint32_t quadCount = 0;
+    for (uint32_t page = 0; page < GLYPH_MAX_PAGES; page++) quadCount += pageTotal[page];
+    if (quadCount && TextReserveVertices(v_ctx, text_ctx, quadCount)) {
+        uint32_t next[GLYPH_MAX_PAGES];
+        uint32_t offset = 0;
+        for (uint32_t page = 0; page < GLYPH_MAX_PAGES; page++) {
+            next[page] = offset;
+            if (pageTotal[page]) text_ctx->textDraws[text_ctx->textDrawCount++] = (TextDraw){page, offset, pageTotal[page]};
+            offset += pageTotal[page];
+        }
+        // one memcpy per entity and page
+        TextGlyph *glyphs = text_ctx->textVertexMapped;
+        for (uint32_t e = 0; e < entryCount; e++) {
+            TextLayoutEntry *entry = textEntries[e];
+            for (uint32_t page = 0; page < GLYPH_MAX_PAGES; page++) {
+                if (!entry->count[page]) continue;
+                memcpy(&glyphs[next[page]], &entry->glyphs[entry->first[page]], sizeof(TextGlyph) * entry->count[page]);
+                next[page] += entry->count[page];
+            }
+        }
+    }
+    text_ctx->textDrawnEpoch = epoch;
+    text_ctx->textIncomplete = incomplete;
 
-        indices[indexCount + 0] = vertexCount + 0;
-        indices[indexCount + 1] = vertexCount + 1;
-        indices[indexCount + 2] = vertexCount + 2;
-        indices[indexCount + 3] = vertexCount + 2;
-        indices[indexCount + 4] = vertexCount + 3;
-        indices[indexCount + 5] = vertexCount + 0;
+    flecs_glyph_cache_flush(cache, v_ctx);
+}
 
-        ndcX += (2.0f * textGlyphs[glyphIdx].advanceX / screenWidth);
-        vertexCount += 4;
-        indexCount += 6;
+void flecs_text_set_value(ecs_world_t *world, ecs_entity_t entity, const char *value) {
+    Text *text = ecs_ensure(world, entity, Text);
+    if (!text) return;
+    size_t length = strlen(value);
+    if (length >= TEXT_MAX_LENGTH) {
+        length = TEXT_MAX_LENGTH - 1;
+        // never cut a multi-byte sequence in half
+        while (length && ((uint8_t)value[length] & 0xC0) == 0x80) length--;
     }
+    memcpy(text->value, value, length);
+    text->value[length] = '\0';
+    ecs_modified(world, entity, Text);
+}
 
-    updateBuffer(v_ctx, text_ctx->textVertexBufferMemory, vertexCount * sizeof(TextVertex), vertices);
-    updateBuffer(v_ctx, text_ctx->textIndexBufferMemory, indexCount * sizeof(uint32_t), indices);
+void TextRenderSystem(ecs_iter_t *it) {
+    SDLContext *sdl_ctx = ecs_field(it, SDLContext, 0);
+    if (!sdl_ctx || sdl_ctx->hasError || sdl_ctx->isShutDown) return;
+    VulkanContext *v_ctx = ecs_field(it, VulkanContext, 1);
+    if (!v_ctx || v_ctx->skipRender) return;
+    Text2DContext *text_ctx = ecs_field(it, Text2DContext, 2);
+    if (!text_ctx || !text_ctx->textDrawCount) return;
 
     vkCmdBindPipeline(v_ctx->commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, text_ctx->textPipeline);
     VkDeviceSize offsets[] = {0};
     vkCmdBindVertexBuffers(v_ctx->commandBuffer, 0, 1, &text_ctx->textVertexBuffer, offsets);
-    vkCmdBindIndexBuffer(v_ctx->commandBuffer, text_ctx->textIndexBuffer, 0, VK_INDEX_TYPE_UINT32);
-    vkCmdBindDescriptorSets(v_ctx->commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, text_ctx->textPipelineLayout, 0, 1, &text_ctx->textDescriptorSet, 0, NULL);
-    vkCmdDrawIndexed(v_ctx->commandBuffer, indexCount, 1, 0, 0, 0);
+    TextView view = {{2.0f / text_ctx->textScreenWidth, 2.0f / text_ctx->textScreenHeight}};
+    vkCmdPushConstants(v_ctx->commandBuffer, text_ctx->textPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, TEXT_VIEW_OFFSET, sizeof(TextView), &view);
+    // shadow offset to page uv, SDF glyphs are stored at GLYPH_SDF_PIXEL_SIZE
+    // so the offset scales with the drawn size like the outline does
+    TextStyle style = text_ctx->textStyle;
+    float uvScale = (float)GLYPH_SDF_PIXEL_SIZE / (TEXT_BAKED_PIXEL_SIZE * GLYPH_PAGE_SIZE);
+    style.shadowOffset[0] *= uvScale;
+    style.shadowOffset[1] *= uvScale;
+    for (uint32_t i = 0; i < text_ctx->textDrawCount; i++) {
+        TextDraw *draw = &text_ctx->textDraws[i];
+        VkDescriptorSet set = flecs_glyph_cache_page_set(text_ctx->textGlyphCache, draw->page);
+        vkCmdBindDescriptorSets(v_ctx->commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, text_ctx->textPipelineLayout, 0, 1, &set, 0, NULL);
+        style.sdf = flecs_glyph_cache_page_mode(text_ctx->textGlyphCache, draw->page) == GLYPH_MODE_SDF;
+        vkCmdPushConstants(v_ctx->commandBuffer, text_ctx->textPipelineLayout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(TextStyle), &style);
+        vkCmdDraw(v_ctx->commandBuffer, 4, draw->glyphCount, 0, draw->firstGlyph);
+    }
 }
 
+// registry slot, marked cleaned by the cleanup observer
+static ModuleHandle text_module_handle = MODULE_HANDLE_NONE;
+
 void text_cleanup_event_system(ecs_iter_t *it){
   ecs_print(1,"[cleanup] text_cleanup_event_system");
   flecs_text_cleanup(it->world);
 
-  module_break_name(it, "text_module");
+  module_set_state(it->world, text_module_handle, MODULE_STATE_CLEANED);
 
   // ecs_query_t *q = ecs_query(it->world, {
   //   .terms = {
@@ -638,48 +1007,55 @@ void flecs_text_cleanup(ecs_world_t *world) {
       vkDestroyDescriptorPool(v_ctx->device, text_ctx->textDescriptorPool, NULL);
       text_ctx->textDescriptorPool = VK_NULL_HANDLE;
   }
-  if (text_ctx->textFontSampler != VK_NULL_HANDLE) {
-      vkDestroySampler(v_ctx->device, text_ctx->textFontSampler, NULL);
-      text_ctx->textFontSampler = VK_NULL_HANDLE;
-  }
-  if (text_ctx->textFontImageView != VK_NULL_HANDLE) {
-      vkDestroyImageView(v_ctx->device, text_ctx->textFontImageView, NULL);
-      text_ctx->textFontImageView = VK_NULL_HANDLE;
-  }
-  if (text_ctx->textFontImageMemory != VK_NULL_HANDLE) {
-      vkFreeMemory(v_ctx->device, text_ctx->textFontImageMemory, NULL);
-      text_ctx->textFontImageMemory = VK_NULL_HANDLE;
-  }
-  if (text_ctx->textFontImage != VK_NULL_HANDLE) {
-      vkDestroyImage(v_ctx->device, text_ctx->textFontImage, NULL);
-      text_ctx->textFontImage = VK_NULL_HANDLE;
+  if (text_ctx->textGlyphCache) {
+      flecs_glyph_cache_destroy(text_ctx->textGlyphCache, v_ctx);
+      text_ctx->textGlyphCache = NULL;
+      text_ctx->textFont = -1;
   }
   if (text_ctx->textVertexBufferMemory != VK_NULL_HANDLE) {
       vkFreeMemory(v_ctx->device, text_ctx->textVertexBufferMemory, NULL);
       text_ctx->textVertexBufferMemory = VK_NULL_HANDLE;
+      text_ctx->textVertexMapped = NULL;
   }
   if (text_ctx->textVertexBuffer != VK_NULL_HANDLE) {
       vkDestroyBuffer(v_ctx->device, text_ctx->textVertexBuffer, NULL);
       text_ctx->textVertexBuffer = VK_NULL_HANDLE;
   }
-  if (text_ctx->textIndexBufferMemory != VK_NULL_HANDLE) {
-      vkFreeMemory(v_ctx->device, text_ctx->textIndexBufferMemory, NULL);
-      text_ctx->textIndexBufferMemory = VK_NULL_HANDLE;
+  text_ctx->textVertexCapacity = 0;
+  if (text_ctx->textQuery) {
+      ecs_query_fini(text_ctx->textQuery);
+      text_ctx->textQuery = NULL;
   }
-  if (text_ctx->textIndexBuffer != VK_NULL_HANDLE) {
-      vkDestroyBuffer(v_ctx->device, text_ctx->textIndexBuffer, NULL);
-      text_ctx->textIndexBuffer = VK_NULL_HANDLE;
-  }
-  if (text_ctx->textGlyphs) {
-      free(text_ctx->textGlyphs);
-      text_ctx->textGlyphs = NULL;
+  if (text_ctx->textLayoutsReady) {
+      text_ctx->textLayoutsReady = false;
+      ecs_map_iter_t mit = ecs_map_iter(&text_ctx->textLayouts);
+      while (ecs_map_next(&mit)) {
+          TextLayoutEntry *entry = (TextLayoutEntry *)(uintptr_t)ecs_map_value(&mit);
+          flecs_mem_free(MEMORY_TAG_TEXT, entry->glyphs);
+          flecs_mem_free(MEMORY_TAG_TEXT, entry);
+      }
+      ecs_map_fini(&text_ctx->textLayouts);
   }
+  flecs_mem_free(MEMORY_TAG_TEXT, text_ctx->textKerning);
+  text_ctx->textKerning = NULL;
+  flecs_mem_free(MEMORY_TAG_TEXT, textQuads);
+  textQuads = NULL;
+  textQuadCapacity = 0;
+  textEntries = NULL; // frame arena
+  textEntryCapacity = 0;
+  // releasing moves the context to another table, clear the field first
+  ecs_entity_t font = text_ctx->textFontAsset;
+  text_ctx->textFontAsset = 0;
+  flecs_asset_release(world, ecs_id(Text2DContext), font);
 
   ecs_log(1, "Text cleanup completed");
 }
 
 void text2d_register_components(ecs_world_t *world){
   ECS_COMPONENT_DEFINE(world, Text2DContext);
+  ECS_COMPONENT_DEFINE(world, Text);
+
+  ecs_set_hooks(world, Text, { .on_remove = TextRemove });
 }
 
 void text2d_register_systems(ecs_world_t *world){
@@ -699,11 +1075,21 @@ void text2d_register_systems(ecs_world_t *world){
     .callback = TextSetupSystem
   });
 
+  ecs_system_init(world, &(ecs_system_desc_t){
+      .entity = ecs_entity(world, { 
+          .name = "TextLayoutSystem", 
+          .add = ecs_ids(ecs_dependson(GlobalPhases.BeginRenderPhase)) 
+      }),
+      .query.terms = { ECS_SINGLETON_IN(SDLContext), ECS_SINGLETON_INOUT(VulkanContext), ECS_SINGLETON_INOUT(Text2DContext) },
+      .callback = TextLayoutSystem
+  });
+
   ecs_system_init(world, &(ecs_system_desc_t){
       .entity = ecs_entity(world, { 
           .name = "TextRenderSystem", 
           .add = ecs_ids(ecs_dependson(GlobalPhases.CMDBufferPhase)) 
       }),
+      .query.terms = { ECS_SINGLETON_IN(SDLContext), ECS_SINGLETON_IN(VulkanContext), ECS_SINGLETON_IN(Text2DContext) },
       .callback = TextRenderSystem
   });
 }
@@ -713,12 +1099,32 @@ void flecs_text_module_init(ecs_world_t *world) {
 
   text2d_register_components(world);
 
-  ecs_singleton_set(world, Text2DContext, {0});
+  // black outline and a soft drop shadow, down-right
+  ecs_singleton_set(world, Text2DContext, {
+    .textFont = -1,
+    .textQuery = ecs_query(world, {
+      .terms = {{ ecs_id(Text), .inout = EcsIn }},
+      .cache_kind = EcsQueryCacheAuto,
+      .flags = ECS_QUERY_DETECT_CHANGES
+    }),
+    .textStyle = {
+      .outlineColor = {0.0f, 0.0f, 0.0f, 1.0f},
+      .shadowColor = {0.0f, 0.0f, 0.0f, 0.5f},
+      .shadowOffset = {2.0f, 2.0f},
+      .outlineWidth = 0.15f,
+      .shadowSoftness = 0.1f
+    }
+  });
+
+  Text2DContext *text_ctx = ecs_singleton_ensure(world, Text2DContext);
+  ecs_map_init(&text_ctx->textLayouts, NULL);
+  text_ctx->textLayoutsReady = true;
+  ecs_singleton_modified(world, Text2DContext);
 
-  ecs_entity_t e = ecs_new(world);
-  ecs_set(world, e, PluginModule, { .name = "text_module", .isCleanUp = false });
+  text_module_handle = module_register(world, "text_module");
 
   text2d_register_systems(world);
+  module_set_state(world, text_module_handle, MODULE_STATE_READY);
 
   ecs_log(1, "Text module initialized");
 }
\ No newline at end of file
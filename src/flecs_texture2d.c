@@ -7,6 +7,8 @@
 #include "flecs_utils.h" // createShaderModule(v_ctx->device, text_vert_spv)
 #include "flecs_vulkan.h"
 #include "flecs_sdl.h"
+#include "flecs_asset_jobs.h"
+#include "flecs_texture_array.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
@@ -68,134 +70,28 @@ static void updateBuffer(VulkanContext *v_ctx, VkDeviceMemory memory, VkDeviceSi
     vkUnmapMemory(v_ctx->device, memory);
 }
 
-static void createTextureImage(VulkanContext *v_ctx, Texture2DContext *text2d_ctx) {
-    int width, height, channels;
-    unsigned char *imageData = stbi_load("assets/textures/light/texture_08.png", &width, &height, &channels, STBI_rgb_alpha);
-    if (!imageData) {
-        ecs_err("Failed to load texture_08.png: %s", stbi_failure_reason());
-        return;
-    }
+// texture set layer -> descriptor, once TextureSetBuildSystem has the array image
+static void Texture2DBindTextureSet(ecs_world_t *world, VulkanContext *v_ctx, Texture2DContext *text2d_ctx) {
+    const TextureSet *set = ecs_get(world, text2d_ctx->textureSet, TextureSet);
+    if (!set || !set->ready) return;
 
-    VkDeviceSize imageSize = width * height * 4;
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingMemory;
-    createBuffer(v_ctx, imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &stagingBuffer, &stagingMemory);
-    updateBuffer(v_ctx, stagingMemory, imageSize, imageData);
-
-    VkImageCreateInfo imageInfo = {VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
-    imageInfo.imageType = VK_IMAGE_TYPE_2D;
-    imageInfo.format = VK_FORMAT_R8G8B8A8_SRGB;
-    imageInfo.extent.width = width;
-    imageInfo.extent.height = height;
-    imageInfo.extent.depth = 1;
-    imageInfo.mipLevels = 1;
-    imageInfo.arrayLayers = 1;
-    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
-    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-    imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-
-    if (vkCreateImage(v_ctx->device, &imageInfo, NULL, &text2d_ctx->texture2dImage) != VK_SUCCESS) {
-        ecs_err("Failed to create texture image");
-        stbi_image_free(imageData);
-        return;
-    }
+    int layer = flecs_texture_set_find(set, "texture_08.png");
+    text2d_ctx->textureLayer = layer < 0 ? 0 : (uint32_t)layer;
 
-    VkMemoryRequirements memReqs;
-    vkGetImageMemoryRequirements(v_ctx->device, text2d_ctx->texture2dImage, &memReqs);
-    VkMemoryAllocateInfo allocInfo = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
-    allocInfo.allocationSize = memReqs.size;
-    VkPhysicalDeviceMemoryProperties memProps;
-    vkGetPhysicalDeviceMemoryProperties(v_ctx->physicalDevice, &memProps);
-    for (uint32_t i = 0; i < memProps.memoryTypeCount; i++) {
-        if (memReqs.memoryTypeBits & (1 << i) && (memProps.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)) {
-            allocInfo.memoryTypeIndex = i;
-            break;
-        }
-    }
-
-    if (vkAllocateMemory(v_ctx->device, &allocInfo, NULL, &text2d_ctx->texture2dImageMemory) != VK_SUCCESS) {
-        vkDestroyImage(v_ctx->device, text2d_ctx->texture2dImage, NULL);
-        stbi_image_free(imageData);
-        return;
-    }
+    VkDescriptorImageInfo imageInfo = {0};
+    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    imageInfo.imageView = set->view;
+    imageInfo.sampler = set->sampler;
 
-    vkBindImageMemory(v_ctx->device, text2d_ctx->texture2dImage, text2d_ctx->texture2dImageMemory, 0);
-
-    VkCommandBuffer commandBuffer;
-    VkCommandBufferAllocateInfo cmdAllocInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
-    cmdAllocInfo.commandPool = v_ctx->commandPool;
-    cmdAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    cmdAllocInfo.commandBufferCount = 1;
-    vkAllocateCommandBuffers(v_ctx->device, &cmdAllocInfo, &commandBuffer);
-
-    VkCommandBufferBeginInfo beginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
-    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-    vkBeginCommandBuffer(commandBuffer, &beginInfo);
-
-    VkImageMemoryBarrier barrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
-    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.image = text2d_ctx->texture2dImage;
-    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barrier.subresourceRange.levelCount = 1;
-    barrier.subresourceRange.layerCount = 1;
-    barrier.srcAccessMask = 0;
-    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-
-    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, NULL, 0, NULL, 1, &barrier);
-
-    VkBufferImageCopy region = {0};
-    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    region.imageSubresource.layerCount = 1;
-    region.imageExtent.width = width;
-    region.imageExtent.height = height;
-    region.imageExtent.depth = 1;
-    vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, text2d_ctx->texture2dImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-
-    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, NULL, 0, NULL, 1, &barrier);
-
-    vkEndCommandBuffer(commandBuffer);
-
-    VkSubmitInfo submitInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &commandBuffer;
-    vkQueueSubmit(v_ctx->graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-    vkQueueWaitIdle(v_ctx->graphicsQueue);
-
-    vkFreeCommandBuffers(v_ctx->device, v_ctx->commandPool, 1, &commandBuffer);
-    vkFreeMemory(v_ctx->device, stagingMemory, NULL);
-    vkDestroyBuffer(v_ctx->device, stagingBuffer, NULL);
-
-    stbi_image_free(imageData);
-
-    VkImageViewCreateInfo viewInfo = {VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
-    viewInfo.image = text2d_ctx->texture2dImage;
-    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-    viewInfo.format = VK_FORMAT_R8G8B8A8_SRGB;
-    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    viewInfo.subresourceRange.levelCount = 1;
-    viewInfo.subresourceRange.layerCount = 1;
-    if (vkCreateImageView(v_ctx->device, &viewInfo, NULL, &text2d_ctx->texture2dImageView) != VK_SUCCESS) {
-        ecs_err("Failed to create texture image view");
-    }
+    VkWriteDescriptorSet descriptorWrite = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+    descriptorWrite.dstSet = text2d_ctx->texture2dDescriptorSet;
+    descriptorWrite.dstBinding = 0;
+    descriptorWrite.descriptorCount = 1;
+    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    descriptorWrite.pImageInfo = &imageInfo;
 
-    VkSamplerCreateInfo samplerInfo = {VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO};
-    samplerInfo.magFilter = VK_FILTER_LINEAR;
-    samplerInfo.minFilter = VK_FILTER_LINEAR;
-    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
-    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-    if (vkCreateSampler(v_ctx->device, &samplerInfo, NULL, &text2d_ctx->texture2dSampler) != VK_SUCCESS) {
-        ecs_err("Failed to create texture sampler");
-    }
+    vkUpdateDescriptorSets(v_ctx->device, 1, &descriptorWrite, 0, NULL);
+    text2d_ctx->textureBound = true;
 }
 
 void Texture2DSetupSystem(ecs_iter_t *it) {
@@ -246,22 +142,8 @@ void Texture2DSetupSystem(ecs_iter_t *it) {
         return;
     }
 
-    createTextureImage(v_ctx, text2d_ctx);
-    if (sdl_ctx->hasError) return;
-
-    VkDescriptorImageInfo imageInfo = {0};
-    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    imageInfo.imageView = text2d_ctx->texture2dImageView;
-    imageInfo.sampler = text2d_ctx->texture2dSampler;
-
-    VkWriteDescriptorSet descriptorWrite = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
-    descriptorWrite.dstSet = text2d_ctx->texture2dDescriptorSet;
-    descriptorWrite.dstBinding = 0;
-    descriptorWrite.descriptorCount = 1;
-    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    descriptorWrite.pImageInfo = &imageInfo;
-
-    vkUpdateDescriptorSets(v_ctx->device, 1, &descriptorWrite, 0, NULL);
+    // whole light set decodes in parallel, descriptor is written in Texture2DBindTextureSet
+    text2d_ctx->textureSet = flecs_texture_set_load(it->world, "assets/textures/light");
 
     Texture2DVertex vertices[] = {
         {{-1.0f, -0.5f}, {0.0f, 1.0f}}, // Bottom-left
@@ -350,9 +232,17 @@ void Texture2DSetupSystem(ecs_iter_t *it) {
     colorBlending.attachmentCount = 1;
     colorBlending.pAttachments = &colorBlendAttachment;
 
+    // material layer in the texture set
+    VkPushConstantRange pushConstantRange = {0};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(uint32_t);
+
     VkPipelineLayoutCreateInfo pipelineLayoutInfo = {VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO};
     pipelineLayoutInfo.setLayoutCount = 1;
     pipelineLayoutInfo.pSetLayouts = &text2d_ctx->texture2dDescriptorSetLayout;
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
     if (vkCreatePipelineLayout(v_ctx->device, &pipelineLayoutInfo, NULL, &text2d_ctx->texture2dPipelineLayout) != VK_SUCCESS) {
         ecs_err("Failed to create texture2d pipeline layout");
         sdl_ctx->hasError = true;
@@ -385,18 +275,23 @@ void Texture2DSetupSystem(ecs_iter_t *it) {
 }
 
 void Texture2DRenderSystem(ecs_iter_t *it) {
-    VulkanContext *v_ctx = ecs_singleton_ensure(it->world, VulkanContext);
+    VulkanContext *v_ctx = ecs_field(it, VulkanContext, 1);
     if (!v_ctx) return;
-    SDLContext *sdl_ctx = ecs_singleton_ensure(it->world, SDLContext);
+    SDLContext *sdl_ctx = ecs_field(it, SDLContext, 0);
     if (!sdl_ctx || sdl_ctx->hasError || sdl_ctx->isShutDown) return;
-    Texture2DContext *text2d_ctx = ecs_singleton_ensure(it->world, Texture2DContext);
+    Texture2DContext *text2d_ctx = ecs_field(it, Texture2DContext, 2);
     if (!text2d_ctx) return;
+    if (!text2d_ctx->textureBound) {
+        Texture2DBindTextureSet(it->world, v_ctx, text2d_ctx);
+        if (!text2d_ctx->textureBound) return; // still loading
+    }
 
     vkCmdBindPipeline(v_ctx->commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, text2d_ctx->texture2dPipeline);
     VkDeviceSize offsets[] = {0};
     vkCmdBindVertexBuffers(v_ctx->commandBuffer, 0, 1, &text2d_ctx->texture2dVertexBuffer, offsets);
     vkCmdBindIndexBuffer(v_ctx->commandBuffer, text2d_ctx->texture2dIndexBuffer, 0, VK_INDEX_TYPE_UINT32);
     vkCmdBindDescriptorSets(v_ctx->commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, text2d_ctx->texture2dPipelineLayout, 0, 1, &text2d_ctx->texture2dDescriptorSet, 0, NULL);
+    vkCmdPushConstants(v_ctx->commandBuffer, text2d_ctx->texture2dPipelineLayout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(uint32_t), &text2d_ctx->textureLayer);
     vkCmdDrawIndexed(v_ctx->commandBuffer, 6, 1, 0, 0, 0);
 }
 
@@ -413,10 +308,7 @@ void flecs_texture2d_cleanup(ecs_world_t *world) {
     if (text2d_ctx->texture2dPipelineLayout != VK_NULL_HANDLE) vkDestroyPipelineLayout(v_ctx->device, text2d_ctx->texture2dPipelineLayout, NULL);
     if (text2d_ctx->texture2dDescriptorSetLayout != VK_NULL_HANDLE) vkDestroyDescriptorSetLayout(v_ctx->device, text2d_ctx->texture2dDescriptorSetLayout, NULL);
     if (text2d_ctx->texture2dDescriptorPool != VK_NULL_HANDLE) vkDestroyDescriptorPool(v_ctx->device, text2d_ctx->texture2dDescriptorPool, NULL);
-    if (text2d_ctx->texture2dSampler != VK_NULL_HANDLE) vkDestroySampler(v_ctx->device, text2d_ctx->texture2dSampler, NULL);
-    if (text2d_ctx->texture2dImageView != VK_NULL_HANDLE) vkDestroyImageView(v_ctx->device, text2d_ctx->texture2dImageView, NULL);
-    if (text2d_ctx->texture2dImageMemory != VK_NULL_HANDLE) vkFreeMemory(v_ctx->device, text2d_ctx->texture2dImageMemory, NULL);
-    if (text2d_ctx->texture2dImage != VK_NULL_HANDLE) vkDestroyImage(v_ctx->device, text2d_ctx->texture2dImage, NULL);
+    // image, view and sampler belong to the texture set (texture_array_module)
     if (text2d_ctx->texture2dVertexBufferMemory != VK_NULL_HANDLE) vkFreeMemory(v_ctx->device, text2d_ctx->texture2dVertexBufferMemory, NULL);
     if (text2d_ctx->texture2dVertexBuffer != VK_NULL_HANDLE) vkDestroyBuffer(v_ctx->device, text2d_ctx->texture2dVertexBuffer, NULL);
     if (text2d_ctx->texture2dIndexBufferMemory != VK_NULL_HANDLE) vkFreeMemory(v_ctx->device, text2d_ctx->texture2dIndexBufferMemory, NULL);
@@ -425,11 +317,14 @@ void flecs_texture2d_cleanup(ecs_world_t *world) {
     ecs_log(1, "Texture2D cleanup completed");
 }
 
+// registry slot, marked cleaned by the cleanup observer
+static ModuleHandle texture2d_module_handle = MODULE_HANDLE_NONE;
+
 void texture2d_cleanup_event_system(ecs_iter_t *it){
   ecs_print(1,"[cleanup] texture2d_cleanup_event_system");
   flecs_texture2d_cleanup(it->world);
 
-  module_break_name(it, "texture2d_module");
+  module_set_state(it->world, texture2d_module_handle, MODULE_STATE_CLEANED);
 }
 
 void texture2d_register_components(ecs_world_t *world) {
@@ -452,6 +347,7 @@ void texture2d_register_systems(ecs_world_t *world){
 
   ecs_system_init(world, &(ecs_system_desc_t){
       .entity = ecs_entity(world, { .name = "Texture2DRenderSystem", .add = ecs_ids(ecs_dependson(GlobalPhases.CMDBufferPhase)) }),
+      .query.terms = { ECS_SINGLETON_IN(SDLContext), ECS_SINGLETON_IN(VulkanContext), ECS_SINGLETON_INOUT(Texture2DContext) },
       .callback = Texture2DRenderSystem
   });
 }
@@ -463,10 +359,10 @@ void flecs_texture2d_module_init(ecs_world_t *world) {
 
   ecs_singleton_set(world, Texture2DContext, {0});
 
-  ecs_entity_t e = ecs_new(world);
-  ecs_set(world, e, PluginModule, { .name = "texture2d_module", .isCleanUp = false });
+  texture2d_module_handle = module_register(world, "texture2d_module");
 
   texture2d_register_systems(world);
+  module_set_state(world, texture2d_module_handle, MODULE_STATE_READY);
 
   ecs_log(1, "Texture2d module initialized");
 }
\ No newline at end of file
@@ -0,0 +1,458 @@
+// texture sets
+// a directory of pngs -> one 2D array image, layers decoded on the asset
+// workers in parallel, materials pick a layer (push constant) so a scene
+// with many prototype textures binds one descriptor.
+
+#include "flecs_texture_array.h"
+#include <stdio.h>
+#include <string.h>
+#include "flecs_utils.h"
+#include "flecs_sdl.h"
+#include "flecs_vulkan.h"
+#include "flecs_vfs.h"
+#include "flecs_memory.h"
+
+static void createBuffer(VulkanContext *v_ctx, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer *buffer, VkDeviceMemory *memory) {
+  VkBufferCreateInfo bufferInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+  bufferInfo.size = size;
+  bufferInfo.usage = usage;
+  bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+  if (vkCreateBuffer(v_ctx->device, &bufferInfo, NULL, buffer) != VK_SUCCESS) {
+    ecs_err("Failed to create buffer");
+    return;
+  }
+
+  VkMemoryRequirements memReqs;
+  vkGetBufferMemoryRequirements(v_ctx->device, *buffer, &memReqs);
+
+  VkMemoryAllocateInfo allocInfo = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+  allocInfo.allocationSize = memReqs.size;
+  VkPhysicalDeviceMemoryProperties memProps;
+  vkGetPhysicalDeviceMemoryProperties(v_ctx->physicalDevice, &memProps);
+  for (uint32_t i = 0; i < memProps.memoryTypeCount; i++) {
+    if (memReqs.memoryTypeBits & (1 << i) && (memProps.memoryTypes[i].propertyFlags & properties) == properties) {
+      allocInfo.memoryTypeIndex = i;
+      break;
+    }
+  }
+
+  if (vkAllocateMemory(v_ctx->device, &allocInfo, NULL, memory) != VK_SUCCESS) {
+    ecs_err("Failed to allocate buffer memory");
+    return;
+  }
+
+  vkBindBufferMemory(v_ctx->device, *buffer, *memory, 0);
+}
+
+static void textureSetFreeLayers(TextureSet *set) {
+  if (set->layerPixels) {
+    for (uint32_t i = 0; i < set->layerCount; i++) free(set->layerPixels[i]);
+  }
+  flecs_mem_free(MEMORY_TAG_TEXTURE, set->layerPixels);
+  flecs_mem_free(MEMORY_TAG_TEXTURE, set->layerPaths);
+  flecs_mem_free(MEMORY_TAG_TEXTURE, set->layerAssets);
+  flecs_mem_free(MEMORY_TAG_TEXTURE, set->layerWidth);
+  flecs_mem_free(MEMORY_TAG_TEXTURE, set->layerHeight);
+  set->layerPixels = NULL;
+  set->layerPaths = NULL;
+  set->layerAssets = NULL;
+  set->layerWidth = NULL;
+  set->layerHeight = NULL;
+}
+
+// all layers in one staging buffer and one command buffer, mips blitted for
+// every layer at once
+static bool createTextureSetImage(VulkanContext *v_ctx, TextureSet *set) {
+  set->width = 0;
+  for (uint32_t i = 0; i < set->layerCount && !set->width; i++) {
+    if (set->layerPixels[i]) {
+      set->width = (uint32_t)set->layerWidth[i];
+      set->height = (uint32_t)set->layerHeight[i];
+    }
+  }
+  if (!set->width) {
+    ecs_err("[texture_set] %s has no loadable layers", set->dir);
+    return false;
+  }
+
+  set->mipLevels = calcMipLevels(set->width, set->height);
+  bool gpuMips = formatSupportsLinearBlit(v_ctx->physicalDevice, VK_FORMAT_R8G8B8A8_SRGB);
+  VkDeviceSize layerSize = (VkDeviceSize)set->width * set->height * 4;
+  uint32_t regionsPerLayer = gpuMips ? 1 : set->mipLevels;
+  VkBufferImageCopy *regions = flecs_mem_calloc(MEMORY_TAG_TEXTURE, (size_t)set->layerCount * regionsPerLayer, sizeof(VkBufferImageCopy));
+  unsigned char **chains = flecs_mem_calloc(MEMORY_TAG_TEXTURE, set->layerCount, sizeof(unsigned char *));
+  if (!regions || !chains) {
+    flecs_mem_free(MEMORY_TAG_TEXTURE, regions);
+    flecs_mem_free(MEMORY_TAG_TEXTURE, chains);
+    return false;
+  }
+
+  // cpu chain per layer when the format can't blit, regions get rebased below
+  VkDeviceSize stagingSize = 0;
+  bool chainFailed = false;
+  for (uint32_t i = 0; i < set->layerCount; i++) {
+    VkBufferImageCopy *layerRegions = regions + (size_t)i * regionsPerLayer;
+    VkDeviceSize size = layerSize;
+    if (!gpuMips) {
+      unsigned char *black = NULL;
+      const unsigned char *src = set->layerPixels[i];
+      if (!src || (uint32_t)set->layerWidth[i] != set->width || (uint32_t)set->layerHeight[i] != set->height) {
+        src = black = flecs_mem_calloc(MEMORY_TAG_TEXTURE, 1, (size_t)layerSize);
+      }
+      size = src ? buildMipChainCPU(src, set->width, set->height, 4, true, set->mipLevels, &chains[i], layerRegions) : 0;
+      flecs_mem_free(MEMORY_TAG_TEXTURE, black);
+      chainFailed = chainFailed || !chains[i];
+    } else {
+      layerRegions->imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+      layerRegions->imageSubresource.layerCount = 1;
+      layerRegions->imageExtent.width = set->width;
+      layerRegions->imageExtent.height = set->height;
+      layerRegions->imageExtent.depth = 1;
+    }
+    for (uint32_t r = 0; r < regionsPerLayer; r++) {
+      layerRegions[r].bufferOffset += stagingSize;
+      layerRegions[r].imageSubresource.baseArrayLayer = i;
+    }
+    stagingSize += size;
+  }
+
+  if (chainFailed) {
+    ecs_err("[texture_set] out of memory building mips for %s", set->dir);
+    for (uint32_t i = 0; i < set->layerCount; i++) free(chains[i]);
+    flecs_mem_free(MEMORY_TAG_TEXTURE, chains);
+    flecs_mem_free(MEMORY_TAG_TEXTURE, regions);
+    return false;
+  }
+
+  VkBuffer stagingBuffer = VK_NULL_HANDLE;
+  VkDeviceMemory stagingMemory = VK_NULL_HANDLE;
+  createBuffer(v_ctx, stagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &stagingBuffer, &stagingMemory);
+  unsigned char *mapped = NULL;
+  if (!stagingMemory || vkMapMemory(v_ctx->device, stagingMemory, 0, stagingSize, 0, (void **)&mapped) != VK_SUCCESS) {
+    ecs_err("[texture_set] failed to map staging buffer");
+    if (stagingBuffer) vkDestroyBuffer(v_ctx->device, stagingBuffer, NULL);
+    if (stagingMemory) vkFreeMemory(v_ctx->device, stagingMemory, NULL);
+    for (uint32_t i = 0; i < set->layerCount; i++) free(chains[i]);
+    flecs_mem_free(MEMORY_TAG_TEXTURE, chains);
+    flecs_mem_free(MEMORY_TAG_TEXTURE, regions);
+    return false;
+  }
+  for (uint32_t i = 0; i < set->layerCount; i++) {
+    unsigned char *dst = mapped + regions[(size_t)i * regionsPerLayer].bufferOffset;
+    if (!gpuMips) {
+      VkDeviceSize size = (i + 1 < set->layerCount ? regions[(size_t)(i + 1) * regionsPerLayer].bufferOffset : stagingSize) -
+                          regions[(size_t)i * regionsPerLayer].bufferOffset;
+      if (chains[i]) memcpy(dst, chains[i], (size_t)size);
+      free(chains[i]);
+    } else if (set->layerPixels[i] && (uint32_t)set->layerWidth[i] == set->width && (uint32_t)set->layerHeight[i] == set->height) {
+      memcpy(dst, set->layerPixels[i], (size_t)layerSize);
+    } else {
+      if (set->layerPixels[i]) ecs_err("[texture_set] %s size differs from layer 0, left black", set->layerPaths[i]);
+      memset(dst, 0, (size_t)layerSize);
+    }
+  }
+  flecs_mem_free(MEMORY_TAG_TEXTURE, chains);
+  vkUnmapMemory(v_ctx->device, stagingMemory);
+
+  VkImageCreateInfo imageInfo = {VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+  imageInfo.imageType = VK_IMAGE_TYPE_2D;
+  imageInfo.format = VK_FORMAT_R8G8B8A8_SRGB;
+  imageInfo.extent.width = set->width;
+  imageInfo.extent.height = set->height;
+  imageInfo.extent.depth = 1;
+  imageInfo.mipLevels = set->mipLevels;
+  imageInfo.arrayLayers = set->layerCount;
+  imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+  imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+  imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+  imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+  bool ok = vkCreateImage(v_ctx->device, &imageInfo, NULL, &set->image) == VK_SUCCESS;
+  if (ok) {
+    VkMemoryRequirements memReqs;
+    vkGetImageMemoryRequirements(v_ctx->device, set->image, &memReqs);
+    VkMemoryAllocateInfo allocInfo = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+    allocInfo.allocationSize = memReqs.size;
+    VkPhysicalDeviceMemoryProperties memProps;
+    vkGetPhysicalDeviceMemoryProperties(v_ctx->physicalDevice, &memProps);
+    for (uint32_t i = 0; i < memProps.memoryTypeCount; i++) {
+      if ((memReqs.memoryTypeBits & (1 << i)) && (memProps.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)) {
+        allocInfo.memoryTypeIndex = i;
+        break;
+      }
+    }
+    ok = vkAllocateMemory(v_ctx->device, &allocInfo, NULL, &set->memory) == VK_SUCCESS;
+    if (ok) vkBindImageMemory(v_ctx->device, set->image, set->memory, 0);
+  }
+
+  if (ok) {
+    VkCommandBuffer commandBuffer;
+    VkCommandBufferAllocateInfo cmdAllocInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+    cmdAllocInfo.commandPool = v_ctx->commandPool;
+    cmdAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    cmdAllocInfo.commandBufferCount = 1;
+    vkAllocateCommandBuffers(v_ctx->device, &cmdAllocInfo, &commandBuffer);
+
+    VkCommandBufferBeginInfo beginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+    VkImageMemoryBarrier barrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = set->image;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.levelCount = set->mipLevels;
+    barrier.subresourceRange.layerCount = set->layerCount;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, NULL, 0, NULL, 1, &barrier);
+
+    vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, set->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, set->layerCount * regionsPerLayer, regions);
+    if (gpuMips) {
+      cmdGenerateMipmaps(commandBuffer, set->image, (int32_t)set->width, (int32_t)set->height, set->mipLevels, set->layerCount);
+    } else {
+      barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+      barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+      barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+      barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+      vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, NULL, 0, NULL, 1, &barrier);
+    }
+
+    vkEndCommandBuffer(commandBuffer);
+
+    VkSubmitInfo submitInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &commandBuffer;
+    vkQueueSubmit(v_ctx->graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
+    vkQueueWaitIdle(v_ctx->graphicsQueue);
+    vkFreeCommandBuffers(v_ctx->device, v_ctx->commandPool, 1, &commandBuffer);
+  }
+  vkFreeMemory(v_ctx->device, stagingMemory, NULL);
+  vkDestroyBuffer(v_ctx->device, stagingBuffer, NULL);
+  flecs_mem_free(MEMORY_TAG_TEXTURE, regions);
+  if (!ok) {
+    ecs_err("[texture_set] failed to create image for %s", set->dir);
+    return false;
+  }
+
+  VkImageViewCreateInfo viewInfo = {VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
+  viewInfo.image = set->image;
+  viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+  viewInfo.format = VK_FORMAT_R8G8B8A8_SRGB;
+  viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  viewInfo.subresourceRange.levelCount = set->mipLevels;
+  viewInfo.subresourceRange.layerCount = set->layerCount;
+  if (vkCreateImageView(v_ctx->device, &viewInfo, NULL, &set->view) != VK_SUCCESS) {
+    ecs_err("[texture_set] failed to create image view");
+    return false;
+  }
+
+  VkSamplerCreateInfo samplerInfo = {VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO};
+  samplerInfo.magFilter = VK_FILTER_LINEAR;
+  samplerInfo.minFilter = VK_FILTER_LINEAR;
+  samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+  samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+  samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+  samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+  samplerInfo.minLod = 0.0f;
+  samplerInfo.maxLod = (float)set->mipLevels;
+  if (vkCreateSampler(v_ctx->device, &samplerInfo, NULL, &set->sampler) != VK_SUCCESS) {
+    ecs_err("[texture_set] failed to create sampler");
+    return false;
+  }
+  return true;
+}
+
+//===============================================
+// loading
+//===============================================
+
+// main thread, takes the decoded pixels, the image is built once every layer is in
+static bool TextureSetStoreLayer(ecs_world_t *world, ecs_entity_t asset, AssetResult *result) {
+  ecs_entity_t setEntity = ecs_get_target(world, asset, EcsChildOf, 0);
+  if (!setEntity) return false;
+  TextureSet *set = ecs_get_mut(world, setEntity, TextureSet);
+  if (!set || !set->layerPixels) return false;
+  if (set->ready) {
+    // hot reload, the layers are baked into one image with shared mips
+    ecs_log(1, "[texture_set] %s changed, texture sets pick it up on restart", ecs_get(world, asset, AssetHandle)->path);
+    return true;
+  }
+
+  for (uint32_t i = 0; i < set->layerCount; i++) {
+    if (set->layerAssets[i] != asset) continue;
+    set->layerPixels[i] = result->pixels;
+    set->layerWidth[i] = result->width;
+    set->layerHeight[i] = result->height;
+    result->pixels = NULL;
+    return true;
+  }
+  return false;
+}
+
+ecs_entity_t flecs_texture_set_load(ecs_world_t *world, const char *dir) {
+  int count = 0;
+  char **files = flecs_vfs_list(dir, ".png", &count);
+  if (count == 0) {
+    ecs_err("[texture_set] no png files in %s", dir);
+    flecs_vfs_list_free(files, count);
+    return 0;
+  }
+  if (count > TEXTURE_SET_MAX_LAYERS) {
+    ecs_err("[texture_set] %s has %d files, using the first %d", dir, count, TEXTURE_SET_MAX_LAYERS);
+    count = TEXTURE_SET_MAX_LAYERS;
+  }
+
+  TextureSet set = {0};
+  snprintf(set.dir, sizeof(set.dir), "%s", dir);
+  set.layerCount = (uint32_t)count;
+  set.layerPaths = flecs_mem_calloc(MEMORY_TAG_TEXTURE, count, ASSET_PATH_MAX);
+  set.layerAssets = flecs_mem_calloc(MEMORY_TAG_TEXTURE, count, sizeof(ecs_entity_t));
+  set.layerPixels = flecs_mem_calloc(MEMORY_TAG_TEXTURE, count, sizeof(unsigned char *));
+  set.layerWidth = flecs_mem_calloc(MEMORY_TAG_TEXTURE, count, sizeof(int));
+  set.layerHeight = flecs_mem_calloc(MEMORY_TAG_TEXTURE, count, sizeof(int));
+  if (!set.layerPaths || !set.layerAssets || !set.layerPixels || !set.layerWidth || !set.layerHeight) {
+    textureSetFreeLayers(&set);
+    flecs_vfs_list_free(files, count);
+    return 0;
+  }
+
+  ecs_entity_t e = ecs_new(world);
+  for (int i = 0; i < count; i++) {
+    snprintf(set.layerPaths[i], ASSET_PATH_MAX, "%s", files[i]);
+    // one job per layer, the asset workers decode them in parallel
+    set.layerAssets[i] = flecs_asset_load(world, &(AssetLoadDesc){
+      .path = files[i],
+      .type = ASSET_TYPE_TEXTURE,
+      .upload = TextureSetStoreLayer,
+      .raw = true
+    });
+    if (set.layerAssets[i]) ecs_add_pair(world, set.layerAssets[i], EcsChildOf, e);
+  }
+  flecs_vfs_list_free(files, count);
+
+  ecs_set_id(world, e, ecs_id(TextureSet), sizeof(TextureSet), &set);
+  ecs_log(1, "[texture_set] loading %s (%d layers)", dir, count);
+  return e;
+}
+
+int flecs_texture_set_find(const TextureSet *set, const char *name) {
+  if (!set || !set->layerPaths || !name) return -1;
+  for (uint32_t i = 0; i < set->layerCount; i++) {
+    const char *path = set->layerPaths[i];
+    const char *file = strrchr(path, '/');
+    file = file ? file + 1 : path;
+    if (strcmp(path, name) == 0 || strcmp(file, name) == 0) return (int)i;
+  }
+  return -1;
+}
+
+//===============================================
+// systems
+//===============================================
+
+void TextureSetBuildSystem(ecs_iter_t *it) {
+  SDLContext *sdl_ctx = ecs_field(it, SDLContext, 1);
+  if (!sdl_ctx || sdl_ctx->hasError || sdl_ctx->isShutDown) return;
+  VulkanContext *v_ctx = ecs_field(it, VulkanContext, 2);
+  if (!v_ctx || !v_ctx->device) return;
+
+  TextureSet *sets = ecs_field(it, TextureSet, 0);
+  for (int i = 0; i < it->count; i++) {
+    TextureSet *set = &sets[i];
+    if (set->ready || !set->layerAssets) continue;
+
+    bool pending = false;
+    for (uint32_t l = 0; l < set->layerCount && !pending; l++) {
+      const AssetHandle *handle = set->layerAssets[l] ? ecs_get(it->world, set->layerAssets[l], AssetHandle) : NULL;
+      pending = handle && handle->state == ASSET_STATE_LOADING;
+    }
+    if (pending) continue;
+
+    set->ready = createTextureSetImage(v_ctx, set);
+    // layer names stay for flecs_texture_set_find, pixels are on the gpu now
+    for (uint32_t l = 0; l < set->layerCount; l++) {
+      free(set->layerPixels[l]);
+      set->layerPixels[l] = NULL;
+    }
+    if (set->ready) {
+      ecs_log(1, "[texture_set] %s ready %ux%u x %u layers, %u mips", set->dir, set->width, set->height, set->layerCount, set->mipLevels);
+    } else {
+      // don't retry every frame
+      flecs_mem_free(MEMORY_TAG_TEXTURE, set->layerAssets);
+      set->layerAssets = NULL;
+    }
+  }
+}
+
+void flecs_texture_array_cleanup(ecs_world_t *world) {
+  VulkanContext *v_ctx = ecs_singleton_ensure(world, VulkanContext);
+  if (!v_ctx || !v_ctx->device) return;
+
+  ecs_log(1, "Texture array cleanup starting...");
+  vkDeviceWaitIdle(v_ctx->device);
+
+  ecs_iter_t it = ecs_each(world, TextureSet);
+  while (ecs_each_next(&it)) {
+    TextureSet *sets = ecs_field(&it, TextureSet, 0);
+    for (int i = 0; i < it.count; i++) {
+      TextureSet *set = &sets[i];
+      if (set->sampler != VK_NULL_HANDLE) vkDestroySampler(v_ctx->device, set->sampler, NULL);
+      if (set->view != VK_NULL_HANDLE) vkDestroyImageView(v_ctx->device, set->view, NULL);
+      if (set->memory != VK_NULL_HANDLE) vkFreeMemory(v_ctx->device, set->memory, NULL);
+      if (set->image != VK_NULL_HANDLE) vkDestroyImage(v_ctx->device, set->image, NULL);
+      textureSetFreeLayers(set);
+      set->sampler = VK_NULL_HANDLE;
+      set->view = VK_NULL_HANDLE;
+      set->memory = VK_NULL_HANDLE;
+      set->image = VK_NULL_HANDLE;
+      set->ready = false;
+    }
+  }
+
+  ecs_log(1, "Texture array cleanup completed");
+}
+
+// registry slot, marked cleaned by the cleanup observer
+static ModuleHandle texture_array_module_handle = MODULE_HANDLE_NONE;
+
+void texture_array_cleanup_event_system(ecs_iter_t *it) {
+  ecs_print(1, "[cleanup] texture_array_cleanup_event_system");
+  flecs_texture_array_cleanup(it->world);
+  module_set_state(it->world, texture_array_module_handle, MODULE_STATE_CLEANED);
+}
+
+void texture_array_register_components(ecs_world_t *world) {
+  ECS_COMPONENT_DEFINE(world, TextureSet);
+}
+
+void texture_array_register_systems(ecs_world_t *world) {
+  ecs_observer(world, {
+    .query.terms = {{ EcsAny, .src.id = CleanUpModule }},
+    .events = { CleanUpEvent },
+    .callback = texture_array_cleanup_event_system
+  });
+
+  ecs_system_init(world, &(ecs_system_desc_t){
+    .entity = ecs_entity(world, { .name = "TextureSetBuildSystem", .add = ecs_ids(ecs_dependson(GlobalPhases.LogicUpdatePhase)) }),
+    .query.terms = {{ ecs_id(TextureSet) }, ECS_SINGLETON_IN(SDLContext), ECS_SINGLETON_INOUT(VulkanContext)},
+    .callback = TextureSetBuildSystem
+  });
+}
+
+void flecs_texture_array_module_init(ecs_world_t *world) {
+  ecs_log(1, "Initializing texture array module...");
+
+  texture_array_register_components(world);
+
+  texture_array_module_handle = module_register(world, "texture_array_module");
+
+  texture_array_register_systems(world);
+  module_set_state(world, texture_array_module_handle, MODULE_STATE_READY);
+
+  ecs_log(1, "Texture array module initialized");
+}
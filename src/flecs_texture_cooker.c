@@ -0,0 +1,701 @@
+// texture cooker
+// BC1 / BC3 / BC7 (mode 6) block encoders, mip chain, KTX2 style cache.
+// Blocks of a level are split over SDL threads by block rows. Endpoint
+// bounds and index fitting have an SSE2 path (x64 always, x86 with SSE2),
+// the plain loops below it are the fallback and give the same blocks.
+
+#include "flecs_texture_cooker.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <SDL3/SDL.h>
+#include "flecs.h"
+#include "flecs_vfs.h"
+#include "flecs_memory.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define COOK_SSE2
+#include <emmintrin.h>
+#endif
+
+//#define STB_IMAGE_IMPLEMENTATION // flecs_texture2d.c
+#include "stb_image.h"
+
+#define COOK_MAX_THREADS 8
+#define COOK_MIN_ROWS_PER_THREAD 8
+
+static const uint8_t KTX2_IDENTIFIER[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+static const char KTX2_KEY_SOURCE_HASH[] = "flecsSourceHash";
+
+//===============================================
+// helpers
+//===============================================
+
+static inline int cook_clamp(int v, int lo, int hi) {
+  return v < lo ? lo : (v > hi ? hi : v);
+}
+
+static inline uint32_t cook_block_bytes(VkFormat format) {
+  return format == VK_FORMAT_BC1_RGB_SRGB_BLOCK ? 8 : 16;
+}
+
+static inline uint64_t cook_level_size(VkFormat format, uint32_t w, uint32_t h) {
+  return (uint64_t)((w + 3) / 4) * ((h + 3) / 4) * cook_block_bytes(format);
+}
+
+static inline uint64_t cook_align(uint64_t v, uint64_t a) {
+  return (v + a - 1) / a * a;
+}
+
+// 4x4 texels, edges clamp so partial blocks on small mips repeat the border
+static void cook_fetch_block(const uint8_t *rgba, uint32_t w, uint32_t h, uint32_t bx, uint32_t by, uint8_t px[16][4]) {
+  for (int y = 0; y < 4; y++) {
+    uint32_t sy = by * 4 + y < h ? by * 4 + y : h - 1;
+    for (int x = 0; x < 4; x++) {
+      uint32_t sx = bx * 4 + x < w ? bx * 4 + x : w - 1;
+      memcpy(px[y * 4 + x], rgba + ((size_t)sy * w + sx) * 4, 4);
+    }
+  }
+}
+
+// per channel min, max and sum of the 16 texels
+static void cook_block_bounds(const uint8_t px[16][4], int lo[4], int hi[4], int sum[4]) {
+#ifdef COOK_SSE2
+  __m128i zero = _mm_setzero_si128();
+  __m128i vmin = _mm_set1_epi8((char)0xff), vmax = zero, vsum = zero;
+  for (int i = 0; i < 16; i += 4) {
+    __m128i v = _mm_loadu_si128((const __m128i *)px[i]);
+    vmin = _mm_min_epu8(vmin, v);
+    vmax = _mm_max_epu8(vmax, v);
+    // 16 bit rgba of two texels each, at most 16 * 255 per lane
+    vsum = _mm_add_epi16(vsum, _mm_add_epi16(_mm_unpacklo_epi8(v, zero), _mm_unpackhi_epi8(v, zero)));
+  }
+  // fold the four texels of each lane group onto texel 0
+  vmin = _mm_min_epu8(vmin, _mm_srli_si128(vmin, 8));
+  vmin = _mm_min_epu8(vmin, _mm_srli_si128(vmin, 4));
+  vmax = _mm_max_epu8(vmax, _mm_srli_si128(vmax, 8));
+  vmax = _mm_max_epu8(vmax, _mm_srli_si128(vmax, 4));
+  vsum = _mm_add_epi16(vsum, _mm_srli_si128(vsum, 8));
+  uint32_t mins = (uint32_t)_mm_cvtsi128_si32(vmin), maxs = (uint32_t)_mm_cvtsi128_si32(vmax);
+  uint16_t sums[8];
+  _mm_storeu_si128((__m128i *)sums, vsum);
+  for (int c = 0; c < 4; c++) {
+    lo[c] = (mins >> (c * 8)) & 0xff;
+    hi[c] = (maxs >> (c * 8)) & 0xff;
+    sum[c] = sums[c];
+  }
+#else
+  for (int c = 0; c < 4; c++) {
+    lo[c] = 255;
+    hi[c] = 0;
+    sum[c] = 0;
+    for (int i = 0; i < 16; i++) {
+      int v = px[i][c];
+      sum[c] += v;
+      if (v < lo[c]) lo[c] = v;
+      if (v > hi[c]) hi[c] = v;
+    }
+  }
+#endif
+}
+
+// closest palette entry per texel, squared error over the first channels
+// (3 or 4), first entry wins ties
+static void cook_fit_indices(const uint8_t px[16][4], const int pal[][4], int count, int channels, int idx[16]) {
+#ifdef COOK_SSE2
+  // alpha lanes masked off for rgb fits
+  __m128i mask = channels == 4 ? _mm_set1_epi32(-1) : _mm_set1_epi32(0x00ffffff);
+  __m128i zero = _mm_setzero_si128();
+  for (int i = 0; i < 16; i += 4) {
+    __m128i v = _mm_and_si128(_mm_loadu_si128((const __m128i *)px[i]), mask);
+    __m128i t01 = _mm_unpacklo_epi8(v, zero), t23 = _mm_unpackhi_epi8(v, zero);
+    __m128i best = _mm_set1_epi32(0x7fffffff), bestIdx = zero;
+    for (int p = 0; p < count; p++) {
+      __m128i e = _mm_setr_epi16((short)pal[p][0], (short)pal[p][1], (short)pal[p][2], (short)(channels == 4 ? pal[p][3] : 0),
+                                 (short)pal[p][0], (short)pal[p][1], (short)pal[p][2], (short)(channels == 4 ? pal[p][3] : 0));
+      __m128i d01 = _mm_sub_epi16(t01, e), d23 = _mm_sub_epi16(t23, e);
+      // r*r + g*g and b*b + a*a per texel, then the two halves added
+      __m128i s01 = _mm_madd_epi16(d01, d01), s23 = _mm_madd_epi16(d23, d23);
+      __m128i evens = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(s01), _mm_castsi128_ps(s23), _MM_SHUFFLE(2, 0, 2, 0)));
+      __m128i odds = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(s01), _mm_castsi128_ps(s23), _MM_SHUFFLE(3, 1, 3, 1)));
+      __m128i err = _mm_add_epi32(evens, odds);
+      __m128i less = _mm_cmplt_epi32(err, best);
+      best = _mm_or_si128(_mm_and_si128(less, err), _mm_andnot_si128(less, best));
+      bestIdx = _mm_or_si128(_mm_and_si128(less, _mm_set1_epi32(p)), _mm_andnot_si128(less, bestIdx));
+    }
+    int32_t out[4];
+    _mm_storeu_si128((__m128i *)out, bestIdx);
+    for (int k = 0; k < 4; k++) idx[i + k] = out[k];
+  }
+#else
+  for (int i = 0; i < 16; i++) {
+    int best = 0, bestErr = 0x7fffffff;
+    for (int p = 0; p < count; p++) {
+      int err = 0;
+      for (int c = 0; c < channels; c++) {
+        int d = px[i][c] - pal[p][c];
+        err += d * d;
+      }
+      if (err < bestErr) {
+        bestErr = err;
+        best = p;
+      }
+    }
+    idx[i] = best;
+  }
+#endif
+}
+
+// endpoints along the bounding box diagonal, channels that run against the
+// widest one are flipped so gradients like red -> green stay on the line
+static void cook_block_endpoints(const uint8_t px[16][4], int channels, int lo[4], int hi[4]) {
+  int mean[4];
+  cook_block_bounds(px, lo, hi, mean);
+  for (int c = 0; c < channels; c++) mean[c] = (mean[c] + 8) / 16;
+
+  int axis = 0;
+  for (int c = 1; c < channels; c++) {
+    if (hi[c] - lo[c] > hi[axis] - lo[axis]) axis = c;
+  }
+  for (int c = 0; c < channels; c++) {
+    if (c == axis) continue;
+    int cov = 0;
+    for (int i = 0; i < 16; i++) {
+      cov += (px[i][c] - mean[c]) * (px[i][axis] - mean[axis]);
+    }
+    if (cov < 0) {
+      int t = lo[c];
+      lo[c] = hi[c];
+      hi[c] = t;
+    }
+  }
+}
+
+//===============================================
+// BC1 color block (also the color half of BC3)
+//===============================================
+
+static inline uint16_t cook_pack565(const int c[3]) {
+  return (uint16_t)(((cook_clamp(c[0], 0, 255) * 31 + 127) / 255) << 11 |
+                    ((cook_clamp(c[1], 0, 255) * 63 + 127) / 255) << 5 |
+                    ((cook_clamp(c[2], 0, 255) * 31 + 127) / 255));
+}
+
+static inline void cook_unpack565(uint16_t v, int c[3]) {
+  int r = (v >> 11) & 31, g = (v >> 5) & 63, b = v & 31;
+  c[0] = (r << 3) | (r >> 2);
+  c[1] = (g << 2) | (g >> 4);
+  c[2] = (b << 3) | (b >> 2);
+}
+
+static void cook_encode_color(const uint8_t px[16][4], uint8_t out[8]) {
+  int lo[4], hi[4];
+  cook_block_endpoints(px, 3, lo, hi);
+
+  // inset 1/16 of the range, less error for the interpolated entries
+  int e0[3], e1[3];
+  for (int c = 0; c < 3; c++) {
+    int inset = (hi[c] - lo[c]) / 16;
+    e0[c] = hi[c] - inset;
+    e1[c] = lo[c] + inset;
+  }
+
+  uint16_t c0 = cook_pack565(e0);
+  uint16_t c1 = cook_pack565(e1);
+  // c0 > c1 selects 4 color mode
+  if (c0 < c1) {
+    uint16_t t = c0;
+    c0 = c1;
+    c1 = t;
+  }
+
+  uint32_t indices = 0;
+  if (c0 != c1) {
+    int pal[4][4] = {{0}};
+    int idx[16];
+    cook_unpack565(c0, pal[0]);
+    cook_unpack565(c1, pal[1]);
+    for (int c = 0; c < 3; c++) {
+      pal[2][c] = (2 * pal[0][c] + pal[1][c] + 1) / 3;
+      pal[3][c] = (pal[0][c] + 2 * pal[1][c] + 1) / 3;
+    }
+    cook_fit_indices(px, (const int (*)[4])pal, 4, 3, idx);
+    for (int i = 0; i < 16; i++) indices |= (uint32_t)idx[i] << (i * 2);
+  }
+
+  out[0] = c0 & 0xff;
+  out[1] = c0 >> 8;
+  out[2] = c1 & 0xff;
+  out[3] = c1 >> 8;
+  out[4] = indices & 0xff;
+  out[5] = (indices >> 8) & 0xff;
+  out[6] = (indices >> 16) & 0xff;
+  out[7] = indices >> 24;
+}
+
+//===============================================
+// BC3 alpha block
+//===============================================
+
+static void cook_encode_alpha(const uint8_t px[16][4], uint8_t out[8]) {
+  int lo[4], hi[4], sum[4];
+  cook_block_bounds(px, lo, hi, sum);
+  int a0 = hi[3], a1 = lo[3];
+
+  uint64_t indices = 0;
+  if (a0 != a1) {
+    // a0 > a1, 8 value mode: a0, a1, then 6 interpolated
+    int pal[8];
+    pal[0] = a0;
+    pal[1] = a1;
+    for (int k = 1; k <= 6; k++) {
+      pal[k + 1] = ((7 - k) * a0 + k * a1 + 3) / 7;
+    }
+    uint8_t idx[16];
+#ifdef COOK_SSE2
+    // the 16 alphas in one register, |a - pal| as saturating differences
+    __m128i a[4];
+    for (int i = 0; i < 4; i++) a[i] = _mm_srli_epi32(_mm_loadu_si128((const __m128i *)px[i * 4]), 24);
+    __m128i alpha = _mm_packus_epi16(_mm_packs_epi32(a[0], a[1]), _mm_packs_epi32(a[2], a[3]));
+    __m128i best = _mm_set1_epi8((char)0xff), bestIdx = _mm_setzero_si128();
+    for (int p = 0; p < 8; p++) {
+      __m128i e = _mm_set1_epi8((char)pal[p]);
+      __m128i err = _mm_or_si128(_mm_subs_epu8(alpha, e), _mm_subs_epu8(e, alpha));
+      // err < best, unsigned: min picks err and they differ
+      __m128i less = _mm_andnot_si128(_mm_cmpeq_epi8(err, best), _mm_cmpeq_epi8(_mm_min_epu8(err, best), err));
+      best = _mm_min_epu8(err, best);
+      bestIdx = _mm_or_si128(_mm_and_si128(less, _mm_set1_epi8((char)p)), _mm_andnot_si128(less, bestIdx));
+    }
+    _mm_storeu_si128((__m128i *)idx, bestIdx);
+#else
+    for (int i = 0; i < 16; i++) {
+      int best = 0, bestErr = 256;
+      for (int p = 0; p < 8; p++) {
+        int err = abs(px[i][3] - pal[p]);
+        if (err < bestErr) {
+          bestErr = err;
+          best = p;
+        }
+      }
+      idx[i] = (uint8_t)best;
+    }
+#endif
+    for (int i = 0; i < 16; i++) indices |= (uint64_t)idx[i] << (i * 3);
+  }
+
+  out[0] = (uint8_t)a0;
+  out[1] = (uint8_t)a1;
+  for (int i = 0; i < 6; i++) {
+    out[2 + i] = (indices >> (i * 8)) & 0xff;
+  }
+}
+
+//===============================================
+// BC7 mode 6: one subset, rgba 7 bit endpoints + p bit, 4 bit indices
+//===============================================
+
+static const int BC7_WEIGHTS4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+typedef struct {
+  uint64_t lo, hi;
+  int pos;
+} CookBits;
+
+static inline void cook_bits_put(CookBits *b, uint32_t value, int count) {
+  for (int i = 0; i < count; i++, b->pos++) {
+    uint64_t bit = (value >> i) & 1;
+    if (b->pos < 64) b->lo |= bit << b->pos;
+    else b->hi |= bit << (b->pos - 64);
+  }
+}
+
+// best 7 bit value + shared p bit for the 4 channels of one endpoint
+static void cook_bc7_quantize(const int e[4], int q[4], int *pbit) {
+  int bestErr = 0x7fffffff;
+  for (int p = 0; p < 2; p++) {
+    int err = 0, tq[4];
+    for (int c = 0; c < 4; c++) {
+      tq[c] = cook_clamp((e[c] - p + 1) >> 1, 0, 127);
+      int d = e[c] - ((tq[c] << 1) | p);
+      err += d * d;
+    }
+    if (err < bestErr) {
+      bestErr = err;
+      *pbit = p;
+      memcpy(q, tq, sizeof(tq));
+    }
+  }
+}
+
+static void cook_encode_bc7(const uint8_t px[16][4], uint8_t out[16]) {
+  int lo[4], hi[4];
+  cook_block_endpoints(px, 4, lo, hi);
+
+  int q0[4], q1[4], p0, p1;
+  cook_bc7_quantize(lo, q0, &p0);
+  cook_bc7_quantize(hi, q1, &p1);
+
+  int pal[16][4];
+  for (int c = 0; c < 4; c++) {
+    int a = (q0[c] << 1) | p0;
+    int b = (q1[c] << 1) | p1;
+    for (int k = 0; k < 16; k++) {
+      pal[k][c] = ((64 - BC7_WEIGHTS4[k]) * a + BC7_WEIGHTS4[k] * b + 32) >> 6;
+    }
+  }
+
+  int idx[16];
+  cook_fit_indices(px, (const int (*)[4])pal, 16, 4, idx);
+
+  // anchor texel index is stored with 3 bits, msb has to be 0
+  if (idx[0] & 8) {
+    for (int c = 0; c < 4; c++) {
+      int t = q0[c];
+      q0[c] = q1[c];
+      q1[c] = t;
+    }
+    int t = p0;
+    p0 = p1;
+    p1 = t;
+    for (int i = 0; i < 16; i++) idx[i] = 15 - idx[i];
+  }
+
+  CookBits bits = {0};
+  cook_bits_put(&bits, 1 << 6, 7); // mode 6
+  for (int c = 0; c < 4; c++) {
+    cook_bits_put(&bits, (uint32_t)q0[c], 7);
+    cook_bits_put(&bits, (uint32_t)q1[c], 7);
+  }
+  cook_bits_put(&bits, (uint32_t)p0, 1);
+  cook_bits_put(&bits, (uint32_t)p1, 1);
+  cook_bits_put(&bits, (uint32_t)idx[0], 3);
+  for (int i = 1; i < 16; i++) {
+    cook_bits_put(&bits, (uint32_t)idx[i], 4);
+  }
+  for (int i = 0; i < 8; i++) {
+    out[i] = (bits.lo >> (i * 8)) & 0xff;
+    out[8 + i] = (bits.hi >> (i * 8)) & 0xff;
+  }
+}
+
+//===============================================
+// level encode, threaded over block rows
+//===============================================
+
+typedef struct {
+  const uint8_t *rgba;
+  uint32_t width, height;
+  VkFormat format;
+  uint8_t *out;
+  uint32_t rowBegin, rowEnd;
+} CookLevelJob;
+
+static int cook_level_rows(void *data) {
+  CookLevelJob *job = data;
+  uint32_t blocksX = (job->width + 3) / 4;
+  uint32_t blockBytes = cook_block_bytes(job->format);
+  uint8_t px[16][4];
+  for (uint32_t by = job->rowBegin; by < job->rowEnd; by++) {
+    for (uint32_t bx = 0; bx < blocksX; bx++) {
+      uint8_t *dst = job->out + ((size_t)by * blocksX + bx) * blockBytes;
+      cook_fetch_block(job->rgba, job->width, job->height, bx, by, px);
+      switch (job->format) {
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+          cook_encode_color(px, dst);
+          break;
+        case VK_FORMAT_BC3_SRGB_BLOCK:
+          cook_encode_alpha(px, dst);
+          cook_encode_color(px, dst + 8);
+          break;
+        default:
+          cook_encode_bc7(px, dst);
+          break;
+      }
+    }
+  }
+  return 0;
+}
+
+static void cook_encode_level(const uint8_t *rgba, uint32_t w, uint32_t h, VkFormat format, int threads, uint8_t *out) {
+  uint32_t blocksY = (h + 3) / 4;
+  int count = threads;
+  if ((uint32_t)count * COOK_MIN_ROWS_PER_THREAD > blocksY) count = (int)(blocksY / COOK_MIN_ROWS_PER_THREAD);
+  if (count < 1) count = 1;
+
+  CookLevelJob jobs[COOK_MAX_THREADS];
+  SDL_Thread *workers[COOK_MAX_THREADS] = {0};
+  for (int i = 0; i < count; i++) {
+    jobs[i] = (CookLevelJob){rgba, w, h, format, out, blocksY * i / count, blocksY * (i + 1) / count};
+  }
+  // job 0 runs on this thread
+  for (int i = 1; i < count; i++) {
+    workers[i] = SDL_CreateThread(cook_level_rows, "texture_cook", &jobs[i]);
+    if (!workers[i]) cook_level_rows(&jobs[i]);
+  }
+  cook_level_rows(&jobs[0]);
+  for (int i = 1; i < count; i++) {
+    if (workers[i]) SDL_WaitThread(workers[i], NULL);
+  }
+}
+
+// 2x2 box filter, odd edges clamp. Every cooked format is sRGB: rgb is
+// averaged in linear space, alpha as is
+static void cook_downsample(const uint8_t *src, uint32_t w, uint32_t h, uint8_t *dst, uint32_t nw, uint32_t nh,
+                            const float *toLinear, const uint8_t *toSrgb) {
+  for (uint32_t y = 0; y < nh; y++) {
+    uint32_t y0 = y * 2, y1 = y * 2 + 1 < h ? y * 2 + 1 : y0;
+    for (uint32_t x = 0; x < nw; x++) {
+      uint32_t x0 = x * 2, x1 = x * 2 + 1 < w ? x * 2 + 1 : x0;
+      const uint8_t *p00 = src + ((size_t)y0 * w + x0) * 4, *p01 = src + ((size_t)y0 * w + x1) * 4;
+      const uint8_t *p10 = src + ((size_t)y1 * w + x0) * 4, *p11 = src + ((size_t)y1 * w + x1) * 4;
+      uint8_t *out = dst + ((size_t)y * nw + x) * 4;
+      for (int c = 0; c < 3; c++) out[c] = flecs_srgb_average(toLinear, toSrgb, p00[c], p01[c], p10[c], p11[c]);
+      out[3] = (uint8_t)((p00[3] + p01[3] + p10[3] + p11[3] + 2) / 4);
+    }
+  }
+}
+
+//===============================================
+// api
+//===============================================
+
+uint64_t flecs_texture_source_hash(const void *data, size_t size) {
+  const uint8_t *p = data;
+  uint64_t h = 14695981039346656037ull;
+  for (size_t i = 0; i < size; i++) {
+    h ^= p[i];
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
+VkFormat flecs_texture_cook_vk_format(TextureCookFormat format) {
+  switch (format) {
+    case TEXTURE_COOK_BC1: return VK_FORMAT_BC1_RGB_SRGB_BLOCK;
+    case TEXTURE_COOK_BC3: return VK_FORMAT_BC3_SRGB_BLOCK;
+    case TEXTURE_COOK_BC7: return VK_FORMAT_BC7_SRGB_BLOCK;
+    default:               return VK_FORMAT_UNDEFINED;
+  }
+}
+
+bool flecs_texture_cook(const uint8_t *rgba, uint32_t width, uint32_t height, TextureCookFormat format,
+                        uint64_t sourceHash, int threads, CookedTexture *cooked) {
+  memset(cooked, 0, sizeof(CookedTexture));
+  if (!rgba || width == 0 || height == 0) return false;
+
+  if (format == TEXTURE_COOK_AUTO) {
+    format = TEXTURE_COOK_BC1;
+    for (size_t i = 0; i < (size_t)width * height; i++) {
+      if (rgba[i * 4 + 3] != 255) {
+        format = TEXTURE_COOK_BC3;
+        break;
+      }
+    }
+  }
+  VkFormat vkFormat = flecs_texture_cook_vk_format(format);
+
+  if (threads <= 0) threads = SDL_GetNumLogicalCPUCores();
+  if (threads > COOK_MAX_THREADS) threads = COOK_MAX_THREADS;
+
+  uint32_t mipLevels = 1;
+  for (uint32_t size = width > height ? width : height; size > 1 && mipLevels < TEXTURE_COOK_MAX_MIPS; size >>= 1) {
+    mipLevels++;
+  }
+
+  // identifier + header + index, level index, kvd (length + key + hash), pad
+  uint32_t levelIndexOffset = 80;
+  uint32_t kvdOffset = levelIndexOffset + mipLevels * 24;
+  uint32_t kvdLength = (uint32_t)(4 + sizeof(KTX2_KEY_SOURCE_HASH) + sizeof(uint64_t));
+  uint64_t dataOffset = cook_align(kvdOffset + cook_align(kvdLength, 4), 16);
+
+  // ktx2 stores the smallest mip first
+  uint64_t levelOffset[TEXTURE_COOK_MAX_MIPS], levelSize[TEXTURE_COOK_MAX_MIPS];
+  uint64_t fileSize = dataOffset;
+  for (int i = (int)mipLevels - 1; i >= 0; i--) {
+    uint32_t w = width >> i ? width >> i : 1;
+    uint32_t h = height >> i ? height >> i : 1;
+    levelOffset[i] = fileSize;
+    levelSize[i] = cook_level_size(vkFormat, w, h);
+    fileSize = cook_align(fileSize + levelSize[i], 16);
+  }
+
+  // the container outlives the cook (CookedTexture.file, freed with free)
+  uint8_t *file = calloc(1, (size_t)fileSize);
+  uint8_t *scratch = flecs_mem_alloc(MEMORY_TAG_TEXTURE, (size_t)width * height * 4);
+  uint8_t *next = flecs_mem_alloc(MEMORY_TAG_TEXTURE, (size_t)(width / 2 + 1) * (height / 2 + 1) * 4);
+  if (!file || !scratch || !next) {
+    free(file);
+    flecs_mem_free(MEMORY_TAG_TEXTURE, scratch);
+    flecs_mem_free(MEMORY_TAG_TEXTURE, next);
+    return false;
+  }
+
+  uint32_t header[9] = {vkFormat, 1, width, height, 0, 0, 1, mipLevels, 0};
+  uint32_t index[4] = {0, 0, kvdOffset, kvdLength};
+  uint64_t sgd[2] = {0, 0};
+  memcpy(file, KTX2_IDENTIFIER, 12);
+  memcpy(file + 12, header, sizeof(header));
+  memcpy(file + 48, index, sizeof(index));
+  memcpy(file + 64, sgd, sizeof(sgd));
+  for (uint32_t i = 0; i < mipLevels; i++) {
+    uint64_t entry[3] = {levelOffset[i], levelSize[i], levelSize[i]};
+    memcpy(file + levelIndexOffset + i * 24, entry, sizeof(entry));
+  }
+  uint32_t keyValueLength = kvdLength - 4;
+  memcpy(file + kvdOffset, &keyValueLength, 4);
+  memcpy(file + kvdOffset + 4, KTX2_KEY_SOURCE_HASH, sizeof(KTX2_KEY_SOURCE_HASH));
+  memcpy(file + kvdOffset + 4 + sizeof(KTX2_KEY_SOURCE_HASH), &sourceHash, sizeof(uint64_t));
+
+  memcpy(scratch, rgba, (size_t)width * height * 4);
+  float toLinear[256];
+  uint8_t toSrgb[SRGB_ENCODE_STEPS];
+  flecs_srgb_tables(toLinear, toSrgb);
+  uint32_t w = width, h = height;
+  for (uint32_t i = 0; i < mipLevels; i++) {
+    cook_encode_level(scratch, w, h, vkFormat, threads, file + levelOffset[i]);
+    if (i + 1 == mipLevels) break;
+    uint32_t nw = w > 1 ? w / 2 : 1;
+    uint32_t nh = h > 1 ? h / 2 : 1;
+    cook_downsample(scratch, w, h, next, nw, nh, toLinear, toSrgb);
+    memcpy(scratch, next, (size_t)nw * nh * 4);
+    w = nw;
+    h = nh;
+  }
+  flecs_mem_free(MEMORY_TAG_TEXTURE, scratch);
+  flecs_mem_free(MEMORY_TAG_TEXTURE, next);
+
+  if (!flecs_texture_cooked_parse(file, (size_t)fileSize, sourceHash, cooked)) {
+    free(file);
+    return false;
+  }
+  return true;
+}
+
+bool flecs_texture_cooked_parse(uint8_t *file, size_t fileSize, uint64_t sourceHash, CookedTexture *cooked) {
+  memset(cooked, 0, sizeof(CookedTexture));
+  if (!file || fileSize < 80 || memcmp(file, KTX2_IDENTIFIER, 12) != 0) return false;
+
+  uint32_t header[9];
+  uint32_t index[4];
+  memcpy(header, file + 12, sizeof(header));
+  memcpy(index, file + 48, sizeof(index));
+  VkFormat format = (VkFormat)header[0];
+  if (format != VK_FORMAT_BC1_RGB_SRGB_BLOCK && format != VK_FORMAT_BC3_SRGB_BLOCK && format != VK_FORMAT_BC7_SRGB_BLOCK) {
+    return false;
+  }
+  uint32_t mipLevels = header[7];
+  if (header[2] == 0 || header[3] == 0 || mipLevels == 0 || mipLevels > TEXTURE_COOK_MAX_MIPS ||
+      fileSize < 80 + (size_t)mipLevels * 24) {
+    return false;
+  }
+
+  // source hash from the key/value data
+  uint64_t storedHash = 0;
+  uint32_t kvdOffset = index[2], kvdLength = index[3];
+  size_t keyLen = sizeof(KTX2_KEY_SOURCE_HASH);
+  if ((size_t)kvdOffset + kvdLength <= fileSize && kvdLength >= 4 + keyLen + sizeof(uint64_t) &&
+      memcmp(file + kvdOffset + 4, KTX2_KEY_SOURCE_HASH, keyLen) == 0) {
+    memcpy(&storedHash, file + kvdOffset + 4 + keyLen, sizeof(uint64_t));
+  }
+  if (sourceHash && storedHash != sourceHash) return false;
+
+  cooked->format = format;
+  cooked->width = header[2];
+  cooked->height = header[3];
+  cooked->mipLevels = mipLevels;
+  for (uint32_t i = 0; i < mipLevels; i++) {
+    uint64_t entry[3];
+    memcpy(entry, file + 80 + i * 24, sizeof(entry));
+    uint32_t w = cooked->width >> i ? cooked->width >> i : 1;
+    uint32_t h = cooked->height >> i ? cooked->height >> i : 1;
+    if (entry[0] % cook_block_bytes(format) != 0 || entry[1] != cook_level_size(format, w, h) ||
+        entry[0] + entry[1] > fileSize) {
+      memset(cooked, 0, sizeof(CookedTexture));
+      return false;
+    }
+    cooked->levelOffset[i] = entry[0];
+    cooked->levelSize[i] = entry[1];
+  }
+  cooked->file = file;
+  cooked->fileSize = fileSize;
+  cooked->sourceHash = storedHash;
+  return true;
+}
+
+bool flecs_texture_cooked_write(const char *path, const CookedTexture *cooked) {
+  if (!path || !cooked || !cooked->file) return false;
+
+  // a worker reading the cache never sees a half written file
+  return flecs_write_file_atomic(path, cooked->file, cooked->fileSize);
+}
+
+void flecs_texture_cooked_free(CookedTexture *cooked) {
+  if (!cooked) return;
+  free(cooked->file);
+  memset(cooked, 0, sizeof(CookedTexture));
+}
+
+void flecs_texture_cache_path(uint64_t sourceHash, TextureCookFormat format, char *out, size_t outSize) {
+  static const char *names[] = {"auto", "bc1", "bc3", "bc7"};
+  snprintf(out, outSize, "%s/%016llx_%s_v%d.ktx2", TEXTURE_CACHE_DIR, (unsigned long long)sourceHash,
+           names[format <= TEXTURE_COOK_BC7 ? format : 0], TEXTURE_COOK_VERSION);
+}
+
+bool flecs_texture_load_cooked(const char *path, TextureCookFormat format, CookedTexture *cooked) {
+  memset(cooked, 0, sizeof(CookedTexture));
+
+  // asset_cooker output in the pack, no source read at all
+  char precooked[VFS_PACK_NAME_MAX];
+  if (snprintf(precooked, sizeof(precooked), "%s%s", path, TEXTURE_COOKED_EXT) < (int)sizeof(precooked)) {
+    size_t precookedSize = 0;
+    uint8_t *file = flecs_vfs_exists(precooked) ? flecs_vfs_read_all(precooked, &precookedSize) : NULL;
+    if (file && flecs_texture_cooked_parse(file, precookedSize, 0, cooked)) {
+      if (format == TEXTURE_COOK_AUTO || cooked->format == flecs_texture_cook_vk_format(format)) {
+        ecs_log(1, "[cooker] pre-cooked %s", precooked);
+        return true;
+      }
+      flecs_texture_cooked_free(cooked); // other format, cook from the source
+    } else {
+      free(file);
+    }
+  }
+
+  VfsView source;
+  if (!flecs_vfs_open_view(path, &source)) return false;
+  uint64_t hash = flecs_texture_source_hash(source.data, source.size);
+
+  char cachePath[256];
+  flecs_texture_cache_path(hash, format, cachePath, sizeof(cachePath));
+  size_t cacheSize = 0;
+  uint8_t *cache = flecs_vfs_read_all(cachePath, &cacheSize);
+  if (cache) {
+    if (flecs_texture_cooked_parse(cache, cacheSize, hash, cooked)) {
+      flecs_vfs_close_view(&source);
+      ecs_log(1, "[cooker] cache hit %s", path);
+      return true;
+    }
+    ecs_log(1, "[cooker] stale cache %s", cachePath);
+    free(cache);
+  }
+
+  int width, height, channels;
+  uint8_t *pixels = stbi_load_from_memory(source.data, (int)source.size, &width, &height, &channels, STBI_rgb_alpha);
+  flecs_vfs_close_view(&source);
+  if (!pixels) return false;
+
+  // one encoder thread: this runs on the asset job workers, which already
+  // cook several textures in parallel
+  Uint64 start = SDL_GetTicks();
+  bool ok = flecs_texture_cook(pixels, (uint32_t)width, (uint32_t)height, format, hash, 1, cooked);
+  stbi_image_free(pixels);
+  if (!ok) return false;
+  ecs_log(1, "[cooker] cooked %s %dx%d %u mips in %llu ms", path, width, height, cooked->mipLevels,
+          (unsigned long long)(SDL_GetTicks() - start));
+
+  // cache miss is not an error, next launch just cooks again
+  SDL_CreateDirectory(TEXTURE_CACHE_DIR);
+  if (!flecs_texture_cooked_write(cachePath, cooked)) {
+    ecs_log(1, "[cooker] failed to write %s", cachePath);
+  }
+  return true;
+}
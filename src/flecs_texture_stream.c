@@ -0,0 +1,751 @@
+// texture streaming
+// residency manager, the gpu image of a texture only holds the levels
+// render systems asked for through flecs_texture_stream_feedback, inside the
+// VRAM budget. Changing residency makes a new image: levels the old one has
+// are copied on the gpu, finer ones come from the cpu copy. The copies of a
+// frame go into one fenced command buffer, nothing waits for the queue.
+
+#include "flecs_texture_stream.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "flecs_utils.h"
+#include "flecs_sdl.h"
+#include "flecs_vulkan.h"
+#include "flecs_memory.h"
+
+static void createBuffer(VulkanContext *v_ctx, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer *buffer, VkDeviceMemory *memory) {
+  VkBufferCreateInfo bufferInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+  bufferInfo.size = size;
+  bufferInfo.usage = usage;
+  bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+  if (vkCreateBuffer(v_ctx->device, &bufferInfo, NULL, buffer) != VK_SUCCESS) {
+    ecs_err("Failed to create buffer");
+    return;
+  }
+
+  VkMemoryRequirements memReqs;
+  vkGetBufferMemoryRequirements(v_ctx->device, *buffer, &memReqs);
+
+  VkMemoryAllocateInfo allocInfo = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+  allocInfo.allocationSize = memReqs.size;
+  VkPhysicalDeviceMemoryProperties memProps;
+  vkGetPhysicalDeviceMemoryProperties(v_ctx->physicalDevice, &memProps);
+  for (uint32_t i = 0; i < memProps.memoryTypeCount; i++) {
+    if (memReqs.memoryTypeBits & (1 << i) && (memProps.memoryTypes[i].propertyFlags & properties) == properties) {
+      allocInfo.memoryTypeIndex = i;
+      break;
+    }
+  }
+
+  if (vkAllocateMemory(v_ctx->device, &allocInfo, NULL, memory) != VK_SUCCESS) {
+    ecs_err("Failed to allocate buffer memory");
+    return;
+  }
+
+  vkBindBufferMemory(v_ctx->device, *buffer, *memory, 0);
+}
+
+static uint32_t levelExtent(uint32_t size, uint32_t mip) {
+  size >>= mip;
+  return size ? size : 1;
+}
+
+// bytes the levels mip..end take, planning estimate (allocations round up)
+static VkDeviceSize residentEstimate(const StreamedTexture *tex, uint32_t mip) {
+  VkDeviceSize total = 0;
+  for (uint32_t i = mip; i < tex->mipLevels; i++) total += tex->levelSize[i];
+  return total;
+}
+
+static void destroyResident(VulkanContext *v_ctx, TextureStreamContext *ctx, StreamedTexture *tex) {
+  if (tex->view != VK_NULL_HANDLE) vkDestroyImageView(v_ctx->device, tex->view, NULL);
+  if (tex->memory != VK_NULL_HANDLE) vkFreeMemory(v_ctx->device, tex->memory, NULL);
+  if (tex->image != VK_NULL_HANDLE) vkDestroyImage(v_ctx->device, tex->image, NULL);
+  tex->view = VK_NULL_HANDLE;
+  tex->memory = VK_NULL_HANDLE;
+  tex->image = VK_NULL_HANDLE;
+  ctx->residentBytes -= tex->residentBytes < ctx->residentBytes ? tex->residentBytes : ctx->residentBytes;
+  tex->residentBytes = 0;
+}
+
+// command buffer of the current upload batch, begun on first use. The slot
+// was submitted TEXTURE_STREAM_UPLOAD_SLOTS batches ago, its fence is
+// normally long signaled
+static VkCommandBuffer uploadBegin(VulkanContext *v_ctx, TextureStreamContext *ctx) {
+  uint32_t slot = ctx->uploadSlot;
+  if (ctx->uploadRecording) return ctx->uploadCmd[slot];
+
+  if (ctx->uploadCmd[slot] == VK_NULL_HANDLE) {
+    VkCommandBufferAllocateInfo cmdAllocInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+    cmdAllocInfo.commandPool = v_ctx->commandPool;
+    cmdAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    cmdAllocInfo.commandBufferCount = 1;
+    if (vkAllocateCommandBuffers(v_ctx->device, &cmdAllocInfo, &ctx->uploadCmd[slot]) != VK_SUCCESS) {
+      ctx->uploadCmd[slot] = VK_NULL_HANDLE;
+      ecs_err("[texture_stream] failed to allocate upload command buffer");
+      return VK_NULL_HANDLE;
+    }
+  }
+  if (ctx->uploadFence[slot] == VK_NULL_HANDLE) {
+    VkFenceCreateInfo fenceInfo = {VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+    if (vkCreateFence(v_ctx->device, &fenceInfo, NULL, &ctx->uploadFence[slot]) != VK_SUCCESS) {
+      ctx->uploadFence[slot] = VK_NULL_HANDLE;
+      ecs_err("[texture_stream] failed to create upload fence");
+      return VK_NULL_HANDLE;
+    }
+  }
+
+  vkWaitForFences(v_ctx->device, 1, &ctx->uploadFence[slot], VK_TRUE, UINT64_MAX);
+  VkCommandBufferBeginInfo beginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+  beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  if (vkBeginCommandBuffer(ctx->uploadCmd[slot], &beginInfo) != VK_SUCCESS) {
+    ecs_err("[texture_stream] failed to begin upload command buffer");
+    return VK_NULL_HANDLE;
+  }
+  ctx->uploadRecording = true;
+  return ctx->uploadCmd[slot];
+}
+
+// submit the batch ahead of the frame's render submit, same queue: the frame
+// sees the new images, and its fence covers the batch for deferred destroys
+static void uploadSubmit(VulkanContext *v_ctx, TextureStreamContext *ctx) {
+  if (!ctx->uploadRecording) return;
+  uint32_t slot = ctx->uploadSlot;
+  ctx->uploadRecording = false;
+  ctx->uploadSlot = (slot + 1) % TEXTURE_STREAM_UPLOAD_SLOTS;
+
+  VkResult result = vkEndCommandBuffer(ctx->uploadCmd[slot]);
+  if (result == VK_SUCCESS) {
+    vkResetFences(v_ctx->device, 1, &ctx->uploadFence[slot]);
+    VkSubmitInfo submitInfo = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &ctx->uploadCmd[slot];
+    result = vkQueueSubmit(v_ctx->graphicsQueue, 1, &submitInfo, ctx->uploadFence[slot]);
+  }
+  if (result != VK_SUCCESS) {
+    ecs_err("[texture_stream] upload submit failed (VkResult: %d)", result);
+    // unsignaled fence would block the slot forever, a new one starts signaled
+    vkDestroyFence(v_ctx->device, ctx->uploadFence[slot], NULL);
+    ctx->uploadFence[slot] = VK_NULL_HANDLE;
+  }
+}
+
+// New image holding levels mip..end. Levels the old image holds too are
+// copied image to image (reuse, not after a reload changed the pixels), the
+// rest come from the cpu copy through one staging buffer. Recorded into the
+// upload batch; the old image, its memory and the staging buffer are retired
+// through flecs_vulkan_defer_destroy. Consumers see the new view through
+// generation.
+static bool makeResident(VulkanContext *v_ctx, TextureStreamContext *ctx, StreamedTexture *tex, uint32_t mip, bool reuse) {
+  if (!tex->data || mip >= tex->mipLevels || mip == tex->residentMip) return tex->data && mip == tex->residentMip;
+
+  uint32_t levels = tex->mipLevels - mip;
+  // levels mip..firstKept-1 are uploaded, firstKept..end copied from the old image
+  bool keepOld = reuse && tex->image != VK_NULL_HANDLE && tex->residentMip < tex->mipLevels;
+  uint32_t firstKept = keepOld ? (tex->residentMip > mip ? tex->residentMip : mip) : tex->mipLevels;
+  uint32_t uploadLevels = firstKept - mip;
+
+  VkBufferImageCopy regions[TEXTURE_STREAM_MAX_MIPS] = {0};
+  VkDeviceSize stagingSize = 0;
+  for (uint32_t i = 0; i < uploadLevels; i++) {
+    regions[i].bufferOffset = stagingSize;
+    regions[i].imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    regions[i].imageSubresource.mipLevel = i;
+    regions[i].imageSubresource.layerCount = 1;
+    regions[i].imageExtent.width = levelExtent(tex->width, mip + i);
+    regions[i].imageExtent.height = levelExtent(tex->height, mip + i);
+    regions[i].imageExtent.depth = 1;
+    stagingSize += tex->levelSize[mip + i];
+  }
+
+  VkBuffer stagingBuffer = VK_NULL_HANDLE;
+  VkDeviceMemory stagingMemory = VK_NULL_HANDLE;
+  if (uploadLevels) {
+    createBuffer(v_ctx, stagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &stagingBuffer, &stagingMemory);
+    uint8_t *mapped = NULL;
+    if (!stagingMemory || vkMapMemory(v_ctx->device, stagingMemory, 0, stagingSize, 0, (void **)&mapped) != VK_SUCCESS) {
+      ecs_err("[texture_stream] failed to map staging buffer");
+      if (stagingBuffer) vkDestroyBuffer(v_ctx->device, stagingBuffer, NULL);
+      if (stagingMemory) vkFreeMemory(v_ctx->device, stagingMemory, NULL);
+      return false;
+    }
+    for (uint32_t i = 0; i < uploadLevels; i++) {
+      memcpy(mapped + regions[i].bufferOffset, tex->data + tex->levelOffset[mip + i], (size_t)tex->levelSize[mip + i]);
+    }
+    vkUnmapMemory(v_ctx->device, stagingMemory);
+  }
+
+  VkImage image = VK_NULL_HANDLE;
+  VkDeviceMemory memory = VK_NULL_HANDLE;
+  VkImageView view = VK_NULL_HANDLE;
+  VkMemoryRequirements memReqs = {0};
+
+  VkImageCreateInfo imageInfo = {VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+  imageInfo.imageType = VK_IMAGE_TYPE_2D;
+  imageInfo.format = tex->format;
+  imageInfo.extent.width = levelExtent(tex->width, mip);
+  imageInfo.extent.height = levelExtent(tex->height, mip);
+  imageInfo.extent.depth = 1;
+  imageInfo.mipLevels = levels;
+  imageInfo.arrayLayers = 1;
+  imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+  imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+  // transfer src: the next residency change copies from it
+  imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+  imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+  bool ok = vkCreateImage(v_ctx->device, &imageInfo, NULL, &image) == VK_SUCCESS;
+  if (ok) {
+    vkGetImageMemoryRequirements(v_ctx->device, image, &memReqs);
+    VkMemoryAllocateInfo allocInfo = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+    allocInfo.allocationSize = memReqs.size;
+    VkPhysicalDeviceMemoryProperties memProps;
+    vkGetPhysicalDeviceMemoryProperties(v_ctx->physicalDevice, &memProps);
+    for (uint32_t i = 0; i < memProps.memoryTypeCount; i++) {
+      if ((memReqs.memoryTypeBits & (1 << i)) && (memProps.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)) {
+        allocInfo.memoryTypeIndex = i;
+        break;
+      }
+    }
+    ok = vkAllocateMemory(v_ctx->device, &allocInfo, NULL, &memory) == VK_SUCCESS;
+    if (ok) vkBindImageMemory(v_ctx->device, image, memory, 0);
+  }
+  if (ok) {
+    VkImageViewCreateInfo viewInfo = {VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
+    viewInfo.image = image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = tex->format;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.levelCount = levels;
+    viewInfo.subresourceRange.layerCount = 1;
+    ok = vkCreateImageView(v_ctx->device, &viewInfo, NULL, &view) == VK_SUCCESS;
+  }
+  VkCommandBuffer commandBuffer = ok ? uploadBegin(v_ctx, ctx) : VK_NULL_HANDLE;
+
+  if (!commandBuffer) {
+    ecs_err("[texture_stream] failed to make %s mip %u resident", tex->path, mip);
+    if (view != VK_NULL_HANDLE) vkDestroyImageView(v_ctx->device, view, NULL);
+    if (memory != VK_NULL_HANDLE) vkFreeMemory(v_ctx->device, memory, NULL);
+    if (image != VK_NULL_HANDLE) vkDestroyImage(v_ctx->device, image, NULL);
+    if (stagingBuffer) vkDestroyBuffer(v_ctx->device, stagingBuffer, NULL);
+    if (stagingMemory) vkFreeMemory(v_ctx->device, stagingMemory, NULL);
+    return false;
+  }
+
+  // new image to transfer dst; kept levels of the old one to transfer src
+  // once the frame in flight is done sampling them
+  VkImageMemoryBarrier barriers[2] = {{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER}, {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER}};
+  barriers[0].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  barriers[0].newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+  barriers[0].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barriers[0].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barriers[0].image = image;
+  barriers[0].subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  barriers[0].subresourceRange.levelCount = levels;
+  barriers[0].subresourceRange.layerCount = 1;
+  barriers[0].srcAccessMask = 0;
+  barriers[0].dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  uint32_t keptLevels = tex->mipLevels - firstKept;
+  if (keptLevels) {
+    barriers[1] = barriers[0];
+    barriers[1].oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barriers[1].newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    barriers[1].image = tex->image;
+    barriers[1].subresourceRange.baseMipLevel = firstKept - tex->residentMip;
+    barriers[1].subresourceRange.levelCount = keptLevels;
+    barriers[1].srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    barriers[1].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+  }
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, NULL, 0, NULL, keptLevels ? 2 : 1, barriers);
+
+  if (uploadLevels) {
+    vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, uploadLevels, regions);
+  }
+  if (keptLevels) {
+    VkImageCopy copies[TEXTURE_STREAM_MAX_MIPS] = {0};
+    for (uint32_t i = 0; i < keptLevels; i++) {
+      uint32_t level = firstKept + i;
+      copies[i].srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+      copies[i].srcSubresource.mipLevel = level - tex->residentMip;
+      copies[i].srcSubresource.layerCount = 1;
+      copies[i].dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+      copies[i].dstSubresource.mipLevel = level - mip;
+      copies[i].dstSubresource.layerCount = 1;
+      copies[i].extent.width = levelExtent(tex->width, level);
+      copies[i].extent.height = levelExtent(tex->height, level);
+      copies[i].extent.depth = 1;
+    }
+    vkCmdCopyImage(commandBuffer, tex->image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, keptLevels, copies);
+  }
+
+  // old image back to the layout its descriptors expect, until they move on
+  barriers[0].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+  barriers[0].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+  barriers[0].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  barriers[0].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+  barriers[1].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+  barriers[1].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+  barriers[1].srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+  barriers[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, NULL, 0, NULL, keptLevels ? 2 : 1, barriers);
+
+  // gone once the frame submitted after this batch is done
+  flecs_vulkan_defer_destroy(v_ctx, VK_OBJECT_TYPE_BUFFER, (uint64_t)stagingBuffer);
+  flecs_vulkan_defer_destroy(v_ctx, VK_OBJECT_TYPE_DEVICE_MEMORY, (uint64_t)stagingMemory);
+  flecs_vulkan_defer_destroy(v_ctx, VK_OBJECT_TYPE_IMAGE_VIEW, (uint64_t)tex->view);
+  flecs_vulkan_defer_destroy(v_ctx, VK_OBJECT_TYPE_IMAGE, (uint64_t)tex->image);
+  flecs_vulkan_defer_destroy(v_ctx, VK_OBJECT_TYPE_DEVICE_MEMORY, (uint64_t)tex->memory);
+  ctx->residentBytes -= tex->residentBytes < ctx->residentBytes ? tex->residentBytes : ctx->residentBytes;
+
+  if (mip < tex->residentMip) ctx->streamedLevels += tex->residentMip - mip;
+  else ctx->evictedLevels += mip - tex->residentMip;
+  tex->image = image;
+  tex->memory = memory;
+  tex->view = view;
+  tex->residentMip = mip;
+  tex->residentBytes = memReqs.size;
+  tex->generation++;
+  ctx->residentBytes += memReqs.size;
+  return true;
+}
+
+// VK_EXT_memory_budget: what the device-local heap has left for textures once
+// everything else (swapchain, buffers, other apps) is taken out
+static void refreshBudget(VulkanContext *v_ctx, TextureStreamContext *ctx) {
+  VkDeviceSize budget = ctx->budgetBytes;
+  if (v_ctx->memoryBudget) {
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProps = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT};
+    VkPhysicalDeviceMemoryProperties2 memProps = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2};
+    memProps.pNext = &budgetProps;
+    vkGetPhysicalDeviceMemoryProperties2(v_ctx->physicalDevice, &memProps);
+
+    uint32_t heap = UINT32_MAX;
+    for (uint32_t i = 0; i < memProps.memoryProperties.memoryHeapCount; i++) {
+      if (!(memProps.memoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)) continue;
+      if (heap == UINT32_MAX || budgetProps.heapBudget[i] > budgetProps.heapBudget[heap]) heap = i;
+    }
+    if (heap != UINT32_MAX) {
+      VkDeviceSize usage = budgetProps.heapUsage[heap];
+      VkDeviceSize other = usage > ctx->residentBytes ? usage - ctx->residentBytes : 0;
+      VkDeviceSize share = (VkDeviceSize)((double)budgetProps.heapBudget[heap] * ctx->heapBudgetFraction);
+      VkDeviceSize device = share > other ? share - other : 0;
+      if (!budget || device < budget) budget = device;
+    }
+  }
+  if (budget != ctx->effectiveBudget) {
+    ecs_log(1, "[texture_stream] budget %llu MB (resident %llu MB)", (unsigned long long)(budget >> 20), (unsigned long long)(ctx->residentBytes >> 20));
+  }
+  ctx->effectiveBudget = budget;
+}
+
+//===============================================
+// loading
+//===============================================
+
+// main thread, takes the cooked container or builds the RGBA8 chain, then
+// puts the tail mips on the gpu so the texture is usable right away
+static bool TextureStreamStore(ecs_world_t *world, ecs_entity_t asset, AssetResult *result) {
+  VulkanContext *v_ctx = ecs_singleton_ensure(world, VulkanContext);
+  TextureStreamContext *ctx = ecs_singleton_ensure(world, TextureStreamContext);
+  if (!v_ctx || !v_ctx->device || !ctx) return false;
+  ecs_entity_t e = ecs_get_target(world, asset, EcsChildOf, 0);
+  StreamedTexture *tex = e ? ecs_get_mut(world, e, StreamedTexture) : NULL;
+  if (!tex) return false;
+
+  // identical pixels under another path: sample that texture's image. One
+  // with an image of its own keeps it, other textures may alias it.
+  ecs_entity_t same = tex->data ? 0 : flecs_asset_registry_find_content(world, ASSET_KIND_STREAMED_TEXTURE, result->contentHash);
+  if (same == e) same = 0;
+  if (same) {
+    const StreamedTexture *other = ecs_get(world, same, StreamedTexture);
+    if (!other || other->alias) same = 0;
+  }
+  if (tex->alias && tex->alias != same) {
+    // hot reload gave it pixels of its own
+    ecs_entity_t previousAlias = tex->alias;
+    tex->alias = 0;
+    flecs_asset_release(world, e, previousAlias);
+    tex = ecs_get_mut(world, e, StreamedTexture);
+  }
+  flecs_asset_registry_set_content(world, e, result->contentHash);
+  if (same) {
+    if (tex->alias == same) return true;
+    tex->alias = same;
+    ecs_log(1, "[texture_stream] %s shares the image of an identical texture", tex->path);
+    flecs_asset_use(world, e, same);
+    return true;
+  }
+
+  // hot reload: the old image stays bound until makeResident swaps in the new tail
+  uint8_t *previous = tex->data;
+  tex->data = NULL;
+
+  if (result->cooked.file) {
+    CookedTexture *cooked = &result->cooked;
+    tex->data = cooked->file;
+    tex->format = cooked->format;
+    tex->width = cooked->width;
+    tex->height = cooked->height;
+    tex->mipLevels = cooked->mipLevels;
+    for (uint32_t i = 0; i < cooked->mipLevels; i++) {
+      tex->levelOffset[i] = cooked->levelOffset[i];
+      tex->levelSize[i] = cooked->levelSize[i];
+    }
+    cooked->file = NULL;
+  } else if (result->pixels) {
+    uint32_t mipLevels = calcMipLevels((uint32_t)result->width, (uint32_t)result->height);
+    if (mipLevels > TEXTURE_STREAM_MAX_MIPS) mipLevels = TEXTURE_STREAM_MAX_MIPS;
+    VkBufferImageCopy regions[TEXTURE_STREAM_MAX_MIPS];
+    size_t total = buildMipChainCPU(result->pixels, (uint32_t)result->width, (uint32_t)result->height, 4, true, mipLevels, &tex->data, regions);
+    if (!tex->data) {
+      tex->data = previous;
+      return false;
+    }
+    tex->format = VK_FORMAT_R8G8B8A8_SRGB;
+    tex->width = (uint32_t)result->width;
+    tex->height = (uint32_t)result->height;
+    tex->mipLevels = mipLevels;
+    for (uint32_t i = 0; i < mipLevels; i++) {
+      tex->levelOffset[i] = regions[i].bufferOffset;
+      tex->levelSize[i] = (i + 1 < mipLevels ? regions[i + 1].bufferOffset : total) - regions[i].bufferOffset;
+    }
+  } else {
+    tex->data = previous;
+    return false;
+  }
+  free(previous);
+
+  tex->tailMip = 0;
+  while (tex->tailMip + 1 < tex->mipLevels &&
+         (levelExtent(tex->width, tex->tailMip) > TEXTURE_STREAM_TAIL_SIZE || levelExtent(tex->height, tex->tailMip) > TEXTURE_STREAM_TAIL_SIZE)) {
+    tex->tailMip++;
+  }
+  tex->residentMip = tex->mipLevels;
+  tex->requestedMip = tex->tailMip;
+  if (tex->sampler != VK_NULL_HANDLE) {
+    // reload: the old image holds the old pixels, nothing to copy from it
+    bool resident = makeResident(v_ctx, ctx, tex, tex->tailMip, false);
+    uploadSubmit(v_ctx, ctx);
+    if (!resident) return false;
+    ecs_log(1, "[texture_stream] reloaded %s %ux%u", tex->path, tex->width, tex->height);
+    return true;
+  }
+
+  VkSamplerCreateInfo samplerInfo = {VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO};
+  samplerInfo.magFilter = VK_FILTER_LINEAR;
+  samplerInfo.minFilter = VK_FILTER_LINEAR;
+  samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+  samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+  samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+  samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+  samplerInfo.minLod = 0.0f;
+  samplerInfo.maxLod = VK_LOD_CLAMP_NONE; // clamped by the view to what is resident
+  if (vkCreateSampler(v_ctx->device, &samplerInfo, NULL, &tex->sampler) != VK_SUCCESS) {
+    ecs_err("[texture_stream] failed to create sampler for %s", tex->path);
+    return false;
+  }
+
+  // submitted right away, the store may run after this frame's stream system
+  bool resident = makeResident(v_ctx, ctx, tex, tex->tailMip, false);
+  uploadSubmit(v_ctx, ctx);
+  if (!resident) return false;
+  ecs_log(1, "[texture_stream] %s %ux%u, %u mips, tail from mip %u resident", tex->path, tex->width, tex->height, tex->mipLevels, tex->tailMip);
+  return true;
+}
+
+// TextureStreamContext for load / feedback (called per texture per frame),
+// bound in module init
+static ecs_ref_t texture_stream_ref;
+
+ecs_entity_t flecs_texture_stream_load(ecs_world_t *world, const char *path) {
+  TextureStreamContext *ctx = ecs_ref_get(world, &texture_stream_ref, TextureStreamContext);
+  if (!ctx || !path) return 0;
+
+  StreamedTexture tex = {0};
+  if (!flecs_asset_normalize_path(path, tex.path, sizeof(tex.path))) return 0;
+  tex.lastUsedFrame = ctx->frame;
+
+  ecs_entity_t e = ecs_new(world);
+  tex.asset = flecs_asset_load(world, &(AssetLoadDesc){
+    .path = tex.path,
+    .type = ASSET_TYPE_TEXTURE,
+    .upload = TextureStreamStore
+  });
+  if (tex.asset) ecs_add_pair(world, tex.asset, EcsChildOf, e);
+  ecs_set_id(world, e, ecs_id(StreamedTexture), sizeof(StreamedTexture), &tex);
+  flecs_asset_registry_add(world, e, ASSET_KIND_STREAMED_TEXTURE, tex.path, 0);
+  return e;
+}
+
+ecs_entity_t flecs_texture_stream_acquire(ecs_world_t *world, ecs_entity_t owner, const char *path) {
+  ecs_entity_t e = flecs_asset_registry_find(world, ASSET_KIND_STREAMED_TEXTURE, path, 0);
+  if (!e) e = flecs_texture_stream_load(world, path);
+  flecs_asset_use(world, owner, e);
+  return e;
+}
+
+const StreamedTexture *flecs_texture_stream_get(ecs_world_t *world, ecs_entity_t texture) {
+  const StreamedTexture *tex = texture ? ecs_get(world, texture, StreamedTexture) : NULL;
+  if (tex && tex->alias) tex = ecs_get(world, tex->alias, StreamedTexture);
+  return tex && tex->view != VK_NULL_HANDLE ? tex : NULL;
+}
+
+void flecs_texture_stream_feedback(ecs_world_t *world, ecs_entity_t texture, float screenPixels) {
+  TextureStreamContext *ctx = ecs_ref_get(world, &texture_stream_ref, TextureStreamContext);
+  StreamedTexture *tex = ecs_get_mut(world, texture, StreamedTexture);
+  if (tex && tex->alias) tex = ecs_get_mut(world, tex->alias, StreamedTexture);
+  if (!ctx || !tex) return;
+
+  uint32_t mip = tex->tailMip;
+  if (tex->mipLevels && screenPixels > 0.0f) {
+    // one texel per pixel: the level whose longer side matches the footprint
+    float longest = (float)(tex->width > tex->height ? tex->width : tex->height);
+    float lod = log2f(longest / screenPixels);
+    mip = lod <= 0.0f ? 0 : (uint32_t)lod;
+    if (mip > tex->tailMip) mip = tex->tailMip;
+  }
+  // several users in one frame, the closest one wins
+  if (tex->lastUsedFrame != ctx->frame || mip < tex->requestedMip) tex->requestedMip = mip;
+  tex->lastUsedFrame = ctx->frame;
+}
+
+//===============================================
+// systems
+//===============================================
+
+// least recently used texture that still has levels above its tail, never
+// one used this frame or the last (those are on screen). Works on the plan,
+// the images only change once the frame's plan is done
+static StreamedTexture *findEvictable(StreamedTexture **textures, int count, uint64_t frame) {
+  StreamedTexture *victim = NULL;
+  for (int i = 0; i < count; i++) {
+    StreamedTexture *tex = textures[i];
+    if (tex->plannedMip >= tex->tailMip || tex->lastUsedFrame + 1 >= frame) continue;
+    if (!victim || tex->lastUsedFrame < victim->lastUsedFrame) victim = tex;
+  }
+  return victim;
+}
+
+// VRAM of tex with levels mip..end, exact for the current image
+static VkDeviceSize plannedSize(const StreamedTexture *tex, uint32_t mip) {
+  return mip == tex->residentMip ? tex->residentBytes : residentEstimate(tex, mip);
+}
+
+// one level of the victim back, in the plan
+static void planEvict(StreamedTexture *victim, VkDeviceSize *plannedBytes) {
+  VkDeviceSize before = plannedSize(victim, victim->plannedMip);
+  VkDeviceSize after = plannedSize(victim, victim->plannedMip + 1);
+  *plannedBytes = *plannedBytes - before + after;
+  victim->plannedMip++;
+}
+
+static int compareUpgrade(const void *a, const void *b) {
+  const StreamedTexture *ta = *(StreamedTexture *const *)a;
+  const StreamedTexture *tb = *(StreamedTexture *const *)b;
+  // coarsest resident first, most of the visible gain per byte
+  if (ta->residentMip != tb->residentMip) return ta->residentMip > tb->residentMip ? -1 : 1;
+  return ta->lastUsedFrame > tb->lastUsedFrame ? -1 : ta->lastUsedFrame < tb->lastUsedFrame;
+}
+
+void TextureStreamSystem(ecs_iter_t *it) {
+  SDLContext *sdl_ctx = ecs_field(it, SDLContext, 0);
+  if (!sdl_ctx || sdl_ctx->hasError || sdl_ctx->isShutDown) return;
+  VulkanContext *v_ctx = ecs_field(it, VulkanContext, 1);
+  if (!v_ctx || !v_ctx->device) return;
+  TextureStreamContext *ctx = ecs_field(it, TextureStreamContext, 2);
+  if (!ctx) return;
+
+  ctx->frame++;
+  if (ctx->budgetRefreshFrames == 0 || ctx->frame % ctx->budgetRefreshFrames == 1) refreshBudget(v_ctx, ctx);
+
+  // this frame's candidates, frame arena (rewound at BeginRenderPhase)
+  int count = 0, capacity = 0;
+  StreamedTexture **textures = NULL;
+  ecs_iter_t tit = ecs_each(it->world, StreamedTexture);
+  while (ecs_each_next(&tit)) {
+    StreamedTexture *t = ecs_field(&tit, StreamedTexture, 0);
+    for (int i = 0; i < tit.count; i++) {
+      if (!t[i].data) continue; // still decoding
+      if (count == capacity) {
+        int grownCapacity = capacity ? capacity * 2 : 64;
+        StreamedTexture **grown = flecs_frame_realloc(textures, sizeof(StreamedTexture *) * capacity, sizeof(StreamedTexture *) * grownCapacity);
+        if (!grown) break;
+        textures = grown;
+        capacity = grownCapacity;
+      }
+      t[i].plannedMip = t[i].residentMip;
+      textures[count++] = &t[i];
+    }
+  }
+  if (!count) return;
+
+  // plan first: drops, evictions and upgrades only move plannedMip, so a
+  // texture evicted twice and upgraded once still gets a single new image
+  VkDeviceSize plannedBytes = ctx->residentBytes;
+
+  // drops first, they free memory for the upgrades below
+  int upgrades = 0;
+  for (int i = 0; i < count; i++) {
+    StreamedTexture *tex = textures[i];
+    uint32_t target = tex->residentMip;
+    if (tex->lastUsedFrame + 1 >= ctx->frame) {
+      target = tex->requestedMip;
+    } else if (ctx->frame - tex->lastUsedFrame > ctx->unusedFrames) {
+      target = tex->tailMip;
+    }
+    if (target > tex->tailMip) target = tex->tailMip;
+    if (target > tex->residentMip) {
+      plannedBytes = plannedBytes - tex->residentBytes + residentEstimate(tex, target);
+      tex->plannedMip = target;
+    } else if (target < tex->residentMip) {
+      // upgrade candidates to the front, the rest stay in the list as eviction victims
+      textures[i] = textures[upgrades];
+      textures[upgrades++] = tex;
+    }
+  }
+
+  // budget shrank (other apps, swapchain), give levels back in LRU order
+  while (ctx->effectiveBudget && plannedBytes > ctx->effectiveBudget) {
+    StreamedTexture *victim = findEvictable(textures, count, ctx->frame);
+    if (!victim) break;
+    planEvict(victim, &plannedBytes);
+  }
+
+  qsort(textures, upgrades, sizeof(StreamedTexture *), compareUpgrade);
+  uint32_t uploads = 0;
+  for (int i = 0; i < upgrades && uploads < ctx->maxUploadsPerFrame; i++) {
+    StreamedTexture *tex = textures[i];
+    uint32_t target = tex->requestedMip < tex->plannedMip ? tex->requestedMip : tex->plannedMip;
+    // make room, otherwise settle for a coarser level
+    while (target < tex->plannedMip && ctx->effectiveBudget) {
+      VkDeviceSize after = plannedBytes - plannedSize(tex, tex->plannedMip) + residentEstimate(tex, target);
+      if (after <= ctx->effectiveBudget) break;
+      StreamedTexture *victim = findEvictable(textures, count, ctx->frame);
+      if (victim && victim != tex) {
+        planEvict(victim, &plannedBytes);
+        continue;
+      }
+      target++;
+    }
+    if (target < tex->plannedMip) {
+      plannedBytes = plannedBytes - plannedSize(tex, tex->plannedMip) + residentEstimate(tex, target);
+      tex->plannedMip = target;
+      uploads++;
+    }
+  }
+
+  // apply: at most one new image per texture, all in one submit
+  for (int i = 0; i < count; i++) {
+    StreamedTexture *tex = textures[i];
+    if (tex->plannedMip != tex->residentMip) makeResident(v_ctx, ctx, tex, tex->plannedMip, true);
+  }
+  uploadSubmit(v_ctx, ctx);
+}
+
+void flecs_texture_stream_cleanup(ecs_world_t *world) {
+  VulkanContext *v_ctx = ecs_singleton_ensure(world, VulkanContext);
+  TextureStreamContext *ctx = ecs_singleton_ensure(world, TextureStreamContext);
+  if (!v_ctx || !v_ctx->device || !ctx) return;
+
+  ecs_log(1, "Texture stream cleanup starting...");
+  vkDeviceWaitIdle(v_ctx->device);
+
+  ecs_iter_t it = ecs_each(world, StreamedTexture);
+  while (ecs_each_next(&it)) {
+    StreamedTexture *textures = ecs_field(&it, StreamedTexture, 0);
+    for (int i = 0; i < it.count; i++) {
+      StreamedTexture *tex = &textures[i];
+      destroyResident(v_ctx, ctx, tex);
+      if (tex->sampler != VK_NULL_HANDLE) vkDestroySampler(v_ctx->device, tex->sampler, NULL);
+      tex->sampler = VK_NULL_HANDLE;
+      free(tex->data);
+      tex->data = NULL;
+      tex->residentMip = tex->mipLevels;
+    }
+  }
+
+  for (uint32_t i = 0; i < TEXTURE_STREAM_UPLOAD_SLOTS; i++) {
+    if (ctx->uploadCmd[i] != VK_NULL_HANDLE) vkFreeCommandBuffers(v_ctx->device, v_ctx->commandPool, 1, &ctx->uploadCmd[i]);
+    if (ctx->uploadFence[i] != VK_NULL_HANDLE) vkDestroyFence(v_ctx->device, ctx->uploadFence[i], NULL);
+    ctx->uploadCmd[i] = VK_NULL_HANDLE;
+    ctx->uploadFence[i] = VK_NULL_HANDLE;
+  }
+  ctx->uploadRecording = false;
+
+  ecs_log(1, "Texture stream cleanup completed");
+}
+
+// registry slot, marked cleaned by the cleanup observer
+static ModuleHandle texture_stream_module_handle = MODULE_HANDLE_NONE;
+
+void texture_stream_cleanup_event_system(ecs_iter_t *it) {
+  ecs_print(1, "[cleanup] texture_stream_cleanup_event_system");
+  flecs_texture_stream_cleanup(it->world);
+  module_set_state(it->world, texture_stream_module_handle, MODULE_STATE_CLEANED);
+}
+
+// last owner released it (asset registry) or the world goes away
+static void StreamedTextureRemove(ecs_iter_t *it) {
+  VulkanContext *v_ctx = ecs_get_mut(it->world, ecs_id(VulkanContext), VulkanContext);
+  TextureStreamContext *ctx = ecs_get_mut(it->world, ecs_id(TextureStreamContext), TextureStreamContext);
+  StreamedTexture *textures = ecs_field(it, StreamedTexture, 0);
+  for (int i = 0; i < it->count; i++) {
+    StreamedTexture *tex = &textures[i];
+    // the frame in flight may still sample it
+    if (v_ctx) {
+      flecs_vulkan_defer_destroy(v_ctx, VK_OBJECT_TYPE_IMAGE_VIEW, (uint64_t)tex->view);
+      flecs_vulkan_defer_destroy(v_ctx, VK_OBJECT_TYPE_IMAGE, (uint64_t)tex->image);
+      flecs_vulkan_defer_destroy(v_ctx, VK_OBJECT_TYPE_DEVICE_MEMORY, (uint64_t)tex->memory);
+      flecs_vulkan_defer_destroy(v_ctx, VK_OBJECT_TYPE_SAMPLER, (uint64_t)tex->sampler);
+    }
+    if (ctx) ctx->residentBytes -= tex->residentBytes < ctx->residentBytes ? tex->residentBytes : ctx->residentBytes;
+    free(tex->data);
+    memset(tex, 0, sizeof(*tex));
+  }
+}
+
+void texture_stream_register_components(ecs_world_t *world) {
+  ECS_COMPONENT_DEFINE(world, StreamedTexture);
+  ECS_COMPONENT_DEFINE(world, TextureStreamContext);
+
+  ecs_set_hooks(world, StreamedTexture, { .on_remove = StreamedTextureRemove });
+}
+
+void texture_stream_register_systems(ecs_world_t *world) {
+  ecs_observer(world, {
+    .query.terms = {{ EcsAny, .src.id = CleanUpModule }},
+    .events = { CleanUpEvent },
+    .callback = texture_stream_cleanup_event_system
+  });
+
+  ecs_system_init(world, &(ecs_system_desc_t){
+    .entity = ecs_entity(world, { .name = "TextureStreamSystem", .add = ecs_ids(ecs_dependson(GlobalPhases.LogicUpdatePhase)) }),
+    .query.terms = { ECS_SINGLETON_IN(SDLContext), ECS_SINGLETON_INOUT(VulkanContext), ECS_SINGLETON_INOUT(TextureStreamContext) },
+    .callback = TextureStreamSystem
+  });
+}
+
+void flecs_texture_stream_module_init(ecs_world_t *world) {
+  ecs_log(1, "Initializing texture stream module...");
+
+  texture_stream_register_components(world);
+
+  ecs_singleton_set(world, TextureStreamContext, {
+    .budgetBytes = TEXTURE_STREAM_DEFAULT_BUDGET,
+    .heapBudgetFraction = 0.5f,
+    .budgetRefreshFrames = 60,
+    .maxUploadsPerFrame = 2,
+    .unusedFrames = TEXTURE_STREAM_UNUSED_FRAMES
+  });
+  texture_stream_ref = ECS_SINGLETON_REF(world, TextureStreamContext);
+
+  texture_stream_module_handle = module_register(world, "texture_stream_module");
+
+  texture_stream_register_systems(world);
+  module_set_state(world, texture_stream_module_handle, MODULE_STATE_READY);
+
+  ecs_log(1, "Texture stream module initialized");
+}
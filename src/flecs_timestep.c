@@ -0,0 +1,139 @@
+#include "flecs_timestep.h"
+#include <cglm/cglm.h>
+#include <string.h>
+
+// pipeline order is system creation order, TimeStepStoreSystem is created
+// first so it runs before any simulation system of the tick
+static int timestep_system_compare(ecs_entity_t e1, const void *ptr1, ecs_entity_t e2, const void *ptr2) {
+  (void)ptr1;
+  (void)ptr2;
+  return (e1 > e2) - (e1 < e2);
+}
+
+// FixedUpdatePhase, first of every tick: current becomes previous
+void TimeStepStoreSystem(ecs_iter_t *it) {
+  const SimTransform *current = ecs_field(it, SimTransform, 0);
+  SimTransformPrev *previous = ecs_field(it, SimTransformPrev, 1);
+  memcpy(previous, current, sizeof(SimTransform) * (size_t)it->count);
+}
+
+// LogicUpdatePhase, once per frame: blend the last two ticks into
+// LocalTransform, TransformPhase turns it into WorldTransform
+void TimeStepInterpolateSystem(ecs_iter_t *it) {
+  const TimeStepContext *ts = ecs_field(it, TimeStepContext, 0);
+  const SimTransformPrev *previous = ecs_field(it, SimTransformPrev, 1);
+  const SimTransform *current = ecs_field(it, SimTransform, 2);
+  LocalTransform *out = ecs_field(it, LocalTransform, 3);
+  float alpha = ts->alpha;
+
+  for (int i = 0; i < it->count; i++) {
+    glm_vec3_lerp((float *)previous[i].position, (float *)current[i].position, alpha, out[i].position);
+    glm_vec3_lerp((float *)previous[i].scale, (float *)current[i].scale, alpha, out[i].scale);
+    glm_quat_slerp((float *)previous[i].rotation, (float *)current[i].rotation, alpha, out[i].rotation);
+  }
+}
+
+void timestep_register_components(ecs_world_t *world) {
+  ECS_COMPONENT_DEFINE(world, TimeStepContext);
+  ECS_COMPONENT_DEFINE(world, SimTransform);
+  ECS_COMPONENT_DEFINE(world, SimTransformPrev);
+}
+
+void timestep_register_systems(ecs_world_t *world) {
+  ecs_system_init(world, &(ecs_system_desc_t){
+    .entity = ecs_entity(world, { .name = "TimeStepStoreSystem", .add = ecs_ids(GlobalPhases.FixedUpdatePhase) }),
+    .query.terms = {
+      { ecs_id(SimTransform), .inout = EcsIn },
+      { ecs_id(SimTransformPrev), .inout = EcsOut }
+    },
+    .callback = TimeStepStoreSystem,
+    .multi_threaded = true
+  });
+
+  ecs_system_init(world, &(ecs_system_desc_t){
+    .entity = ecs_entity(world, { .name = "TimeStepInterpolateSystem", .add = ecs_ids(ecs_dependson(GlobalPhases.LogicUpdatePhase)) }),
+    .query.terms = {
+      ECS_SINGLETON_IN(TimeStepContext),
+      { ecs_id(SimTransformPrev), .inout = EcsIn },
+      { ecs_id(SimTransform), .inout = EcsIn },
+      { ecs_id(LocalTransform), .inout = EcsOut }
+    },
+    .callback = TimeStepInterpolateSystem,
+    .multi_threaded = true
+  });
+}
+
+// TimeStepContext for flecs_timestep_progress, bound in module init
+static ecs_ref_t timestep_ref;
+
+void flecs_timestep_module_init(ecs_world_t *world, float tickRate) {
+  ecs_log(1, "Initializing timestep module...");
+
+  timestep_register_components(world);
+
+  if (tickRate <= 0.0f) tickRate = TIMESTEP_DEFAULT_RATE;
+
+  // FixedUpdatePhase is a tag, not an EcsPhase, so the default pipeline
+  // (ecs_progress) never picks these systems up
+  ecs_entity_t pipeline = ecs_pipeline(world, {
+    .entity = ecs_entity(world, { .name = "FixedPipeline" }),
+    .query.terms = {
+      { .id = EcsSystem },
+      { .id = GlobalPhases.FixedUpdatePhase }
+    },
+    .query.order_by_callback = timestep_system_compare
+  });
+
+  ecs_singleton_set(world, TimeStepContext, {
+    .tickRate = tickRate,
+    .fixedDelta = 1.0f / tickRate,
+    .maxFrameDelta = TIMESTEP_MAX_FRAME_DELTA,
+    .maxTicksPerFrame = TIMESTEP_MAX_TICKS,
+    .fixedPipeline = pipeline
+  });
+  timestep_ref = ECS_SINGLETON_REF(world, TimeStepContext);
+
+  timestep_register_systems(world);
+
+  ecs_log(1, "Timestep module initialized (%.0f ticks/s)", tickRate);
+}
+
+bool flecs_timestep_progress(ecs_world_t *world, float frameDelta) {
+  TimeStepContext *ts = ecs_ref_get(world, &timestep_ref, TimeStepContext);
+  if (!ts) return ecs_progress(world, frameDelta);
+  if (frameDelta > ts->maxFrameDelta) frameDelta = ts->maxFrameDelta;
+  if (frameDelta < 0.0f) frameDelta = 0.0f;
+  ts->accumulator += frameDelta;
+
+  int32_t ticks = 0;
+  while (ts->accumulator >= ts->fixedDelta && ticks < ts->maxTicksPerFrame) {
+    ecs_entity_t pipeline = ts->fixedPipeline;
+    float fixedDelta = ts->fixedDelta;
+    ecs_run_pipeline(world, pipeline, fixedDelta);
+    // systems may have moved the singleton's table
+    ts = ecs_ref_get(world, &timestep_ref, TimeStepContext);
+    ts->accumulator -= fixedDelta;
+    ts->tick++;
+    ticks++;
+  }
+
+  // behind by more than the catch-up limit: drop the backlog instead of
+  // spiralling, the simulation runs slow for this frame
+  if (ts->accumulator >= ts->fixedDelta) {
+    uint64_t dropped = (uint64_t)(ts->accumulator / ts->fixedDelta);
+    ts->droppedTicks += dropped;
+    ts->accumulator -= (float)dropped * ts->fixedDelta;
+    ecs_dbg("[timestep] dropped %llu ticks", (unsigned long long)dropped);
+  }
+
+  ts->ticksThisFrame = ticks;
+  ts->alpha = ts->accumulator / ts->fixedDelta;
+
+  return ecs_progress(world, frameDelta);
+}
+
+void flecs_timestep_set_transform(ecs_world_t *world, ecs_entity_t entity, const SimTransform *transform) {
+  ecs_set_ptr(world, entity, SimTransform, transform);
+  ecs_set_ptr(world, entity, SimTransformPrev, transform);
+  flecs_transform_add(world, entity, transform);
+}
@@ -0,0 +1,144 @@
+#include "flecs_transform.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define TRANSFORM_SSE 1
+#endif
+
+// translation * rotation * scale
+static void transform_compose(const LocalTransform *local, mat4 out) {
+  glm_quat_mat4((float *)local->rotation, out);
+  glm_vec4_scale(out[0], local->scale[0], out[0]);
+  glm_vec4_scale(out[1], local->scale[1], out[1]);
+  glm_vec4_scale(out[2], local->scale[2], out[2]);
+  out[3][0] = local->position[0];
+  out[3][1] = local->position[1];
+  out[3][2] = local->position[2];
+  out[3][3] = 1.0f;
+}
+
+// world[i] = parent * world[i] over a table column. Every entity of a table
+// has the same parent, its columns stay in registers for the whole batch
+static void transform_mul_batch(const WorldTransform *parent, WorldTransform *world, int32_t count) {
+#ifdef TRANSFORM_SSE
+  __m128 p0 = _mm_loadu_ps(parent->matrix[0]);
+  __m128 p1 = _mm_loadu_ps(parent->matrix[1]);
+  __m128 p2 = _mm_loadu_ps(parent->matrix[2]);
+  __m128 p3 = _mm_loadu_ps(parent->matrix[3]);
+  for (int32_t i = 0; i < count; i++) {
+    vec4 *m = world[i].matrix;
+    for (int c = 0; c < 4; c++) {
+      __m128 col = _mm_loadu_ps(m[c]);
+      __m128 r = _mm_mul_ps(p0, _mm_shuffle_ps(col, col, _MM_SHUFFLE(0, 0, 0, 0)));
+      r = _mm_add_ps(r, _mm_mul_ps(p1, _mm_shuffle_ps(col, col, _MM_SHUFFLE(1, 1, 1, 1))));
+      r = _mm_add_ps(r, _mm_mul_ps(p2, _mm_shuffle_ps(col, col, _MM_SHUFFLE(2, 2, 2, 2))));
+      r = _mm_add_ps(r, _mm_mul_ps(p3, _mm_shuffle_ps(col, col, _MM_SHUFFLE(3, 3, 3, 3))));
+      _mm_storeu_ps(m[c], r);
+    }
+  }
+#else
+  for (int32_t i = 0; i < count; i++) {
+    glm_mat4_mul((vec4 *)parent->matrix, world[i].matrix, world[i].matrix);
+  }
+#endif
+}
+
+// TransformPhase, parents before children (cascade)
+void TransformPropagateSystem(ecs_iter_t *it) {
+  TransformContext *t_ctx = ecs_field(it, TransformContext, 0);
+  t_ctx->updatedCount = 0;
+  t_ctx->updatedTables = 0;
+  if (!t_ctx->query || !ecs_query_changed(t_ctx->query)) return;
+
+  ecs_iter_t qit = ecs_query_iter(it->world, t_ctx->query);
+  while (ecs_query_next(&qit)) {
+    // own LocalTransform and parent WorldTransform unchanged
+    if (!ecs_iter_changed(&qit)) {
+      ecs_iter_skip(&qit);
+      continue;
+    }
+    const LocalTransform *local = ecs_field(&qit, LocalTransform, 0);
+    WorldTransform *world = ecs_field(&qit, WorldTransform, 1);
+
+    for (int i = 0; i < qit.count; i++) {
+      transform_compose(&local[i], world[i].matrix);
+    }
+    if (ecs_field_is_set(&qit, 2)) {
+      transform_mul_batch(ecs_field(&qit, WorldTransform, 2), world, qit.count);
+    }
+    t_ctx->updatedCount += (uint32_t)qit.count;
+    t_ctx->updatedTables++;
+  }
+}
+
+void flecs_transform_cleanup(ecs_world_t *world) {
+  TransformContext *t_ctx = ecs_singleton_ensure(world, TransformContext);
+  if (!t_ctx) return;
+  if (t_ctx->query) {
+    ecs_query_fini(t_ctx->query);
+    t_ctx->query = NULL;
+  }
+}
+
+// registry slot, marked cleaned by the cleanup observer
+static ModuleHandle transform_module_handle = MODULE_HANDLE_NONE;
+
+void transform_cleanup_event_system(ecs_iter_t *it) {
+  ecs_print(1, "[cleanup] transform_cleanup_event_system");
+  flecs_transform_cleanup(it->world);
+  module_set_state(it->world, transform_module_handle, MODULE_STATE_CLEANED);
+}
+
+void transform_register_components(ecs_world_t *world) {
+  ECS_COMPONENT_DEFINE(world, LocalTransform);
+  ECS_COMPONENT_DEFINE(world, WorldTransform);
+  ECS_COMPONENT_DEFINE(world, TransformContext);
+}
+
+void transform_register_systems(ecs_world_t *world) {
+  ecs_observer(world, {
+    .query.terms = {{ EcsAny, .src.id = CleanUpModule }},
+    .events = { CleanUpEvent },
+    .callback = transform_cleanup_event_system
+  });
+
+  ecs_system_init(world, &(ecs_system_desc_t){
+    .entity = ecs_entity(world, { .name = "TransformPropagateSystem", .add = ecs_ids(ecs_dependson(GlobalPhases.TransformPhase)) }),
+    .query.terms = { ECS_SINGLETON_INOUT(TransformContext) },
+    .callback = TransformPropagateSystem
+  });
+}
+
+void flecs_transform_module_init(ecs_world_t *world) {
+  ecs_log(1, "Initializing transform module...");
+
+  transform_register_components(world);
+
+  ecs_singleton_set(world, TransformContext, {
+    .query = ecs_query(world, {
+      .terms = {
+        { ecs_id(LocalTransform), .inout = EcsIn },
+        { ecs_id(WorldTransform), .inout = EcsOut },
+        // parent's, breadth first, optional so roots match
+        { ecs_id(WorldTransform), .src.id = EcsCascade, .oper = EcsOptional, .inout = EcsIn }
+      },
+      .cache_kind = EcsQueryCacheAuto,
+      .flags = ECS_QUERY_DETECT_CHANGES
+    })
+  });
+
+  transform_module_handle = module_register(world, "transform_module");
+
+  transform_register_systems(world);
+  module_set_state(world, transform_module_handle, MODULE_STATE_READY);
+
+  ecs_log(1, "Transform module initialized");
+}
+
+void flecs_transform_add(ecs_world_t *world, ecs_entity_t entity, const LocalTransform *local) {
+  LocalTransform value = local ? *local : TRANSFORM_IDENTITY;
+  WorldTransform matrix;
+  transform_compose(&value, matrix.matrix); // valid before the first propagation, parent applied there
+  ecs_set_ptr(world, entity, LocalTransform, &value);
+  ecs_set_ptr(world, entity, WorldTransform, &matrix);
+}
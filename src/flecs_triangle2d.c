@@ -254,11 +254,11 @@ void TriangleModuleSetupSystem(ecs_iter_t *it) {
 void TriangleRenderBufferSystem(ecs_iter_t *it) {
     // WorldContext *ctx = ecs_get_ctx(it->world);
     // if (!ctx || ctx->hasError) return;
-    SDLContext *sdl_ctx = ecs_singleton_ensure(it->world, SDLContext);
+    SDLContext *sdl_ctx = ecs_field(it, SDLContext, 0);
     if (!sdl_ctx || sdl_ctx->hasError || sdl_ctx->isShutDown) return;
-    VulkanContext *v_ctx = ecs_singleton_ensure(it->world, VulkanContext);
+    VulkanContext *v_ctx = ecs_field(it, VulkanContext, 1);
     if (!v_ctx) return;
-    TriangleContext *tri_ctx = ecs_singleton_ensure(it->world, TriangleContext);
+    TriangleContext *tri_ctx = ecs_field(it, TriangleContext, 2);
     if (!tri_ctx) return;
 
     vkCmdBindPipeline(v_ctx->commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, tri_ctx->triGraphicsPipeline);
@@ -268,11 +268,14 @@ void TriangleRenderBufferSystem(ecs_iter_t *it) {
     vkCmdDrawIndexed(v_ctx->commandBuffer, 3, 1, 0, 0, 0); // 3 indices, 1 instance
 }
 
+// registry slot, marked cleaned by the cleanup observer
+static ModuleHandle triangle2d_module_handle = MODULE_HANDLE_NONE;
+
 void triangle2d_cleanup_event_system(ecs_iter_t *it){
   ecs_print(1,"[cleanup] triangle2d_cleanup_event_system");
   flecs_triangle2d_cleanup(it->world);
 
-  module_break_name(it, "triangle2d_module");
+  module_set_state(it->world, triangle2d_module_handle, MODULE_STATE_CLEANED);
 }
 
 void flecs_triangle2d_cleanup(ecs_world_t *world) {
@@ -333,6 +336,7 @@ void triangle2d_register_systems(ecs_world_t *world){
 
   ecs_system_init(world, &(ecs_system_desc_t){
       .entity = ecs_entity(world, { .name = "TriangleRenderBufferSystem", .add = ecs_ids(ecs_dependson(GlobalPhases.CMDBufferPhase)) }),
+      .query.terms = { ECS_SINGLETON_IN(SDLContext), ECS_SINGLETON_IN(VulkanContext), ECS_SINGLETON_IN(TriangleContext) },
       .callback = TriangleRenderBufferSystem
   });
 }
@@ -344,10 +348,10 @@ void flecs_triangle2d_module_init(ecs_world_t *world) {
 
   ecs_singleton_set(world, TriangleContext, {0});
 
-  ecs_entity_t e = ecs_new(world);
-  ecs_set(world, e, PluginModule, { .name = "triangle2d_module", .isCleanUp = false });
+  triangle2d_module_handle = module_register(world, "triangle2d_module");
 
   triangle2d_register_systems(world);
+  module_set_state(world, triangle2d_module_handle, MODULE_STATE_READY);
 
   ecs_log(1, "Triangle2d module initialized");
 }
\ No newline at end of file
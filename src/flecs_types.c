@@ -8,8 +8,11 @@ void flecs_phases_init(ecs_world_t *world, FlecsPhases *phases) {
   phases->LogicUpdatePhase = ecs_new_w_id(world, EcsPhase);
   ecs_add_pair(world, phases->LogicUpdatePhase, EcsDependsOn, EcsPreUpdate);
 
+  phases->TransformPhase = ecs_new_w_id(world, EcsPhase);
+  ecs_add_pair(world, phases->TransformPhase, EcsDependsOn, phases->LogicUpdatePhase);
+
   phases->BeginRenderPhase = ecs_new_w_id(world, EcsPhase);
-  ecs_add_pair(world, phases->BeginRenderPhase, EcsDependsOn, phases->LogicUpdatePhase);
+  ecs_add_pair(world, phases->BeginRenderPhase, EcsDependsOn, phases->TransformPhase);
 
   phases->BeginCMDBufferPhase = ecs_new_w_id(world, EcsPhase);
   ecs_add_pair(world, phases->BeginCMDBufferPhase, EcsDependsOn, phases->BeginRenderPhase);
@@ -29,6 +32,10 @@ void flecs_phases_init(ecs_world_t *world, FlecsPhases *phases) {
   phases->EndRenderPhase = ecs_new_w_id(world, EcsPhase);
   ecs_add_pair(world, phases->EndRenderPhase, EcsDependsOn, phases->EndCMDBufferPhase);
 
+  // Fixed tick systems, a tag instead of an EcsPhase: only the timestep
+  // pipeline runs them
+  phases->FixedUpdatePhase = ecs_entity(world, { .name = "FixedUpdatePhase" });
+
   // Setup phases (single flow, run once under EcsOnStart)
   phases->SetupPhase = ecs_new_w_id(world, EcsPhase);
   ecs_add_pair(world, phases->SetupPhase, EcsDependsOn, EcsOnStart);  // Start of setup chain
@@ -72,29 +79,22 @@ void flecs_phases_init(ecs_world_t *world, FlecsPhases *phases) {
 void flecs_shutdown_event_system(ecs_iter_t *it){
   ecs_print(1,"[module] flecs_shutdown_event_system");
 
+  ModuleContext *g_module = ecs_singleton_ensure(it->world, ModuleContext);
+  for (int i = 0; i < g_module->moduleCount; i++) {
+    PluginModule *p = &g_module->modules[i];
+    ecs_print(1,"Module Name : %s", p->name);
+    // LOADING: its init bailed before registering a cleanup observer
+    if (p->state == MODULE_STATE_LOADING) module_set_state(it->world, i, MODULE_STATE_CLEANED);
+    else if (p->state == MODULE_STATE_READY) p->state = MODULE_STATE_DRAINING;
+  }
+
   ecs_emit(it->world, &(ecs_event_desc_t) {
     .event = CleanUpEvent,
     .entity = CleanUpModule
   });
 
-  ecs_query_t *q = ecs_query(it->world, {
-    .terms = {
-      { .id = ecs_id(PluginModule) },
-    }
-  });
-
-  ecs_iter_t s_it = ecs_query_iter(it->world, q);
-
-  while (ecs_query_next(&s_it)) {
-    PluginModule *p = ecs_field(&s_it, PluginModule, 0);
-    for (int i = 0; i < s_it.count; i ++) {
-      ecs_print(1,"Module Name : %s", 
-        p[i].name
-        //ecs_get_name(s_it.world, s_it.entities[i])
-      
-      );
-    }
-  }
+  // the cleanup observers marked their modules, the check finishes next frame
+  ecs_enable(it->world, g_module->drainSystem, true);
 }
 
 void flecs_cleanup_event_system(ecs_iter_t *it){
@@ -117,55 +117,22 @@ void flecs_close_event_system(ecs_iter_t *it){
   ecs_print(1,"[module] flecs_close_event_system");
 }
 
+// only enabled while draining, steady state frames do not run it
 void flecs_cleanup_checks_system(ecs_iter_t *it){
-  ModuleContext *g_module = ecs_singleton_ensure(it->world, ModuleContext);
-  if(!g_module)return;
-  PluginModule *plugin = ecs_field(it, PluginModule, 0);
-  //ecs_print(1,"checking...");
-
-  ecs_query_t *q = ecs_query(it->world, {
-    .terms = {
-      { .id = ecs_id(PluginModule) },
-    }
-  });
+  ModuleContext *g_module = ecs_field(it, ModuleContext, 0);
 
-  ecs_iter_t s_it = ecs_query_iter(it->world, q);
-
-  bool isFinishCleanup = false;
-  int count = 0;
-  while (ecs_query_next(&s_it)) {
-    PluginModule *p = ecs_field(&s_it, PluginModule, 0);
-    for (int i = 0; i < s_it.count; i ++) {
-      // ecs_print(1,"Module Name : %s", 
-      //   p[i].name
-      //   //ecs_get_name(s_it.world, s_it.entities[i])
-      // );
-      //ecs_print(1,"isCleanUp %d", p[i].isCleanUp);
-      if(p[i].isCleanUp){
-        isFinishCleanup = true;
-        count+=1;
-      }
-    }
-  }
-
-  //
-  //ecs_print(1," COUNT: %d Len:%d ", count, s_it.count);
-  if((count == s_it.count && g_module->isCleanUpModule == false) ){
-    g_module->isCleanUpModule = true;
-    ecs_emit(it->world, &(ecs_event_desc_t) {
-      .event = CleanUpGraphicEvent,
-      .entity = CleanUpGraphic
-    });
-  }
-  //=============================================
-  // 
-  //=============================================
+  if (g_module->cleanedCount < g_module->moduleCount || g_module->isCleanUpModule) return;
 
+  g_module->isCleanUpModule = true;
+  ecs_enable(it->world, it->system, false);
+  ecs_emit(it->world, &(ecs_event_desc_t) {
+    .event = CleanUpGraphicEvent,
+    .entity = CleanUpGraphic
+  });
 }
 
 void flecs_register_components(ecs_world_t *world){
 
-  ECS_COMPONENT_DEFINE(world, PluginModule);
   ECS_COMPONENT_DEFINE(world, ModuleContext);
   // ECS_COMPONENT_DEFINE(world, PluginModuleContext);
 }
@@ -201,14 +168,16 @@ void flecs_register_systems(ecs_world_t *world){
   });
 
 
-  ecs_system_init(world, &(ecs_system_desc_t){
+  ecs_entity_t drain = ecs_system_init(world, &(ecs_system_desc_t){
     .entity = ecs_entity(world, { 
       .name = "flecs_cleanup_checks_system",
       .add = ecs_ids(ecs_dependson(EcsOnUpdate)) 
     }),
-    .query.terms = {{ ecs_id(PluginModule), .inout = EcsIn }},
+    .query.terms = { ECS_SINGLETON_INOUT(ModuleContext) },
     .callback = flecs_cleanup_checks_system,
   });
+  ecs_enable(world, drain, false);
+  ecs_singleton_ensure(world, ModuleContext)->drainSystem = drain;
 
 }
 
@@ -238,47 +207,34 @@ void flecs_init_module(ecs_world_t *world){
 
 }
 
-ecs_entity_t add_module_name(ecs_world_t *world, const char *name) {
-  ecs_entity_t e = ecs_new(world);
-  PluginModule module = { .isCleanUp = false };
-  
+ModuleHandle module_register(ecs_world_t *world, const char *name) {
+  ModuleContext *g_module = ecs_singleton_ensure(world, ModuleContext);
+  if (g_module->moduleCount >= MODULE_MAX) {
+    ecs_err("Module registry full (%d), %s not tracked", MODULE_MAX, name);
+    return MODULE_HANDLE_NONE;
+  }
+
+  ModuleHandle handle = g_module->moduleCount++;
+  PluginModule *module = &g_module->modules[handle];
+  module->state = MODULE_STATE_LOADING;
   // Copy name safely
   #ifdef _MSC_VER
-      strncpy_s(module.name, sizeof(module.name), name, _TRUNCATE); // MSVC-safe
+      strncpy_s(module->name, sizeof(module->name), name, _TRUNCATE); // MSVC-safe
   #else
-      strncpy(module.name, name, sizeof(module.name) - 1);
-      module.name[sizeof(module.name) - 1] = '\0'; // Ensure null-termination
+      strncpy(module->name, name, sizeof(module->name) - 1);
+      module->name[sizeof(module->name) - 1] = '\0'; // Ensure null-termination
   #endif
-  
-  // Set component
-  //ecs_set(world, e, PluginModule, module);
-  ecs_set_id(world, e, ecs_id(PluginModule), sizeof(PluginModule), &module);
-  return e;
+  return handle;
 }
 
-void module_break_name(ecs_iter_t *it, const char *module_name){
-  // Create query for PluginModule
-  ecs_query_t *q = ecs_query(it->world, {
-    .terms = {
-      { .id = ecs_id(PluginModule) }
-    }
-  });
+void module_set_state(ecs_world_t *world, ModuleHandle handle, ModuleState state) {
+  ModuleContext *g_module = ecs_singleton_ensure(world, ModuleContext);
+  if (handle < 0 || handle >= g_module->moduleCount) return;
 
-  ecs_iter_t s_it = ecs_query_iter(it->world, q);
-  bool found = false;
-
-  while (ecs_query_next(&s_it) && !found) {
-    PluginModule *p = ecs_field(&s_it, PluginModule, 0); // 1-based index
-    for (int i = 0; i < s_it.count; i++) {
-        printf("Checking module: %s\n", p[i].name);
-        if (strcmp(p[i].name, module_name) == 0) {
-            p[i].isCleanUp = true;
-            printf("Marked %s for cleanup\n", module_name);
-            found = true;
-            break; // Exit inner loop
-        }
-    }
-  }
-  
+  PluginModule *module = &g_module->modules[handle];
+  if (module->state == state) return;
+  if (state == MODULE_STATE_CLEANED) g_module->cleanedCount++;
+  if (module->state == MODULE_STATE_CLEANED) g_module->cleanedCount--;
+  module->state = state;
+  ecs_dbg("[module] %s state %d", module->name, state);
 }
-
@@ -0,0 +1,474 @@
+// virtual file system
+// PhysFS for directories, our own mapped pack for shipping so thousands of
+// small loose files become one open + page faults.
+
+#include "flecs_vfs.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "physfs.h"
+#include "flecs.h"
+#include <SDL3/SDL.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+typedef struct {
+  const uint8_t *base;          // whole pack mapped read only
+  size_t size;
+  const VfsPackEntry *entries;
+  uint32_t entryCount;
+  uint32_t *buckets;            // open addressing, index + 1, 0 = empty
+  uint32_t bucketCount;
+#ifdef _WIN32
+  HANDLE file;
+  HANDLE mapping;
+#else
+  int fd;
+#endif
+} VfsPack;
+
+static bool g_vfs_init = false;
+static VfsPack g_pack = {0};
+
+//===============================================
+// helpers
+//===============================================
+
+// FNV-1a
+static uint32_t vfs_hash(const char *s) {
+  uint32_t h = 2166136261u;
+  while (*s) {
+    h ^= (uint8_t)*s++;
+    h *= 16777619u;
+  }
+  return h;
+}
+
+// "./assets/x" and "/assets/x" -> "assets/x"
+static const char *vfs_normalize(const char *path) {
+  while (path[0] == '.' && path[1] == '/') path += 2;
+  while (path[0] == '/') path++;
+  return path;
+}
+
+static const VfsPackEntry *vfs_pack_find(const char *path) {
+  if (!g_pack.base || !g_pack.bucketCount) return NULL;
+  uint32_t mask = g_pack.bucketCount - 1;
+  uint32_t i = vfs_hash(path) & mask;
+  for (;;) {
+    uint32_t slot = g_pack.buckets[i];
+    if (slot == 0) return NULL;
+    const VfsPackEntry *e = &g_pack.entries[slot - 1];
+    if (strncmp(e->name, path, VFS_PACK_NAME_MAX) == 0) return e;
+    i = (i + 1) & mask;
+  }
+}
+
+static void vfs_pack_unmap(void) {
+  free(g_pack.buckets);
+#ifdef _WIN32
+  if (g_pack.base) UnmapViewOfFile(g_pack.base);
+  if (g_pack.mapping) CloseHandle(g_pack.mapping);
+  if (g_pack.file && g_pack.file != INVALID_HANDLE_VALUE) CloseHandle(g_pack.file);
+#else
+  if (g_pack.base) munmap((void *)g_pack.base, g_pack.size);
+  if (g_pack.fd > 0) close(g_pack.fd);
+#endif
+  memset(&g_pack, 0, sizeof(g_pack));
+}
+
+//===============================================
+// lz4 block decoder
+//===============================================
+
+int64_t flecs_vfs_lz4_decompress(const uint8_t *src, size_t srcSize, uint8_t *dst, size_t dstSize) {
+  const uint8_t *ip = src;
+  const uint8_t *iend = src + srcSize;
+  uint8_t *op = dst;
+  uint8_t *oend = dst + dstSize;
+
+  while (ip < iend) {
+    uint8_t token = *ip++;
+
+    // literals
+    size_t litLen = token >> 4;
+    if (litLen == 15) {
+      uint8_t b;
+      do {
+        if (ip >= iend) return -1;
+        b = *ip++;
+        litLen += b;
+      } while (b == 255);
+    }
+    if (litLen > (size_t)(iend - ip) || litLen > (size_t)(oend - op)) return -1;
+    memcpy(op, ip, litLen);
+    ip += litLen;
+    op += litLen;
+
+    // last sequence has no match
+    if (ip >= iend) break;
+
+    if (iend - ip < 2) return -1;
+    size_t offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+    ip += 2;
+    if (offset == 0 || offset > (size_t)(op - dst)) return -1;
+
+    size_t matchLen = token & 15;
+    if (matchLen == 15) {
+      uint8_t b;
+      do {
+        if (ip >= iend) return -1;
+        b = *ip++;
+        matchLen += b;
+      } while (b == 255);
+    }
+    matchLen += 4;
+    if (matchLen > (size_t)(oend - op)) return -1;
+
+    // overlap copy, byte by byte when the match runs into itself
+    const uint8_t *match = op - offset;
+    if (offset >= matchLen) {
+      memcpy(op, match, matchLen);
+      op += matchLen;
+    } else {
+      while (matchLen--) *op++ = *match++;
+    }
+  }
+  return (int64_t)(op - dst);
+}
+
+//===============================================
+// api
+//===============================================
+
+bool flecs_vfs_init(const char *argv0) {
+  if (g_vfs_init) return true;
+  if (!PHYSFS_init(argv0)) {
+    ecs_err("PHYSFS_init failed: %s", PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode()));
+    return false;
+  }
+  g_vfs_init = true;
+  // loose files next to the exe and the working dir, "assets/..." paths keep working
+  flecs_vfs_mount(PHYSFS_getBaseDir(), NULL);
+  flecs_vfs_mount(".", NULL);
+  return true;
+}
+
+void flecs_vfs_deinit(void) {
+  if (!g_vfs_init) return;
+  vfs_pack_unmap();
+  PHYSFS_deinit();
+  g_vfs_init = false;
+}
+
+bool flecs_vfs_mount(const char *dir, const char *mountPoint) {
+  if (!g_vfs_init || !dir) return false;
+  if (!PHYSFS_mount(dir, mountPoint, 1)) {
+    ecs_log(1, "[vfs] mount %s failed: %s", dir, PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode()));
+    return false;
+  }
+  ecs_log(1, "[vfs] mounted %s", dir);
+  return true;
+}
+
+bool flecs_vfs_mount_pack(const char *packPath) {
+  if (!g_vfs_init) return false;
+  if (g_pack.base) {
+    ecs_err("[vfs] pack already mounted");
+    return false;
+  }
+
+#ifdef _WIN32
+  g_pack.file = CreateFileA(packPath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (g_pack.file == INVALID_HANDLE_VALUE) {
+    g_pack.file = NULL;
+    return false;
+  }
+  LARGE_INTEGER fileSize;
+  GetFileSizeEx(g_pack.file, &fileSize);
+  g_pack.size = (size_t)fileSize.QuadPart;
+  g_pack.mapping = CreateFileMappingA(g_pack.file, NULL, PAGE_READONLY, 0, 0, NULL);
+  if (g_pack.mapping) g_pack.base = MapViewOfFile(g_pack.mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+  g_pack.fd = open(packPath, O_RDONLY);
+  if (g_pack.fd < 0) {
+    g_pack.fd = 0;
+    return false;
+  }
+  struct stat st;
+  if (fstat(g_pack.fd, &st) == 0 && st.st_size > 0) {
+    g_pack.size = (size_t)st.st_size;
+    void *mapped = mmap(NULL, g_pack.size, PROT_READ, MAP_PRIVATE, g_pack.fd, 0);
+    if (mapped != MAP_FAILED) g_pack.base = mapped;
+  }
+#endif
+  if (!g_pack.base) {
+    ecs_err("[vfs] failed to map %s", packPath);
+    vfs_pack_unmap();
+    return false;
+  }
+
+  const VfsPackHeader *header = (const VfsPackHeader *)g_pack.base;
+  if (g_pack.size < sizeof(VfsPackHeader) || header->magic != VFS_PACK_MAGIC || header->version != VFS_PACK_VERSION ||
+      g_pack.size < sizeof(VfsPackHeader) + (size_t)header->entryCount * sizeof(VfsPackEntry)) {
+    ecs_err("[vfs] %s is not a valid pack", packPath);
+    vfs_pack_unmap();
+    return false;
+  }
+  g_pack.entries = (const VfsPackEntry *)(g_pack.base + sizeof(VfsPackHeader));
+  g_pack.entryCount = header->entryCount;
+
+  // power of two, at most half full
+  g_pack.bucketCount = 16;
+  while (g_pack.bucketCount < g_pack.entryCount * 2) g_pack.bucketCount <<= 1;
+  g_pack.buckets = calloc(g_pack.bucketCount, sizeof(uint32_t));
+  if (!g_pack.buckets) {
+    vfs_pack_unmap();
+    return false;
+  }
+  uint32_t mask = g_pack.bucketCount - 1;
+  for (uint32_t i = 0; i < g_pack.entryCount; i++) {
+    const VfsPackEntry *e = &g_pack.entries[i];
+    // the mapping is read only, a name without its NUL in byte 127 is rejected
+    // rather than terminated, lookups strcmp it
+    if (!memchr(e->name, '\0', VFS_PACK_NAME_MAX)) {
+      ecs_err("[vfs] pack entry %u name is not terminated", i);
+      vfs_pack_unmap();
+      return false;
+    }
+    // no offset + packedSize, a huge offset wraps it back in range. Raw
+    // views hand out size bytes, that has to be what is stored
+    if (e->offset > g_pack.size || e->packedSize > g_pack.size - e->offset ||
+        (e->compression == VFS_COMPRESSION_NONE && e->size != e->packedSize)) {
+      ecs_err("[vfs] pack entry %s out of range", e->name);
+      vfs_pack_unmap();
+      return false;
+    }
+    uint32_t b = vfs_hash(e->name) & mask;
+    while (g_pack.buckets[b]) b = (b + 1) & mask;
+    g_pack.buckets[b] = i + 1;
+  }
+
+  ecs_log(1, "[vfs] mounted pack %s (%u entries)", packPath, g_pack.entryCount);
+  return true;
+}
+
+bool flecs_vfs_exists(const char *path) {
+  if (!path) return false;
+  path = vfs_normalize(path);
+  if (vfs_pack_find(path)) return true;
+  return g_vfs_init && PHYSFS_exists(path);
+}
+
+bool flecs_vfs_real_path(const char *path, char *out, size_t outSize) {
+  if (!path || !out || outSize == 0) return false;
+  path = vfs_normalize(path);
+  // pack wins the lookup, edits to the loose file would never be seen
+  if (vfs_pack_find(path) || !g_vfs_init) return false;
+  const char *dir = PHYSFS_getRealDir(path);
+  if (!dir) return false;
+  size_t len = strlen(dir);
+  const char *sep = (len && (dir[len - 1] == '/' || dir[len - 1] == '\\')) ? "" : "/";
+  if (snprintf(out, outSize, "%s%s%s", dir, sep, path) >= (int)outSize) return false;
+  // inside a zip mount there is no file on disk to watch
+  FILE *f = fopen(out, "rb");
+  if (!f) return false;
+  fclose(f);
+  return true;
+}
+
+bool flecs_vfs_open_view(const char *path, VfsView *view) {
+  memset(view, 0, sizeof(VfsView));
+  if (!path) return false;
+  path = vfs_normalize(path);
+
+  const VfsPackEntry *e = vfs_pack_find(path);
+  if (e) {
+    const uint8_t *src = g_pack.base + e->offset;
+    if (e->compression == VFS_COMPRESSION_NONE) {
+      view->data = src;
+      view->size = e->size;
+      return true;
+    }
+    if (e->compression == VFS_COMPRESSION_LZ4) {
+      uint8_t *dst = malloc(e->size ? e->size : 1);
+      if (!dst) return false;
+      if (flecs_vfs_lz4_decompress(src, e->packedSize, dst, e->size) != (int64_t)e->size) {
+        ecs_err("[vfs] lz4 decode failed %s", path);
+        free(dst);
+        return false;
+      }
+      view->data = dst;
+      view->size = e->size;
+      view->owned = dst;
+      return true;
+    }
+    ecs_err("[vfs] unknown compression %u for %s", e->compression, path);
+    return false;
+  }
+
+  size_t size = 0;
+  void *data = flecs_vfs_read_all(path, &size);
+  if (!data) return false;
+  view->data = data;
+  view->size = size;
+  view->owned = data;
+  return true;
+}
+
+void flecs_vfs_close_view(VfsView *view) {
+  if (!view) return;
+  free(view->owned);
+  memset(view, 0, sizeof(VfsView));
+}
+
+void *flecs_vfs_read_all(const char *path, size_t *size) {
+  if (size) *size = 0;
+  if (!path) return NULL;
+  path = vfs_normalize(path);
+
+  const VfsPackEntry *e = vfs_pack_find(path);
+  if (e) {
+    VfsView view;
+    if (!flecs_vfs_open_view(path, &view)) return NULL;
+    if (view.owned) {
+      if (size) *size = view.size;
+      return view.owned;
+    }
+    void *copy = malloc(view.size ? view.size : 1);
+    if (copy) {
+      memcpy(copy, view.data, view.size);
+      if (size) *size = view.size;
+    }
+    return copy;
+  }
+
+  if (!g_vfs_init) return NULL;
+  PHYSFS_File *file = PHYSFS_openRead(path);
+  if (!file) return NULL;
+  PHYSFS_sint64 length = PHYSFS_fileLength(file);
+  if (length < 0) {
+    PHYSFS_close(file);
+    return NULL;
+  }
+  // +1 so text files can be used as c string
+  char *data = malloc((size_t)length + 1);
+  if (!data) {
+    PHYSFS_close(file);
+    return NULL;
+  }
+  if (PHYSFS_readBytes(file, data, (PHYSFS_uint64)length) != length) {
+    ecs_err("[vfs] short read %s: %s", path, PHYSFS_getErrorByCode(PHYSFS_getLastErrorCode()));
+    free(data);
+    PHYSFS_close(file);
+    return NULL;
+  }
+  data[length] = '\0';
+  PHYSFS_close(file);
+  if (size) *size = (size_t)length;
+  return data;
+}
+
+typedef struct {
+  char **items;
+  int count;
+  int capacity;
+  const char *dir;
+  size_t dirLen;
+  const char *ext;
+} VfsList;
+
+static void vfs_list_add(VfsList *list, const char *name) {
+  size_t len = strlen(name);
+  if (list->ext) {
+    size_t extLen = strlen(list->ext);
+    if (len < extLen || strcmp(name + len - extLen, list->ext) != 0) return;
+  }
+  char path[VFS_PACK_NAME_MAX];
+  if (snprintf(path, sizeof(path), "%.*s/%s", (int)list->dirLen, list->dir, name) >= (int)sizeof(path)) return;
+  // pack and loose files can both have it
+  for (int i = 0; i < list->count; i++) {
+    if (strcmp(list->items[i], path) == 0) return;
+  }
+  if (list->count == list->capacity) {
+    int capacity = list->capacity ? list->capacity * 2 : 16;
+    char **items = realloc(list->items, sizeof(char *) * capacity);
+    if (!items) return;
+    list->items = items;
+    list->capacity = capacity;
+  }
+  char *copy = malloc(strlen(path) + 1);
+  if (!copy) return;
+  strcpy(copy, path);
+  list->items[list->count++] = copy;
+}
+
+static PHYSFS_EnumerateCallbackResult vfs_list_physfs(void *data, const char *origdir, const char *fname) {
+  VfsList *list = data;
+  char path[VFS_PACK_NAME_MAX];
+  snprintf(path, sizeof(path), "%s/%s", origdir, fname);
+  PHYSFS_Stat st;
+  if (PHYSFS_stat(path, &st) && st.filetype == PHYSFS_FILETYPE_REGULAR) {
+    vfs_list_add(list, fname);
+  }
+  return PHYSFS_ENUM_OK;
+}
+
+static int vfs_list_compare(const void *a, const void *b) {
+  return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+char **flecs_vfs_list(const char *dir, const char *ext, int *count) {
+  *count = 0;
+  if (!dir) return NULL;
+  dir = vfs_normalize(dir);
+  VfsList list = { .dir = dir, .dirLen = strlen(dir), .ext = ext };
+  while (list.dirLen > 0 && dir[list.dirLen - 1] == '/') list.dirLen--;
+
+  for (uint32_t i = 0; i < g_pack.entryCount; i++) {
+    const char *name = g_pack.entries[i].name;
+    if (strncmp(name, dir, list.dirLen) != 0 || name[list.dirLen] != '/') continue;
+    const char *file = name + list.dirLen + 1;
+    if (strchr(file, '/')) continue;
+    vfs_list_add(&list, file);
+  }
+  if (g_vfs_init) {
+    char physDir[VFS_PACK_NAME_MAX];
+    snprintf(physDir, sizeof(physDir), "%.*s", (int)list.dirLen, dir);
+    PHYSFS_enumerate(physDir, vfs_list_physfs, &list);
+  }
+
+  if (list.count > 1) qsort(list.items, list.count, sizeof(char *), vfs_list_compare);
+  *count = list.count;
+  return list.items;
+}
+
+void flecs_vfs_list_free(char **list, int count) {
+  if (!list) return;
+  for (int i = 0; i < count; i++) free(list[i]);
+  free(list);
+}
+
+bool flecs_write_file_atomic(const char *path, const void *data, size_t size) {
+  char tmpPath[512];
+  if (snprintf(tmpPath, sizeof(tmpPath), "%s.%llu.tmp", path, (unsigned long long)SDL_GetCurrentThreadID()) >= (int)sizeof(tmpPath)) {
+    return false;
+  }
+  FILE *f = fopen(tmpPath, "wb");
+  if (!f) return false;
+  bool ok = fwrite(data, 1, size, f) == size;
+  ok = fclose(f) == 0 && ok;
+  if (!ok || !SDL_RenamePath(tmpPath, path)) {
+    SDL_RemovePath(tmpPath);
+    return false;
+  }
+  return true;
+}
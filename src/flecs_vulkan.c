@@ -4,6 +4,7 @@
 #include "flecs.h"
 #include "flecs_sdl.h"
 #include "flecs_utils.h" // report_sdl_error
+#include "flecs_memory.h"
 
 static VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(
   VkDebugUtilsMessageSeverityFlagBitsEXT severity,
@@ -32,7 +33,7 @@ void InstanceSetupSystem(ecs_iter_t *it) {
   appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
   appInfo.pEngineName = "No Engine";
   appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-  appInfo.apiVersion = VK_API_VERSION_1_0;
+  appInfo.apiVersion = VK_API_VERSION_1_1; // vkGetPhysicalDeviceMemoryProperties2 for the memory budget
 
   // Get SDL3 Vulkan instance extensions
   uint32_t sdlExtensionCount = 0;
@@ -43,7 +44,7 @@ void InstanceSetupSystem(ecs_iter_t *it) {
 
   // Add VK_EXT_debug_utils
   uint32_t totalExtensionCount = sdlExtensionCount + 1;
-  const char **extensions = malloc(sizeof(const char *) * totalExtensionCount);
+  const char **extensions = flecs_mem_alloc(MEMORY_TAG_VULKAN, sizeof(const char *) * totalExtensionCount);
   if (!extensions) {
     report_sdl_error(sdl_ctx, "Error: Failed to allocate memory for extensions");
   }
@@ -69,7 +70,7 @@ void InstanceSetupSystem(ecs_iter_t *it) {
   createInfo.ppEnabledLayerNames = validationLayers;
 
   VkResult result = vkCreateInstance(&createInfo, NULL, &v_ctx->instance);
-  free(extensions);
+  flecs_mem_free(MEMORY_TAG_VULKAN, extensions);
   if (result != VK_SUCCESS) {
     ecs_err("Error: Failed to create Vulkan instance (VkResult: %d)", result);
     report_sdl_error(sdl_ctx, "Failed to create Vulkan instance");
@@ -135,7 +136,7 @@ void SurfaceSetupSystem(ecs_iter_t *it) {
     report_sdl_error(sdl_ctx, "[SurfaceSetupSystem] No Vulkan physical devices found");
   }
 
-  VkPhysicalDevice* devices = malloc(sizeof(VkPhysicalDevice) * deviceCount);
+  VkPhysicalDevice* devices = flecs_mem_alloc(MEMORY_TAG_VULKAN, sizeof(VkPhysicalDevice) * deviceCount);
   if (!devices) {
     ecs_err("Error: Failed to allocate memory for devices");
     report_sdl_error(sdl_ctx, "[SurfaceSetupSystem] Memory allocation failed");
@@ -144,12 +145,12 @@ void SurfaceSetupSystem(ecs_iter_t *it) {
   result = vkEnumeratePhysicalDevices(v_ctx->instance, &deviceCount, devices);
   if (result != VK_SUCCESS) {
     ecs_err("Error: vkEnumeratePhysicalDevices failed (VkResult: %d)", result);
-    free(devices);
+    flecs_mem_free(MEMORY_TAG_VULKAN, devices);
     report_sdl_error(sdl_ctx, "[SurfaceSetupSystem] Failed to enumerate physical devices (second call)");
   }
 
   v_ctx->physicalDevice = devices[0];  // Pick first device for now
-  free(devices);
+  flecs_mem_free(MEMORY_TAG_VULKAN, devices);
   
   ecs_log(1, "Surface setup completed");
 }
@@ -179,7 +180,7 @@ void DeviceSetupSystem(ecs_iter_t *it) {
     report_sdl_error(sdl_ctx, "[DeviceSetupSystem] No queue families available");
   }
 
-  VkQueueFamilyProperties* queueFamilies = malloc(sizeof(VkQueueFamilyProperties) * queueFamilyCount);
+  VkQueueFamilyProperties* queueFamilies = flecs_mem_alloc(MEMORY_TAG_VULKAN, sizeof(VkQueueFamilyProperties) * queueFamilyCount);
   if (!queueFamilies) {
     ecs_err("Error: Failed to allocate queueFamilies");
     report_sdl_error(sdl_ctx, "[DeviceSetupSystem] Memory allocation failed");
@@ -196,7 +197,7 @@ void DeviceSetupSystem(ecs_iter_t *it) {
       if (v_ctx->graphicsFamily != UINT32_MAX && v_ctx->presentFamily != UINT32_MAX) break;
   }
   ecs_log(1,"Graphics family: %u, Present family: %u", v_ctx->graphicsFamily, v_ctx->presentFamily);
-  free(queueFamilies);
+  flecs_mem_free(MEMORY_TAG_VULKAN, queueFamilies);
 
   if (v_ctx->graphicsFamily == UINT32_MAX || v_ctx->presentFamily == UINT32_MAX) {
     ecs_err("Error: Failed to find required queue families");
@@ -217,11 +218,41 @@ void DeviceSetupSystem(ecs_iter_t *it) {
       queueCreateInfoCount = 2;
   }
 
+  // BC textures from the texture cooker, optional
+  VkPhysicalDeviceFeatures supportedFeatures;
+  vkGetPhysicalDeviceFeatures(v_ctx->physicalDevice, &supportedFeatures);
+  VkPhysicalDeviceFeatures enabledFeatures = {0};
+  enabledFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC;
+  v_ctx->textureCompressionBC = supportedFeatures.textureCompressionBC == VK_TRUE;
+
   VkDeviceCreateInfo deviceCreateInfo = {VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};  // Fixed sType
   deviceCreateInfo.queueCreateInfoCount = queueCreateInfoCount;
   deviceCreateInfo.pQueueCreateInfos = queueCreateInfos;
-  const char *deviceExtensions[] = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
-  deviceCreateInfo.enabledExtensionCount = 1;
+  deviceCreateInfo.pEnabledFeatures = &enabledFeatures;
+  const char *deviceExtensions[2] = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+  uint32_t deviceExtensionCount = 1;
+
+  // heap budget/usage for texture streaming, optional (needs a 1.1 device)
+  VkPhysicalDeviceProperties deviceProperties;
+  vkGetPhysicalDeviceProperties(v_ctx->physicalDevice, &deviceProperties);
+  uint32_t availableCount = 0;
+  vkEnumerateDeviceExtensionProperties(v_ctx->physicalDevice, NULL, &availableCount, NULL);
+  VkExtensionProperties *available = flecs_mem_alloc(MEMORY_TAG_VULKAN, sizeof(VkExtensionProperties) * (availableCount ? availableCount : 1));
+  v_ctx->memoryBudget = false;
+  if (available && deviceProperties.apiVersion >= VK_API_VERSION_1_1) {
+    vkEnumerateDeviceExtensionProperties(v_ctx->physicalDevice, NULL, &availableCount, available);
+    for (uint32_t i = 0; i < availableCount; i++) {
+      if (strcmp(available[i].extensionName, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) == 0) {
+        deviceExtensions[deviceExtensionCount++] = VK_EXT_MEMORY_BUDGET_EXTENSION_NAME;
+        v_ctx->memoryBudget = true;
+        break;
+      }
+    }
+  }
+  flecs_mem_free(MEMORY_TAG_VULKAN, available);
+  ecs_log(1, "VK_EXT_memory_budget: %s", v_ctx->memoryBudget ? "yes" : "no");
+
+  deviceCreateInfo.enabledExtensionCount = deviceExtensionCount;
   deviceCreateInfo.ppEnabledExtensionNames = deviceExtensions;
   //ecs_err("vkCreateDevice");
   if (vkCreateDevice(v_ctx->physicalDevice, &deviceCreateInfo, NULL, &v_ctx->device) != VK_SUCCESS) {
@@ -273,7 +304,7 @@ void SwapchainSetupSystem(ecs_iter_t *it) {
   // Query supported formats
   uint32_t formatCount;
   vkGetPhysicalDeviceSurfaceFormatsKHR(v_ctx->physicalDevice, sdl_ctx->surface, &formatCount, NULL);
-  VkSurfaceFormatKHR* formats = malloc(sizeof(VkSurfaceFormatKHR) * formatCount);
+  VkSurfaceFormatKHR* formats = flecs_mem_alloc(MEMORY_TAG_VULKAN, sizeof(VkSurfaceFormatKHR) * formatCount);
   vkGetPhysicalDeviceSurfaceFormatsKHR(v_ctx->physicalDevice, sdl_ctx->surface, &formatCount, formats);
   VkSurfaceFormatKHR selectedFormat = formats[0];
   for (uint32_t i = 0; i < formatCount; i++) {
@@ -283,12 +314,12 @@ void SwapchainSetupSystem(ecs_iter_t *it) {
           break;
       }
   }
-  free(formats);
+  flecs_mem_free(MEMORY_TAG_VULKAN, formats);
   ecs_log(1, "Query supported present modes");
   // Query supported present modes
   uint32_t presentModeCount;
   vkGetPhysicalDeviceSurfacePresentModesKHR(v_ctx->physicalDevice, sdl_ctx->surface, &presentModeCount, NULL);
-  VkPresentModeKHR* presentModes = malloc(sizeof(VkPresentModeKHR) * presentModeCount);
+  VkPresentModeKHR* presentModes = flecs_mem_alloc(MEMORY_TAG_VULKAN, sizeof(VkPresentModeKHR) * presentModeCount);
   vkGetPhysicalDeviceSurfacePresentModesKHR(v_ctx->physicalDevice, sdl_ctx->surface, &presentModeCount, presentModes);
   VkPresentModeKHR selectedPresentMode = VK_PRESENT_MODE_FIFO_KHR;
   for (uint32_t i = 0; i < presentModeCount; i++) {
@@ -297,7 +328,7 @@ void SwapchainSetupSystem(ecs_iter_t *it) {
           break;
       }
   }
-  free(presentModes);
+  flecs_mem_free(MEMORY_TAG_VULKAN, presentModes);
   
   // Create swapchain
   VkSwapchainCreateInfoKHR swapchainCreateInfo = {VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR};
@@ -324,11 +355,11 @@ void SwapchainSetupSystem(ecs_iter_t *it) {
 
   // Get swapchain images
   vkGetSwapchainImagesKHR(v_ctx->device, v_ctx->swapchain, &v_ctx->imageCount, NULL);
-  v_ctx->swapchainImages = malloc(sizeof(VkImage) * v_ctx->imageCount);
+  v_ctx->swapchainImages = flecs_mem_alloc(MEMORY_TAG_VULKAN, sizeof(VkImage) * v_ctx->imageCount);
   vkGetSwapchainImagesKHR(v_ctx->device, v_ctx->swapchain, &v_ctx->imageCount, v_ctx->swapchainImages);
 
   // Create image views
-  v_ctx->swapchainImageViews = malloc(sizeof(VkImageView) * v_ctx->imageCount);
+  v_ctx->swapchainImageViews = flecs_mem_alloc(MEMORY_TAG_VULKAN, sizeof(VkImageView) * v_ctx->imageCount);
   for (uint32_t i = 0; i < v_ctx->imageCount; i++) {
       VkImageViewCreateInfo viewInfo = {VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
       viewInfo.image = v_ctx->swapchainImages[i];
@@ -399,7 +430,7 @@ void FramebufferSetupSystem(ecs_iter_t *it) {
   VulkanContext *v_ctx = ecs_singleton_ensure(it->world, VulkanContext);
   if (!v_ctx) return;
 
-  v_ctx->framebuffers = malloc(sizeof(VkFramebuffer) * v_ctx->imageCount);
+  v_ctx->framebuffers = flecs_mem_alloc(MEMORY_TAG_VULKAN, sizeof(VkFramebuffer) * v_ctx->imageCount);
   for (uint32_t i = 0; i < v_ctx->imageCount; i++) {
       VkFramebufferCreateInfo framebufferInfo = {VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO};
       framebufferInfo.renderPass = v_ctx->renderPass;
@@ -492,11 +523,54 @@ void SyncSetupSystem(ecs_iter_t *it) {
 //=====================================
 // RENDER LOOP
 //=====================================
+static void destroyDeferred(VkDevice device, const VulkanDeferredDestroy *d) {
+  switch (d->type) {
+    case VK_OBJECT_TYPE_IMAGE: vkDestroyImage(device, (VkImage)d->handle, NULL); break;
+    case VK_OBJECT_TYPE_IMAGE_VIEW: vkDestroyImageView(device, (VkImageView)d->handle, NULL); break;
+    case VK_OBJECT_TYPE_SAMPLER: vkDestroySampler(device, (VkSampler)d->handle, NULL); break;
+    case VK_OBJECT_TYPE_BUFFER: vkDestroyBuffer(device, (VkBuffer)d->handle, NULL); break;
+    case VK_OBJECT_TYPE_DEVICE_MEMORY: vkFreeMemory(device, (VkDeviceMemory)d->handle, NULL); break;
+    case VK_OBJECT_TYPE_PIPELINE: vkDestroyPipeline(device, (VkPipeline)d->handle, NULL); break;
+    default: ecs_err("[vulkan] deferred destroy of unsupported object type %d", (int)d->type); break;
+  }
+}
+
+// all = device idle (cleanup), else only what was queued before the last submitted frame
+static void flushDeferred(VulkanContext *v_ctx, bool all) {
+  uint32_t kept = 0;
+  for (uint32_t i = 0; i < v_ctx->deferredCount; i++) {
+    if (all || v_ctx->deferred[i].frame < v_ctx->frameCount) {
+      destroyDeferred(v_ctx->device, &v_ctx->deferred[i]);
+    } else {
+      v_ctx->deferred[kept++] = v_ctx->deferred[i];
+    }
+  }
+  v_ctx->deferredCount = kept;
+}
+
+void flecs_vulkan_defer_destroy(VulkanContext *v_ctx, VkObjectType type, uint64_t handle) {
+  if (!v_ctx || !v_ctx->device || !handle) return;
+  VulkanDeferredDestroy entry = {type, handle, v_ctx->frameCount};
+  if (v_ctx->deferredCount == v_ctx->deferredCapacity) {
+    uint32_t capacity = v_ctx->deferredCapacity ? v_ctx->deferredCapacity * 2 : 32;
+    VulkanDeferredDestroy *grown = flecs_mem_realloc(MEMORY_TAG_VULKAN, v_ctx->deferred, sizeof(VulkanDeferredDestroy) * capacity);
+    if (!grown) {
+      // no room to wait, stall instead of leaking
+      vkDeviceWaitIdle(v_ctx->device);
+      destroyDeferred(v_ctx->device, &entry);
+      return;
+    }
+    v_ctx->deferred = grown;
+    v_ctx->deferredCapacity = capacity;
+  }
+  v_ctx->deferred[v_ctx->deferredCount++] = entry;
+}
+
 void BeginRenderSystem(ecs_iter_t *it) {
-  SDLContext *sdl_ctx = ecs_singleton_ensure(it->world, SDLContext);
+  SDLContext *sdl_ctx = ecs_field(it, SDLContext, 0);
   if(sdl_ctx->isShutDown)return;
   if (!sdl_ctx || sdl_ctx->hasError || sdl_ctx->isShutDown) return;
-  VulkanContext *v_ctx = ecs_singleton_ensure(it->world, VulkanContext);
+  VulkanContext *v_ctx = ecs_field(it, VulkanContext, 1);
   if (!v_ctx) return;
 
   // Skip rendering if swapchain recreation is needed
@@ -514,6 +588,8 @@ void BeginRenderSystem(ecs_iter_t *it) {
 
   vkWaitForFences(v_ctx->device, 1, &v_ctx->inFlightFence, VK_TRUE, UINT64_MAX);
   vkResetFences(v_ctx->device, 1, &v_ctx->inFlightFence);
+  // last submitted frame is done, anything queued before it can go
+  flushDeferred(v_ctx, false);
 
   VkResult result = vkAcquireNextImageKHR(v_ctx->device, v_ctx->swapchain, UINT64_MAX,
     v_ctx->imageAvailableSemaphore, VK_NULL_HANDLE, &v_ctx->imageIndex);
@@ -534,10 +610,10 @@ void BeginRenderSystem(ecs_iter_t *it) {
 }
 
 void BeginCMDBufferSystem(ecs_iter_t *it) {
-  SDLContext *sdl_ctx = ecs_singleton_ensure(it->world, SDLContext);
+  SDLContext *sdl_ctx = ecs_field(it, SDLContext, 0);
   if(sdl_ctx->isShutDown)return;
   if (!sdl_ctx || sdl_ctx->hasError || sdl_ctx->isShutDown) return;
-  VulkanContext *v_ctx = ecs_singleton_ensure(it->world, VulkanContext);
+  VulkanContext *v_ctx = ecs_field(it, VulkanContext, 1);
   if (!v_ctx) return;
 
   if (v_ctx->skipRender) {
@@ -574,10 +650,10 @@ void BeginCMDBufferSystem(ecs_iter_t *it) {
 }
 
 void EndCMDBufferSystem(ecs_iter_t *it) {
-  SDLContext *sdl_ctx = ecs_singleton_ensure(it->world, SDLContext);
+  SDLContext *sdl_ctx = ecs_field(it, SDLContext, 0);
   if(sdl_ctx->isShutDown)return;
   if (!sdl_ctx || sdl_ctx->hasError || sdl_ctx->isShutDown) return;
-  VulkanContext *v_ctx = ecs_singleton_ensure(it->world, VulkanContext);
+  VulkanContext *v_ctx = ecs_field(it, VulkanContext, 1);
   if (!v_ctx) return;
 
   if (v_ctx->skipRender) {
@@ -595,10 +671,10 @@ void EndCMDBufferSystem(ecs_iter_t *it) {
 }
 
 void EndRenderSystem(ecs_iter_t *it) {
-  SDLContext *sdl_ctx = ecs_singleton_ensure(it->world, SDLContext);
+  SDLContext *sdl_ctx = ecs_field(it, SDLContext, 0);
   if(sdl_ctx->isShutDown)return;
   if (!sdl_ctx || sdl_ctx->hasError || sdl_ctx->isShutDown) return;
-  VulkanContext *v_ctx = ecs_singleton_ensure(it->world, VulkanContext);
+  VulkanContext *v_ctx = ecs_field(it, VulkanContext, 1);
   if (!v_ctx) return;
 
   if (v_ctx->skipRender) {
@@ -624,6 +700,7 @@ void EndRenderSystem(ecs_iter_t *it) {
     sdl_ctx->errorMessage = "Failed to submit queue";
     return;
   }
+  v_ctx->frameCount++;
 
   VkPresentInfoKHR presentInfo = {VK_STRUCTURE_TYPE_PRESENT_INFO_KHR};
   presentInfo.waitSemaphoreCount = 1;
@@ -659,6 +736,10 @@ void flecs_vulkan_cleanup(ecs_world_t *world) {
 
   if (ctx->device) {
       vkDeviceWaitIdle(ctx->device);
+      flushDeferred(ctx, true);
+      flecs_mem_free(MEMORY_TAG_VULKAN, ctx->deferred);
+      ctx->deferred = NULL;
+      ctx->deferredCapacity = 0;
 
       // Destroy device-specific objects (excluding triangle-specific resources)
       if (ctx->inFlightFence != VK_NULL_HANDLE) {
@@ -692,15 +773,15 @@ void flecs_vulkan_cleanup(ecs_world_t *world) {
           }
       }
       if (ctx->framebuffers) {
-          free(ctx->framebuffers);
+          flecs_mem_free(MEMORY_TAG_VULKAN, ctx->framebuffers);
           ctx->framebuffers = NULL;
       }
       if (ctx->swapchainImageViews) {
-          free(ctx->swapchainImageViews);
+          flecs_mem_free(MEMORY_TAG_VULKAN, ctx->swapchainImageViews);
           ctx->swapchainImageViews = NULL;
       }
       if (ctx->swapchainImages) {
-          free(ctx->swapchainImages);
+          flecs_mem_free(MEMORY_TAG_VULKAN, ctx->swapchainImages);
           ctx->swapchainImages = NULL;
       }
       if (ctx->swapchain != VK_NULL_HANDLE) {
@@ -752,9 +833,9 @@ static void cleanupSwapchain(ecs_iter_t *it) {
       v_ctx->swapchainImageViews[i] = VK_NULL_HANDLE;
     }
   }
-  free(v_ctx->framebuffers);
-  free(v_ctx->swapchainImageViews);
-  free(v_ctx->swapchainImages);
+  flecs_mem_free(MEMORY_TAG_VULKAN, v_ctx->framebuffers);
+  flecs_mem_free(MEMORY_TAG_VULKAN, v_ctx->swapchainImageViews);
+  flecs_mem_free(MEMORY_TAG_VULKAN, v_ctx->swapchainImages);
   vkDestroySwapchainKHR(v_ctx->device, v_ctx->swapchain, NULL);
 
   v_ctx->framebuffers = NULL;
@@ -802,7 +883,7 @@ static void recreateSwapchain(ecs_iter_t *it) {
   // Recreate swapchain (similar to SwapchainSetupSystem)
   uint32_t formatCount;
   vkGetPhysicalDeviceSurfaceFormatsKHR(v_ctx->physicalDevice, sdl_ctx->surface, &formatCount, NULL);
-  VkSurfaceFormatKHR* formats = malloc(sizeof(VkSurfaceFormatKHR) * formatCount);
+  VkSurfaceFormatKHR* formats = flecs_mem_alloc(MEMORY_TAG_VULKAN, sizeof(VkSurfaceFormatKHR) * formatCount);
   vkGetPhysicalDeviceSurfaceFormatsKHR(v_ctx->physicalDevice, sdl_ctx->surface, &formatCount, formats);
   VkSurfaceFormatKHR selectedFormat = formats[0];
   for (uint32_t i = 0; i < formatCount; i++) {
@@ -812,11 +893,11 @@ static void recreateSwapchain(ecs_iter_t *it) {
       break;
     }
   }
-  free(formats);
+  flecs_mem_free(MEMORY_TAG_VULKAN, formats);
 
   uint32_t presentModeCount;
   vkGetPhysicalDeviceSurfacePresentModesKHR(v_ctx->physicalDevice, sdl_ctx->surface, &presentModeCount, NULL);
-  VkPresentModeKHR* presentModes = malloc(sizeof(VkPresentModeKHR) * presentModeCount);
+  VkPresentModeKHR* presentModes = flecs_mem_alloc(MEMORY_TAG_VULKAN, sizeof(VkPresentModeKHR) * presentModeCount);
   vkGetPhysicalDeviceSurfacePresentModesKHR(v_ctx->physicalDevice, sdl_ctx->surface, &presentModeCount, presentModes);
   VkPresentModeKHR selectedPresentMode = VK_PRESENT_MODE_FIFO_KHR;
   for (uint32_t i = 0; i < presentModeCount; i++) {
@@ -825,7 +906,7 @@ static void recreateSwapchain(ecs_iter_t *it) {
       break;
     }
   }
-  free(presentModes);
+  flecs_mem_free(MEMORY_TAG_VULKAN, presentModes);
 
   VkSwapchainCreateInfoKHR swapchainCreateInfo = {VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR};
   swapchainCreateInfo.surface = sdl_ctx->surface;
@@ -850,11 +931,11 @@ static void recreateSwapchain(ecs_iter_t *it) {
 
   // Get new swapchain images
   vkGetSwapchainImagesKHR(v_ctx->device, v_ctx->swapchain, &v_ctx->imageCount, NULL);
-  v_ctx->swapchainImages = malloc(sizeof(VkImage) * v_ctx->imageCount);
+  v_ctx->swapchainImages = flecs_mem_alloc(MEMORY_TAG_VULKAN, sizeof(VkImage) * v_ctx->imageCount);
   vkGetSwapchainImagesKHR(v_ctx->device, v_ctx->swapchain, &v_ctx->imageCount, v_ctx->swapchainImages);
 
   // Create new image views
-  v_ctx->swapchainImageViews = malloc(sizeof(VkImageView) * v_ctx->imageCount);
+  v_ctx->swapchainImageViews = flecs_mem_alloc(MEMORY_TAG_VULKAN, sizeof(VkImageView) * v_ctx->imageCount);
   for (uint32_t i = 0; i < v_ctx->imageCount; i++) {
     VkImageViewCreateInfo viewInfo = {VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
     viewInfo.image = v_ctx->swapchainImages[i];
@@ -872,7 +953,7 @@ static void recreateSwapchain(ecs_iter_t *it) {
   }
 
   // Recreate framebuffers
-  v_ctx->framebuffers = malloc(sizeof(VkFramebuffer) * v_ctx->imageCount);
+  v_ctx->framebuffers = flecs_mem_alloc(MEMORY_TAG_VULKAN, sizeof(VkFramebuffer) * v_ctx->imageCount);
   for (uint32_t i = 0; i < v_ctx->imageCount; i++) {
     VkFramebufferCreateInfo framebufferInfo = {VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO};
     framebufferInfo.renderPass = v_ctx->renderPass;
@@ -903,9 +984,9 @@ static void recreateSwapchain(ecs_iter_t *it) {
 
 // resize window when SDL input handle
 void SwapchainRecreationSystem(ecs_iter_t *it) {
-  SDLContext *sdl_ctx = ecs_singleton_ensure(it->world, SDLContext);
+  SDLContext *sdl_ctx = ecs_field(it, SDLContext, 0);
   if (!sdl_ctx || sdl_ctx->hasError || sdl_ctx->isShutDown) return;
-  VulkanContext *v_ctx = ecs_singleton_ensure(it->world, VulkanContext);
+  VulkanContext *v_ctx = ecs_field(it, VulkanContext, 1);
   if (!v_ctx) return;
 
   if (sdl_ctx->needsSwapchainRecreation) {
@@ -985,27 +1066,32 @@ void vulkan_register_system(ecs_world_t *world){
 
   ecs_system_init(world, &(ecs_system_desc_t){
     .entity = ecs_entity(world, { .name = "SwapchainRecreationSystem", .add = ecs_ids(ecs_dependson(GlobalPhases.LogicUpdatePhase)) }),
+    .query.terms = { ECS_SINGLETON_INOUT(SDLContext), ECS_SINGLETON_INOUT(VulkanContext) },
     .callback = SwapchainRecreationSystem
   });
 
   ecs_system_init(world, &(ecs_system_desc_t){
       .entity = ecs_entity(world, { .name = "BeginRenderSystem", .add = ecs_ids(ecs_dependson(GlobalPhases.BeginRenderPhase)) }),
+      .query.terms = { ECS_SINGLETON_INOUT(SDLContext), ECS_SINGLETON_INOUT(VulkanContext) },
       .callback = BeginRenderSystem
   });
 
   ecs_system_init(world, &(ecs_system_desc_t){
       .entity = ecs_entity(world, { .name = "BeginCMDBufferSystem", .add = ecs_ids(ecs_dependson(GlobalPhases.BeginCMDBufferPhase)) }),
+      .query.terms = { ECS_SINGLETON_INOUT(SDLContext), ECS_SINGLETON_INOUT(VulkanContext) },
       .callback = BeginCMDBufferSystem
   });
 
   // //end cmd buffer
   ecs_system_init(world, &(ecs_system_desc_t){
     .entity = ecs_entity(world, { .name = "EndCMDBufferSystem", .add = ecs_ids(ecs_dependson(GlobalPhases.EndCMDBufferPhase)) }),
+    .query.terms = { ECS_SINGLETON_INOUT(SDLContext), ECS_SINGLETON_INOUT(VulkanContext) },
     .callback = EndCMDBufferSystem
   });
 
   ecs_system_init(world, &(ecs_system_desc_t){
       .entity = ecs_entity(world, { .name = "EndRenderSystem", .add = ecs_ids(ecs_dependson(GlobalPhases.EndRenderPhase)) }),
+      .query.terms = { ECS_SINGLETON_INOUT(SDLContext), ECS_SINGLETON_INOUT(VulkanContext) },
       .callback = EndRenderSystem
   });
 }
@@ -2,12 +2,27 @@
 
 #include <SDL3/SDL.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "flecs.h"
 #include "flecs_types.h"
 #include "flecs_vulkan.h"
 #include "flecs_imgui.h"
 #include "flecs_text.h"
 #include "flecs_sdl.h"
+#include "flecs_asset_jobs.h"
+#include "flecs_asset_registry.h"
+#include "flecs_hot_reload.h"
+#include "flecs_vfs.h"
+#include "flecs_texture_array.h"
+#include "flecs_texture_stream.h"
+#include "flecs_transform.h"
+#include "flecs_timestep.h"
+#include "flecs_profile.h"
+#include "flecs_bvh.h"
+#include "flecs_memory.h"
+#include "flecs_snapshot.h"
+#include "flecs_replay.h"
 // #include "flecs_texture2d.h"
 // #include "flecs_triangle2d.h"
 // #include "flecs_cube3d.h"
@@ -16,8 +31,58 @@
 #include "flecs_assimp.h"
 #include "flecs_assets3d.h"
 
+// "--name N" on the command line, fallback when missing
+static int32_t mainArgInt(int argc, char *argv[], const char *name, int32_t fallback) {
+  int32_t value = fallback;
+  for (int i = 1; i + 1 < argc; i++) {
+    if (strcmp(argv[i], name) == 0) value = atoi(argv[i + 1]);
+  }
+  return value;
+}
+
+// "--name text" on the command line, fallback when missing
+static const char *mainArgString(int argc, char *argv[], const char *name, const char *fallback) {
+  const char *value = fallback;
+  for (int i = 1; i + 1 < argc; i++) {
+    if (strcmp(argv[i], name) == 0) value = argv[i + 1];
+  }
+  return value;
+}
+
+// --record file / --replay file, --replay-pace recorded|fast|fixed
+static void mainReplayInit(ecs_world_t *world, int argc, char *argv[]) {
+  const char *pace = mainArgString(argc, argv, "--replay-pace", "recorded");
+  ReplayPace replayPace = strcmp(pace, "fast") == 0 ? REPLAY_PACE_FAST :
+                          strcmp(pace, "fixed") == 0 ? REPLAY_PACE_FIXED : REPLAY_PACE_RECORDED;
+  const char *replayPath = mainArgString(argc, argv, "--replay", NULL);
+  const char *recordPath = mainArgString(argc, argv, "--record", NULL);
+  if (replayPath) {
+    flecs_replay_module_init(world, REPLAY_PLAY, replayPath, replayPace);
+  } else {
+    flecs_replay_module_init(world, recordPath ? REPLAY_RECORD : REPLAY_OFF, recordPath, replayPace);
+  }
+}
+
+// flecs worker stages, "--threads N" (1 = single threaded), one per core by
+// default. Only systems marked .multi_threaded use the workers
+static int32_t mainThreadCount(int argc, char *argv[]) {
+  int32_t threads = mainArgInt(argc, argv, "--threads", SDL_GetNumLogicalCPUCores());
+  if (threads < 1) threads = 1;
+  return threads > ECS_MAX_THREADS ? ECS_MAX_THREADS : threads;
+}
+
 int main(int argc, char *argv[]) {
 
+  // flecs allocates through mimalloc from its first allocation (vfs logs
+  // through flecs already)
+  flecs_memory_os_api_init();
+
+  // virtual file system, loose files + assets.pak if it exists
+  if (!flecs_vfs_init(argv[0])) {
+    return 1;
+  }
+  flecs_vfs_mount_pack("assets.pak");
+
   ecs_world_t *world = ecs_init();
   //ecs_log_set_level(1);
   ecs_print(1, "init main, flecs ...");
@@ -25,14 +90,63 @@ int main(int argc, char *argv[]) {
   //this need to be load first for phase for setup and runtime render
   ecs_log(1, "Initializing main flecs_init_module...");
   flecs_init_module(world);
+
+  // per frame arena, its reset has to be the first BeginRenderPhase system
+  ecs_log(1, "Calling flecs_memory_module_init...");
+  flecs_memory_module_init(world);
+
+  // per system / per phase CPU timing, systems are wrapped after every module init
+  ecs_log(1, "Calling flecs_profile_module_init...");
+  flecs_profile_module_init(world);
+
+  // LocalTransform / WorldTransform through ChildOf (before timestep, it blends into LocalTransform)
+  ecs_log(1, "Calling flecs_transform_module_init...");
+  flecs_transform_module_init(world);
+
+  // Bounds + WorldTransform in a dynamic AABB tree, updated right after propagation
+  ecs_log(1, "Calling flecs_bvh_module_init...");
+  flecs_bvh_module_init(world);
+
+  // simulation ticks at a fixed rate, rendering once per frame (--tick-rate N)
+  ecs_log(1, "Calling flecs_timestep_module_init...");
+  flecs_timestep_module_init(world, (float)mainArgInt(argc, argv, "--tick-rate", TIMESTEP_DEFAULT_RATE));
+
+  // binary / JSON snapshots of the plain data components registered above
+  ecs_log(1, "Calling flecs_snapshot_module_init...");
+  flecs_snapshot_module_init(world);
   // 
   ecs_log(1, "Calling flecs_sdl_module_init...");
   // setup SDL 3.x window and Input event 
   flecs_sdl_module_init(world);
+
+  // input record / replay, its system has to follow SDLInputSystem
+  ecs_log(1, "Calling flecs_replay_module_init...");
+  mainReplayInit(world, argc, argv);
+
   // setup Vulkan graphic
   ecs_log(1, "Calling flecs_vulkan_module_init...");
   flecs_vulkan_module_init(world);
 
+  // worker threads for stbi_load, aiImportFile, freetype (before modules that load assets)
+  ecs_log(1, "Calling flecs_asset_jobs_module_init...");
+  flecs_asset_jobs_module_init(world);
+
+  // shared assets by path and content hash, refcounted by owner entities
+  ecs_log(1, "Calling flecs_asset_registry_module_init...");
+  flecs_asset_registry_module_init(world);
+
+  // re-import changed loose asset files while running (before modules that load assets)
+  ecs_log(1, "Calling flecs_hot_reload_module_init...");
+  flecs_hot_reload_module_init(world);
+
+  // texture sets, directory of pngs as one 2d array image (texture2d uses it)
+  ecs_log(1, "Calling flecs_texture_array_module_init...");
+  flecs_texture_array_module_init(world);
+
+  // texture streaming, mips resident by screen size inside a VRAM budget (cubetexture3d uses it)
+  ecs_log(1, "Calling flecs_texture_stream_module_init...");
+  flecs_texture_stream_module_init(world);
+
   // example test module
   // ecs_log(1, "Calling flecs_cubetexture3d_module_init...");
   // flecs_cubetexture3d_module_init(world);
@@ -69,27 +183,44 @@ int main(int argc, char *argv[]) {
   ecs_log(1, "Calling flecs_imgui_module_init...");
   flecs_imgui_module_init(world);
   
+  // render submission stays on the main thread, systems declare their
+  // singleton reads / writes (ECS_SINGLETON_IN / INOUT) for the scheduler
+  int32_t threads = mainThreadCount(argc, argv);
+  if (threads > 1) {
+    ecs_set_threads(world, threads);
+    ecs_log(1, "flecs worker threads: %d", threads);
+  }
+
+  // after every system exists and the stage count is known
+  flecs_profile_attach(world);
+
   ecs_print(1, "Entering main loop...");
-  Uint64 previousTime = SDL_GetTicks(); // Time at the start
+  Uint64 previousTime = SDL_GetTicksNS(); // Time at the start
   //ecs_abort(ECS_INTERNAL_ERROR, "TEST"); // Test error
 
+  // SDLContext once per frame, the ref skips the singleton lookup
+  ecs_ref_t sdl_ref = ECS_SINGLETON_REF(world, SDLContext);
   bool shouldQuit = false;
   while (!shouldQuit) {
-    SDLContext *sdl_ctx = ecs_singleton_ensure(world, SDLContext);
-    if(!sdl_ctx)return;
     // Get current time and calculate delta time
-    Uint64 currentTime = SDL_GetTicks();
-    float deltaTime = (currentTime - previousTime) / 1000.0f; // Convert ms to seconds
+    Uint64 currentTime = SDL_GetTicksNS();
+    float deltaTime = (float)((double)(currentTime - previousTime) / SDL_NS_PER_SECOND); // Convert ns to seconds
     previousTime = currentTime; // Update previous time for next frame
     // Print delta time
     //printf("Delta Time: %f seconds\n", deltaTime);
-    //flecs run time update
-    ecs_progress(world, deltaTime);
-    //check if SDL context is quit
-    shouldQuit = sdl_ctx->shouldQuit;
+    // recorded delta when replaying (and the wait for real time pacing)
+    deltaTime = flecs_replay_frame_delta(world, deltaTime);
+    //flecs run time update, fixed simulation ticks then one render frame
+    flecs_timestep_progress(world, deltaTime);
+    flecs_profile_frame_end(world);
+    //check if SDL context is quit (after the frame, the table may have moved)
+    const SDLContext *sdl_ctx = ecs_ref_get(world, &sdl_ref, SDLContext);
+    shouldQuit = !sdl_ctx || sdl_ctx->shouldQuit;
   }
   //ecs_progress(world, 1);
 
+  flecs_profile_print(world);
+
   ecs_print(1, "Cleaning up...");
   // flecs_luajit_cleanup(world);
   // Vulkan graphic variable cleanup
@@ -104,6 +235,9 @@ int main(int argc, char *argv[]) {
   // flecs_sdl_cleanup(world);
   // flecs cleanup world
   ecs_fini(world);
+  flecs_vfs_deinit();
+  // what is still live per tag after the world is gone
+  flecs_memory_print();
 
   ecs_print(1, "Program exiting");
   return 0;